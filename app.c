@@ -0,0 +1,390 @@
+/******************************************************************************
+* File Name: app.c
+*
+* Description: Application core of the power modes example. The switch
+*              interrupt counts presses; the idle governor enters Sleep or
+*              Deep Sleep depending on the press count; the power callback
+*              blinks the User LED before the transition. Every function
+*              works on the app_ctx_t it is given.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cy_pdl.h"
+#include "cybsp.h"
+#include "cycfg_pins.h"
+#include "app.h"
+#include "defer.h"
+#include "supply_mon.h"
+#include "wdt_svc.h"
+
+#define LOG_MODULE_LEVEL        LOG_LEVEL_APP
+#include "log.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+#define LED_ON                  (0U)
+#define LED_OFF                 (1U)
+
+/* Callback phases the application module never needs: CHECK_READY always
+ * succeeds, and CHECK_FAIL / AFTER_TRANSITION only log */
+#define APP_PM_SKIP             (CY_SYSPM_SKIP_CHECK_READY | \
+    (LOG_ENABLED(LOG_LEVEL_WARN) ? 0U : CY_SYSPM_SKIP_CHECK_FAIL) | \
+    (LOG_ENABLED(LOG_LEVEL_DEBUG) ? 0U : CY_SYSPM_SKIP_AFTER_TRANSITION))
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+PM_WAKE_FUNC static void app_idle(app_ctx_t *ctx);
+PM_WAKE_FUNC static void app_sleep(app_ctx_t *ctx, cy_en_syspm_callback_type_t type);
+PM_WAKE_FUNC static void app_press_work(void *arg, uint32_t now);
+static void led_blink(app_ctx_t *ctx, uint32_t blink_time, uint32_t num_toggles);
+
+/*******************************************************************************
+ * Function Name: app_init
+ *******************************************************************************
+ *
+ * Summary:
+ *  Initializes an application instance. Call it before pm_init(), which
+ *  enables the switch interrupt.
+ *
+ * Parameters:
+ *  ctx: Instance.
+ *  config: Tunables, see APP_CONFIG_DEFAULT.
+ *  module: Power management module whose callback and switch interrupt
+ *          handler forward to app_pm_event() and app_switch_isr() for this
+ *          instance; its skipMode must point to ctx->pmSkip.
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void app_init(app_ctx_t *ctx, const app_config_t *config, const pm_module_t *module)
+{
+    ctx->config = *config;
+    ctx->module = module;
+    ctx->switchPressCount = 0;
+    ctx->sleepPressCount = 0;
+    ctx->presses = 0U;
+    ctx->pmSkip = APP_PM_SKIP;
+
+    /* The first press is never within the debounce window */
+    ctx->lastPressTicks = 0U - WDT_SVC_MS_TO_TICKS(config->debounceMs);
+
+    /* Attach the output shadow to the User LED port */
+    gpio_out_init(&ctx->ledPort, CYBSP_USER_LED_PORT);
+}
+
+/*******************************************************************************
+ * Function Name: app_step
+ *******************************************************************************
+ *
+ * Summary:
+ *  One iteration of the main loop: reports the loop alive to the watchdog,
+ *  runs the work the interrupt handlers deferred, and runs the idle
+ *  governor. Part of the wake path, see PM_WAKE_PATH_IN_RAM.
+ *
+ * Parameters:
+ *  ctx: Instance.
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+PM_WAKE_FUNC void app_step(app_ctx_t *ctx)
+{
+    /* The main loop runs after every wakeup: report it to the watchdog */
+    wdt_svc_kick();
+
+    /* Count the switch presses taken since the last iteration */
+    defer_run();
+
+    /* Pick and enter the power mode for the current switch press count */
+    app_idle(ctx);
+}
+
+/*******************************************************************************
+ * Function Name: app_idle
+ *******************************************************************************
+ *
+ * Summary:
+ *  Idle governor. Keeps the User LED on in Active mode and enters Sleep or
+ *  Deep Sleep depending on the number of switch presses.
+ *
+ * Parameters:
+ *  ctx: Instance.
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+PM_WAKE_FUNC static void app_idle(app_ctx_t *ctx)
+{
+    /* Turn on User LED; no port access when it is already on */
+    gpio_out_write(&ctx->ledPort, CYBSP_USER_LED_NUM, LED_ON);
+
+    /* Sleep mode */
+    if (ctx->switchPressCount == ctx->config.sleepPress)
+    {
+        LOG_INFO("Enter Sleep mode");
+
+        /* Go to Sleep, or Deep Sleep if the supply is degraded */
+        app_sleep(ctx, supply_policy_sleep_type(CY_SYSPM_SLEEP));
+    }
+    /* Deep sleep mode */
+    else if (ctx->switchPressCount == ctx->config.deepSleepPress)
+    {
+        LOG_INFO("Enter Deep Sleep mode");
+
+        /* Go to Deep Sleep */
+        app_sleep(ctx, CY_SYSPM_DEEPSLEEP);
+
+        /* Making switch press count to 0U */
+        ctx->switchPressCount = 0;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: app_sleep
+ *******************************************************************************
+ *
+ * Summary:
+ *  Enters a low power mode until the switch is pressed. When a module refuses
+ *  Deep Sleep, for example the USB-PD gate during CC / PD activity, the CPU
+ *  enters Sleep instead. An entry canceled for pending work is not retried:
+ *  the work runs first.
+ *
+ * Parameters:
+ *  ctx: Instance.
+ *  type: CY_SYSPM_SLEEP or CY_SYSPM_DEEPSLEEP.
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+PM_WAKE_FUNC static void app_sleep(app_ctx_t *ctx, cy_en_syspm_callback_type_t type)
+{
+    ctx->sleepPressCount = ctx->switchPressCount;
+
+    /* Watchdog service wakeups return here with no switch press: report the
+     * main loop alive and go back to sleep, without the LED indication */
+    do
+    {
+        if ((pm_enter(type) == CY_SYSPM_FAIL) && (type == CY_SYSPM_DEEPSLEEP))
+        {
+            LOG_INFO("Deep Sleep blocked, enter Sleep mode");
+            (void) pm_enter(CY_SYSPM_SLEEP);
+        }
+        wdt_svc_kick();
+        defer_run();
+        pm_skip_update(ctx->module, CY_SYSPM_SKIP_BEFORE_TRANSITION, 0U);
+    } while (!app_work_pending(ctx));
+
+    pm_skip_update(ctx->module, 0U, CY_SYSPM_SKIP_BEFORE_TRANSITION);
+}
+
+/*******************************************************************************
+ * Function Name: app_switch_isr
+ *******************************************************************************
+ *
+ * Summary:
+ *  Switch interrupt: clears the pin interrupt and defers the press to the
+ *  main loop (app_press_work()), with the time of the edge when there is a
+ *  debounce window. If the queue is full the edge is dropped, as an edge
+ *  merged into a pending interrupt would be.
+ *
+ * Parameters:
+ *  ctx: Instance.
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+PM_WAKE_FUNC void app_switch_isr(app_ctx_t *ctx)
+{
+    /* Clears the triggered pin interrupt */
+    Cy_GPIO_ClearInterrupt(CYBSP_USER_BTN_PORT, CYBSP_USER_BTN_NUM);
+
+    (void) defer_post(app_press_work, ctx, (ctx->config.debounceMs != 0U) ? wdt_svc_now() : 0U);
+}
+
+/*******************************************************************************
+ * Function Name: app_press_work
+ *******************************************************************************
+ *
+ * Summary:
+ *  Switch press, run by the main loop: counts the press. With a debounce
+ *  window, edges within it after a counted press are ignored.
+ *
+ * Parameters:
+ *  arg: Instance.
+ *  now: wdt_svc_now() at the edge, with a debounce window.
+ *
+ ******************************************************************************/
+PM_WAKE_FUNC static void app_press_work(void *arg, uint32_t now)
+{
+    app_ctx_t *ctx = (app_ctx_t *)arg;
+
+    if (ctx->config.debounceMs != 0U)
+    {
+        if ((now - ctx->lastPressTicks) < WDT_SVC_MS_TO_TICKS(ctx->config.debounceMs))
+        {
+            return;
+        }
+        ctx->lastPressTicks = now;
+    }
+
+    /* Counts the switch press */
+    ctx->switchPressCount++;
+    ctx->presses++;
+    LOG_DEBUG("Switch press %ld", ctx->switchPressCount);
+}
+
+/*******************************************************************************
+ * Function Name: app_work_pending
+ *******************************************************************************
+ *
+ * Summary:
+ *  Reports a switch press that app_sleep() has not acted on yet. A press
+ *  still in the deferred work queue is reported by the queue's own module:
+ *  pm_enter() checks both with interrupts masked, so a press taken during
+ *  the LED indication does not wait in Sleep for the next wakeup.
+ *
+ * Parameters:
+ *  ctx: Instance.
+ *
+ * Return:
+ *  true if the switch press count changed since app_sleep() started.
+ *
+ ******************************************************************************/
+PM_WAKE_FUNC bool app_work_pending(const app_ctx_t *ctx)
+{
+    return ctx->switchPressCount != ctx->sleepPressCount;
+}
+
+/*******************************************************************************
+ * Function Name: app_pm_event
+ *******************************************************************************
+ *
+ * Summary:
+ *  Sleep and Deep Sleep callback implementation. It turns the LED off before
+ *  going to the low power mode, after blinking it two times for Sleep mode and
+ *  three times for Deep Sleep mode.
+ *
+ * Parameters:
+ *  ctx: Instance.
+ *  type: Power mode being entered, see cy_en_syspm_callback_type_t
+ *  mode: Callback mode, see cy_en_syspm_callback_mode_t
+ *
+ * Return:
+ *  Entered status, see cy_en_syspm_status_t.
+ *
+ ******************************************************************************/
+PM_WAKE_FUNC cy_en_syspm_status_t app_pm_event(app_ctx_t *ctx, cy_en_syspm_callback_type_t type,
+                                               cy_en_syspm_callback_mode_t mode)
+{
+    cy_en_syspm_status_t ret_val = CY_SYSPM_FAIL;
+
+    switch (mode)
+    {
+        case CY_SYSPM_CHECK_READY:
+            ret_val = CY_SYSPM_SUCCESS;
+            break;
+
+        case CY_SYSPM_CHECK_FAIL:
+            LOG_WARN("Device failed to enter Deep Sleep mode");
+            ret_val = CY_SYSPM_FAIL;
+            break;
+
+        case CY_SYSPM_BEFORE_TRANSITION:
+            /* Blink the LED two times before Sleep and three times before
+             * Deep Sleep, fewer when the supply is degraded */
+            led_blink(ctx, ctx->config.blinkTimeMs,
+                      supply_policy_throttle((type == CY_SYSPM_DEEPSLEEP) ? 3U : 2U));
+
+            ret_val = CY_SYSPM_SUCCESS;
+            break;
+
+        case CY_SYSPM_AFTER_TRANSITION:
+            LOG_DEBUG("Enters Active mode");
+            ret_val = CY_SYSPM_SUCCESS;
+            break;
+
+        default:
+            /* Don't do anything in the other modes */
+            ret_val = CY_SYSPM_SUCCESS;
+            break;
+    }
+    return ret_val;
+}
+
+/*******************************************************************************
+ * Function Name: led_blink
+ *******************************************************************************
+ * Summary:
+ * Blinks the LED for num_toggles times, with a period of blink_time.
+ *
+ * Parameters:
+ * ctx:         Instance.
+ * blink_time:  Time in ms for on and off times.
+ * num_toggles: Describes how many times to toggle the LED on and off.
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void led_blink(app_ctx_t *ctx, uint32_t blink_time, uint32_t num_toggles)
+{
+    /* Variable used to set LED blink time */
+    uint8_t count = 0U;
+
+    /* Toggle the LED the desired number of times in this loop */
+    for (count = 0; count < num_toggles; count++)
+    {
+        gpio_out_write(&ctx->ledPort, CYBSP_USER_LED_NUM, LED_OFF);
+        Cy_SysLib_Delay(blink_time);
+        gpio_out_write(&ctx->ledPort, CYBSP_USER_LED_NUM, LED_ON);
+        Cy_SysLib_Delay(blink_time);
+    }
+
+    /* Turn off the User LED */
+    gpio_out_write(&ctx->ledPort, CYBSP_USER_LED_NUM, LED_OFF);
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,109 @@
+/******************************************************************************
+* File Name: app.h
+*
+* Description: Application core of the power modes example: the switch press
+*              counting, the idle governor and the LED indication of the
+*              power transitions. All state is kept in an app_ctx_t passed
+*              to every function, so the core is re-entrant; the firmware
+*              binds one static instance in main.c.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef APP_H
+#define APP_H
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cy_pdl.h"
+#include "pm_module.h"
+#include "gpio_out.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Default tunables, see app_config_t */
+#define APP_SLEEP_SWITCH_PRESS          (1U)
+#define APP_DEEP_SLEEP_SWITCH_PRESS     (3U)
+#define APP_BLINK_TIME_MS               (200U)
+#define APP_DEBOUNCE_MS                 (0U)
+
+#define APP_CONFIG_DEFAULT                                                     \
+{                                                                              \
+    APP_SLEEP_SWITCH_PRESS,                                                    \
+    APP_DEEP_SLEEP_SWITCH_PRESS,                                               \
+    APP_BLINK_TIME_MS,                                                         \
+    APP_DEBOUNCE_MS                                                            \
+}
+
+/*******************************************************************************
+ * Data types
+ ******************************************************************************/
+/* Application tunables */
+typedef struct
+{
+    int16_t sleepPress;                 /* Switch presses that select Sleep */
+    int16_t deepSleepPress;             /* Switch presses that select Deep Sleep */
+    uint32_t blinkTimeMs;               /* LED on and off times of the indication */
+    uint32_t debounceMs;                /* Edges ignored after a press, 0 for none */
+} app_config_t;
+
+/* Application instance */
+typedef struct
+{
+    app_config_t config;
+    const pm_module_t *module;          /* Power management module of the instance */
+    int16_t switchPressCount;           /* Presses since the last Deep Sleep */
+    int16_t sleepPressCount;            /* Count app_sleep() waits to change */
+    volatile uint8_t pmSkip;            /* Callback phases skipped by the module */
+    uint32_t lastPressTicks;            /* wdt_svc_now() of the last press */
+    uint32_t presses;                   /* Presses counted since app_init() */
+    gpio_out_port_t ledPort;            /* Shadowed User LED port */
+} app_ctx_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+void app_init(app_ctx_t *ctx, const app_config_t *config, const pm_module_t *module);
+PM_WAKE_FUNC void app_step(app_ctx_t *ctx);
+PM_WAKE_FUNC void app_switch_isr(app_ctx_t *ctx);
+PM_WAKE_FUNC bool app_work_pending(const app_ctx_t *ctx);
+PM_WAKE_FUNC cy_en_syspm_status_t app_pm_event(app_ctx_t *ctx, cy_en_syspm_callback_type_t type,
+                                               cy_en_syspm_callback_mode_t mode);
+
+#endif /* APP_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,235 @@
+/******************************************************************************
+* File Name: clock_ctrl.c
+*
+* Description: Clock change service. HFCLK is sourced from the IMO (24 - 48
+*              MHz in 4 MHz steps) through the HFCLK divider (1, 2, 4 or 8).
+*              Flash wait states are raised before a frequency increase and
+*              lowered after a decrease, so the flash is never accessed with
+*              too few wait states and never runs with more than needed.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "clock_ctrl.h"
+#include "pm_module.h"
+
+#define LOG_MODULE_LEVEL        LOG_LEVEL_CLOCK
+#include "log.h"
+
+/*******************************************************************************
+ * Global variables
+ ******************************************************************************/
+/* IMO frequencies, from CLOCK_CTRL_IMO_MIN_MHZ in CLOCK_CTRL_IMO_STEP_MHZ
+ * steps. The PDL takes them in Hz. */
+static const cy_en_sysclk_imo_freq_t imoFreq[] =
+{
+    CY_SYSCLK_IMO_24MHZ, CY_SYSCLK_IMO_28MHZ, CY_SYSCLK_IMO_32MHZ, CY_SYSCLK_IMO_36MHZ,
+    CY_SYSCLK_IMO_40MHZ, CY_SYSCLK_IMO_44MHZ, CY_SYSCLK_IMO_48MHZ
+};
+
+/*******************************************************************************
+ * Function Name: clock_ctrl_get_hfclk
+ *******************************************************************************
+ *
+ * Summary:
+ *  Returns the current HFCLK frequency.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  HFCLK frequency in Hz.
+ *
+ ******************************************************************************/
+uint32_t clock_ctrl_get_hfclk(void)
+{
+    return Cy_SysClk_ClkHfGetFrequency();
+}
+
+/*******************************************************************************
+ * Function Name: clock_ctrl_set_hfclk
+ *******************************************************************************
+ *
+ * Summary:
+ *  Switches HFCLK to the requested frequency. The IMO frequency and HFCLK
+ *  divider are picked with the smallest divider that reaches it. The flash
+ *  wait states follow the frequency with Cy_SysLib_SetWaitStates(), and the
+ *  clockChanged hook of each power management module is called once the new
+ *  frequency is active. If the IMO refuses the frequency, the divider and
+ *  wait states are restored and the clock stays as it was.
+ *
+ * Parameters:
+ *  hfclkMhz: HFCLK frequency in MHz, for example 48, 24, 12 or 3.
+ *
+ * Return:
+ *  CY_SYSCLK_SUCCESS, CY_SYSCLK_BAD_PARAM if the frequency cannot be
+ *  generated from the IMO or cannot hold CLOCK_CTRL_UART_BAUD, or the
+ *  status of the failed IMO change.
+ *
+ ******************************************************************************/
+cy_en_sysclk_status_t clock_ctrl_set_hfclk(uint32_t hfclkMhz)
+{
+    uint32_t divShift;
+    uint32_t imoMhz = 0U;
+    uint32_t oldMhz = clock_ctrl_get_hfclk() / 1000000UL;
+    cy_en_sysclk_dividers_t oldDiv;
+    cy_en_sysclk_status_t status;
+
+    /* Smallest divider (1, 2, 4, 8) with the IMO in range */
+    for (divShift = 0U; divShift <= 3U; divShift++)
+    {
+        imoMhz = hfclkMhz << divShift;
+        if ((imoMhz >= CLOCK_CTRL_IMO_MIN_MHZ) && (imoMhz <= CLOCK_CTRL_IMO_MAX_MHZ) &&
+            ((imoMhz % CLOCK_CTRL_IMO_STEP_MHZ) == 0U))
+        {
+            break;
+        }
+    }
+
+    if ((hfclkMhz == 0U) || (divShift > 3U))
+    {
+        return CY_SYSCLK_BAD_PARAM;
+    }
+
+#if (CLOCK_CTRL_UART_BAUD != 0U)
+    {
+        /* The peripheral clock follows HFCLK through its own divider */
+        uint32_t periHz = (uint32_t)(((uint64_t)hfclkMhz * 1000000UL * Cy_SysClk_ClkPeriGetFrequency()) /
+                                     clock_ctrl_get_hfclk());
+        clock_ctrl_uart_t uart;
+
+        if (!clock_ctrl_uart_clock(periHz, CLOCK_CTRL_UART_BAUD, &uart))
+        {
+            LOG_WARN("HFCLK %lu MHz: UART baud error %ld ppm", hfclkMhz, uart.errorPpm);
+            return CY_SYSCLK_BAD_PARAM;
+        }
+    }
+#endif
+
+    /* Going up: enough wait states for the new frequency first */
+    if (hfclkMhz > oldMhz)
+    {
+        Cy_SysLib_SetWaitStates(hfclkMhz);
+    }
+
+    /* Divide down before changing the IMO so HFCLK never overshoots */
+    oldDiv = Cy_SysClk_ClkHfGetDivider();
+    Cy_SysClk_ClkHfSetDivider(CY_SYSCLK_DIV_8);
+    status = Cy_SysClk_ImoSetFrequency(imoFreq[(imoMhz - CLOCK_CTRL_IMO_MIN_MHZ) / CLOCK_CTRL_IMO_STEP_MHZ]);
+    if (status != CY_SYSCLK_SUCCESS)
+    {
+        /* The IMO kept its frequency: back to the old divider, and to the
+         * wait states of the old frequency */
+        Cy_SysClk_ClkHfSetDivider(oldDiv);
+        if (hfclkMhz > oldMhz)
+        {
+            Cy_SysLib_SetWaitStates(oldMhz);
+        }
+        LOG_ERROR("HFCLK %lu MHz: IMO %lu MHz refused", hfclkMhz, imoMhz);
+        return status;
+    }
+    Cy_SysClk_ClkHfSetDivider((cy_en_sysclk_dividers_t)divShift);
+
+    /* Going down: drop the wait states no longer needed */
+    if (hfclkMhz < oldMhz)
+    {
+        Cy_SysLib_SetWaitStates(hfclkMhz);
+    }
+
+    /* SystemCoreClock and the Cy_SysLib_Delay calibration */
+    SystemCoreClockUpdate();
+
+    pm_notify_clock(hfclkMhz * 1000000UL);
+    LOG_INFO("HFCLK %lu MHz: IMO %lu MHz / %lu", hfclkMhz, imoMhz, 1UL << divShift);
+
+    return CY_SYSCLK_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: clock_ctrl_uart_clock
+ *******************************************************************************
+ *
+ * Summary:
+ *  Picks the UART clock divider and oversampling closest to a baud rate:
+ *  for each oversampling the nearest divider, the one with the smallest
+ *  error first, the smallest oversampling on a tie.
+ *
+ * Parameters:
+ *  clkHz: Peripheral clock feeding the divider, in Hz.
+ *  baud: Baud rate.
+ *  uart: Returns the setting and its error.
+ *
+ * Return:
+ *  true if the error is within CLOCK_CTRL_BAUD_TOL_PPM.
+ *
+ ******************************************************************************/
+bool clock_ctrl_uart_clock(uint32_t clkHz, uint32_t baud, clock_ctrl_uart_t *uart)
+{
+    uint32_t ovs;
+    uint32_t div;
+    uint64_t rate;
+    int64_t error;
+    int64_t best = INT64_MAX;
+
+    uart->div = 0U;
+    uart->ovs = 0U;
+    uart->errorPpm = INT32_MAX;
+    for (ovs = CLOCK_CTRL_UART_OVS_MIN; ovs <= CLOCK_CTRL_UART_OVS_MAX; ovs++)
+    {
+        div = (clkHz + ((baud * ovs) / 2U)) / (baud * ovs);
+        if ((div == 0U) || (div > 65536UL))
+        {
+            continue;
+        }
+
+        /* Error of the bit rate clkHz / (div * ovs), relative to baud */
+        rate = (uint64_t)baud * div * ovs;
+        error = (((int64_t)clkHz - (int64_t)rate) * 1000000LL) / (int64_t)rate;
+        if (((error < 0) ? -error : error) < best)
+        {
+            best = (error < 0) ? -error : error;
+            uart->div = div;
+            uart->ovs = ovs;
+            uart->errorPpm = (int32_t)error;
+        }
+    }
+
+    return best <= (int64_t)CLOCK_CTRL_BAUD_TOL_PPM;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,93 @@
+/******************************************************************************
+* File Name: clock_ctrl.h
+*
+* Description: Clock change service. Changes the HFCLK frequency with the
+*              flash wait states retuned on every transition, then lets the
+*              power management modules adapt their peripheral clocks (UART
+*              baud rate, timer periods).
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef CLOCK_CTRL_H
+#define CLOCK_CTRL_H
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cy_pdl.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* IMO frequency range, in MHz, and step */
+#define CLOCK_CTRL_IMO_MIN_MHZ  (24U)
+#define CLOCK_CTRL_IMO_MAX_MHZ  (48U)
+#define CLOCK_CTRL_IMO_STEP_MHZ (4U)
+
+/* Baud rate every HFCLK setting must hold on CYBSP_UART, or 0 for none. The
+ * Makefile sets it with TELEMETRY_UART=1; clock_ctrl_set_hfclk() refuses
+ * the frequencies that cannot hold it within CLOCK_CTRL_BAUD_TOL_PPM. */
+#ifndef CLOCK_CTRL_UART_BAUD
+#define CLOCK_CTRL_UART_BAUD    (0U)
+#endif
+
+#define CLOCK_CTRL_BAUD_TOL_PPM (20000U)    /* 2 % */
+
+/* SCB UART oversampling range */
+#define CLOCK_CTRL_UART_OVS_MIN (8U)
+#define CLOCK_CTRL_UART_OVS_MAX (16U)
+
+/*******************************************************************************
+ * Data types
+ ******************************************************************************/
+/* UART clock setting: 16-bit peripheral divider and SCB oversampling */
+typedef struct
+{
+    uint32_t div;                       /* Divider, 1 - 65536 */
+    uint32_t ovs;                       /* Oversampling, SCB clocks per bit */
+    int32_t errorPpm;                   /* Baud rate error */
+} clock_ctrl_uart_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+cy_en_sysclk_status_t clock_ctrl_set_hfclk(uint32_t hfclkMhz);
+uint32_t clock_ctrl_get_hfclk(void);
+bool clock_ctrl_uart_clock(uint32_t clkHz, uint32_t baud, clock_ctrl_uart_t *uart);
+
+#endif /* CLOCK_CTRL_H */
+
+/* [] END OF FILE */
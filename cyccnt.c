@@ -0,0 +1,253 @@
+/******************************************************************************
+* File Name: cyccnt.c
+*
+* Description: Cycle counter on SysTick, extended to 32 bits by the wrap
+*              interrupt, and the begin/end probes of cyccnt.h.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cyccnt.h"
+
+#if CYCCNT_ENABLE
+
+#include "pm_module.h"
+
+/*******************************************************************************
+ * Global variables
+ ******************************************************************************/
+static volatile uint32_t cycWraps;      /* SysTick reloads */
+static uint32_t cycEpoch;               /* Sleep and Deep Sleep entries */
+static uint32_t cycOverhead;            /* Cycles of an empty span */
+
+/* Only BEFORE_TRANSITION and AFTER_TRANSITION have work to do */
+static volatile uint8_t cycSkip = CY_SYSPM_SKIP_CHECK_READY | CY_SYSPM_SKIP_CHECK_FAIL;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+static void cyccnt_init(void);
+static cy_en_syspm_status_t cyccnt_pm_callback(cy_en_syspm_callback_type_t type,
+                                               cy_en_syspm_callback_mode_t mode);
+
+PM_MODULE_DEFINE(cyccnt_module, PM_PRIORITY_DEFAULT,
+    .init     = cyccnt_init,
+    .callback = cyccnt_pm_callback,
+    .types    = PM_TYPE_ALL,
+    .skipMode = &cycSkip);
+
+/*******************************************************************************
+ * Function Name: SysTick_Handler
+ *******************************************************************************
+ *
+ * Summary:
+ *  SysTick wrap interrupt: counts the upper bits of the cycle counter.
+ *
+ ******************************************************************************/
+void SysTick_Handler(void)
+{
+    cycWraps++;
+}
+
+/*******************************************************************************
+ * Function Name: cyccnt_now
+ *******************************************************************************
+ *
+ * Summary:
+ *  Reads the cycle counter. With interrupts masked, a wrap may be pending
+ *  and not yet counted: then SysTick is read again, as the first value may
+ *  predate the reload.
+ *
+ * Return:
+ *  CPU cycles, modulo 2^32. Only differences are meaningful.
+ *
+ ******************************************************************************/
+uint32_t cyccnt_now(void)
+{
+    uint32_t savedIntr = Cy_SysLib_EnterCriticalSection();
+    uint32_t wraps = cycWraps;
+    uint32_t val = SysTick->VAL;
+
+    if ((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) != 0U)
+    {
+        wraps++;
+        val = SysTick->VAL;
+    }
+    Cy_SysLib_ExitCriticalSection(savedIntr);
+
+    /* SysTick counts down */
+    return (wraps << CYCCNT_SYSTICK_BITS) | (CYCCNT_SYSTICK_MASK - val);
+}
+
+/*******************************************************************************
+ * Function Name: cyccnt_overhead
+ *******************************************************************************
+ *
+ * Summary:
+ *  Cycles of an empty span, subtracted from every span a probe measures.
+ *
+ ******************************************************************************/
+uint32_t cyccnt_overhead(void)
+{
+    return cycOverhead;
+}
+
+/*******************************************************************************
+ * Function Name: cyccnt_begin
+ *******************************************************************************
+ *
+ * Summary:
+ *  Starts a span. Use CYCCNT_BEGIN, which compiles out.
+ *
+ * Parameters:
+ *  probe: Probe of the span.
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void cyccnt_begin(cyccnt_probe_t *probe)
+{
+    probe->epoch = cycEpoch;
+    probe->start = cyccnt_now();
+}
+
+/*******************************************************************************
+ * Function Name: cyccnt_end
+ *******************************************************************************
+ *
+ * Summary:
+ *  Ends a span and adds it to the probe. Use CYCCNT_END, which compiles out.
+ *
+ * Parameters:
+ *  probe: Probe of the span.
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void cyccnt_end(cyccnt_probe_t *probe)
+{
+    uint32_t cycles = cyccnt_now() - probe->start;
+
+    if (probe->epoch != cycEpoch)
+    {
+        probe->invalid++;
+        return;
+    }
+
+    cycles = (cycles > cycOverhead) ? (cycles - cycOverhead) : 0U;
+    probe->count++;
+    probe->sum += cycles;
+    if (cycles < probe->min)
+    {
+        probe->min = cycles;
+    }
+    if (cycles > probe->max)
+    {
+        probe->max = cycles;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: cyccnt_init
+ *******************************************************************************
+ *
+ * Summary:
+ *  Power management module init hook: enables the SysTick wrap interrupt on
+ *  the counter pm_stats_init() started, and calibrates the probe overhead.
+ *
+ ******************************************************************************/
+static void cyccnt_init(void)
+{
+    cyccnt_probe_t probe = CYCCNT_PROBE_INIT;
+    uint32_t run;
+
+    if ((SysTick->CTRL & SysTick_CTRL_ENABLE_Msk) == 0U)
+    {
+        SysTick->LOAD = CYCCNT_SYSTICK_MASK;
+        SysTick->VAL = 0U;
+        SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+    }
+    SysTick->CTRL |= SysTick_CTRL_TICKINT_Msk;
+
+    cycOverhead = 0U;
+    for (run = 0U; run < CYCCNT_CALIBRATE_RUNS; run++)
+    {
+        cyccnt_begin(&probe);
+        cyccnt_end(&probe);
+    }
+    cycOverhead = probe.min;
+}
+
+/*******************************************************************************
+ * Function Name: cyccnt_pm_callback
+ *******************************************************************************
+ *
+ * Summary:
+ *  Masks the SysTick interrupt before Sleep and Deep Sleep, with any pending
+ *  wrap cleared, so it cannot wake the CPU; the spans open meanwhile become
+ *  invalid. Unmasks it on wakeup.
+ *
+ ******************************************************************************/
+static cy_en_syspm_status_t cyccnt_pm_callback(cy_en_syspm_callback_type_t type,
+                                               cy_en_syspm_callback_mode_t mode)
+{
+    (void) type;
+
+    if (mode == CY_SYSPM_BEFORE_TRANSITION)
+    {
+        SysTick->CTRL &= ~SysTick_CTRL_TICKINT_Msk;
+        SCB->ICSR = SCB_ICSR_PENDSTCLR_Msk;
+        cycEpoch++;
+    }
+    else if (mode == CY_SYSPM_AFTER_TRANSITION)
+    {
+        SysTick->CTRL |= SysTick_CTRL_TICKINT_Msk;
+    }
+    else
+    {
+        /* Nothing to do in the other phases */
+    }
+
+    return CY_SYSPM_SUCCESS;
+}
+
+#endif /* CYCCNT_ENABLE */
+
+/* [] END OF FILE */
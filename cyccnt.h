@@ -0,0 +1,133 @@
+/******************************************************************************
+* File Name: cyccnt.h
+*
+* Description: Cycle counter for code timing on the Cortex-M0+, which has no
+*              DWT cycle counter. SysTick, already free running for pm_stats.c,
+*              is extended to 32 bits by counting its wraps, and begin/end
+*              probes keep the count, minimum, maximum and sum of the cycles a
+*              piece of code takes, less the calibrated cost of the probe
+*              itself. The probes compile out unless CYCCNT_ENABLE is set.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef CYCCNT_H
+#define CYCCNT_H
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cy_pdl.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Enables the cycle counter and the probes. Set from the Makefile:
+ * CYCCNT_ENABLE=1. The module then owns SysTick_Handler. */
+#ifndef CYCCNT_ENABLE
+#define CYCCNT_ENABLE           (0U)
+#endif
+
+/* SysTick: 24-bit down counter of CPU cycles */
+#define CYCCNT_SYSTICK_BITS     (24U)
+#define CYCCNT_SYSTICK_MASK     ((1UL << CYCCNT_SYSTICK_BITS) - 1U)
+
+/* Empty begin/end pairs timed by the init hook; the fastest is the probe
+ * overhead */
+#define CYCCNT_CALIBRATE_RUNS   (8U)
+
+/*******************************************************************************
+ * Data types
+ ******************************************************************************/
+/* Probe: cycles of the spans from CYCCNT_BEGIN to CYCCNT_END. A span that
+ * crosses a Sleep or Deep Sleep entry, during which SysTick is masked or
+ * stopped, is counted in invalid only. */
+typedef struct
+{
+    uint32_t start;                     /* cyccnt_now() at CYCCNT_BEGIN */
+    uint32_t epoch;                     /* Power transitions at CYCCNT_BEGIN */
+    uint32_t count;                     /* Spans measured */
+    uint32_t min;                       /* Shortest span, cycles */
+    uint32_t max;                       /* Longest span, cycles */
+    uint64_t sum;                       /* Sum of the spans, cycles */
+    uint32_t invalid;                   /* Spans across a power transition */
+} cyccnt_probe_t;
+
+#define CYCCNT_PROBE_INIT       { .min = UINT32_MAX }
+
+/*******************************************************************************
+ * Macro Name: CYCCNT_PROBE
+ *******************************************************************************
+ *
+ * Summary:
+ *  Defines a static probe, and CYCCNT_BEGIN / CYCCNT_END time the code
+ *  between them with it. Spans must not nest on the same probe, and must be
+ *  shorter than 2^32 cycles (89 s at 48 MHz). Without CYCCNT_ENABLE the
+ *  probe is not defined and the macros expand to nothing.
+ *
+ * Parameters:
+ *  name: Identifier of the probe.
+ *
+ * Example:
+ *  CYCCNT_PROBE(ledProbe);
+ *
+ *  CYCCNT_BEGIN(ledProbe);
+ *  gpio_out_write(&ctx->ledPort, CYBSP_USER_LED_NUM, LED_ON);
+ *  CYCCNT_END(ledProbe);
+ *
+ ******************************************************************************/
+#if CYCCNT_ENABLE
+#define CYCCNT_PROBE(name)      static cyccnt_probe_t name = CYCCNT_PROBE_INIT
+#define CYCCNT_BEGIN(probe)     cyccnt_begin(&(probe))
+#define CYCCNT_END(probe)       cyccnt_end(&(probe))
+#else
+#define CYCCNT_PROBE(name)      extern cyccnt_probe_t name
+#define CYCCNT_BEGIN(probe)     do { } while (0)
+#define CYCCNT_END(probe)       do { } while (0)
+#endif
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+#if CYCCNT_ENABLE
+uint32_t cyccnt_now(void);
+uint32_t cyccnt_overhead(void);
+void cyccnt_begin(cyccnt_probe_t *probe);
+void cyccnt_end(cyccnt_probe_t *probe);
+#endif
+
+#endif /* CYCCNT_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,207 @@
+/******************************************************************************
+* File Name: defer.c
+*
+* Description: Deferred work queue (defer.h). A ring of DEFER_QUEUE_LEN
+*              items with free running head and tail counts. The main loop
+*              is the only consumer and takes items without masking
+*              interrupts. Producers may be interrupt handlers of any
+*              priority; without exclusive access instructions on the
+*              Cortex-M0, a post masks interrupts while it claims and fills
+*              its slot, a dozen instructions. A power management module
+*              reports queued work to pm_enter(), so the CPU never sleeps
+*              on an item posted after the main loop looked.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "defer.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+#define DEFER_QUEUE_MASK        (DEFER_QUEUE_LEN - 1U)
+
+/*******************************************************************************
+ * Data types
+ ******************************************************************************/
+typedef struct
+{
+    defer_fn_t fn;
+    void *arg;
+    uint32_t data;
+} defer_item_t;
+
+/*******************************************************************************
+ * Global variables
+ ******************************************************************************/
+static defer_item_t deferQueue[DEFER_QUEUE_LEN];
+
+/* Items posted and taken, modulo 2^32; written by the producers and by the
+ * main loop respectively */
+static volatile uint32_t deferHead;
+static volatile uint32_t deferTail;
+
+static defer_stats_t deferStats;
+
+PM_MODULE_DEFINE(defer_module, PM_PRIORITY_DEFAULT,
+    .workPending = defer_pending);
+
+/*******************************************************************************
+ * Function Name: defer_post
+ *******************************************************************************
+ *
+ * Summary:
+ *  Queues a work item for the main loop. Callable from interrupt handlers and
+ *  from thread context. The main loop sees the item before it sleeps again.
+ *
+ * Parameters:
+ *  fn: Work function.
+ *  arg: First argument of fn, for example the instance.
+ *  data: Second argument of fn, for example a time stamp.
+ *
+ * Return:
+ *  false if the queue is full: the item is dropped and counted.
+ *
+ ******************************************************************************/
+PM_WAKE_FUNC bool defer_post(defer_fn_t fn, void *arg, uint32_t data)
+{
+    /* The CMSIS intrinsics: inline, so the wake path stays in SRAM */
+    uint32_t savedIntr = __get_PRIMASK();
+    defer_item_t *item;
+    uint32_t head;
+    uint32_t queued;
+    bool posted = false;
+
+    __disable_irq();
+    head = deferHead;
+    queued = head - deferTail;
+    if (queued < DEFER_QUEUE_LEN)
+    {
+        item = &deferQueue[head & DEFER_QUEUE_MASK];
+        item->fn = fn;
+        item->arg = arg;
+        item->data = data;
+        __DMB();
+        deferHead = head + 1U;
+
+        deferStats.posted++;
+        deferStats.highWater = (queued >= deferStats.highWater) ? (queued + 1U) : deferStats.highWater;
+        posted = true;
+    }
+    else
+    {
+        deferStats.full++;
+    }
+    __set_PRIMASK(savedIntr);
+
+    return posted;
+}
+
+/*******************************************************************************
+ * Function Name: defer_run
+ *******************************************************************************
+ *
+ * Summary:
+ *  Runs the queued items in posting order, including those posted while it
+ *  runs. Call it from the main loop only.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+PM_WAKE_FUNC void defer_run(void)
+{
+    defer_item_t item;
+    uint32_t tail = deferTail;
+
+    while (tail != deferHead)
+    {
+        __DMB();
+        item = deferQueue[tail & DEFER_QUEUE_MASK];
+
+        /* Frees the slot before the call, which may post again */
+        tail++;
+        deferTail = tail;
+        deferStats.run++;
+        item.fn(item.arg, item.data);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: defer_pending
+ *******************************************************************************
+ *
+ * Summary:
+ *  Power management module hook: reports queued items. pm_enter() checks it
+ *  with interrupts masked.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  true if an item waits for defer_run().
+ *
+ ******************************************************************************/
+PM_WAKE_FUNC bool defer_pending(void)
+{
+    return deferHead != deferTail;
+}
+
+/*******************************************************************************
+ * Function Name: defer_stats
+ *******************************************************************************
+ *
+ * Summary:
+ *  Returns the queue counters.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  The counters, updated in place.
+ *
+ ******************************************************************************/
+const defer_stats_t *defer_stats(void)
+{
+    return &deferStats;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,92 @@
+/******************************************************************************
+* File Name: defer.h
+*
+* Description: Deferred work queue. Interrupt handlers post a small work item
+*              and return; the main loop runs the items in thread context
+*              before the idle governor picks a power mode.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef DEFER_H
+#define DEFER_H
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cy_pdl.h"
+#include "pm_module.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Queue length, a power of two. Items are posted from interrupts taken while
+ * the main loop is busy, for example during the LED indication, so size it
+ * for the events of the longest main loop iteration. */
+#ifndef DEFER_QUEUE_LEN
+#define DEFER_QUEUE_LEN         (16U)
+#endif
+
+#if ((DEFER_QUEUE_LEN & (DEFER_QUEUE_LEN - 1U)) != 0U) || (DEFER_QUEUE_LEN > 256U)
+#error "DEFER_QUEUE_LEN must be a power of two, at most 256"
+#endif
+
+/*******************************************************************************
+ * Data types
+ ******************************************************************************/
+/* Work function, called from the main loop with the arguments given to
+ * defer_post() */
+typedef void (*defer_fn_t)(void *arg, uint32_t data);
+
+/* Counters */
+typedef struct
+{
+    uint32_t posted;            /* Items posted */
+    uint32_t run;               /* Items run */
+    uint32_t full;              /* Posts refused, queue full */
+    uint32_t highWater;         /* Most items queued at once */
+} defer_stats_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+PM_WAKE_FUNC bool defer_post(defer_fn_t fn, void *arg, uint32_t data);
+PM_WAKE_FUNC void defer_run(void);
+PM_WAKE_FUNC bool defer_pending(void);
+const defer_stats_t *defer_stats(void);
+
+#endif /* DEFER_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,210 @@
+/******************************************************************************
+* File Name: fxstat.c
+*
+* Description: Fixed-point statistics (fxstat.h). The Cortex-M0 has a 32-bit
+*              multiply only and no divide: 64-bit products are built from
+*              16-bit halves, weights are powers of two, and the only
+*              division is in the percentile readout.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "fxstat.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Largest deviation squared in the variance, so the square fits 32 bits */
+#define FXSTAT_EWMA_MAX_DEV     (0xFFFFUL)
+
+/*******************************************************************************
+ * Function Name: fxstat_umul64
+ *******************************************************************************
+ *
+ * Summary:
+ *  32 x 32 to 64 bit multiply from four 16 x 16 bit products, cheaper on the
+ *  Cortex-M0 than the generic 64 x 64 bit library multiply.
+ *
+ * Parameters:
+ *  a: Multiplicand.
+ *  b: Multiplier.
+ *
+ * Return:
+ *  a * b.
+ *
+ ******************************************************************************/
+PM_WAKE_FUNC uint64_t fxstat_umul64(uint32_t a, uint32_t b)
+{
+    uint32_t al = a & 0xFFFFU;
+    uint32_t ah = a >> 16;
+    uint32_t bl = b & 0xFFFFU;
+    uint32_t bh = b >> 16;
+    uint32_t mid = (ah * bl) + (al * bh);
+    uint64_t product = ((uint64_t)(ah * bh) << 32) | (al * bl);
+
+    /* The sum of the middle products may carry into bit 32 */
+    if (mid < (ah * bl))
+    {
+        product += 1ULL << 48;
+    }
+
+    return product + ((uint64_t)mid << 16);
+}
+
+/*******************************************************************************
+ * Function Name: fxstat_charge_add
+ *******************************************************************************
+ *
+ * Summary:
+ *  Integrates a constant current over a number of ticks. The fraction of a
+ *  uA s is carried over to the next call, so no charge is lost to rounding.
+ *
+ * Parameters:
+ *  frac: Fraction of the accumulator, the low word of the sum.
+ *  ticks: Time at the current.
+ *  perTick: Charge per tick, see FXSTAT_CHARGE_PER_TICK.
+ *
+ * Return:
+ *  Whole uA s to add to the accumulator.
+ *
+ ******************************************************************************/
+PM_WAKE_FUNC uint32_t fxstat_charge_add(uint32_t *frac, uint32_t ticks, uint32_t perTick)
+{
+    uint64_t charge = fxstat_umul64(ticks, perTick) + *frac;
+
+    *frac = (uint32_t)charge;
+
+    return (uint32_t)(charge >> FXSTAT_CHARGE_FRAC);
+}
+
+/*******************************************************************************
+ * Function Name: fxstat_ewma_add
+ *******************************************************************************
+ *
+ * Summary:
+ *  Adds a sample to an exponentially weighted mean and variance, weight
+ *  2^-FXSTAT_EWMA_SHIFT. The first sample, while mean is 0, sets the mean.
+ *  Deviations are clamped to FXSTAT_EWMA_MAX_DEV.
+ *
+ * Parameters:
+ *  mean: Mean, FXSTAT_EWMA_FRAC fraction bits.
+ *  var: Variance, no fraction bits.
+ *  sample: New sample, below 2^(32 - FXSTAT_EWMA_FRAC - 1).
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+PM_WAKE_FUNC void fxstat_ewma_add(uint32_t *mean, uint32_t *var, uint32_t sample)
+{
+    int32_t diff = (int32_t)(sample << FXSTAT_EWMA_FRAC) - (int32_t)*mean;
+    uint32_t dev = (uint32_t)((diff < 0) ? -diff : diff) >> FXSTAT_EWMA_FRAC;
+    uint32_t sq;
+
+    if (*mean == 0U)
+    {
+        *mean = sample << FXSTAT_EWMA_FRAC;
+        return;
+    }
+
+    /* mean += w * diff; var = (1 - w) * (var + w * diff^2) */
+    *mean = (uint32_t)((int32_t)*mean + (diff / (1L << FXSTAT_EWMA_SHIFT)));
+    dev = (dev < FXSTAT_EWMA_MAX_DEV) ? dev : FXSTAT_EWMA_MAX_DEV;
+    sq = dev * dev;
+    *var = (*var - (*var >> FXSTAT_EWMA_SHIFT)) + ((sq - (sq >> FXSTAT_EWMA_SHIFT)) >> FXSTAT_EWMA_SHIFT);
+}
+
+/*******************************************************************************
+ * Function Name: fxstat_hist_quantile
+ *******************************************************************************
+ *
+ * Summary:
+ *  Estimates a quantile of a log2 histogram (see PM_STATS_HIST_SHIFT),
+ *  interpolating linearly inside the bin. For the open last bin the lower
+ *  bound is returned.
+ *
+ * Parameters:
+ *  hist: Bin counts.
+ *  bins: Number of bins, at least 2.
+ *  shift: Bin 0 counts values below 2^shift.
+ *  q16: Quantile, 16 fraction bits (FXSTAT_Q16).
+ *
+ * Return:
+ *  The quantile, 0 for an empty histogram.
+ *
+ ******************************************************************************/
+uint32_t fxstat_hist_quantile(const uint16_t *hist, uint32_t bins, uint32_t shift, uint32_t q16)
+{
+    uint32_t total = 0U;
+    uint32_t below = 0U;
+    uint32_t rank;
+    uint32_t lo;
+    uint32_t hi;
+    uint32_t frac16;
+    uint32_t bin;
+
+    for (bin = 0U; bin < bins; bin++)
+    {
+        total += hist[bin];
+    }
+    if (total == 0U)
+    {
+        return 0U;
+    }
+
+    rank = (uint32_t)(fxstat_umul64(total, q16) >> 16);
+    rank = (rank < total) ? rank : (total - 1U);
+    for (bin = 0U; (below + hist[bin]) <= rank; bin++)
+    {
+        below += hist[bin];
+    }
+
+    lo = (bin == 0U) ? 0U : (1UL << (shift + bin - 1U));
+    if (bin == (bins - 1U))
+    {
+        return lo;
+    }
+    hi = 1UL << (shift + bin);
+
+    /* Position inside the bin, at the middle of the rank's share */
+    frac16 = ((((rank - below) << 1) + 1U) << 15) / hist[bin];
+
+    return lo + (uint32_t)(fxstat_umul64(hi - lo, frac16) >> 16);
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,86 @@
+/******************************************************************************
+* File Name: fxstat.h
+*
+* Description: Fixed-point statistics for the power statistics: charge
+*              accumulation, exponentially weighted mean and variance, and
+*              percentiles of a log2 histogram. Integer arithmetic only, so
+*              no soft-float routines are linked on the Cortex-M0, and every
+*              update takes a fixed number of cycles.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef FXSTAT_H
+#define FXSTAT_H
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cy_pdl.h"
+#include "pm_module.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Fraction bits of the charge accumulators: the fraction is a whole word */
+#define FXSTAT_CHARGE_FRAC      (32U)
+
+/* Charge of one tick of a clock at a current, in uA s with
+ * FXSTAT_CHARGE_FRAC fraction bits, rounded. A constant expression, for
+ * currents up to 4 A. At a 40 kHz tick the error is below 1e-7 for currents
+ * from 100 uA. */
+#define FXSTAT_CHARGE_PER_TICK(currentNa, tickHz) \
+    ((uint32_t)((((uint64_t)(currentNa) << FXSTAT_CHARGE_FRAC) + (500ULL * (uint64_t)(tickHz))) / \
+                (1000ULL * (uint64_t)(tickHz))))
+
+/* Exponentially weighted statistics: weight 2^-FXSTAT_EWMA_SHIFT of a new
+ * sample, mean with FXSTAT_EWMA_FRAC fraction bits */
+#define FXSTAT_EWMA_SHIFT       (4U)
+#define FXSTAT_EWMA_FRAC        (4U)
+
+/* Quantiles are given with 16 fraction bits, for example p99 = 64881 */
+#define FXSTAT_Q16(permille)    ((uint32_t)(((uint32_t)(permille) * 65536UL) / 1000UL))
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+PM_WAKE_FUNC uint64_t fxstat_umul64(uint32_t a, uint32_t b);
+PM_WAKE_FUNC uint32_t fxstat_charge_add(uint32_t *frac, uint32_t ticks, uint32_t perTick);
+PM_WAKE_FUNC void fxstat_ewma_add(uint32_t *mean, uint32_t *var, uint32_t sample);
+uint32_t fxstat_hist_quantile(const uint16_t *hist, uint32_t bins, uint32_t shift, uint32_t q16);
+
+#endif /* FXSTAT_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,159 @@
+/******************************************************************************
+* File Name: gpio_out.h
+*
+* Description: Shadowed GPIO output layer. Keeps a RAM copy of the output
+*              data register of each port it drives, so writes that do not
+*              change the pin state are dropped and several pins of one port
+*              are updated with a single register write.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef GPIO_OUT_H
+#define GPIO_OUT_H
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cy_pdl.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Count the data register writes issued and dropped, per port */
+#ifndef GPIO_OUT_STATS
+#define GPIO_OUT_STATS          (0U)
+#endif
+
+/*******************************************************************************
+ * Data types
+ ******************************************************************************/
+/* Output port driven through the shadow layer. All output pins of the port
+ * must be written through it from thread context only, otherwise the shadow
+ * goes stale. */
+typedef struct
+{
+    GPIO_PRT_Type *base;        /* Port registers */
+    uint32_t shadow;            /* Last value written to the DR register */
+#if GPIO_OUT_STATS
+    uint32_t writes;            /* DR writes issued */
+    uint32_t dropped;           /* Writes dropped because nothing changed */
+#endif
+} gpio_out_port_t;
+
+/*******************************************************************************
+ * Function Name: gpio_out_init
+ *******************************************************************************
+ *
+ * Summary:
+ *  Attaches a shadow to a port, loading it from the current register value.
+ *  Call it after the pins are configured (cybsp_init).
+ *
+ * Parameters:
+ *  port: Shadow port object.
+ *  base: Port registers, for example CYBSP_USER_LED_PORT.
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+__STATIC_INLINE void gpio_out_init(gpio_out_port_t *port, GPIO_PRT_Type *base)
+{
+    port->base = base;
+    port->shadow = GPIO_PRT_DR(base);
+#if GPIO_OUT_STATS
+    port->writes = 0U;
+    port->dropped = 0U;
+#endif
+}
+
+/*******************************************************************************
+ * Function Name: gpio_out_update
+ *******************************************************************************
+ *
+ * Summary:
+ *  Sets the pins selected by mask to the matching bits of value, with one
+ *  register write, or none if the pins already have that state.
+ *
+ * Parameters:
+ *  port: Shadow port object.
+ *  mask: Pins to update, bit n for pin n.
+ *  value: New pin values, bit n for pin n.
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+__STATIC_INLINE void gpio_out_update(gpio_out_port_t *port, uint32_t mask, uint32_t value)
+{
+    uint32_t dr = (port->shadow & ~mask) | (value & mask);
+    bool changed = (dr != port->shadow);
+
+    if (changed)
+    {
+        port->shadow = dr;
+        GPIO_PRT_DR(port->base) = dr;
+    }
+
+#if GPIO_OUT_STATS
+    port->writes += changed ? 1U : 0U;
+    port->dropped += changed ? 0U : 1U;
+#endif
+}
+
+/*******************************************************************************
+ * Function Name: gpio_out_write
+ *******************************************************************************
+ *
+ * Summary:
+ *  Drop-in replacement for Cy_GPIO_Write on a shadowed port.
+ *
+ * Parameters:
+ *  port: Shadow port object.
+ *  pinNum: Pin number within the port.
+ *  value: Output value, 0 or 1.
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+__STATIC_INLINE void gpio_out_write(gpio_out_port_t *port, uint32_t pinNum, uint32_t value)
+{
+    gpio_out_update(port, 1UL << pinNum, (value & 1UL) << pinNum);
+}
+
+#endif /* GPIO_OUT_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,402 @@
+/******************************************************************************
+* File Name: elfsym.c
+*
+* Description: Function symbols of an ELF file (elfsym.h). Only the section
+*              headers and the symbol table are read; no debug information
+*              is needed.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "elfsym.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+#define ELF_CLASS_32            (1U)
+#define ELF_CLASS_64            (2U)
+#define ELF_DATA_LE             (1U)
+#define ELF_MACHINE_ARM         (40U)
+#define ELF_SHT_SYMTAB          (2U)
+#define ELF_STT_FUNC            (2U)
+
+/*******************************************************************************
+ * Function Name: get
+ *******************************************************************************
+ *
+ * Summary:
+ *  Reads a little endian field of 1 - 8 bytes.
+ *
+ ******************************************************************************/
+static uint64_t get(const uint8_t *p, size_t size)
+{
+    uint64_t value = 0U;
+
+    while (size-- > 0U)
+    {
+        value = (value << 8) | p[size];
+    }
+
+    return value;
+}
+
+static int elfsym_compare(const void *a, const void *b)
+{
+    const elfsym_t *x = a;
+    const elfsym_t *y = b;
+
+    return (x->addr > y->addr) - (x->addr < y->addr);
+}
+
+static int elfsym_flat_compare(const void *a, const void *b)
+{
+    const elfsym_flat_t *x = a;
+    const elfsym_flat_t *y = b;
+
+    return (x->count < y->count) - (x->count > y->count);
+}
+
+/*******************************************************************************
+ * Function Name: elfsym_load
+ *******************************************************************************
+ *
+ * Summary:
+ *  Reads the function symbols of an ELF file. The Thumb bit of ARM function
+ *  addresses is cleared.
+ *
+ * Parameters:
+ *  table: Returns the symbols; free with elfsym_free().
+ *  path: ELF file.
+ *
+ * Return:
+ *  false if the file cannot be read or is not a little endian ELF file.
+ *
+ ******************************************************************************/
+bool elfsym_load(elfsym_table_t *table, const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    long size;
+    const uint8_t *img;
+    const uint8_t *sh;
+    const uint8_t *sym;
+    bool is64;
+    bool thumb;
+    uint64_t shoff;
+    uint64_t off;
+    uint64_t symSize;
+    uint64_t strOff;
+    uint64_t strSize;
+    uint64_t name;
+    size_t shentsize;
+    size_t shnum;
+    size_t entsize;
+    size_t i;
+    size_t j;
+
+    memset(table, 0, sizeof(*table));
+    if ((f == NULL) || (fseek(f, 0, SEEK_END) != 0) || ((size = ftell(f)) < 64))
+    {
+        if (f != NULL)
+        {
+            (void) fclose(f);
+        }
+        return false;
+    }
+    rewind(f);
+    table->image = malloc((size_t)size);
+    if ((table->image == NULL) || (fread(table->image, 1U, (size_t)size, f) != (size_t)size))
+    {
+        (void) fclose(f);
+        elfsym_free(table);
+        return false;
+    }
+    (void) fclose(f);
+    table->imageSize = (size_t)size;
+
+    img = table->image;
+    if ((memcmp(img, "\177ELF", 4U) != 0) || (img[5] != ELF_DATA_LE) ||
+        ((img[4] != ELF_CLASS_32) && (img[4] != ELF_CLASS_64)))
+    {
+        elfsym_free(table);
+        return false;
+    }
+    is64 = (img[4] == ELF_CLASS_64);
+    thumb = (get(&img[18], 2U) == ELF_MACHINE_ARM);
+    shoff = is64 ? get(&img[40], 8U) : get(&img[32], 4U);
+    shentsize = (size_t)get(&img[is64 ? 58 : 46], 2U);
+    shnum = (size_t)get(&img[is64 ? 60 : 48], 2U);
+    if ((shoff + ((uint64_t)shentsize * shnum)) > (uint64_t)size)
+    {
+        elfsym_free(table);
+        return false;
+    }
+
+    for (i = 0U; i < shnum; i++)
+    {
+        sh = &img[shoff + (i * shentsize)];
+        if (get(&sh[4], 4U) != ELF_SHT_SYMTAB)
+        {
+            continue;
+        }
+
+        /* Symbol table and its string table (sh_link) */
+        off = is64 ? get(&sh[24], 8U) : get(&sh[16], 4U);
+        symSize = is64 ? get(&sh[32], 8U) : get(&sh[20], 4U);
+        entsize = is64 ? 24U : 16U;
+        j = (size_t)get(&sh[is64 ? 40 : 24], 4U);
+        if ((j >= shnum) || ((off + symSize) > (uint64_t)size))
+        {
+            continue;
+        }
+        sh = &img[shoff + (j * shentsize)];
+        strOff = is64 ? get(&sh[24], 8U) : get(&sh[16], 4U);
+        strSize = is64 ? get(&sh[32], 8U) : get(&sh[20], 4U);
+        if ((strOff + strSize) > (uint64_t)size)
+        {
+            continue;
+        }
+
+        table->syms = realloc(table->syms, (table->count + (size_t)(symSize / entsize)) * sizeof(elfsym_t));
+        if (table->syms == NULL)
+        {
+            elfsym_free(table);
+            return false;
+        }
+        for (j = 0U; j < (size_t)(symSize / entsize); j++)
+        {
+            sym = &img[off + (j * entsize)];
+            name = get(sym, 4U);
+            /* Defined functions only (st_shndx is not SHN_UNDEF) */
+            if (((sym[is64 ? 4 : 12] & 0x0FU) != ELF_STT_FUNC) || (get(&sym[is64 ? 6 : 14], 2U) == 0U) ||
+                (name >= strSize))
+            {
+                continue;
+            }
+            table->syms[table->count].addr = is64 ? get(&sym[8], 8U) : get(&sym[4], 4U);
+            table->syms[table->count].size = is64 ? get(&sym[16], 8U) : get(&sym[8], 4U);
+            table->syms[table->count].name = (const char *)&img[strOff + name];
+            if (thumb)
+            {
+                table->syms[table->count].addr &= ~(uint64_t)1U;
+            }
+            table->count++;
+        }
+    }
+
+    qsort(table->syms, table->count, sizeof(elfsym_t), elfsym_compare);
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: elfsym_lookup
+ *******************************************************************************
+ *
+ * Summary:
+ *  Finds the function holding an address. A symbol without a size holds
+ *  the addresses up to the next symbol.
+ *
+ * Parameters:
+ *  table: Symbols.
+ *  addr: Code address.
+ *
+ * Return:
+ *  The symbol, NULL if no function holds the address.
+ *
+ ******************************************************************************/
+const elfsym_t *elfsym_lookup(const elfsym_table_t *table, uint64_t addr)
+{
+    size_t lo = 0U;
+    size_t hi = table->count;
+    size_t mid;
+    const elfsym_t *sym;
+
+    /* Last symbol at or below addr */
+    while (lo < hi)
+    {
+        mid = (lo + hi) / 2U;
+        if (table->syms[mid].addr <= addr)
+        {
+            lo = mid + 1U;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    if (lo == 0U)
+    {
+        return NULL;
+    }
+
+    sym = &table->syms[lo - 1U];
+    return ((sym->size == 0U) || (addr < (sym->addr + sym->size))) ? sym : NULL;
+}
+
+/*******************************************************************************
+ * Function Name: elfsym_flat
+ *******************************************************************************
+ *
+ * Summary:
+ *  Sums counts per function and sorts the functions by count, largest first.
+ *  Addresses in no function are summed as "?".
+ *
+ * Parameters:
+ *  table: Symbols.
+ *  pcs: Addresses.
+ *  counts: Count of each address.
+ *  n: Number of addresses.
+ *  flat: Returns the profile, n entries at most.
+ *
+ * Return:
+ *  Number of entries in flat.
+ *
+ ******************************************************************************/
+size_t elfsym_flat(const elfsym_table_t *table, const uint64_t *pcs, const double *counts, size_t n,
+                   elfsym_flat_t *flat)
+{
+    const elfsym_t *sym;
+    const char *name;
+    size_t entries = 0U;
+    size_t i;
+    size_t j;
+
+    for (i = 0U; i < n; i++)
+    {
+        sym = elfsym_lookup(table, pcs[i]);
+        name = (sym != NULL) ? sym->name : "?";
+        for (j = 0U; (j < entries) && (strcmp(flat[j].name, name) != 0); j++)
+        {
+        }
+        if (j == entries)
+        {
+            flat[entries].name = name;
+            flat[entries].count = 0.0;
+            entries++;
+        }
+        flat[j].count += counts[i];
+    }
+
+    qsort(flat, entries, sizeof(elfsym_flat_t), elfsym_flat_compare);
+    return entries;
+}
+
+/*******************************************************************************
+ * Function Name: elfsym_section
+ *******************************************************************************
+ *
+ * Summary:
+ *  Finds a section of the ELF file loaded by elfsym_load() by name.
+ *
+ * Parameters:
+ *  table: Symbols, holding the file.
+ *  name: Section name.
+ *  addr: Returns the section address.
+ *  size: Returns the section size.
+ *
+ * Return:
+ *  false if the file has no such section.
+ *
+ ******************************************************************************/
+bool elfsym_section(const elfsym_table_t *table, const char *name, uint64_t *addr, uint64_t *size)
+{
+    const uint8_t *img = table->image;
+    const uint8_t *sh;
+    bool is64;
+    uint64_t shoff;
+    uint64_t strOff;
+    uint64_t shName;
+    size_t shentsize;
+    size_t shnum;
+    size_t shstrndx;
+    size_t i;
+
+    if (img == NULL)
+    {
+        return false;
+    }
+    is64 = (img[4] == ELF_CLASS_64);
+    shoff = is64 ? get(&img[40], 8U) : get(&img[32], 4U);
+    shentsize = (size_t)get(&img[is64 ? 58 : 46], 2U);
+    shnum = (size_t)get(&img[is64 ? 60 : 48], 2U);
+    shstrndx = (size_t)get(&img[is64 ? 62 : 50], 2U);
+    if (shstrndx >= shnum)
+    {
+        return false;
+    }
+    sh = &img[shoff + (shstrndx * shentsize)];
+    strOff = is64 ? get(&sh[24], 8U) : get(&sh[16], 4U);
+
+    /* elfsym_load() checked the section headers, not the names */
+    for (i = 0U; i < shnum; i++)
+    {
+        sh = &img[shoff + (i * shentsize)];
+        shName = get(sh, 4U);
+        if ((strOff + shName + strlen(name) + 1U) > table->imageSize)
+        {
+            continue;
+        }
+        if (memcmp(&img[strOff + shName], name, strlen(name) + 1U) == 0)
+        {
+            *addr = is64 ? get(&sh[16], 8U) : get(&sh[12], 4U);
+            *size = is64 ? get(&sh[32], 8U) : get(&sh[20], 4U);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*******************************************************************************
+ * Function Name: elfsym_free
+ *******************************************************************************
+ *
+ * Summary:
+ *  Frees the symbols of elfsym_load().
+ *
+ ******************************************************************************/
+void elfsym_free(elfsym_table_t *table)
+{
+    free(table->syms);
+    free(table->image);
+    memset(table, 0, sizeof(*table));
+}
+
+/* [] END OF FILE */
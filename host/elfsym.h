@@ -0,0 +1,91 @@
+/******************************************************************************
+* File Name: elfsym.h
+*
+* Description: Function symbols of an ELF file, for the flat profile of the
+*              PC samples (prof.c). Reads 32-bit firmware and 64-bit host
+*              files, little endian.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef ELFSYM_H
+#define ELFSYM_H
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/*******************************************************************************
+ * Data types
+ ******************************************************************************/
+typedef struct
+{
+    uint64_t addr;
+    uint64_t size;
+    const char *name;
+} elfsym_t;
+
+/* Function symbols sorted by address */
+typedef struct
+{
+    elfsym_t *syms;
+    size_t count;
+    uint8_t *image;                     /* File contents, holds the names */
+    size_t imageSize;                   /* Bytes in image */
+} elfsym_table_t;
+
+/* Flat profile entry: counts per function */
+typedef struct
+{
+    const char *name;
+    double count;
+} elfsym_flat_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+bool elfsym_load(elfsym_table_t *table, const char *path);
+const elfsym_t *elfsym_lookup(const elfsym_table_t *table, uint64_t addr);
+size_t elfsym_flat(const elfsym_table_t *table, const uint64_t *pcs, const double *counts, size_t n,
+                   elfsym_flat_t *flat);
+bool elfsym_section(const elfsym_table_t *table, const char *name, uint64_t *addr, uint64_t *size);
+void elfsym_free(elfsym_table_t *table);
+
+#endif /* ELFSYM_H */
+
+/* [] END OF FILE */
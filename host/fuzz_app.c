@@ -0,0 +1,541 @@
+/******************************************************************************
+* File Name: fuzz_app.c
+*
+* Description: Property-based fuzz target of the power state machine, in the
+*              libFuzzer format (LLVMFuzzerTestOneInput). The input is decoded
+*              into a timed sequence of button edges, contact bounce, edges
+*              landed between any two steps of the firmware code, CHECK_READY
+*              refusals, USB-PD activity and software timers, which drives
+*              the application core (app.c) and the power management modules
+*              on the host simulator. Invariants, checked with abort():
+*              - no lost events: every button edge is served by the switch
+*                interrupt, and every software timer expires on time;
+*              - no sleep with pending work: the CPU never sleeps while a
+*                switch press waits in the deferred work queue or for the
+*                main loop;
+*              - bounded latency: the main loop sees every counted press
+*                within one LED indication, and the watchdog never resets.
+*              fuzz_signature records the states in which the events landed,
+*              for the corpus builder of fuzz_main.c.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+#include "cybsp.h"
+#include "pm_module.h"
+#include "app.h"
+#include "defer.h"
+#include "pd_gate.h"
+#include "wdt_svc.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Input: one configuration byte, then two bytes per operation */
+#define FUZZ_OP_WAIT            (0U)    /* Time passes: (arg + 1) x 4 ms */
+#define FUZZ_OP_PRESS           (1U)    /* One falling edge */
+#define FUZZ_OP_BOUNCE          (2U)    /* Edges 1 - 4 ms apart */
+#define FUZZ_OP_PREEMPT         (3U)    /* Edge after arg + 1 code steps */
+#define FUZZ_OP_REFUSE          (4U)    /* Next CHECK_READYs fail */
+#define FUZZ_OP_PD              (5U)    /* USB-PD activity for (arg + 1) x 2 ms */
+#define FUZZ_OP_TIMER           (6U)    /* One-shot timer of (arg + 1) x 2 ms */
+#define FUZZ_OP_IDLE            (7U)    /* Time passes: (arg + 1) x 100 ms */
+#define FUZZ_OP_COUNT           (8U)
+#define FUZZ_MAX_OPS            (256U)
+
+#define FUZZ_BLINK_MS           (50U)
+#define FUZZ_SETTLE_MS          (2000U) /* After the last operation */
+#define FUZZ_END_EDGES          (8U)    /* Edges to bring the main loop out */
+#define FUZZ_BOUNCE_QUEUED      (8U)    /* Bounce edges in the event queue */
+
+/* A counted press is seen by the main loop within the longest LED
+ * indication (three blinks) */
+#define FUZZ_LATENCY_MS         ((6U * FUZZ_BLINK_MS) + 20U)
+#define FUZZ_TIMER_LATE_MS      (10U)
+
+/* Software timer of the fuzzer; the application does not use its timers */
+#define FUZZ_TIMER_ID           (WDT_SVC_TIMER_STATS - 1U)
+
+/* Where the firmware was when an event landed, see fuzz_signature */
+#define FUZZ_PHASE_MAIN         (0U)
+#define FUZZ_PHASE_CHECK_READY  (1U)
+#define FUZZ_PHASE_CHECK_FAIL   (2U)
+#define FUZZ_PHASE_BEFORE       (3U)
+#define FUZZ_PHASE_SLEEP        (4U)
+#define FUZZ_PHASE_AFTER        (5U)
+
+#define FUZZ_KIND_EDGE          (0U)
+#define FUZZ_KIND_PREEMPT       (1U)
+#define FUZZ_KIND_COUNTED       (2U)
+#define FUZZ_KIND_REFUSED       (3U)
+#define FUZZ_KIND_NO_SLEEP      (4U)
+#define FUZZ_KIND_TIMER         (5U)
+#define FUZZ_KIND_LATENCY       (6U)
+
+#define FUZZ_SKIP_ALL           (CY_SYSPM_SKIP_CHECK_READY | CY_SYSPM_SKIP_CHECK_FAIL | \
+                                 CY_SYSPM_SKIP_BEFORE_TRANSITION | CY_SYSPM_SKIP_AFTER_TRANSITION)
+
+/*******************************************************************************
+ * Global variables
+ ******************************************************************************/
+uint8_t fuzz_signature[FUZZ_SIGNATURE_BYTES];
+
+static app_ctx_t app = { .pmSkip = FUZZ_SKIP_ALL };
+
+/* Input */
+static const uint8_t *ops;
+static size_t opCount;
+static size_t opIndex;
+static uint64_t cursorMs;
+
+/* Injected conditions */
+static uint32_t preemptSteps;
+static uint32_t refusals;
+static uint32_t bounceQueued;
+static bool pdActive;
+static uint64_t pdEndMs;
+
+/* Checks */
+static uint32_t phase;
+static bool slept;
+static uint32_t edges;
+static uint32_t served;
+static bool pressPending;
+static uint32_t counted;
+static uint64_t pressCycles;
+static bool timerPending;
+static uint64_t timerDueMs;
+static bool ending;
+static uint32_t endEdges;
+
+static void fuzz_fail(const char *what)
+{
+    fprintf(stderr, "fuzz: %s at %.3f ms\n", what, (double)sim.cycles * 1000.0 / sim.hfclkHz);
+    abort();
+}
+
+/* Records the state an event landed in */
+static void fuzz_mark(uint32_t kind, uint32_t detail)
+{
+    /* Presses taken so far, counted or still queued for the main loop */
+    uint32_t count = (uint32_t)app.switchPressCount + (defer_stats()->posted - defer_stats()->run);
+    uint32_t bit = (((kind * 8U) + (phase & 7U)) * 8U) + ((detail != 0U) ? (detail & 7U) : ((count < 7U) ? count : 7U));
+
+    bit %= (FUZZ_SIGNATURE_BYTES * 8U);
+    fuzz_signature[bit / 8U] |= (uint8_t)(1U << (bit % 8U));
+}
+
+/* One falling edge on the button pin. Edges while the interrupt is still
+ * pending merge into it. */
+static void fuzz_edge(void)
+{
+    if (!sim.pending[CYBSP_USER_BTN_IRQ])
+    {
+        edges++;
+    }
+    CYBSP_USER_BTN_PORT->PS &= ~(1UL << CYBSP_USER_BTN_NUM);
+    sim_raise_irq(CYBSP_USER_BTN_IRQ);
+}
+
+/* The press is counted by the main loop, from the deferred work queue: the
+ * latency runs from the first edge it has not looked at */
+static void fuzz_isr(void)
+{
+    served++;
+    app_switch_isr(&app);
+    if (!pressPending)
+    {
+        pressPending = true;
+        pressCycles = sim.cycles;
+        fuzz_mark(FUZZ_KIND_COUNTED, 0U);
+    }
+}
+
+/* The main loop looked at the press count */
+static void fuzz_observe(void)
+{
+    uint32_t ms;
+    uint32_t bucket = 1U;
+
+    if (app.presses != counted)
+    {
+        counted = app.presses;
+        ms = (uint32_t)(((sim.cycles - pressCycles) * 1000U) / sim.hfclkHz);
+        if (ms > FUZZ_LATENCY_MS)
+        {
+            fuzz_fail("press latency over bound");
+        }
+        while ((bucket < 7U) && ((ms >> bucket) != 0U))
+        {
+            bucket++;
+        }
+        fuzz_mark(FUZZ_KIND_LATENCY, bucket);
+        pressPending = false;
+    }
+
+    /* Edges taken from the queue and not counted were within the debounce
+     * window */
+    if (!defer_pending())
+    {
+        pressPending = false;
+    }
+}
+
+/* Edge landed in the middle of the firmware code */
+static void fuzz_preempt(void)
+{
+    if ((preemptSteps != 0U) && (--preemptSteps == 0U))
+    {
+        fuzz_mark(FUZZ_KIND_PREEMPT, 0U);
+        fuzz_edge();
+        sim_dispatch_irqs();
+    }
+}
+
+static void fuzz_sleep_entry(void)
+{
+    slept = true;
+    phase = FUZZ_PHASE_SLEEP;
+    if (app_work_pending(&app) || defer_pending())
+    {
+        fuzz_fail("sleep with a press pending");
+    }
+
+    /* Edges not counted by now were within the debounce window */
+    pressPending = false;
+}
+
+static void fuzz_timer(void)
+{
+    if (!timerPending)
+    {
+        fuzz_fail("timer expired while stopped");
+    }
+    if (sim_now_ms() > (timerDueMs + FUZZ_TIMER_LATE_MS))
+    {
+        fuzz_fail("timer expired late");
+    }
+    timerPending = false;
+    fuzz_mark(FUZZ_KIND_TIMER, 0U);
+}
+
+/* End of FUZZ_OP_PD activity, moved on while the activity is extended */
+static void fuzz_pd_end(void)
+{
+    if (sim_now_ms() < pdEndMs)
+    {
+        sim_schedule(sim_ms_to_cycles(pdEndMs), fuzz_pd_end);
+    }
+    else
+    {
+        pd_gate_clear(PD_GATE_CC);
+        pdActive = false;
+    }
+}
+
+/* Bounce edge of FUZZ_OP_BOUNCE */
+static void fuzz_bounce(void)
+{
+    bounceQueued--;
+    fuzz_mark(FUZZ_KIND_EDGE, 0U);
+    fuzz_edge();
+}
+
+/* After the input: edges until the main loop comes out of its sleep loop */
+static void fuzz_end(void)
+{
+    if (++endEdges > FUZZ_END_EDGES)
+    {
+        fuzz_fail("main loop does not return");
+    }
+    ending = true;
+    fuzz_edge();
+    sim_schedule(sim_ms_to_cycles(sim_now_ms() + 1000U), fuzz_end);
+}
+
+/*******************************************************************************
+ * Function Name: fuzz_next
+ *******************************************************************************
+ *
+ * Summary:
+ *  Runs the operations of the input due now, then schedules itself at the
+ *  time of the next one, or the end of the run after the last one.
+ *
+ ******************************************************************************/
+static void fuzz_next(void)
+{
+    uint32_t op;
+    uint32_t arg;
+    uint32_t i;
+
+    while (opIndex < opCount)
+    {
+        op = ops[2U * opIndex] % FUZZ_OP_COUNT;
+        arg = ops[(2U * opIndex) + 1U];
+        opIndex++;
+
+        switch (op)
+        {
+            case FUZZ_OP_WAIT:
+            case FUZZ_OP_IDLE:
+                cursorMs += (uint64_t)(arg + 1U) * ((op == FUZZ_OP_WAIT) ? 4U : 100U);
+                sim_schedule(sim_ms_to_cycles(cursorMs), fuzz_next);
+                return;
+
+            case FUZZ_OP_PRESS:
+                fuzz_mark(FUZZ_KIND_EDGE, 0U);
+                fuzz_edge();
+                break;
+
+            case FUZZ_OP_BOUNCE:
+                for (i = 0U; (i <= (arg & 3U)) && (bounceQueued < FUZZ_BOUNCE_QUEUED); i++)
+                {
+                    bounceQueued++;
+                    sim_schedule(sim_ms_to_cycles(cursorMs + (i * (((arg >> 2) & 3U) + 1U))), fuzz_bounce);
+                }
+                break;
+
+            case FUZZ_OP_PREEMPT:
+                preemptSteps = arg + 1U;
+                break;
+
+            case FUZZ_OP_REFUSE:
+                refusals = (arg % 3U) + 1U;
+                break;
+
+            case FUZZ_OP_PD:
+                pdEndMs = cursorMs + ((uint64_t)(arg + 1U) * 2U);
+                if (!pdActive)
+                {
+                    pd_gate_set(PD_GATE_CC);
+                    pdActive = true;
+                    sim_schedule(sim_ms_to_cycles(pdEndMs), fuzz_pd_end);
+                }
+                break;
+
+            default:
+                timerPending = true;
+                timerDueMs = cursorMs + ((uint64_t)(arg + 1U) * 2U);
+                wdt_svc_timer_start(FUZZ_TIMER_ID, WDT_SVC_MS_TO_TICKS((arg + 1U) * 2U), false, fuzz_timer);
+                break;
+        }
+    }
+
+    sim_schedule(sim_ms_to_cycles(cursorMs + FUZZ_SETTLE_MS), fuzz_end);
+}
+
+/* Application callbacks, as main.c */
+static cy_en_syspm_status_t fuzz_app_callback(cy_en_syspm_callback_type_t type,
+                                              cy_en_syspm_callback_mode_t mode)
+{
+    return app_pm_event(&app, type, mode);
+}
+
+static bool fuzz_app_work_pending(void)
+{
+    return app_work_pending(&app);
+}
+
+static const cy_stc_sysint_t fuzz_switch_intr = { CYBSP_USER_BTN_IRQ, 3U };
+
+PM_MODULE_DEFINE(fuzz_app_module, PM_PRIORITY_DEFAULT,
+    .callback = fuzz_app_callback,
+    .types    = PM_TYPE_ALL,
+    .skipMode = &app.pmSkip,
+    .wakeIntr = &fuzz_switch_intr,
+    .wakeIsr  = fuzz_isr,
+    .workPending = fuzz_app_work_pending);
+
+/* First module on the way down: tracks the phase */
+static cy_en_syspm_status_t fuzz_probe_callback(cy_en_syspm_callback_type_t type,
+                                                cy_en_syspm_callback_mode_t mode)
+{
+    (void) type;
+    if (mode == CY_SYSPM_CHECK_READY)
+    {
+        phase = FUZZ_PHASE_CHECK_READY;
+    }
+    else if (mode == CY_SYSPM_BEFORE_TRANSITION)
+    {
+        phase = FUZZ_PHASE_BEFORE;
+        slept = false;
+    }
+
+    return CY_SYSPM_SUCCESS;
+}
+
+PM_MODULE_DEFINE(fuzz_probe_module, PM_PRIORITY_HIGH,
+    .callback = fuzz_probe_callback,
+    .types    = PM_TYPE_ALL);
+
+/* Last module on the way down: refuses CHECK_READY on request, so every
+ * other module sees CHECK_FAIL */
+static cy_en_syspm_status_t fuzz_fault_callback(cy_en_syspm_callback_type_t type,
+                                                cy_en_syspm_callback_mode_t mode)
+{
+    cy_en_syspm_status_t ret = CY_SYSPM_SUCCESS;
+
+    (void) type;
+    if ((mode == CY_SYSPM_CHECK_READY) && (refusals != 0U))
+    {
+        refusals--;
+        fuzz_mark(FUZZ_KIND_REFUSED, 0U);
+        phase = FUZZ_PHASE_CHECK_FAIL;
+        ret = CY_SYSPM_FAIL;
+    }
+    else if (mode == CY_SYSPM_AFTER_TRANSITION)
+    {
+        if (!slept)
+        {
+            fuzz_mark(FUZZ_KIND_NO_SLEEP, 0U);
+        }
+        phase = FUZZ_PHASE_AFTER;
+    }
+
+    return ret;
+}
+
+PM_MODULE_DEFINE(fuzz_fault_module, PM_PRIORITY_LOW,
+    .callback = fuzz_fault_callback,
+    .types    = PM_TYPE_ALL);
+
+/*******************************************************************************
+ * Function Name: LLVMFuzzerTestOneInput
+ *******************************************************************************
+ *
+ * Summary:
+ *  Runs one input. The first byte selects the configuration: bit 0 a 10 ms
+ *  debounce window, bit 1 two presses instead of one for Sleep.
+ *
+ * Parameters:
+ *  data: Input.
+ *  size: Input length.
+ *
+ * Return:
+ *  0; invariant violations abort.
+ *
+ ******************************************************************************/
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    app_config_t config = APP_CONFIG_DEFAULT;
+    uint32_t wakeups;
+
+    if (size < 1U)
+    {
+        return 0;
+    }
+
+    memset(fuzz_signature, 0, sizeof(fuzz_signature));
+    ops = &data[1];
+    opCount = (size - 1U) / 2U;
+    opCount = (opCount < FUZZ_MAX_OPS) ? opCount : FUZZ_MAX_OPS;
+    opIndex = 0U;
+    cursorMs = 0U;
+    preemptSteps = 0U;
+    refusals = 0U;
+    bounceQueued = 0U;
+    pdActive = false;
+    phase = FUZZ_PHASE_MAIN;
+    slept = false;
+    edges = 0U;
+    served = 0U;
+    pressPending = false;
+    counted = 0U;
+    timerPending = false;
+    ending = false;
+    endEdges = 0U;
+
+    config.blinkTimeMs = FUZZ_BLINK_MS;
+    config.debounceMs = ((data[0] & 1U) != 0U) ? 10U : 0U;
+    config.sleepPress = ((data[0] & 2U) != 0U) ? 2 : 1;
+
+    sim_reset();
+    (void) cybsp_init();
+    app_init(&app, &config, &fuzz_app_module);
+    (void) pm_init();
+    sim.preempt = fuzz_preempt;
+    sim.sleepEntry = fuzz_sleep_entry;
+    __enable_irq();
+    sim_schedule(0U, fuzz_next);
+
+    /* The main loop of main.c */
+    while (!ending)
+    {
+        wakeups = sim.wakeups;
+        phase = FUZZ_PHASE_MAIN;
+        fuzz_observe();
+        app_step(&app);
+        fuzz_observe();
+        if (sim.wakeups == wakeups)
+        {
+            sim_busy_wait();
+        }
+    }
+    sim_dispatch_irqs();
+    fuzz_observe();
+
+    if (served != edges)
+    {
+        fuzz_fail("button edge not served");
+    }
+    if (timerPending)
+    {
+        fuzz_fail("timer did not expire");
+    }
+    if (sim.wdtResets != 0U)
+    {
+        fuzz_fail("watchdog reset");
+    }
+
+    sim.preempt = NULL;
+    sim.sleepEntry = NULL;
+    wdt_svc_timer_stop(FUZZ_TIMER_ID);
+    if (pdActive)
+    {
+        pd_gate_clear(PD_GATE_CC);
+    }
+    app.pmSkip = FUZZ_SKIP_ALL;
+
+    return 0;
+}
+
+/* [] END OF FILE */
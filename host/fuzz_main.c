@@ -0,0 +1,410 @@
+/******************************************************************************
+* File Name: fuzz_main.c
+*
+* Description: Stand-alone driver of the fuzz target (fuzz_app.c), for
+*              builds without libFuzzer. Replays input files and
+*              directories, and with -n generates inputs by mutating the
+*              corpus. A generated input that lands events in states no
+*              earlier input reached (fuzz_signature) is added to the corpus
+*              directory, so the corpus keeps the interleavings found for
+*              regression runs. Every input runs in a process of its own; a
+*              failing input is saved as crash-<hash>.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* fork(), mmap(), opendir() with -std=c99 */
+#define _DEFAULT_SOURCE
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include "sim.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+#define FUZZ_MAX_INPUT          (513U)  /* Configuration byte and 256 ops */
+#define FUZZ_MAX_CORPUS         (4096U)
+
+/*******************************************************************************
+ * Data types
+ ******************************************************************************/
+typedef struct
+{
+    size_t size;
+    uint8_t data[FUZZ_MAX_INPUT];
+} fuzz_input_t;
+
+/*******************************************************************************
+ * Global variables
+ ******************************************************************************/
+static fuzz_input_t corpus[FUZZ_MAX_CORPUS];
+static uint32_t corpusCount;
+static uint8_t coverage[FUZZ_SIGNATURE_BYTES];
+static uint8_t *shared;
+static uint64_t rngState = 1U;
+
+static uint32_t fuzz_rand(uint32_t n)
+{
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 7;
+    rngState ^= rngState << 17;
+    return (uint32_t)((rngState >> 16) % n);
+}
+
+/* FNV-1a, names corpus and crash files */
+static uint64_t fuzz_hash(const uint8_t *data, size_t size)
+{
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    size_t i;
+
+    for (i = 0U; i < size; i++)
+    {
+        hash = (hash ^ data[i]) * 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+static void fuzz_save(const char *dir, const char *prefix, const uint8_t *data, size_t size)
+{
+    char path[512];
+    FILE *f;
+
+    (void) snprintf(path, sizeof(path), "%s%s%s%016llx", (dir != NULL) ? dir : "", (dir != NULL) ? "/" : "",
+                    prefix, (unsigned long long)fuzz_hash(data, size));
+    f = fopen(path, "wb");
+    if (f != NULL)
+    {
+        (void) fwrite(data, 1U, size, f);
+        (void) fclose(f);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: fuzz_run
+ *******************************************************************************
+ *
+ * Summary:
+ *  Runs one input in a child process.
+ *
+ * Parameters:
+ *  data: Input.
+ *  size: Input length.
+ *
+ * Return:
+ *  true if the invariants held; the signature of the run is in shared.
+ *
+ ******************************************************************************/
+static bool fuzz_run(const uint8_t *data, size_t size)
+{
+    pid_t pid;
+    int status;
+
+    (void) fflush(NULL);
+    pid = fork();
+    if (pid == 0)
+    {
+        (void) LLVMFuzzerTestOneInput(data, size);
+        memcpy(shared, fuzz_signature, FUZZ_SIGNATURE_BYTES);
+        _exit(0);
+    }
+
+    return (pid > 0) && (waitpid(pid, &status, 0) == pid) && WIFEXITED(status) &&
+           (WEXITSTATUS(status) == 0);
+}
+
+/* Merges the signature of the last run; true if it has new states */
+static bool fuzz_merge(void)
+{
+    bool fresh = false;
+    uint32_t i;
+
+    for (i = 0U; i < FUZZ_SIGNATURE_BYTES; i++)
+    {
+        fresh = fresh || ((shared[i] & ~coverage[i]) != 0U);
+        coverage[i] |= shared[i];
+    }
+    return fresh;
+}
+
+static uint32_t fuzz_coverage(void)
+{
+    uint32_t bits = 0U;
+    uint32_t i;
+
+    for (i = 0U; i < FUZZ_SIGNATURE_BYTES; i++)
+    {
+        bits += (uint32_t)__builtin_popcount(coverage[i]);
+    }
+    return bits;
+}
+
+static void fuzz_add(const uint8_t *data, size_t size)
+{
+    if (corpusCount < FUZZ_MAX_CORPUS)
+    {
+        corpus[corpusCount].size = size;
+        memcpy(corpus[corpusCount].data, data, size);
+        corpusCount++;
+    }
+}
+
+/* Replays one file; false if it fails */
+static bool fuzz_replay_file(const char *path)
+{
+    uint8_t data[FUZZ_MAX_INPUT];
+    size_t size;
+    FILE *f = fopen(path, "rb");
+
+    if (f == NULL)
+    {
+        perror(path);
+        return false;
+    }
+    size = fread(data, 1U, sizeof(data), f);
+    (void) fclose(f);
+
+    if (!fuzz_run(data, size))
+    {
+        fprintf(stderr, "FAIL %s\n", path);
+        return false;
+    }
+    (void) fuzz_merge();
+    fuzz_add(data, size);
+    return true;
+}
+
+/* Replays a file or every file of a directory; returns the failures */
+static uint32_t fuzz_replay(const char *path, uint32_t *runs)
+{
+    struct stat st;
+    struct dirent *entry;
+    DIR *dir;
+    char file[512];
+    uint32_t failed = 0U;
+
+    if ((stat(path, &st) == 0) && S_ISDIR(st.st_mode))
+    {
+        dir = opendir(path);
+        while ((dir != NULL) && ((entry = readdir(dir)) != NULL))
+        {
+            if (entry->d_name[0] != '.')
+            {
+                (void) snprintf(file, sizeof(file), "%s/%s", path, entry->d_name);
+                failed += fuzz_replay_file(file) ? 0U : 1U;
+                (*runs)++;
+            }
+        }
+        if (dir != NULL)
+        {
+            (void) closedir(dir);
+        }
+    }
+    else
+    {
+        failed += fuzz_replay_file(path) ? 0U : 1U;
+        (*runs)++;
+    }
+
+    return failed;
+}
+
+/* New input: a corpus entry with a few byte, insert, erase or splice
+ * mutations, or random bytes while the corpus is empty */
+static size_t fuzz_mutate(uint8_t *data)
+{
+    const fuzz_input_t *base;
+    const fuzz_input_t *other;
+    size_t size;
+    uint32_t n = fuzz_rand(4U) + 1U;
+    uint32_t at;
+
+    if (corpusCount == 0U)
+    {
+        size = 1U + (2U * (fuzz_rand(32U) + 1U));
+        for (at = 0U; at < size; at++)
+        {
+            data[at] = (uint8_t)fuzz_rand(256U);
+        }
+        return size;
+    }
+
+    base = &corpus[fuzz_rand(corpusCount)];
+    size = base->size;
+    memcpy(data, base->data, size);
+
+    while (n-- > 0U)
+    {
+        at = fuzz_rand((uint32_t)size);
+        switch (fuzz_rand(4U))
+        {
+            case 0U:
+                data[at] = (uint8_t)fuzz_rand(256U);
+                break;
+
+            case 1U:
+                if ((size + 2U) <= FUZZ_MAX_INPUT)
+                {
+                    memmove(&data[at + 2U], &data[at], size - at);
+                    data[at] = (uint8_t)fuzz_rand(256U);
+                    data[at + 1U] = (uint8_t)fuzz_rand(256U);
+                    size += 2U;
+                }
+                break;
+
+            case 2U:
+                if ((size > 3U) && ((at + 2U) <= size) && (at > 0U))
+                {
+                    memmove(&data[at], &data[at + 2U], size - at - 2U);
+                    size -= 2U;
+                }
+                break;
+
+            default:
+                other = &corpus[fuzz_rand(corpusCount)];
+                if (other->size > 1U)
+                {
+                    size = (at > 0U) ? at : 1U;
+                    n = (uint32_t)(other->size - 1U);
+                    n = ((size + n) <= FUZZ_MAX_INPUT) ? n : (uint32_t)(FUZZ_MAX_INPUT - size);
+                    memcpy(&data[size], &other->data[1], n);
+                    size += n;
+                    n = 0U;
+                }
+                break;
+        }
+    }
+
+    return size;
+}
+
+/*******************************************************************************
+ * Function Name: main
+ *******************************************************************************
+ *
+ * Summary:
+ *  fuzz [-n runs] [-s seed] [-o corpus_dir] [input file or directory ...]
+ *
+ ******************************************************************************/
+int main(int argc, char **argv)
+{
+    uint8_t data[FUZZ_MAX_INPUT];
+    const char *outDir = NULL;
+    uint32_t generate = 0U;
+    uint32_t runs = 0U;
+    uint32_t failed = 0U;
+    uint32_t added = 0U;
+    uint32_t i;
+    size_t size;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:s:o:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'n':
+                generate = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+
+            case 's':
+                rngState = strtoull(optarg, NULL, 0);
+                rngState = (rngState == 0U) ? 1U : rngState;
+                break;
+
+            case 'o':
+                outDir = optarg;
+                break;
+
+            default:
+                fprintf(stderr, "usage: %s [-n runs] [-s seed] [-o corpus_dir] [input ...]\n", argv[0]);
+                return 2;
+        }
+    }
+
+    shared = mmap(NULL, FUZZ_SIGNATURE_BYTES, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (shared == MAP_FAILED)
+    {
+        perror("mmap");
+        return 2;
+    }
+
+    for (i = (uint32_t)optind; i < (uint32_t)argc; i++)
+    {
+        failed += fuzz_replay(argv[i], &runs);
+    }
+    printf("replayed %lu inputs, %lu failed, %lu states\n", (unsigned long)runs, (unsigned long)failed,
+           (unsigned long)fuzz_coverage());
+
+    for (i = 0U; (i < generate) && (failed == 0U); i++)
+    {
+        size = fuzz_mutate(data);
+        memset(shared, 0, FUZZ_SIGNATURE_BYTES);
+        if (!fuzz_run(data, size))
+        {
+            fuzz_save(NULL, "crash-", data, size);
+            fprintf(stderr, "FAIL crash-%016llx\n", (unsigned long long)fuzz_hash(data, size));
+            failed++;
+        }
+        else if (fuzz_merge())
+        {
+            fuzz_add(data, size);
+            if (outDir != NULL)
+            {
+                fuzz_save(outDir, "", data, size);
+            }
+            added++;
+        }
+    }
+    if (generate != 0U)
+    {
+        printf("generated %lu inputs, %lu new in the corpus, %lu states\n", (unsigned long)i,
+               (unsigned long)added, (unsigned long)fuzz_coverage());
+    }
+
+    (void) munmap(shared, FUZZ_SIGNATURE_BYTES);
+
+    return (failed == 0U) ? 0 : 1;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,408 @@
+/******************************************************************************
+* File Name: cy_pdl.h
+*
+* Description: Host build stand-in for the PDL. Declares the subset of the
+*              CAT2 PDL types and functions used by the firmware; pdl_stub.c
+*              implements them on top of the simulator.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef CY_PDL_H
+#define CY_PDL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/*******************************************************************************
+ * cy_syslib
+ ******************************************************************************/
+#define __STATIC_INLINE         static inline
+#define __WEAK                  __attribute__((weak))
+#define CY_ASSERT(x)            do { if (!(x)) { sim_assert_failed(__FILE__, __LINE__); } } while (0)
+
+typedef uint32_t cy_rslt_t;
+
+#define CY_RSLT_SUCCESS         (0U)
+#define CY_RSLT_TYPE_ERROR      (2U)
+
+extern uint32_t SystemCoreClock;
+
+void sim_assert_failed(const char *file, int line);
+void Cy_SysLib_Delay(uint32_t milliseconds);
+void Cy_SysLib_SetWaitStates(uint32_t clkHfMHz);
+void SystemCoreClockUpdate(void);
+void __enable_irq(void);
+void __disable_irq(void);
+uint32_t __get_PRIMASK(void);
+void __set_PRIMASK(uint32_t priMask);
+
+/* Single core, in order: a barrier only has to stop the compiler */
+#define __DMB()                 __asm__ volatile ("" ::: "memory")
+uint32_t Cy_SysLib_EnterCriticalSection(void);
+void Cy_SysLib_ExitCriticalSection(uint32_t savedIntrStatus);
+
+/*******************************************************************************
+ * core_cm0plus SysTick
+ ******************************************************************************/
+typedef struct
+{
+    volatile uint32_t CTRL;
+    volatile uint32_t LOAD;
+    volatile uint32_t VAL;
+    volatile uint32_t CALIB;
+} SysTick_Type;
+
+#define SysTick_CTRL_ENABLE_Msk     (1UL << 0)
+#define SysTick_CTRL_TICKINT_Msk    (1UL << 1)
+#define SysTick_CTRL_CLKSOURCE_Msk  (1UL << 2)
+#define SysTick_CTRL_COUNTFLAG_Msk  (1UL << 16)
+
+/* VAL is brought up to date with the simulated time on every access */
+SysTick_Type *sim_systick(void);
+#define SysTick                     (sim_systick())
+
+/*******************************************************************************
+ * core_cm0plus SCB
+ ******************************************************************************/
+typedef struct
+{
+    volatile uint32_t ICSR;
+} SCB_Type;
+
+#define SCB_ICSR_PENDSTCLR_Msk      (1UL << 25)
+#define SCB_ICSR_PENDSTSET_Msk      (1UL << 26)
+
+/* ICSR shows the SysTick interrupt pending; a PENDSTCLR write takes effect
+ * at the next access */
+SCB_Type *sim_scb_core(void);
+#define SCB                         (sim_scb_core())
+
+/* Exception frame: the PC an interrupt handler would find stacked, which
+ * the simulator takes from where the interrupted code charged its cycles */
+uint32_t sim_stacked_pc(void);
+
+/* Word copy loops charge every word here, so the simulated interrupts can
+ * land between two words: seqlock.c runs SEQLOCK_COPY_WORD() per word */
+void sim_copy_word(void);
+#define SEQLOCK_COPY_WORD()     sim_copy_word()
+
+/* The power management callback walk charges every module it visits here
+ * (pm_module.c runs PM_CALL_STEP() per module) */
+void sim_pm_call(bool called);
+#define PM_CALL_STEP(called)    sim_pm_call(called)
+
+/*******************************************************************************
+ * cy_sysclk
+ ******************************************************************************/
+typedef enum
+{
+    CY_SYSCLK_SUCCESS       = 0x0U,
+    CY_SYSCLK_BAD_PARAM     = 0x1U,
+    CY_SYSCLK_TIMEOUT       = 0x2U,
+    CY_SYSCLK_INVALID_STATE = 0x3U
+} cy_en_sysclk_status_t;
+
+typedef enum
+{
+    CY_SYSCLK_IMO_24MHZ = 24000000UL,
+    CY_SYSCLK_IMO_28MHZ = 28000000UL,
+    CY_SYSCLK_IMO_32MHZ = 32000000UL,
+    CY_SYSCLK_IMO_36MHZ = 36000000UL,
+    CY_SYSCLK_IMO_40MHZ = 40000000UL,
+    CY_SYSCLK_IMO_44MHZ = 44000000UL,
+    CY_SYSCLK_IMO_48MHZ = 48000000UL
+} cy_en_sysclk_imo_freq_t;
+
+typedef enum
+{
+    CY_SYSCLK_NO_DIV = 0U,
+    CY_SYSCLK_DIV_2  = 1U,
+    CY_SYSCLK_DIV_4  = 2U,
+    CY_SYSCLK_DIV_8  = 3U
+} cy_en_sysclk_dividers_t;
+
+typedef enum
+{
+    CY_SYSCLK_DIV_8_BIT    = 0U,
+    CY_SYSCLK_DIV_16_BIT   = 1U,
+    CY_SYSCLK_DIV_16_5_BIT = 2U,
+    CY_SYSCLK_DIV_24_5_BIT = 3U
+} cy_en_sysclk_divider_types_t;
+
+cy_en_sysclk_status_t Cy_SysClk_ImoSetFrequency(cy_en_sysclk_imo_freq_t freq);
+void Cy_SysClk_ClkHfSetDivider(cy_en_sysclk_dividers_t divider);
+cy_en_sysclk_dividers_t Cy_SysClk_ClkHfGetDivider(void);
+uint32_t Cy_SysClk_ClkHfGetFrequency(void);
+uint32_t Cy_SysClk_ClkPeriGetFrequency(void);
+cy_en_sysclk_status_t Cy_SysClk_PeriphSetDivider(cy_en_sysclk_divider_types_t dividerType,
+                                                 uint32_t dividerNum, uint32_t dividerValue);
+
+/*******************************************************************************
+ * cy_sysint
+ ******************************************************************************/
+/* Device family of the simulated interrupt numbers */
+#define CY_DEVICE_PMG1S3
+
+typedef enum
+{
+    SysTick_IRQn                = -1,
+    ioss_interrupts_gpio_0_IRQn = 0,
+    ioss_interrupts_gpio_1_IRQn = 1,
+    ioss_interrupts_gpio_2_IRQn = 2,
+    ioss_interrupts_gpio_3_IRQn = 3,
+    srss_interrupt_IRQn         = 6,
+    scb_0_interrupt_IRQn        = 8,
+    usbpd_0_interrupt_IRQn      = 12,
+    tcpwm_interrupts_0_IRQn     = 17,
+    SIM_IRQ_COUNT               = 32
+} IRQn_Type;
+
+typedef void (*cy_israddress)(void);
+
+typedef struct
+{
+    IRQn_Type intrSrc;
+    uint32_t intrPriority;
+} cy_stc_sysint_t;
+
+typedef enum
+{
+    CY_SYSINT_SUCCESS   = 0x00U,
+    CY_SYSINT_BAD_PARAM = 0x01U
+} cy_en_sysint_status_t;
+
+cy_en_sysint_status_t Cy_SysInt_Init(const cy_stc_sysint_t *config, cy_israddress userIsr);
+void NVIC_EnableIRQ(IRQn_Type irqn);
+void NVIC_DisableIRQ(IRQn_Type irqn);
+void NVIC_ClearPendingIRQ(IRQn_Type irqn);
+void NVIC_SetPendingIRQ(IRQn_Type irqn);
+
+/*******************************************************************************
+ * cy_syspm
+ ******************************************************************************/
+typedef enum
+{
+    CY_SYSPM_SUCCESS       = 0x0U,
+    CY_SYSPM_BAD_PARAM     = 0x1U,
+    CY_SYSPM_TIMEOUT       = 0x2U,
+    CY_SYSPM_INVALID_STATE = 0x3U,
+    CY_SYSPM_CANCELED      = 0x4U,
+    CY_SYSPM_FAIL          = 0x5U
+} cy_en_syspm_status_t;
+
+typedef enum
+{
+    CY_SYSPM_SLEEP     = 0U,
+    CY_SYSPM_DEEPSLEEP = 1U
+} cy_en_syspm_callback_type_t;
+
+typedef enum
+{
+    CY_SYSPM_CHECK_READY       = 0x01U,
+    CY_SYSPM_CHECK_FAIL        = 0x02U,
+    CY_SYSPM_BEFORE_TRANSITION = 0x04U,
+    CY_SYSPM_AFTER_TRANSITION  = 0x08U
+} cy_en_syspm_callback_mode_t;
+
+#define CY_SYSPM_SKIP_CHECK_READY           (0x01U)
+#define CY_SYSPM_SKIP_CHECK_FAIL            (0x02U)
+#define CY_SYSPM_SKIP_BEFORE_TRANSITION     (0x04U)
+#define CY_SYSPM_SKIP_AFTER_TRANSITION      (0x08U)
+
+typedef struct
+{
+    void *base;
+    void *context;
+} cy_stc_syspm_callback_params_t;
+
+cy_en_syspm_status_t Cy_SysPm_CpuEnterSleep(void);
+cy_en_syspm_status_t Cy_SysPm_CpuEnterDeepSleep(void);
+
+/*******************************************************************************
+ * cy_wdt
+ ******************************************************************************/
+void Cy_WDT_Enable(void);
+void Cy_WDT_Disable(void);
+void Cy_WDT_SetMatch(uint32_t match);
+uint32_t Cy_WDT_GetMatch(void);
+uint32_t Cy_WDT_GetCount(void);
+void Cy_WDT_MaskInterrupt(void);
+void Cy_WDT_UnmaskInterrupt(void);
+void Cy_WDT_ClearInterrupt(void);
+uint32_t Cy_WDT_GetInterruptStatus(void);
+
+/*******************************************************************************
+ * cy_gpio
+ ******************************************************************************/
+typedef struct
+{
+    volatile uint32_t DR;
+    volatile uint32_t PS;
+    volatile uint32_t INTR;
+} GPIO_PRT_Type;
+
+#define GPIO_PRT_DR(base)       (((GPIO_PRT_Type *)(base))->DR)
+
+void Cy_GPIO_Write(GPIO_PRT_Type *base, uint32_t pinNum, uint32_t value);
+uint32_t Cy_GPIO_Read(GPIO_PRT_Type *base, uint32_t pinNum);
+void Cy_GPIO_ClearInterrupt(GPIO_PRT_Type *base, uint32_t pinNum);
+
+/*******************************************************************************
+ * cy_scb_uart
+ ******************************************************************************/
+typedef struct
+{
+    uint32_t reserved;
+} CySCB_Type;
+
+typedef struct
+{
+    uint32_t reserved;
+} cy_stc_scb_uart_context_t;
+
+typedef struct
+{
+    uint32_t reserved;
+} cy_stc_scb_uart_config_t;
+
+void Cy_SCB_UART_Init(CySCB_Type *base, const cy_stc_scb_uart_config_t *config,
+                      cy_stc_scb_uart_context_t *context);
+void Cy_SCB_UART_Enable(CySCB_Type *base);
+void Cy_SCB_UART_PutString(CySCB_Type *base, const char *string);
+void Cy_SCB_UART_PutArrayBlocking(CySCB_Type *base, void *buffer, uint32_t size);
+bool Cy_SCB_UART_IsTxComplete(CySCB_Type const *base);
+
+/*******************************************************************************
+ * cy_scb_ezi2c
+ ******************************************************************************/
+typedef enum
+{
+    CY_SCB_EZI2C_SUCCESS   = 0x00U,
+    CY_SCB_EZI2C_BAD_PARAM = 0x01U
+} cy_en_scb_ezi2c_status_t;
+
+typedef struct
+{
+    uint32_t reserved;
+} cy_stc_scb_ezi2c_config_t;
+
+typedef struct
+{
+    uint8_t *buf1;
+    uint32_t buf1Size;
+    uint32_t buf1rwBondary;
+} cy_stc_scb_ezi2c_context_t;
+
+cy_en_scb_ezi2c_status_t Cy_SCB_EZI2C_Init(CySCB_Type *base, cy_stc_scb_ezi2c_config_t const *config,
+                                           cy_stc_scb_ezi2c_context_t *context);
+void Cy_SCB_EZI2C_Enable(CySCB_Type *base);
+void Cy_SCB_EZI2C_SetBuffer1(CySCB_Type const *base, uint8_t *buffer, uint32_t bufSize,
+                             uint32_t rwBoundary, cy_stc_scb_ezi2c_context_t *context);
+void Cy_SCB_EZI2C_Interrupt(CySCB_Type *base, cy_stc_scb_ezi2c_context_t *context);
+cy_en_syspm_status_t Cy_SCB_EZI2C_DeepSleepCallback(cy_stc_syspm_callback_params_t *callbackParams,
+                                                    cy_en_syspm_callback_mode_t mode);
+
+/*******************************************************************************
+ * cy_tcpwm
+ ******************************************************************************/
+typedef struct
+{
+    volatile uint32_t CTRL;
+} TCPWM_Type;
+
+typedef enum
+{
+    CY_TCPWM_SUCCESS   = 0x00U,
+    CY_TCPWM_BAD_PARAM = 0x01U
+} cy_en_tcpwm_status_t;
+
+/* The counter counts clocks of its peripheral divider, sim.tcpwmClockHz */
+typedef struct
+{
+    uint32_t period;
+    uint32_t interruptSources;
+} cy_stc_tcpwm_counter_config_t;
+
+#define CY_TCPWM_INT_ON_TC          (1UL)
+
+cy_en_tcpwm_status_t Cy_TCPWM_Counter_Init(TCPWM_Type *base, uint32_t cntNum,
+                                           cy_stc_tcpwm_counter_config_t const *config);
+void Cy_TCPWM_Counter_Enable(TCPWM_Type *base, uint32_t cntNum);
+void Cy_TCPWM_TriggerStart(TCPWM_Type *base, uint32_t counters);
+void Cy_TCPWM_TriggerStopOrKill(TCPWM_Type *base, uint32_t counters);
+void Cy_TCPWM_ClearInterrupt(TCPWM_Type *base, uint32_t cntNum, uint32_t source);
+
+/*******************************************************************************
+ * cy_usbpd_common, cy_usbpd_vbus_ctrl
+ ******************************************************************************/
+#define CY_IP_MXUSBPD
+
+typedef enum
+{
+    CY_USBPD_STAT_SUCCESS   = 0x00U,
+    CY_USBPD_STAT_BAD_PARAM = 0x01U
+} cy_en_usbpd_status_t;
+
+typedef enum
+{
+    CY_USBPD_ADC_ID_0 = 0U,
+    CY_USBPD_ADC_ID_1 = 1U
+} cy_en_usbpd_adc_id_t;
+
+typedef struct
+{
+    uint32_t reserved;
+} cy_stc_usbpd_config_t;
+
+typedef struct
+{
+    uint8_t port;
+    bool adcInit;
+} cy_stc_usbpd_context_t;
+
+typedef void *(*cy_cb_usbpd_dpm_get_config_t)(void);
+
+/* Cy_USBPD_Adc_Calibrate() returns sim.vdddMv */
+cy_en_usbpd_status_t Cy_USBPD_Init(cy_stc_usbpd_context_t *context, uint8_t port, void *base,
+                                   void *trimsBase, cy_stc_usbpd_config_t *config,
+                                   cy_cb_usbpd_dpm_get_config_t dpmGetConfig);
+cy_en_usbpd_status_t Cy_USBPD_Adc_Init(cy_stc_usbpd_context_t *context, cy_en_usbpd_adc_id_t adcId);
+uint16_t Cy_USBPD_Adc_Calibrate(cy_stc_usbpd_context_t *context, cy_en_usbpd_adc_id_t adcId);
+
+#endif /* CY_PDL_H */
+
+/* [] END OF FILE */
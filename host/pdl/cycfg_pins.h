@@ -0,0 +1,77 @@
+/******************************************************************************
+* File Name: cycfg_pins.h
+*
+* Description: Host build stand-in for the generated pin configuration,
+*              matching the PMG1-CY7110 design.modus.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef CYCFG_PINS_H
+#define CYCFG_PINS_H
+
+#include "cy_pdl.h"
+
+extern GPIO_PRT_Type sim_gpio_port[4];
+extern CySCB_Type sim_scb[2];
+extern const cy_stc_scb_uart_config_t CYBSP_UART_config;
+extern const cy_stc_scb_ezi2c_config_t CYBSP_I2C_config;
+extern TCPWM_Type sim_tcpwm;
+extern const cy_stc_tcpwm_counter_config_t CYBSP_PROF_TIMER_config;
+extern uint32_t sim_usbpd[2];
+extern const cy_stc_usbpd_config_t mtb_usbpd_port0_config;
+
+#define CYBSP_USER_BTN_PORT     (&sim_gpio_port[2])
+#define CYBSP_USER_BTN_NUM      (0U)
+#define CYBSP_USER_BTN_IRQ      ioss_interrupts_gpio_2_IRQn
+
+#define CYBSP_USER_LED_PORT     (&sim_gpio_port[2])
+#define CYBSP_USER_LED_NUM      (1U)
+
+#define CYBSP_UART_HW           (&sim_scb[1])
+
+#define CYBSP_I2C_HW            (&sim_scb[0])
+#define CYBSP_I2C_IRQ           scb_0_interrupt_IRQn
+
+#define CYBSP_PROF_TIMER_HW     (&sim_tcpwm)
+#define CYBSP_PROF_TIMER_NUM    (0U)
+#define CYBSP_PROF_TIMER_IRQ    tcpwm_interrupts_0_IRQn
+
+#define mtb_usbpd_port0_HW      (&sim_usbpd[0])
+#define mtb_usbpd_port0_HW_TRIM (&sim_usbpd[1])
+
+#endif /* CYCFG_PINS_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,1145 @@
+/******************************************************************************
+* File Name: pdl_stub.c
+*
+* Description: PDL stand-in implementation for the host simulator. Register
+*              accesses are counted and every call is charged its cycle cost
+*              from the Cortex-M0 cost model in sim.h. The simulator core
+*              keeps the scenario event queue; Sleep and Deep Sleep skip
+*              virtual time to the next event or WDT match instead of
+*              stepping through it.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+#include "cybsp.h"
+#include "prof.h"
+
+/*******************************************************************************
+ * Global variables
+ ******************************************************************************/
+sim_t sim;
+
+/* README Table 3; the first kit is the default TARGET */
+const sim_kit_t sim_kits[SIM_KIT_COUNT] =
+{
+    { "PMG1-CY7110", 5800.0, 2230.0, 178.2 },
+    { "PMG1-CY7111", 6250.0, 2360.0, 315.1 },
+    { "PMG1-CY7112", 7440.0, 3500.0, 381.0 },
+    { "PMG1-CY7113", 9310.0, 4050.0, 237.9 },
+};
+uint32_t SystemCoreClock = SIM_HFCLK_HZ;
+GPIO_PRT_Type sim_gpio_port[4];
+CySCB_Type sim_scb[2];
+TCPWM_Type sim_tcpwm;
+uint32_t sim_usbpd[2];
+const cy_stc_usbpd_config_t mtb_usbpd_port0_config;
+const cy_stc_scb_uart_config_t CYBSP_UART_config;
+const cy_stc_scb_ezi2c_config_t CYBSP_I2C_config;
+
+/* design.modus: CYBSP_PROF_TIMER, 1 kHz from a 1 MHz divider */
+const cy_stc_tcpwm_counter_config_t CYBSP_PROF_TIMER_config = { 999U, CY_TCPWM_INT_ON_TC };
+
+/*******************************************************************************
+ * Simulator core
+ ******************************************************************************/
+void sim_reset(void)
+{
+    memset(&sim, 0, sizeof(sim));
+    memset(sim_gpio_port, 0, sizeof(sim_gpio_port));
+    sim.hfclkHz = SIM_HFCLK_HZ;
+    sim.imoMhz = SIM_HFCLK_HZ / 1000000UL;
+    sim.waitStates = 2U;
+    sim.vdddMv = 3300U;
+    sim.periDiv16[0] = 51U;
+    SystemCoreClock = SIM_HFCLK_HZ;
+}
+
+/* One WDT counter match: sets the interrupt, or counts an unserviced match
+ * while it is still set; the last unserviced match resets the device */
+static void sim_wdt_match(void)
+{
+    if (sim.wdtUnserviced == 0U)
+    {
+        sim.wdtUnserviced = 1U;
+        if (!sim.wdtMasked)
+        {
+            sim_raise_irq(srss_interrupt_IRQn);
+        }
+    }
+    else if (++sim.wdtUnserviced >= SIM_WDT_RESET_MATCHES)
+    {
+        sim.wdtResets++;
+        sim.wdtUnserviced = 0U;
+        sim.wdtEnabled = false;
+    }
+}
+
+/* Runs the ILO driven WDT counter for the given HFCLK cycles */
+static void sim_wdt_advance(uint64_t cycles)
+{
+    uint64_t ticks;
+    uint64_t first;
+
+    sim.iloAcc += cycles * SIM_ILO_HZ;
+    ticks = sim.iloAcc / sim.hfclkHz;
+    sim.iloAcc -= ticks * sim.hfclkHz;
+    sim.iloTicks += ticks;
+
+    if (!sim.wdtEnabled || (ticks == 0U))
+    {
+        return;
+    }
+
+    /* Ticks until the counter next equals the match value */
+    first = ((sim.wdtMatch - sim.wdtCount - 1U) & SIM_WDT_COUNTER_MASK) + 1U;
+    sim.wdtCount = (uint32_t)((sim.wdtCount + ticks) & SIM_WDT_COUNTER_MASK);
+    while (sim.wdtEnabled && (ticks >= first))
+    {
+        sim_wdt_match();
+        ticks -= first;
+        first = SIM_WDT_COUNTER_MASK + 1U;
+    }
+}
+
+/* Time of the next WDT counter match, or UINT64_MAX if the WDT is stopped.
+ * The match happens in the first cycle where the ILO phase reaches it. */
+static uint64_t sim_wdt_next_match(void)
+{
+    uint64_t first;
+
+    if (!sim.wdtEnabled)
+    {
+        return UINT64_MAX;
+    }
+
+    first = ((sim.wdtMatch - sim.wdtCount - 1U) & SIM_WDT_COUNTER_MASK) + 1U;
+    return sim.cycles + (((first * sim.hfclkHz) - sim.iloAcc) + SIM_ILO_HZ - 1U) / SIM_ILO_HZ;
+}
+
+/* Cycles between terminal counts of the profiler counter */
+static uint64_t sim_tcpwm_interval(void)
+{
+    return (((uint64_t)sim.tcpwmPeriod + 1U) * sim.hfclkHz) / sim.tcpwmClockHz;
+}
+
+static void sim_run_isr(IRQn_Type irqn, cy_israddress isr);
+static void sim_scb_sync(void);
+static void sim_systick_update(void);
+
+/* Firmware SysTick handler, if the build has one (cyccnt.c) */
+extern void SysTick_Handler(void) __attribute__((weak));
+
+/* Terminal count of the profiler counter, in the code at pc: the interrupt
+ * preempts the code at once, as on the device */
+static void sim_tcpwm_count(uintptr_t pc)
+{
+    uint64_t interval = sim_tcpwm_interval();
+
+    sim.tcpwmNext += (((sim.cycles - sim.tcpwmNext) / interval) + 1U) * interval;
+    sim.stackedPc = (uint32_t)pc;
+    sim.pending[tcpwm_interrupts_0_IRQn] = true;
+    if (sim.irqEnabled && (sim.isrActive == 0U) && sim.enabled[tcpwm_interrupts_0_IRQn] &&
+        (sim.isr[tcpwm_interrupts_0_IRQn] != NULL))
+    {
+        sim.pending[tcpwm_interrupts_0_IRQn] = false;
+        sim_run_isr(tcpwm_interrupts_0_IRQn, sim.isr[tcpwm_interrupts_0_IRQn]);
+    }
+}
+
+/* Time of the next SysTick wrap with its interrupt enabled, or UINT64_MAX.
+ * SysTick counts in Active and Sleep mode. */
+static uint64_t sim_systick_next(void)
+{
+    const uint32_t tickint = SysTick_CTRL_ENABLE_Msk | SysTick_CTRL_TICKINT_Msk;
+
+    if ((sim.mode == SIM_MODE_DEEPSLEEP) || ((sim.systick.CTRL & tickint) != tickint))
+    {
+        return UINT64_MAX;
+    }
+
+    sim_systick_update();
+    return sim.cycles + sim.systick.VAL + 1U;
+}
+
+/* SysTick wrap: the interrupt preempts Active mode code at once, and wakes
+ * the CPU from Sleep */
+static void sim_systick_wrap(void)
+{
+    sim.systickWraps++;
+    sim.systickPending = true;
+    if ((sim.mode == SIM_MODE_ACTIVE) && sim.irqEnabled && (sim.isrActive == 0U) &&
+        (SysTick_Handler != NULL))
+    {
+        sim.systickPending = false;
+        sim_run_isr(SysTick_IRQn, SysTick_Handler);
+    }
+}
+
+/* Charges time to the power mode the CPU is in, and to the code site at pc */
+static void sim_charge(uintptr_t pc, uint64_t cycles)
+{
+    sim.cycles += cycles;
+    sim.modeCycles[sim.mode] += cycles;
+    sim.energy.modeS[sim.mode] += (double)cycles / sim.hfclkHz;
+    sim_wdt_advance(cycles);
+
+    if (sim.mode == SIM_MODE_ACTIVE)
+    {
+        sim.energy.activeLoadS += (double)cycles / SIM_HFCLK_HZ;
+        if ((sim.activeCycles != NULL) &&
+            ((sim.isrActive == 0U) || (sim.isrIrqn != tcpwm_interrupts_0_IRQn)))
+        {
+            sim.activeCycles(pc, cycles);
+        }
+    }
+}
+
+/* Advances virtual time without running events: code executing in Active
+ * mode. Events that fall due meanwhile run at the next sleep or delay. The
+ * code site is the caller, a PDL call charging its cost, or busyPc. While
+ * the profiler counter runs or the SysTick interrupt is enabled, the time
+ * is split at their interrupts, so a long busy wait is sampled once per
+ * period and no SysTick wrap is missed. */
+__attribute__((noinline)) void sim_advance(uint64_t cycles)
+{
+    uintptr_t pc = (sim.busyPc != 0U) ? sim.busyPc : (uintptr_t)__builtin_return_address(0);
+    uint64_t next;
+    uint64_t step;
+    bool count;
+
+    for (;;)
+    {
+        /* A wrap at the same time as a terminal count is taken first */
+        next = sim_systick_next();
+        count = (sim.mode == SIM_MODE_ACTIVE) && sim.tcpwmRunning && (sim.tcpwmNext < next);
+        if (count)
+        {
+            next = sim.tcpwmNext;
+        }
+        if ((sim.cycles + cycles) < next)
+        {
+            break;
+        }
+
+        step = (next > sim.cycles) ? (next - sim.cycles) : 0U;
+        sim_charge(pc, step);
+        cycles -= step;
+        if (count)
+        {
+            sim_tcpwm_count(pc);
+        }
+        else
+        {
+            sim_systick_wrap();
+        }
+    }
+    sim_charge(pc, cycles);
+
+    /* Lets a harness land interrupts between any two steps of the code */
+    if ((sim.preempt != NULL) && (sim.mode == SIM_MODE_ACTIVE) && (sim.isrActive == 0U))
+    {
+        sim.preempt();
+    }
+}
+
+/* Charge drawn by a kit over the time in energy, uA x s */
+double sim_charge_uas(const sim_energy_t *energy, const sim_kit_t *kit)
+{
+    return ((energy->modeS[SIM_MODE_ACTIVE] + energy->modeS[SIM_MODE_SLEEP]) * kit->sleepUa) +
+           (energy->activeLoadS * (kit->activeUa - kit->sleepUa)) +
+           (energy->modeS[SIM_MODE_DEEPSLEEP] * kit->deepSleepUa);
+}
+
+void sim_raise_irq(IRQn_Type irqn)
+{
+    sim.pending[irqn] = true;
+}
+
+/* Runs an interrupt handler, with the exception entry and return */
+static void sim_run_isr(IRQn_Type irqn, cy_israddress isr)
+{
+    uintptr_t busyPc = sim.busyPc;
+    IRQn_Type isrIrqn = sim.isrIrqn;
+
+    sim.busyPc = 0U;
+    sim.isrIrqn = irqn;
+    sim.isrActive++;
+    sim.isrRuns++;
+    sim_advance(SIM_CYCLES_ISR_ENTRY);
+    isr();
+    sim_advance(SIM_CYCLES_ISR_EXIT);
+    sim.isrActive--;
+    sim.isrIrqn = isrIrqn;
+    sim.busyPc = busyPc;
+}
+
+void sim_dispatch_irqs(void)
+{
+    uint32_t irqn;
+
+    /* Interrupts of the same priority do not nest */
+    if (!sim.irqEnabled || (sim.isrActive != 0U))
+    {
+        return;
+    }
+
+    sim_scb_sync();
+    if (sim.systickPending && (SysTick_Handler != NULL))
+    {
+        sim.systickPending = false;
+        sim_run_isr(SysTick_IRQn, SysTick_Handler);
+    }
+
+    for (irqn = 0U; irqn < (uint32_t)SIM_IRQ_COUNT; irqn++)
+    {
+        if (sim.pending[irqn] && sim.enabled[irqn] && (sim.isr[irqn] != NULL))
+        {
+            sim.pending[irqn] = false;
+            sim_run_isr((IRQn_Type)irqn, sim.isr[irqn]);
+        }
+    }
+}
+
+/* Event queue order: by time, then by scheduling order */
+static bool sim_event_before(const sim_event_t *a, const sim_event_t *b)
+{
+    return (a->at < b->at) || ((a->at == b->at) && (a->seq < b->seq));
+}
+
+/*******************************************************************************
+ * Function Name: sim_schedule
+ *******************************************************************************
+ *
+ * Summary:
+ *  Schedules a scenario event. An event scheduled in the past runs at the
+ *  next sleep or delay.
+ *
+ * Parameters:
+ *  at: Virtual time, HFCLK cycles (see sim_ms_to_cycles()).
+ *  fn: Event function.
+ *
+ ******************************************************************************/
+void sim_schedule(uint64_t at, sim_event_fn_t fn)
+{
+    sim_event_t event = { at, sim.eventSeq++, fn };
+    uint32_t i;
+
+    if (sim.eventCount >= SIM_EVENT_MAX)
+    {
+        sim_assert_failed("event queue full", (int)SIM_EVENT_MAX);
+    }
+
+    /* Sift up */
+    for (i = sim.eventCount++; (i > 0U) && sim_event_before(&event, &sim.events[(i - 1U) / 2U]);
+         i = (i - 1U) / 2U)
+    {
+        sim.events[i] = sim.events[(i - 1U) / 2U];
+    }
+    sim.events[i] = event;
+}
+
+static sim_event_t sim_event_pop(void)
+{
+    sim_event_t first = sim.events[0];
+    sim_event_t last = sim.events[--sim.eventCount];
+    uint32_t i = 0U;
+    uint32_t child;
+
+    /* Sift the last event down from the root */
+    for (child = 1U; child < sim.eventCount; child = (2U * i) + 1U)
+    {
+        if (((child + 1U) < sim.eventCount) && sim_event_before(&sim.events[child + 1U], &sim.events[child]))
+        {
+            child++;
+        }
+        if (!sim_event_before(&sim.events[child], &last))
+        {
+            break;
+        }
+        sim.events[i] = sim.events[child];
+        i = child;
+    }
+    sim.events[i] = last;
+
+    return first;
+}
+
+/* Runs the events due at the current time, in order */
+static void sim_run_events(void)
+{
+    sim_event_t event;
+
+    while ((sim.eventCount != 0U) && (sim.events[0].at <= sim.cycles))
+    {
+        event = sim_event_pop();
+        sim.eventsRun++;
+        event.fn();
+    }
+}
+
+static bool sim_wake_pending(void)
+{
+    uint32_t irqn;
+
+    sim_scb_sync();
+    if (sim.systickPending)
+    {
+        return true;
+    }
+
+    for (irqn = 0U; irqn < (uint32_t)SIM_IRQ_COUNT; irqn++)
+    {
+        if (sim.pending[irqn] && sim.enabled[irqn])
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Jumps to the next event, WDT match, SysTick wrap interrupt or limit,
+ * whichever comes first, and runs the events due then */
+static void sim_skip(uint64_t limit)
+{
+    uint64_t next = sim_wdt_next_match();
+    uint64_t wrap = sim_systick_next();
+
+    if (wrap < next)
+    {
+        next = wrap;
+    }
+
+    if ((sim.eventCount != 0U) && (sim.events[0].at < next))
+    {
+        next = sim.events[0].at;
+    }
+    if (limit < next)
+    {
+        next = limit;
+    }
+
+    if (next == UINT64_MAX)
+    {
+        /* Nothing would ever wake the device */
+        fprintf(stderr, "sleep without a wake source at %llu ms\n", (unsigned long long)sim_now_ms());
+        abort();
+    }
+
+    if (next > sim.cycles)
+    {
+        sim_advance(next - sim.cycles);
+        sim.skips++;
+    }
+    sim_run_events();
+}
+
+/* Waits in the current mode until an enabled interrupt is pending, or a
+ * handler has run meanwhile (see sim.preempt): time skips from event to
+ * event, so idle time costs nothing to simulate */
+static void sim_wait_irq(void)
+{
+    uint64_t isrRuns = sim.isrRuns;
+
+    sim_run_events();
+    while (!sim_wake_pending() && (sim.isrRuns == isrRuns))
+    {
+        sim_skip(UINT64_MAX);
+    }
+}
+
+/* Firmware spinning in an Active mode loop until an interrupt does
+ * something: skips time like sleep, charged as Active time */
+void sim_busy_wait(void)
+{
+    sim.busyPc = (uintptr_t)__builtin_return_address(0);
+    sim_wait_irq();
+    sim.busyPc = 0U;
+    sim_dispatch_irqs();
+}
+
+static void sim_sleep(sim_mode_t mode)
+{
+    if (sim.sleepEntry != NULL)
+    {
+        sim.sleepEntry();
+    }
+    sim_advance(SIM_CYCLES_SLEEP_ENTRY);
+    sim.mode = mode;
+    sim_wait_irq();
+    sim.mode = SIM_MODE_ACTIVE;
+    sim.wakeups++;
+    sim_advance(SIM_CYCLES_SLEEP_EXIT);
+
+    sim_dispatch_irqs();
+}
+
+/* I2C master read of the EZI2C slave: the address match raises the SCB
+ * interrupt, which wakes the device and serves the read */
+void sim_i2c_read(uint32_t offset, uint32_t length)
+{
+    sim.i2cOffset = offset;
+    sim.i2cLength = (length < SIM_I2C_MAX_READ) ? length : SIM_I2C_MAX_READ;
+    sim_raise_irq(scb_0_interrupt_IRQn);
+}
+
+void sim_assert_failed(const char *file, int line)
+{
+    fprintf(stderr, "CY_ASSERT failed at %s:%d\n", file, line);
+    abort();
+}
+
+/*******************************************************************************
+ * cy_syslib
+ ******************************************************************************/
+/* Busy wait: interrupts are served as their events occur */
+void Cy_SysLib_Delay(uint32_t milliseconds)
+{
+    uint64_t end = sim.cycles + sim_us_to_cycles(1000U * (uint64_t)milliseconds);
+    uintptr_t busyPc = sim.busyPc;
+
+    sim.busyPc = (uintptr_t)Cy_SysLib_Delay;
+    sim_run_events();
+    sim_dispatch_irqs();
+    while (sim.cycles < end)
+    {
+        sim_skip(end);
+        sim_dispatch_irqs();
+    }
+    sim.busyPc = busyPc;
+}
+
+/* PMG1 flash: no wait state up to 16 MHz, one up to 32 MHz, two above */
+void Cy_SysLib_SetWaitStates(uint32_t clkHfMHz)
+{
+    sim.waitStates = (clkHfMHz <= 16U) ? 0U : ((clkHfMHz <= 32U) ? 1U : 2U);
+    sim.busWrites++;
+}
+
+void SystemCoreClockUpdate(void)
+{
+    SystemCoreClock = sim.hfclkHz;
+}
+
+void __enable_irq(void)
+{
+    sim.irqEnabled = true;
+    sim_dispatch_irqs();
+}
+
+void __disable_irq(void)
+{
+    sim.irqEnabled = false;
+}
+
+/* PRIMASK is 1 while interrupts are masked */
+uint32_t __get_PRIMASK(void)
+{
+    return sim.irqEnabled ? 0U : 1U;
+}
+
+void __set_PRIMASK(uint32_t priMask)
+{
+    if (priMask != 0U)
+    {
+        __disable_irq();
+    }
+    else
+    {
+        __enable_irq();
+    }
+}
+
+uint32_t Cy_SysLib_EnterCriticalSection(void)
+{
+    uint32_t saved = sim.irqEnabled ? 1U : 0U;
+
+    sim.irqEnabled = false;
+    return saved;
+}
+
+void Cy_SysLib_ExitCriticalSection(uint32_t savedIntrStatus)
+{
+    if (savedIntrStatus != 0U)
+    {
+        __enable_irq();
+    }
+}
+
+/*******************************************************************************
+ * core_cm0plus SysTick
+ ******************************************************************************/
+/* SysTick counts the CPU clock down from LOAD, and stops in Deep Sleep */
+static void sim_systick_update(void)
+{
+    uint64_t counted = sim.cycles - sim.modeCycles[SIM_MODE_DEEPSLEEP];
+    bool enabled = (sim.systick.CTRL & SysTick_CTRL_ENABLE_Msk) != 0U;
+
+    if (enabled && !sim.systickRunning)
+    {
+        sim.systickStart = counted;
+    }
+    sim.systickRunning = enabled;
+
+    if (enabled)
+    {
+        sim.systick.VAL = sim.systick.LOAD -
+            (uint32_t)((counted - sim.systickStart) % ((uint64_t)sim.systick.LOAD + 1U));
+    }
+}
+
+SysTick_Type *sim_systick(void)
+{
+    sim_systick_update();
+    sim.systickRead = sim.cycles;
+
+    return &sim.systick;
+}
+
+/* Only the SysTick pending bits of ICSR are modeled. A PENDSTCLR write
+ * takes effect at the next access. */
+static void sim_scb_sync(void)
+{
+    if ((sim.scbCore.ICSR & SCB_ICSR_PENDSTCLR_Msk) != 0U)
+    {
+        sim.systickPending = false;
+    }
+    sim.scbCore.ICSR = sim.systickPending ? SCB_ICSR_PENDSTSET_Msk : 0U;
+}
+
+/* cyccnt_now() is charged here, as it reads ICSR after SysTick; the time
+ * may cross a wrap, as on the device. The PENDSTCLR write before sleep is
+ * charged the same. */
+SCB_Type *sim_scb_core(void)
+{
+    sim_advance(SIM_CYCLES_CYCCNT_NOW);
+    sim_scb_sync();
+
+    return &sim.scbCore;
+}
+
+/* The profiler handler's work is charged here, as it reads the frame */
+uint32_t sim_stacked_pc(void)
+{
+    sim_advance(SIM_CYCLES_PROF_SAMPLE);
+    return sim.stackedPc;
+}
+
+/* prof.c reads the PC from the exception frame, which the simulator does not
+ * build: its counter interrupt takes the PC from sim_stacked_pc() instead */
+#if PROF_SAMPLE
+void prof_timer_isr(void)
+{
+    prof_sample(sim_stacked_pc());
+}
+#endif
+
+/* A module the callback walk skips costs the checks of pm_call(); a module
+ * it calls, the indirect call and the return of its callback as well. The
+ * code site is the walk, not this stub. */
+void sim_pm_call(bool called)
+{
+    uintptr_t busyPc = sim.busyPc;
+
+    if (busyPc == 0U)
+    {
+        sim.busyPc = (uintptr_t)__builtin_return_address(0);
+    }
+    sim_advance(called ? SIM_CYCLES_PM_CALLBACK : SIM_CYCLES_PM_SKIP);
+    sim.busyPc = busyPc;
+}
+
+/* Each word is a step of its own, for sim.preempt */
+void sim_copy_word(void)
+{
+    sim.copyWords++;
+    sim_advance(SIM_CYCLES_COPY_WORD);
+}
+
+/*******************************************************************************
+ * cy_sysclk
+ ******************************************************************************/
+static void sim_update_hfclk(void)
+{
+    sim.hfclkHz = (sim.imoMhz * 1000000UL) >> sim.hfDivShift;
+
+    /* Running the flash faster than its wait states allow is a hardware fault */
+    if ((sim.hfclkHz > 32000000UL) && (sim.waitStates < 2U))
+    {
+        sim_assert_failed("flash wait states", (int)(sim.hfclkHz / 1000000UL));
+    }
+    if ((sim.hfclkHz > 16000000UL) && (sim.waitStates < 1U))
+    {
+        sim_assert_failed("flash wait states", (int)(sim.hfclkHz / 1000000UL));
+    }
+}
+
+/* Takes the frequency in Hz, as the PDL does; fails with the IMO unchanged
+ * for any other value, or when the scenario set sim.imoFail */
+cy_en_sysclk_status_t Cy_SysClk_ImoSetFrequency(cy_en_sysclk_imo_freq_t freq)
+{
+    uint32_t hz = (uint32_t)freq;
+
+    sim.busWrites++;
+    if (sim.imoFail || (hz < 24000000UL) || (hz > 48000000UL) || ((hz % 4000000UL) != 0U))
+    {
+        sim.imoFail = false;
+        return CY_SYSCLK_BAD_PARAM;
+    }
+    sim.imoMhz = hz / 1000000UL;
+    sim_update_hfclk();
+    return CY_SYSCLK_SUCCESS;
+}
+
+cy_en_sysclk_dividers_t Cy_SysClk_ClkHfGetDivider(void)
+{
+    sim.busReads++;
+    return (cy_en_sysclk_dividers_t)sim.hfDivShift;
+}
+
+void Cy_SysClk_ClkHfSetDivider(cy_en_sysclk_dividers_t divider)
+{
+    sim.hfDivShift = (uint32_t)divider;
+    sim.busWrites++;
+    sim_update_hfclk();
+}
+
+uint32_t Cy_SysClk_ClkHfGetFrequency(void)
+{
+    return sim.hfclkHz;
+}
+
+/* The peripheral clock divider of design.modus divides by 1 */
+uint32_t Cy_SysClk_ClkPeriGetFrequency(void)
+{
+    return sim.hfclkHz;
+}
+
+cy_en_sysclk_status_t Cy_SysClk_PeriphSetDivider(cy_en_sysclk_divider_types_t dividerType,
+                                                 uint32_t dividerNum, uint32_t dividerValue)
+{
+    if ((dividerType != CY_SYSCLK_DIV_16_BIT) || (dividerNum >= 4U))
+    {
+        return CY_SYSCLK_BAD_PARAM;
+    }
+
+    sim.periDiv16[dividerNum] = dividerValue;
+    sim.busWrites++;
+    return CY_SYSCLK_SUCCESS;
+}
+
+/*******************************************************************************
+ * cy_sysint
+ ******************************************************************************/
+cy_en_sysint_status_t Cy_SysInt_Init(const cy_stc_sysint_t *config, cy_israddress userIsr)
+{
+    if ((config == NULL) || ((uint32_t)config->intrSrc >= (uint32_t)SIM_IRQ_COUNT))
+    {
+        return CY_SYSINT_BAD_PARAM;
+    }
+
+    sim.isr[config->intrSrc] = userIsr;
+    return CY_SYSINT_SUCCESS;
+}
+
+void NVIC_EnableIRQ(IRQn_Type irqn)
+{
+    sim.enabled[irqn] = true;
+}
+
+void NVIC_DisableIRQ(IRQn_Type irqn)
+{
+    sim.enabled[irqn] = false;
+}
+
+void NVIC_ClearPendingIRQ(IRQn_Type irqn)
+{
+    sim.pending[irqn] = false;
+}
+
+void NVIC_SetPendingIRQ(IRQn_Type irqn)
+{
+    sim.pending[irqn] = true;
+}
+
+/*******************************************************************************
+ * cy_syspm
+ ******************************************************************************/
+cy_en_syspm_status_t Cy_SysPm_CpuEnterSleep(void)
+{
+    sim_sleep(SIM_MODE_SLEEP);
+    return CY_SYSPM_SUCCESS;
+}
+
+cy_en_syspm_status_t Cy_SysPm_CpuEnterDeepSleep(void)
+{
+    sim_sleep(SIM_MODE_DEEPSLEEP);
+    return CY_SYSPM_SUCCESS;
+}
+
+/*******************************************************************************
+ * cy_wdt
+ ******************************************************************************/
+void Cy_WDT_Enable(void)
+{
+    sim.wdtEnabled = true;
+    sim.busWrites++;
+}
+
+void Cy_WDT_Disable(void)
+{
+    sim.wdtEnabled = false;
+    sim.busWrites++;
+}
+
+void Cy_WDT_SetMatch(uint32_t match)
+{
+    sim.wdtMatch = match & SIM_WDT_COUNTER_MASK;
+    sim.busWrites++;
+}
+
+uint32_t Cy_WDT_GetMatch(void)
+{
+    sim.busReads++;
+    return sim.wdtMatch;
+}
+
+uint32_t Cy_WDT_GetCount(void)
+{
+    sim.busReads++;
+    return sim.wdtCount;
+}
+
+void Cy_WDT_MaskInterrupt(void)
+{
+    sim.wdtMasked = true;
+    sim.busWrites++;
+}
+
+void Cy_WDT_UnmaskInterrupt(void)
+{
+    sim.wdtMasked = false;
+    sim.busWrites++;
+}
+
+void Cy_WDT_ClearInterrupt(void)
+{
+    sim.wdtUnserviced = 0U;
+    sim.busWrites++;
+}
+
+uint32_t Cy_WDT_GetInterruptStatus(void)
+{
+    sim.busReads++;
+    return (sim.wdtUnserviced != 0U) ? 1U : 0U;
+}
+
+/*******************************************************************************
+ * cy_gpio
+ ******************************************************************************/
+void Cy_GPIO_Write(GPIO_PRT_Type *base, uint32_t pinNum, uint32_t value)
+{
+    uint32_t dr = base->DR;
+
+    base->DR = (dr & ~(1UL << pinNum)) | ((value & 1UL) << pinNum);
+    sim.busReads++;
+    sim.busWrites++;
+    sim_advance(SIM_CYCLES_GPIO_WRITE);
+}
+
+uint32_t Cy_GPIO_Read(GPIO_PRT_Type *base, uint32_t pinNum)
+{
+    sim.busReads++;
+    return (base->PS >> pinNum) & 1UL;
+}
+
+void Cy_GPIO_ClearInterrupt(GPIO_PRT_Type *base, uint32_t pinNum)
+{
+    base->INTR = 1UL << pinNum;
+    sim.busWrites++;
+    sim_advance(SIM_CYCLES_GPIO_CLEAR);
+}
+
+/*******************************************************************************
+ * cy_scb_uart
+ ******************************************************************************/
+void Cy_SCB_UART_Init(CySCB_Type *base, const cy_stc_scb_uart_config_t *config,
+                      cy_stc_scb_uart_context_t *context)
+{
+    (void) base;
+    (void) config;
+    (void) context;
+}
+
+void Cy_SCB_UART_Enable(CySCB_Type *base)
+{
+    (void) base;
+}
+
+/* Queues bytes on the line; blocks while they do not fit in the TX FIFO.
+ * Interrupts that became pending while blocked are served at its end, so a
+ * long blocking write does not hold them past the caller. */
+static void sim_uart_put(const uint8_t *data, uint32_t size)
+{
+    uint64_t byteCycles = ((uint64_t)sim.hfclkHz * SIM_UART_BITS_PER_BYTE) / SIM_UART_BAUD;
+    uint64_t start = (sim.uartTxDone > sim.cycles) ? sim.uartTxDone : sim.cycles;
+    uint64_t fifoCycles = SIM_UART_FIFO_DEPTH * byteCycles;
+    bool blocked = false;
+
+    sim.uartTxDone = start + (size * byteCycles);
+    sim.uartBytes += size;
+    sim.busWrites += size;
+    sim_advance((uint64_t)size * SIM_CYCLES_UART_BYTE);
+    if (sim.uartTxDone > (sim.cycles + fifoCycles))
+    {
+        sim_advance(sim.uartTxDone - fifoCycles - sim.cycles);
+        blocked = true;
+    }
+
+    if (sim.uartCapture != NULL)
+    {
+        (void) fwrite(data, 1U, size, sim.uartCapture);
+    }
+    if (blocked)
+    {
+        sim_dispatch_irqs();
+    }
+}
+
+void Cy_SCB_UART_PutString(CySCB_Type *base, const char *string)
+{
+    (void) base;
+    sim_uart_put((const uint8_t *)string, (uint32_t)strlen(string));
+}
+
+void Cy_SCB_UART_PutArrayBlocking(CySCB_Type *base, void *buffer, uint32_t size)
+{
+    (void) base;
+    sim_uart_put((const uint8_t *)buffer, size);
+}
+
+/* A polling loop on this is skipped to its last failing poll: the polls
+ * in between are charged but not simulated one by one. Interrupts pending
+ * meanwhile are served, as between the polls on the device. */
+bool Cy_SCB_UART_IsTxComplete(CySCB_Type const *base)
+{
+    uint64_t polls;
+
+    (void) base;
+    sim.busReads++;
+    sim_advance(SIM_CYCLES_UART_POLL);
+    if (sim.cycles >= sim.uartTxDone)
+    {
+        return true;
+    }
+
+    polls = (sim.uartTxDone - sim.cycles - 1U) / SIM_CYCLES_UART_POLL;
+    sim.busReads += (uint32_t)polls;
+    sim_advance(polls * SIM_CYCLES_UART_POLL);
+    sim_dispatch_irqs();
+    return false;
+}
+
+/*******************************************************************************
+ * cy_scb_ezi2c
+ ******************************************************************************/
+cy_en_scb_ezi2c_status_t Cy_SCB_EZI2C_Init(CySCB_Type *base, cy_stc_scb_ezi2c_config_t const *config,
+                                           cy_stc_scb_ezi2c_context_t *context)
+{
+    (void) base;
+    (void) config;
+    memset(context, 0, sizeof(*context));
+    return CY_SCB_EZI2C_SUCCESS;
+}
+
+void Cy_SCB_EZI2C_Enable(CySCB_Type *base)
+{
+    (void) base;
+    sim.busWrites++;
+}
+
+void Cy_SCB_EZI2C_SetBuffer1(CySCB_Type const *base, uint8_t *buffer, uint32_t bufSize,
+                             uint32_t rwBoundary, cy_stc_scb_ezi2c_context_t *context)
+{
+    (void) base;
+    context->buf1 = buffer;
+    context->buf1Size = bufSize;
+    context->buf1rwBondary = rwBoundary;
+    sim.i2cBuffer = buffer;
+}
+
+/* Serves the pending master read from the buffer; bytes past its end read
+ * as 0xFF, like the EZI2C default */
+void Cy_SCB_EZI2C_Interrupt(CySCB_Type *base, cy_stc_scb_ezi2c_context_t *context)
+{
+    uint32_t i;
+    uint32_t addr;
+
+    (void) base;
+    for (i = 0U; i < sim.i2cLength; i++)
+    {
+        addr = sim.i2cOffset + i;
+        sim.i2cRx[i] = (addr < context->buf1Size) ? context->buf1[addr] : 0xFFU;
+        sim.busWrites++;
+        sim_advance(SIM_CYCLES_I2C_BYTE);
+    }
+    sim.i2cBytes += sim.i2cLength;
+    sim.i2cLength = 0U;
+}
+
+/* Transfers complete within the interrupt, so the slave is never busy */
+cy_en_syspm_status_t Cy_SCB_EZI2C_DeepSleepCallback(cy_stc_syspm_callback_params_t *callbackParams,
+                                                    cy_en_syspm_callback_mode_t mode)
+{
+    (void) callbackParams;
+    (void) mode;
+    return CY_SYSPM_SUCCESS;
+}
+
+/*******************************************************************************
+ * cy_tcpwm
+ ******************************************************************************/
+cy_en_tcpwm_status_t Cy_TCPWM_Counter_Init(TCPWM_Type *base, uint32_t cntNum,
+                                           cy_stc_tcpwm_counter_config_t const *config)
+{
+    (void) base;
+    (void) cntNum;
+    sim.tcpwmPeriod = config->period;
+    sim.tcpwmLeft = 0U;
+    sim.busWrites++;
+    return CY_TCPWM_SUCCESS;
+}
+
+void Cy_TCPWM_Counter_Enable(TCPWM_Type *base, uint32_t cntNum)
+{
+    (void) base;
+    (void) cntNum;
+    sim.busWrites++;
+}
+
+/* The counter resumes where it stopped; it only counts while its divider
+ * is clocked */
+void Cy_TCPWM_TriggerStart(TCPWM_Type *base, uint32_t counters)
+{
+    (void) base;
+    (void) counters;
+    sim.busWrites++;
+    if (!sim.tcpwmRunning && (sim.tcpwmClockHz != 0U))
+    {
+        sim.tcpwmRunning = true;
+        sim.tcpwmNext = sim.cycles + ((sim.tcpwmLeft != 0U) ? sim.tcpwmLeft : sim_tcpwm_interval());
+    }
+}
+
+void Cy_TCPWM_TriggerStopOrKill(TCPWM_Type *base, uint32_t counters)
+{
+    (void) base;
+    (void) counters;
+    sim.busWrites++;
+    if (sim.tcpwmRunning)
+    {
+        sim.tcpwmRunning = false;
+        sim.tcpwmLeft = (sim.tcpwmNext > sim.cycles) ? (sim.tcpwmNext - sim.cycles) : 0U;
+    }
+}
+
+void Cy_TCPWM_ClearInterrupt(TCPWM_Type *base, uint32_t cntNum, uint32_t source)
+{
+    (void) base;
+    (void) cntNum;
+    (void) source;
+    sim.busWrites++;
+}
+
+/*******************************************************************************
+ * cybsp
+ ******************************************************************************/
+/*******************************************************************************
+ * cy_usbpd_common, cy_usbpd_vbus_ctrl
+ ******************************************************************************/
+cy_en_usbpd_status_t Cy_USBPD_Init(cy_stc_usbpd_context_t *context, uint8_t port, void *base,
+                                   void *trimsBase, cy_stc_usbpd_config_t *config,
+                                   cy_cb_usbpd_dpm_get_config_t dpmGetConfig)
+{
+    (void) base;
+    (void) trimsBase;
+    (void) config;
+    (void) dpmGetConfig;
+    if ((context == NULL) || (port != 0U))
+    {
+        return CY_USBPD_STAT_BAD_PARAM;
+    }
+    memset(context, 0, sizeof(*context));
+    context->port = port;
+    return CY_USBPD_STAT_SUCCESS;
+}
+
+cy_en_usbpd_status_t Cy_USBPD_Adc_Init(cy_stc_usbpd_context_t *context, cy_en_usbpd_adc_id_t adcId)
+{
+    (void) adcId;
+    context->adcInit = true;
+    return CY_USBPD_STAT_SUCCESS;
+}
+
+/* The ADC converts the bandgap against VDDD: sim.vdddTrace(), if set, gives
+ * VDDD at the current time */
+uint16_t Cy_USBPD_Adc_Calibrate(cy_stc_usbpd_context_t *context, cy_en_usbpd_adc_id_t adcId)
+{
+    (void) adcId;
+    CY_ASSERT(context->adcInit);
+    sim.busReads++;
+    if (sim.vdddTrace != NULL)
+    {
+        sim.vdddMv = sim.vdddTrace(sim_now_ms());
+    }
+    return sim.vdddMv;
+}
+
+cy_rslt_t cybsp_init(void)
+{
+    /* design.modus: User LED initial state 0, button pulled up */
+    sim_gpio_port[2].DR = 0U;
+    sim_gpio_port[2].PS = 1UL << CYBSP_USER_BTN_NUM;
+    return CY_RSLT_SUCCESS;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,348 @@
+/******************************************************************************
+* File Name: sim.h
+*
+* Description: Host simulator of the PMG1 firmware. The firmware sources are
+*              compiled natively against the PDL stand-ins in pdl/ and
+*              driven by scenarios that inject button presses and other
+*              events. Time is discrete-event: scenario events are kept in a
+*              queue ordered by virtual time, and Sleep / Deep Sleep jump
+*              straight to the next event or WDT match.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef SIM_H
+#define SIM_H
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdio.h>
+#include "cy_pdl.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Default HFCLK, as configured in design.modus */
+#define SIM_HFCLK_HZ            (48000000UL)
+
+/* WDT clock (ILO) and counter width */
+#define SIM_ILO_HZ              (40000UL)
+#define SIM_WDT_COUNTER_MASK    (0xFFFFUL)
+
+/* Matches with the WDT interrupt pending before the WDT resets the device */
+#define SIM_WDT_RESET_MATCHES   (3U)
+
+/* Kits of the current model (sim_kits[]) */
+#define SIM_KIT_COUNT           (4U)
+
+/* ILO ticks since the last transition the residency record may miss at the
+ * end of a run (sim_app_residency_ok) */
+#define SIM_APP_RESIDENCY_SLACK (SIM_ILO_HZ / 100U)
+
+/* Longest run with daily records, see sim_app_result_t */
+#define SIM_APP_MAX_DAYS        (31U)
+
+/* Scenario events pending at the same time */
+#define SIM_EVENT_MAX           (16U)
+
+/* Cortex-M0 cost model, in CPU cycles, of the PDL calls the firmware makes */
+#define SIM_CYCLES_GPIO_WRITE   (14U)   /* Inlined DR read-modify-write */
+#define SIM_CYCLES_GPIO_CLEAR   (10U)
+#define SIM_CYCLES_ISR_ENTRY    (16U)   /* Exception entry */
+#define SIM_CYCLES_ISR_EXIT     (16U)   /* Exception return */
+#define SIM_CYCLES_UART_BYTE    (40U)   /* Polled FIFO write per byte */
+#define SIM_CYCLES_UART_POLL    (12U)   /* One TX status poll */
+#define SIM_CYCLES_I2C_BYTE     (30U)   /* EZI2C interrupt per byte read */
+#define SIM_CYCLES_PROF_SAMPLE  (44U)   /* prof_sample(): hash, first probe */
+#define SIM_CYCLES_CYCCNT_NOW   (22U)   /* cyccnt_now(): critical section, reads */
+#define SIM_CYCLES_COPY_WORD    (8U)    /* LDR, STR, index, compare, branch */
+#define SIM_CYCLES_SLEEP_ENTRY  (10U)   /* Cy_SysPm_CpuEnterSleep(): SCR update, WFI */
+#define SIM_CYCLES_SLEEP_EXIT   (6U)    /* WFI return, function return */
+#define SIM_CYCLES_PM_SKIP      (12U)   /* pm_call(): types and skip mode checks */
+#define SIM_CYCLES_PM_CALLBACK  (20U)   /* Checks, indirect call, trivial callback */
+
+/* CPI model of the Cortex-M0 running from flash: zero wait state CPI and
+ * flash fetches per instruction (one 32-bit fetch per two Thumb instructions
+ * plus refetches after taken branches). Each fetch stalls for the wait
+ * states. The cycles of the cost model above are zero wait state cycles. */
+#define SIM_CPI_BASE            (1.25)
+#define SIM_FETCH_PER_INSN      (0.6)
+
+/* CYBSP_UART line: 115200 baud, 8N1, 8 byte TX FIFO */
+#define SIM_UART_BAUD           (115200UL)
+#define SIM_UART_BITS_PER_BYTE  (10U)
+#define SIM_UART_FIFO_DEPTH     (8U)
+
+/* Size of the fuzz_signature bitmap (fuzz_app.c) */
+#define FUZZ_SIGNATURE_BYTES    (64U)
+
+/* Longest I2C read the simulated master issues */
+#define SIM_I2C_MAX_READ        (128U)
+
+/*******************************************************************************
+ * Data types
+ ******************************************************************************/
+typedef enum
+{
+    SIM_MODE_ACTIVE = 0U,
+    SIM_MODE_SLEEP,
+    SIM_MODE_DEEPSLEEP,
+    SIM_MODE_COUNT
+} sim_mode_t;
+
+/* Scenario event: runs at its virtual time, like a hardware event. It may
+ * change the modeled hardware, call the firmware hooks an interrupt handler
+ * would call, raise interrupts and schedule further events. */
+typedef void (*sim_event_fn_t)(void);
+
+typedef struct
+{
+    uint64_t at;                        /* Virtual time, HFCLK cycles */
+    uint64_t seq;                       /* Scheduling order, for equal times */
+    sim_event_fn_t fn;
+} sim_event_t;
+
+/* Current model of a TARGET kit (README Table 3), in uA. The part of the
+ * Active current above the Sleep current scales with HFCLK from its 48 MHz
+ * value. */
+typedef struct
+{
+    const char *target;                 /* TARGET in the Makefile */
+    double activeUa;
+    double sleepUa;
+    double deepSleepUa;
+} sim_kit_t;
+
+/* Time spent in the power modes, from which sim_charge_uas() computes the
+ * charge drawn by any kit */
+typedef struct
+{
+    double modeS[SIM_MODE_COUNT];       /* Seconds in each power mode */
+    double activeLoadS;                 /* Active seconds x HFCLK / 48 MHz */
+} sim_energy_t;
+
+/* Simulated device state */
+typedef struct
+{
+    uint64_t cycles;                    /* Virtual CPU time, HFCLK cycles */
+    uint32_t hfclkHz;                   /* Current HFCLK frequency */
+    uint32_t imoMhz;                    /* IMO frequency */
+    uint32_t hfDivShift;                /* HFCLK divider, log2 */
+    uint32_t waitStates;                /* Flash wait states */
+    bool imoFail;                       /* Next IMO change fails */
+    uint32_t periDiv16[4];              /* 16-bit peripheral dividers */
+    uint16_t vdddMv;                    /* Supply voltage */
+    uint16_t (*vdddTrace)(uint64_t ms); /* VDDD over time, or NULL for vdddMv */
+    sim_mode_t mode;                    /* Current power mode */
+    uint64_t modeCycles[SIM_MODE_COUNT];/* Time spent in each power mode */
+    sim_energy_t energy;                /* Time in the power modes */
+    uint32_t wakeups;                   /* Sleep / Deep Sleep exits */
+    uint32_t busReads;                  /* Peripheral register reads */
+    uint32_t busWrites;                 /* Peripheral register writes */
+    uint64_t copyWords;                 /* Words copied by copy loops */
+    uint32_t uartBytes;                 /* Bytes sent on the UART */
+    uint64_t uartTxDone;                /* Time the last queued byte is sent */
+    FILE *uartCapture;                  /* UART output capture, or NULL */
+    uint64_t iloAcc;                    /* ILO phase, in HFCLK cycles x ILO Hz */
+    uint64_t iloTicks;                  /* ILO ticks since sim_reset() */
+    uint32_t wdtCount;                  /* WDT counter */
+    uint32_t wdtMatch;                  /* WDT match value */
+    bool wdtEnabled;                    /* WDT counting */
+    bool wdtMasked;                     /* WDT interrupt masked */
+    uint32_t wdtUnserviced;             /* Matches since the interrupt was set */
+    uint32_t wdtResets;                 /* Watchdog resets */
+    SysTick_Type systick;               /* SysTick registers */
+    uint64_t systickStart;              /* SysTick time base at enable */
+    bool systickRunning;
+    uint64_t systickRead;               /* Time of the last firmware access */
+    bool systickPending;                /* SysTick wrap interrupt pending */
+    uint64_t systickWraps;              /* SysTick wrap interrupts raised */
+    SCB_Type scbCore;                   /* SCB registers */
+    uint32_t i2cOffset;                 /* Pending master read: offset */
+    uint32_t i2cLength;                 /* Pending master read: length, 0 if none */
+    uint8_t i2cRx[SIM_I2C_MAX_READ];    /* Bytes received by the master */
+    const uint8_t *i2cBuffer;           /* EZI2C buffer set by the firmware */
+    uint32_t i2cBytes;                  /* Bytes sent to the master */
+    bool irqEnabled;                    /* Global interrupt enable */
+    cy_israddress isr[SIM_IRQ_COUNT];   /* Installed handlers */
+    bool enabled[SIM_IRQ_COUNT];        /* NVIC enable */
+    bool pending[SIM_IRQ_COUNT];        /* NVIC pending */
+    sim_event_t events[SIM_EVENT_MAX];  /* Event queue, binary min-heap */
+    uint32_t eventCount;
+    uint64_t eventSeq;                  /* Events scheduled so far */
+    uint64_t eventsRun;                 /* Events run so far */
+    uint64_t skips;                     /* Time skips of the sleep model */
+    uint32_t isrActive;                 /* Interrupt handler running */
+    uint64_t isrRuns;                   /* Interrupt handlers run */
+    sim_event_fn_t preempt;             /* Called at every step of Active mode
+                                         * code outside interrupts, or NULL */
+    sim_event_fn_t sleepEntry;          /* Called as the CPU sleeps, or NULL */
+    uint32_t tcpwmClockHz;              /* Profiler counter clock, 0 if not clocked */
+    uint32_t tcpwmPeriod;               /* Counter period, in clocks - 1 */
+    bool tcpwmRunning;
+    uint64_t tcpwmNext;                 /* Time of the next terminal count */
+    uint64_t tcpwmLeft;                 /* Cycles to it, while stopped */
+    uint32_t stackedPc;                 /* PC at the last terminal count */
+    uintptr_t busyPc;                   /* Code a time skip in Active mode stands
+                                         * for, or 0 */
+    IRQn_Type isrIrqn;                  /* Interrupt served, if isrActive */
+    void (*activeCycles)(uintptr_t pc, uint64_t cycles); /* Called with the Active
+                                         * cycles of each code site outside the
+                                         * profiler interrupt, or NULL */
+} sim_t;
+
+/* Button press generators of sim_app_run() */
+typedef enum
+{
+    SIM_PRESS_STEADY = 0U,              /* Presses at a constant mean rate */
+    SIM_PRESS_USER                      /* Daily use: sessions, nights, idle days */
+} sim_press_model_t;
+
+/* Parameters of an application core run (scenario 'app') */
+typedef struct
+{
+    uint32_t hours;                     /* Simulated time */
+    uint64_t seed;                      /* Button press trace */
+    sim_press_model_t model;            /* Button press generator */
+    uint32_t hfclkMhz;                  /* HFCLK, see clock_ctrl_set_hfclk() */
+    uint32_t debounceMs;                /* Switch debounce window, 0 for none */
+    uint32_t sleepPress;                /* SLEEP_SWITCH_PRESS */
+    uint32_t deepSleepPress;            /* DEEP_SLEEP_SWITCH_PRESS */
+    uint32_t blinkMs;                   /* BLINK_TIME_MS */
+    void (*setup)(void);                /* Called before pm_init(), or NULL */
+} sim_app_params_t;
+
+/* One simulated day of a run */
+typedef struct
+{
+    sim_energy_t energy;
+    uint32_t wakeups;
+    uint32_t presses;
+} sim_app_day_t;
+
+/* Results of one application core run */
+typedef struct
+{
+    double avgUa;                       /* Average current, default TARGET */
+    double deepSleepPct;                /* Deep Sleep residency */
+    double latencyMeanMs;               /* Press until the main loop sees it */
+    double latencyMaxMs;
+    uint32_t presses;                   /* Button presses */
+    uint32_t counted;                   /* Presses counted by switch_isr */
+    uint32_t wakeups;
+    uint64_t iloTicks;                  /* ILO ticks since pm_init() */
+    uint64_t residencyTicks;            /* Sum of the residency in pm_stats */
+    uint32_t days;                      /* Complete days recorded */
+    sim_app_day_t day[SIM_APP_MAX_DAYS];
+} sim_app_result_t;
+
+/* Totals of a sim_batch_run() */
+typedef struct
+{
+    uint32_t steals;                    /* Tasks taken from another worker */
+    uint32_t failed;                    /* Simulations that did not complete */
+    double wallS;
+    double cpuS;                        /* Sum of the simulation CPU times */
+} sim_batch_stats_t;
+
+/*******************************************************************************
+ * Global variables
+ ******************************************************************************/
+extern sim_t sim;
+extern const sim_kit_t sim_kits[SIM_KIT_COUNT];
+extern uint8_t fuzz_signature[FUZZ_SIGNATURE_BYTES];
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+void sim_reset(void);
+void sim_advance(uint64_t cycles);
+void sim_raise_irq(IRQn_Type irqn);
+void sim_dispatch_irqs(void);
+void sim_schedule(uint64_t at, sim_event_fn_t fn);
+void sim_busy_wait(void);
+void sim_i2c_read(uint32_t offset, uint32_t length);
+double sim_charge_uas(const sim_energy_t *energy, const sim_kit_t *kit);
+void sim_app_run(const sim_app_params_t *params, sim_app_result_t *result);
+bool sim_app_residency_ok(const sim_app_result_t *result);
+bool sim_batch_run(const sim_app_params_t *params, sim_app_result_t *results, bool *done,
+                   uint32_t count, uint32_t jobs, sim_batch_stats_t *stats);
+
+__STATIC_INLINE uint64_t sim_us_to_cycles(uint64_t us)
+{
+    return (us * sim.hfclkHz) / 1000000UL;
+}
+
+/* Virtual time in ms, and the time of an absolute ms for sim_schedule() */
+__STATIC_INLINE uint64_t sim_now_ms(void)
+{
+    return (sim.cycles * 1000U) / sim.hfclkHz;
+}
+
+__STATIC_INLINE uint64_t sim_ms_to_cycles(uint64_t ms)
+{
+    return (ms * sim.hfclkHz) / 1000U;
+}
+
+/* Fuzz target (fuzz_app.c), libFuzzer entry point */
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+/* Scenarios */
+int sim_gpio(int argc, char **argv);
+int sim_clock(int argc, char **argv);
+int sim_supply(int argc, char **argv);
+int sim_pd(int argc, char **argv);
+int sim_wdt(int argc, char **argv);
+int sim_i2c(int argc, char **argv);
+int sim_uart(int argc, char **argv);
+int sim_button(int argc, char **argv);
+int sim_app(int argc, char **argv);
+int sim_sweep(int argc, char **argv);
+int sim_days(int argc, char **argv);
+int sim_trace(int argc, char **argv);
+int sim_fxstat(int argc, char **argv);
+int sim_qhist(int argc, char **argv);
+int sim_seqlock(int argc, char **argv);
+int sim_prof(int argc, char **argv);
+int sim_cyccnt(int argc, char **argv);
+int sim_bench(int argc, char **argv);
+int sim_defer(int argc, char **argv);
+int sim_pool(int argc, char **argv);
+int sim_wake(int argc, char **argv);
+
+#endif /* SIM_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,466 @@
+/******************************************************************************
+* File Name: sim_app.c
+*
+* Description: Scenario 'app': runs the application core (app.c) as the
+*              firmware main loop does, with its tunables and HFCLK as
+*              run-time parameters, so the sweep runner (sim_sweep.c) can
+*              explore combinations of them. Button presses arrive at
+*              random, each followed by contact bounce edges: either at a
+*              steady mean rate, or from a model of daily use (sessions of
+*              presses during waking hours, nights and idle days) for the
+*              per-day statistics of scenario 'days'.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "sim.h"
+#include "cybsp.h"
+#include "pm_module.h"
+#include "pm_stats.h"
+#include "app.h"
+#include "clock_ctrl.h"
+#include "supply_mon.h"
+#include "wdt_svc.h"
+#include "defer.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+#define SIM_APP_PRESS_MEAN_MS   (2.0 * 60000.0)     /* Mean time between presses */
+#define SIM_APP_HOLD_MS         (150U)              /* Press duration */
+#define SIM_APP_BOUNCE_MAX      (3U)                /* Bounce edges per press */
+#define SIM_APP_BOUNCE_MS       (8U)                /* Bounce edges within */
+
+/* Daily use model (SIM_PRESS_USER). Times between sessions and between the
+ * presses of a session are log-normal: median and sigma of the logarithm. */
+#define SIM_APP_DAY_MS          (24U * 3600000U)
+#define SIM_USER_WAKE_H         (7.0)               /* Start of the waking hours */
+#define SIM_USER_WAKE_SPREAD_H  (2.0)               /* ... drawn within */
+#define SIM_USER_AWAKE_H        (16.0)              /* Length of the waking hours */
+#define SIM_USER_IDLE_DAY       (0.15)              /* Share of days without use */
+#define SIM_USER_SESSION_MS     (45.0 * 60000.0)    /* Between sessions, median */
+#define SIM_USER_SESSION_SIGMA  (1.2)
+#define SIM_USER_PRESSES_MEAN   (3.0)               /* Presses per session */
+#define SIM_USER_PRESS_MS       (1500.0)            /* Within a session, median */
+#define SIM_USER_PRESS_SIGMA    (0.8)
+#define SIM_USER_HOLD_MIN_MS    (80U)               /* Press duration, uniform */
+#define SIM_USER_HOLD_MAX_MS    (300U)
+#define SIM_USER_BOUNCE_MAX     (5U)                /* Worn contacts bounce more */
+#define SIM_USER_BOUNCE_MS      (10U)
+
+/* Phases the application module skips outside of sim_app_run(): all. The
+ * button interrupt is installed by sim_app_run() too, not by pm_init(). */
+#define SIM_APP_SKIP_ALL        (CY_SYSPM_SKIP_CHECK_READY | CY_SYSPM_SKIP_CHECK_FAIL | \
+                                 CY_SYSPM_SKIP_BEFORE_TRANSITION | CY_SYSPM_SKIP_AFTER_TRANSITION)
+
+/*******************************************************************************
+ * Global variables
+ ******************************************************************************/
+static sim_app_params_t params;
+static uint64_t endMs;
+static uint64_t rngState;
+static sim_app_result_t *result;
+
+/* Daily use model */
+static uint32_t sessionLeft;                /* Presses left in the session */
+static uint64_t useDay;                     /* Next day to draw */
+static uint64_t useStartMs;                 /* Waking hours of the current day */
+static uint64_t useEndMs;
+
+/* Totals at the start of the current day */
+static sim_energy_t dayEnergy;
+static uint32_t dayWakeups;
+static uint32_t dayPresses;
+
+/* The application instance, bound to sim_app_module as main.c binds its own */
+static app_ctx_t app = { .pmSkip = SIM_APP_SKIP_ALL };
+
+/* Measurements */
+static uint32_t presses;
+static uint32_t counted;
+static uint32_t seen;
+static bool pressPending;
+static uint64_t pressCycles;
+static double latencySumMs;
+static double latencyMaxMs;
+static uint32_t latencies;
+
+static double sim_app_uniform(void)
+{
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 7;
+    rngState ^= rngState << 17;
+    return ((double)(rngState >> 11) + 0.5) / 9007199254740992.0;
+}
+
+/* Log-normal with the given median */
+static double sim_app_lognormal(double median, double sigma)
+{
+    /* Box-Muller */
+    double n = sqrt(-2.0 * log(sim_app_uniform())) * cos(6.283185307179586 * sim_app_uniform());
+
+    return median * exp(sigma * n);
+}
+
+/*******************************************************************************
+ * Function Name: sim_app_in_use
+ *******************************************************************************
+ *
+ * Summary:
+ *  Moves the time of a session start out of the night: to a random time in
+ *  the first hour of the next waking hours, skipping idle days.
+ *
+ * Parameters:
+ *  ms: Proposed session start.
+ *
+ * Return:
+ *  Session start.
+ *
+ ******************************************************************************/
+static uint64_t sim_app_in_use(uint64_t ms)
+{
+    while (ms >= useEndMs)
+    {
+        useStartMs = (useDay * SIM_APP_DAY_MS) +
+                     (uint64_t)((SIM_USER_WAKE_H + (SIM_USER_WAKE_SPREAD_H * sim_app_uniform())) * 3600000.0);
+        useEndMs = useStartMs + (uint64_t)(SIM_USER_AWAKE_H * 3600000.0);
+        useDay++;
+        if (sim_app_uniform() < SIM_USER_IDLE_DAY)
+        {
+            ms = (ms > useStartMs) ? ms : useStartMs;
+            useEndMs = useStartMs;
+        }
+        else if (ms < useStartMs)
+        {
+            ms = useStartMs + (uint64_t)(sim_app_uniform() * 3600000.0);
+        }
+    }
+
+    return ms;
+}
+
+/* Time of the next press, from the release of the current one */
+static uint64_t sim_app_next_press(uint64_t releaseMs)
+{
+    if (params.model == SIM_PRESS_STEADY)
+    {
+        return releaseMs + (uint64_t)(-SIM_APP_PRESS_MEAN_MS * log(sim_app_uniform()));
+    }
+
+    if (sessionLeft > 0U)
+    {
+        sessionLeft--;
+        return releaseMs + (uint64_t)sim_app_lognormal(SIM_USER_PRESS_MS, SIM_USER_PRESS_SIGMA);
+    }
+
+    /* Geometric number of presses in the next session, at least one */
+    sessionLeft = (uint32_t)(log(sim_app_uniform()) / log(1.0 - (1.0 / SIM_USER_PRESSES_MEAN)));
+    return sim_app_in_use(releaseMs + (uint64_t)sim_app_lognormal(SIM_USER_SESSION_MS,
+                                                                  SIM_USER_SESSION_SIGMA));
+}
+
+/* One falling edge on the button pin */
+static void sim_app_edge(void)
+{
+    CYBSP_USER_BTN_PORT->PS &= ~(1UL << CYBSP_USER_BTN_NUM);
+    sim_raise_irq(CYBSP_USER_BTN_IRQ);
+}
+
+static void sim_app_release(void)
+{
+    CYBSP_USER_BTN_PORT->PS |= 1UL << CYBSP_USER_BTN_NUM;
+}
+
+/*******************************************************************************
+ * Function Name: sim_app_press
+ *******************************************************************************
+ *
+ * Summary:
+ *  Button press: a falling edge, followed by contact bounce edges. Schedules
+ *  the bounce edges, the release and the next press.
+ *
+ ******************************************************************************/
+static void sim_app_press(void)
+{
+    bool user = (params.model == SIM_PRESS_USER);
+    uint64_t now = sim_now_ms();
+    uint32_t bounceMax = user ? SIM_USER_BOUNCE_MAX : SIM_APP_BOUNCE_MAX;
+    uint32_t bounceMs = user ? SIM_USER_BOUNCE_MS : SIM_APP_BOUNCE_MS;
+    uint32_t holdMs = user ? (SIM_USER_HOLD_MIN_MS + (uint32_t)(sim_app_uniform() *
+                              (SIM_USER_HOLD_MAX_MS - SIM_USER_HOLD_MIN_MS))) : SIM_APP_HOLD_MS;
+    uint32_t bounces = (uint32_t)(sim_app_uniform() * (bounceMax + 1U));
+    uint32_t i;
+
+    presses++;
+    if (!pressPending)
+    {
+        pressPending = true;
+        pressCycles = sim.cycles;
+    }
+    sim_app_edge();
+
+    for (i = 0U; i < bounces; i++)
+    {
+        sim_schedule(sim_ms_to_cycles(now + 1U + (uint64_t)(sim_app_uniform() * bounceMs)),
+                     sim_app_edge);
+    }
+    sim_schedule(sim_ms_to_cycles(now + holdMs), sim_app_release);
+    sim_schedule(sim_ms_to_cycles(sim_app_next_press(now + holdMs)), sim_app_press);
+}
+
+/* Day boundary: records the day, up to the days of the run */
+static void sim_app_day_end(void)
+{
+    sim_app_day_t *day = &result->day[result->days];
+    uint32_t i;
+
+    for (i = 0U; i < SIM_MODE_COUNT; i++)
+    {
+        day->energy.modeS[i] = sim.energy.modeS[i] - dayEnergy.modeS[i];
+    }
+    day->energy.activeLoadS = sim.energy.activeLoadS - dayEnergy.activeLoadS;
+    day->wakeups = sim.wakeups - dayWakeups;
+    day->presses = presses - dayPresses;
+    dayEnergy = sim.energy;
+    dayWakeups = sim.wakeups;
+    dayPresses = presses;
+
+    result->days++;
+    if ((result->days < SIM_APP_MAX_DAYS) &&
+        (((uint64_t)(result->days + 1U) * SIM_APP_DAY_MS) <= endMs))
+    {
+        sim_schedule(sim_ms_to_cycles((uint64_t)(result->days + 1U) * SIM_APP_DAY_MS), sim_app_day_end);
+    }
+}
+
+/* The main loop looked at the press count: a press counted since it last
+ * looked has been seen */
+static void sim_app_observe(void)
+{
+    double ms;
+
+    counted = app.presses;
+    if ((counted != seen) && pressPending)
+    {
+        ms = ((double)(sim.cycles - pressCycles) * 1000.0) / sim.hfclkHz;
+        latencySumMs += ms;
+        latencyMaxMs = (ms > latencyMaxMs) ? ms : latencyMaxMs;
+        latencies++;
+        pressPending = false;
+    }
+    seen = counted;
+}
+
+/* Runs after the press queued before it: the main loop has just counted it */
+static void sim_app_counted(void *arg, uint32_t data)
+{
+    (void) arg;
+    (void) data;
+    sim_app_observe();
+}
+
+/* switch_isr() of main.c. The instance counts the presses it accepts in the
+ * main loop, from the deferred work queue; a probe queued behind each edge
+ * sees them counted. */
+static void sim_app_isr(void)
+{
+    app_switch_isr(&app);
+    (void) defer_post(sim_app_counted, NULL, 0U);
+}
+
+/* app_pm_callback() of main.c */
+static cy_en_syspm_status_t sim_app_callback(cy_en_syspm_callback_type_t type,
+                                             cy_en_syspm_callback_mode_t mode)
+{
+    return app_pm_event(&app, type, mode);
+}
+
+static bool sim_app_work_pending(void)
+{
+    return app_work_pending(&app);
+}
+
+PM_MODULE_DEFINE(sim_app_module, PM_PRIORITY_DEFAULT,
+    .callback = sim_app_callback,
+    .types    = PM_TYPE_ALL,
+    .skipMode = &app.pmSkip,
+    .workPending = sim_app_work_pending);
+
+/*******************************************************************************
+ * Function Name: sim_app_run
+ *******************************************************************************
+ *
+ * Summary:
+ *  Runs the application core. Module state is not reset between runs: the
+ *  sweep runner calls it once per process. The run ends at the first main
+ *  loop iteration after the simulated time; the days complete within the
+ *  simulated time are recorded, up to SIM_APP_MAX_DAYS.
+ *
+ * Parameters:
+ *  p: Model parameters.
+ *  result: Returns the results.
+ *
+ ******************************************************************************/
+void sim_app_run(const sim_app_params_t *p, sim_app_result_t *r)
+{
+    static const cy_stc_sysint_t switchIntr = { CYBSP_USER_BTN_IRQ, 3U };
+    app_config_t config = APP_CONFIG_DEFAULT;
+    uint32_t wakeups;
+    uint64_t iloStart;
+    uint32_t mode;
+
+    params = *p;
+    result = r;
+    result->days = 0U;
+    endMs = (uint64_t)params.hours * 3600000U;
+    /* splitmix64 of the seed, so small seeds give well mixed xorshift states */
+    rngState = params.seed + 0x9E3779B97F4A7C15ULL;
+    rngState = (rngState ^ (rngState >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    rngState = (rngState ^ (rngState >> 27)) * 0x94D049BB133111EBULL;
+    rngState ^= rngState >> 31;
+    rngState = (rngState == 0U) ? 1U : rngState;
+
+    sim_reset();
+    (void) cybsp_init();
+    config.sleepPress = (int16_t)params.sleepPress;
+    config.deepSleepPress = (int16_t)params.deepSleepPress;
+    config.blinkTimeMs = params.blinkMs;
+    config.debounceMs = params.debounceMs;
+    app_init(&app, &config, &sim_app_module);
+    (void) Cy_SysInt_Init(&switchIntr, sim_app_isr);
+    NVIC_EnableIRQ(switchIntr.intrSrc);
+    if (params.setup != NULL)
+    {
+        params.setup();
+    }
+    iloStart = sim.iloTicks;
+    (void) pm_init();
+    (void) clock_ctrl_set_hfclk(params.hfclkMhz);
+    __enable_irq();
+    sim_schedule(sim_ms_to_cycles(sim_app_next_press(0U)), sim_app_press);
+    if (SIM_APP_DAY_MS <= endMs)
+    {
+        sim_schedule(sim_ms_to_cycles(SIM_APP_DAY_MS), sim_app_day_end);
+    }
+
+    /* The main loop of main.c */
+    while (sim_now_ms() < endMs)
+    {
+        wakeups = sim.wakeups;
+        sim_app_observe();
+        app_step(&app);
+        sim_app_observe();
+        if (sim.wakeups == wakeups)
+        {
+            /* Nothing to do in Active mode: the loop spins until an interrupt */
+            sim_busy_wait();
+        }
+    }
+    app.pmSkip = SIM_APP_SKIP_ALL;
+
+    result->avgUa = sim_charge_uas(&sim.energy, &sim_kits[0]) / ((double)sim.cycles / sim.hfclkHz);
+    result->deepSleepPct = (100.0 * sim.modeCycles[SIM_MODE_DEEPSLEEP]) / sim.cycles;
+    result->latencyMeanMs = (latencies != 0U) ? (latencySumMs / latencies) : 0.0;
+    result->latencyMaxMs = latencyMaxMs;
+    result->presses = presses;
+    result->counted = counted;
+    result->wakeups = sim.wakeups;
+
+    /* One more transition closes the residency record, which then holds
+     * every ILO tick since pm_init() across the 32-bit wraps of each mode */
+    (void) pm_enter(CY_SYSPM_SLEEP);
+    result->iloTicks = sim.iloTicks - iloStart;
+    result->residencyTicks = 0U;
+    for (mode = 0U; mode < PM_STATS_MODES; mode++)
+    {
+        result->residencyTicks += pm_stats_residency_ticks(&pm_stats, mode);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: sim_app_residency_ok
+ *******************************************************************************
+ *
+ * Summary:
+ *  Checks the residency in pm_stats against the simulated time of a run: it
+ *  may miss at most SIM_APP_RESIDENCY_SLACK ticks after the last transition.
+ *
+ ******************************************************************************/
+bool sim_app_residency_ok(const sim_app_result_t *result)
+{
+    return (result->residencyTicks <= result->iloTicks) &&
+           ((result->iloTicks - result->residencyTicks) <= SIM_APP_RESIDENCY_SLACK);
+}
+
+/*******************************************************************************
+ * Function Name: sim_app
+ *******************************************************************************
+ *
+ * Summary:
+ *  Scenario entry: sim app [hours] [blink_ms] [debounce_ms] [hfclk_mhz]
+ *
+ ******************************************************************************/
+int sim_app(int argc, char **argv)
+{
+    sim_app_params_t p = { 6U, 1U, SIM_PRESS_STEADY, 48U, 0U, 1U, 3U, 200U, NULL };
+    sim_app_result_t r;
+
+    p.hours = (argc > 0) ? (uint32_t)strtoul(argv[0], NULL, 0) : p.hours;
+    p.blinkMs = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : p.blinkMs;
+    p.debounceMs = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 0) : p.debounceMs;
+    p.hfclkMhz = (argc > 3) ? (uint32_t)strtoul(argv[3], NULL, 0) : p.hfclkMhz;
+    p.hours = (p.hours != 0U) ? p.hours : 6U;
+
+    sim_app_run(&p, &r);
+
+    printf("%lu h at %lu MHz, blink %lu ms, debounce %lu ms: %lu presses, %lu counted, %lu wakeups\n",
+           (unsigned long)p.hours, (unsigned long)p.hfclkMhz, (unsigned long)p.blinkMs,
+           (unsigned long)p.debounceMs, (unsigned long)r.presses, (unsigned long)r.counted,
+           (unsigned long)r.wakeups);
+    printf("average current %.1f uA, Deep Sleep %.2f %%\n", r.avgUa, r.deepSleepPct);
+    printf("press to main loop: mean %.1f ms, max %.1f ms\n", r.latencyMeanMs, r.latencyMaxMs);
+    printf("residency in pm_stats: %llu of %llu ILO ticks, %s\n", (unsigned long long)r.residencyTicks,
+           (unsigned long long)r.iloTicks, sim_app_residency_ok(&r) ? "ok" : "off");
+
+    return sim_app_residency_ok(&r) ? 0 : 1;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,166 @@
+/******************************************************************************
+* File Name: sim_bench.c
+*
+* Description: Microbenchmark scenario. Runs the benchmark harness of the
+*              microbench firmware (microbench.c) on the simulator, prints
+*              its UART report, and checks every result against the cycle
+*              costs the simulator charges for the primitives.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include "sim.h"
+#include "microbench.h"
+#include "pm_module.h"
+
+/*******************************************************************************
+ * Function Name: sim_bench_walk
+ *******************************************************************************
+ *
+ * Summary:
+ *  Cycles the simulator charges for the callback walk of a Deep Sleep entry
+ *  when every module is ready: each phase visits each module, and calls
+ *  those that take part in Deep Sleep and do not skip the phase.
+ *  pm_check() walks CHECK_READY and CHECK_FAIL; a transition walks
+ *  CHECK_READY, BEFORE_TRANSITION and AFTER_TRANSITION.
+ *
+ ******************************************************************************/
+static uint32_t sim_bench_walk(const uint8_t *phases, uint32_t count, bool skips)
+{
+    const pm_module_t *module;
+    uint32_t cycles = 0U;
+    uint32_t m;
+    uint32_t i;
+
+    for (m = 0U; m < PM_TABLE_COUNT; m++)
+    {
+        module = PM_TABLE_MODULE(m);
+        for (i = 0U; i < count; i++)
+        {
+            if ((module->callback != NULL) &&
+                ((module->types & (1UL << (uint32_t)CY_SYSPM_DEEPSLEEP)) != 0U) &&
+                (!skips || (module->skipMode == NULL) || ((*module->skipMode & phases[i]) == 0U)))
+            {
+                cycles += SIM_CYCLES_PM_CALLBACK;
+            }
+            else
+            {
+                cycles += SIM_CYCLES_PM_SKIP;
+            }
+        }
+    }
+
+    return cycles;
+}
+
+/*******************************************************************************
+ * Function Name: sim_bench
+ *******************************************************************************
+ *
+ * Summary:
+ *  Scenario entry: sim bench [runs]
+ *
+ ******************************************************************************/
+int sim_bench(int argc, char **argv)
+{
+    static const uint8_t checkPhases[2] = { CY_SYSPM_SKIP_CHECK_READY, CY_SYSPM_SKIP_CHECK_FAIL };
+    static const uint8_t entryPhases[3] =
+    {
+        CY_SYSPM_SKIP_CHECK_READY, CY_SYSPM_SKIP_BEFORE_TRANSITION, CY_SYSPM_SKIP_AFTER_TRANSITION
+    };
+
+    /* Cycles per operation the simulator charges; the callback walk depends
+     * on the modules linked in and their skip modes */
+    uint32_t model[MICROBENCH_COUNT] =
+    {
+        [MICROBENCH_GPIO_WRITE]  = SIM_CYCLES_GPIO_WRITE,
+        [MICROBENCH_GPIO_CLEAR]  = SIM_CYCLES_GPIO_CLEAR,
+        [MICROBENCH_SLEEP]       = SIM_CYCLES_SLEEP_ENTRY + SIM_CYCLES_SLEEP_EXIT,
+        [MICROBENCH_PM_WALK]     = 0U,
+        [MICROBENCH_PM_WALK_ALL] = 0U,
+        [MICROBENCH_UART_BYTE]   = SIM_CYCLES_UART_BYTE,
+    };
+    uint32_t runs = (argc > 0) ? (uint32_t)strtoul(argv[0], NULL, 0) : MICROBENCH_RUNS;
+    const microbench_result_t *result;
+    uint32_t id;
+    uint32_t off = 0U;
+
+    runs = (runs != 0U) ? runs : MICROBENCH_RUNS;
+
+    sim_reset();
+    (void) pm_init();
+    __enable_irq();
+
+    /* The main loop of the benchmark firmware reports alive between runs;
+     * here a long run holds it */
+    Cy_WDT_Disable();
+
+    microbench_run(runs);
+    model[MICROBENCH_PM_WALK] = sim_bench_walk(checkPhases, 2U, true);
+    model[MICROBENCH_PM_WALK_ALL] = sim_bench_walk(checkPhases, 2U, false);
+
+    /* The report, as the benchmark firmware sends it */
+    sim.uartCapture = stdout;
+    microbench_report();
+    (void) fflush(stdout);
+    sim.uartCapture = NULL;
+
+    for (id = 0U; id < (uint32_t)MICROBENCH_COUNT; id++)
+    {
+        result = microbench_result((microbench_id_t)id);
+        if ((result->probe.count != runs) || (result->probe.invalid != 0U) ||
+            (result->probe.min != result->probe.max) || (result->probe.min != (model[id] * result->ops)))
+        {
+            printf("%s: %lu spans, %lu to %lu cycles, model %lu\n", result->name,
+                   (unsigned long)result->probe.count, (unsigned long)result->probe.min,
+                   (unsigned long)result->probe.max, (unsigned long)model[id]);
+            off++;
+        }
+    }
+    printf("%lu of %u primitives off the simulator cost model\n", (unsigned long)off,
+           (unsigned)MICROBENCH_COUNT);
+    printf("Deep Sleep entry, callback walk: %lu cycles with the skip masks, %lu without\n",
+           (unsigned long)sim_bench_walk(entryPhases, 3U, true),
+           (unsigned long)sim_bench_walk(entryPhases, 3U, false));
+
+    return (off == 0U) ? 0 : 1;
+}
+
+/* [] END OF FILE */
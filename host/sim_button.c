@@ -0,0 +1,183 @@
+/******************************************************************************
+* File Name: sim_button.c
+*
+* Description: Scenario 'button': days of User button presses with Deep Sleep
+*              in between, to show the speed of the discrete-event core. The
+*              presses arrive at random; each one raises the button GPIO
+*              interrupt, which wakes the device.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include "sim.h"
+#include "cybsp.h"
+#include "pm_module.h"
+#include "wdt_svc.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+#define SIM_BUTTON_MEAN_MS      (20.0 * 60000.0)    /* Mean time between presses */
+#define SIM_BUTTON_HOLD_MS      (150U)              /* Press duration */
+
+/*******************************************************************************
+ * Global variables
+ ******************************************************************************/
+static uint64_t endMs;
+static uint64_t rngState;
+static uint32_t presses;
+static uint32_t served;
+static bool pressed;
+
+static double sim_button_uniform(void)
+{
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 7;
+    rngState ^= rngState << 17;
+    return ((double)(rngState >> 11) + 0.5) / 9007199254740992.0;
+}
+
+/* Wakes the device to end the run */
+static void sim_button_end(void)
+{
+    sim_raise_irq(CYBSP_USER_BTN_IRQ);
+}
+
+/* Button released: the pin goes high again, no interrupt (falling edge) */
+static void sim_button_release(void)
+{
+    CYBSP_USER_BTN_PORT->PS |= 1UL << CYBSP_USER_BTN_NUM;
+}
+
+/*******************************************************************************
+ * Function Name: sim_button_press
+ *******************************************************************************
+ *
+ * Summary:
+ *  Button press: the pin goes low and raises the GPIO interrupt. Schedules
+ *  the release and the next press.
+ *
+ ******************************************************************************/
+static void sim_button_press(void)
+{
+    uint64_t now = sim_now_ms();
+    uint64_t next = now + SIM_BUTTON_HOLD_MS + (uint64_t)(-SIM_BUTTON_MEAN_MS * log(sim_button_uniform()));
+
+    presses++;
+    pressed = true;
+    CYBSP_USER_BTN_PORT->PS &= ~(1UL << CYBSP_USER_BTN_NUM);
+    sim_raise_irq(CYBSP_USER_BTN_IRQ);
+
+    sim_schedule(sim_ms_to_cycles(now + SIM_BUTTON_HOLD_MS), sim_button_release);
+    if (next < endMs)
+    {
+        sim_schedule(sim_ms_to_cycles(next), sim_button_press);
+    }
+    else
+    {
+        sim_schedule(sim_ms_to_cycles(endMs), sim_button_end);
+    }
+}
+
+static void sim_button_isr(void)
+{
+    Cy_GPIO_ClearInterrupt(CYBSP_USER_BTN_PORT, CYBSP_USER_BTN_NUM);
+    if (pressed)
+    {
+        pressed = false;
+        served++;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: sim_button
+ *******************************************************************************
+ *
+ * Summary:
+ *  Scenario entry: sim button [days] [seed]
+ *
+ ******************************************************************************/
+int sim_button(int argc, char **argv)
+{
+    static const cy_stc_sysint_t buttonIntr = { CYBSP_USER_BTN_IRQ, 3U };
+    uint32_t days = (argc > 0) ? (uint32_t)strtoul(argv[0], NULL, 0) : 30U;
+    clock_t start;
+    double hostS;
+    double simS;
+
+    rngState = (argc > 1) ? strtoull(argv[1], NULL, 0) : 1U;
+    rngState = (rngState == 0U) ? 1U : rngState;
+    days = (days != 0U) ? days : 30U;
+    endMs = (uint64_t)days * 24U * 3600000U;
+
+    start = clock();
+    sim_reset();
+    (void) cybsp_init();
+    (void) Cy_SysInt_Init(&buttonIntr, sim_button_isr);
+    NVIC_EnableIRQ(buttonIntr.intrSrc);
+    (void) pm_init();
+    __enable_irq();
+    sim_schedule(sim_ms_to_cycles((uint64_t)(-SIM_BUTTON_MEAN_MS * log(sim_button_uniform()))),
+                 sim_button_press);
+
+    while (sim_now_ms() < endMs)
+    {
+        wdt_svc_kick();
+        if (pm_enter(CY_SYSPM_DEEPSLEEP) == CY_SYSPM_FAIL)
+        {
+            (void) pm_enter(CY_SYSPM_SLEEP);
+        }
+    }
+    hostS = (double)(clock() - start) / CLOCKS_PER_SEC;
+    simS = (double)sim.cycles / sim.hfclkHz;
+
+    printf("simulated %lu days: %lu presses, %lu served, %lu wakeups, Deep Sleep %.3f %%\n",
+           (unsigned long)days, (unsigned long)presses, (unsigned long)served, (unsigned long)sim.wakeups,
+           100.0 * sim.modeCycles[SIM_MODE_DEEPSLEEP] / sim.cycles);
+    printf("events %llu, time skips %llu (a 100 us tick model steps %.3g times)\n",
+           (unsigned long long)sim.eventsRun, (unsigned long long)sim.skips, simS * 1e4);
+    printf("host time %.2f s, %.0fx faster than real time\n", hostS, simS / ((hostS > 0.0) ? hostS : 1e-6));
+
+    return (served == presses) ? 0 : 1;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,135 @@
+/******************************************************************************
+* File Name: sim_clock.c
+*
+* Description: Scenario 'clock': steps HFCLK through its operating points
+*              with clock_ctrl_set_hfclk() and compares the cycles per
+*              instruction with tuned flash wait states against wait states
+*              left at the 48 MHz setting.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdio.h>
+#include "sim.h"
+#include "clock_ctrl.h"
+#include "pm_module.h"
+
+/*******************************************************************************
+ * Global variables
+ ******************************************************************************/
+static uint32_t notifiedHz;
+
+/* Stands in for a module with clock dependent peripherals */
+static void sim_clock_changed(uint32_t hfclkHz)
+{
+    notifiedHz = hfclkHz;
+}
+
+PM_MODULE_DEFINE(sim_clock_module, PM_PRIORITY_DEFAULT,
+    .clockChanged = sim_clock_changed);
+
+/*******************************************************************************
+ * Function Name: sim_clock
+ *******************************************************************************
+ *
+ * Summary:
+ *  Scenario entry: sim clock
+ *
+ ******************************************************************************/
+int sim_clock(int argc, char **argv)
+{
+    static const uint32_t points[] = { 48U, 40U, 32U, 24U, 16U, 12U, 8U, 6U, 4U, 3U, 48U };
+    uint32_t staleWs;
+    uint32_t hfclkHz;
+    uint32_t waitStates;
+    clock_ctrl_uart_t uart;
+    bool holds;
+    bool kept;
+    int result = 0;
+    uint32_t i;
+    double cpiTuned;
+    double cpiStale;
+
+    (void) argc;
+    (void) argv;
+
+    sim_reset();
+    staleWs = sim.waitStates;
+
+    printf("%6s %4s %8s %8s %4s %8s %8s %4s %5s %7s  %s\n", "MHz", "WS", "CPI", "MIPS",
+           "WS48", "CPI48", "MIPS48", "OVS", "div", "baud %", "notified");
+    for (i = 0U; i < (sizeof(points) / sizeof(points[0])); i++)
+    {
+        /* The UART setting the frequency needs: refused unless it holds */
+        notifiedHz = 0U;
+        holds = clock_ctrl_uart_clock(points[i] * 1000000UL, CLOCK_CTRL_UART_BAUD, &uart);
+        if (clock_ctrl_set_hfclk(points[i]) != CY_SYSCLK_SUCCESS)
+        {
+            printf("%6lu refused, best UART setting %lu x %lu off by %.2f %%\n", (unsigned long)points[i],
+                   (unsigned long)uart.ovs, (unsigned long)uart.div, uart.errorPpm / 10000.0);
+            result |= holds ? 1 : 0;
+            continue;
+        }
+        result |= holds ? 0 : 1;
+
+        cpiTuned = SIM_CPI_BASE + (SIM_FETCH_PER_INSN * sim.waitStates);
+        cpiStale = SIM_CPI_BASE + (SIM_FETCH_PER_INSN * staleWs);
+        printf("%6lu %4lu %8.2f %8.2f %4lu %8.2f %8.2f %4lu %5lu %7.2f  %s\n",
+               (unsigned long)(sim.hfclkHz / 1000000UL), (unsigned long)sim.waitStates,
+               cpiTuned, (sim.hfclkHz / 1e6) / cpiTuned,
+               (unsigned long)staleWs, cpiStale, (sim.hfclkHz / 1e6) / cpiStale,
+               (unsigned long)uart.ovs, (unsigned long)uart.div, uart.errorPpm / 10000.0,
+               ((notifiedHz == sim.hfclkHz) && (SystemCoreClock == sim.hfclkHz)) ? "yes" : "NO");
+    }
+
+    /* An IMO change that fails leaves the clock, the wait states and the
+     * modules as they were */
+    (void) clock_ctrl_set_hfclk(12U);
+    hfclkHz = sim.hfclkHz;
+    waitStates = sim.waitStates;
+    notifiedHz = 0U;
+    sim.imoFail = true;
+    kept = (clock_ctrl_set_hfclk(40U) != CY_SYSCLK_SUCCESS) && (sim.hfclkHz == hfclkHz) &&
+           (sim.waitStates == waitStates) && (SystemCoreClock == hfclkHz) && (notifiedHz == 0U);
+    printf("IMO change refused at %lu MHz: clock %s\n", (unsigned long)(hfclkHz / 1000000UL),
+           kept ? "kept" : "CHANGED");
+
+    return kept ? result : 1;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,247 @@
+/******************************************************************************
+* File Name: sim_cyccnt.c
+*
+* Description: Cycle counter scenario. Times random spans, from one cycle to
+*              tens of seconds, with the cyccnt.h probes: with interrupts
+*              enabled, so the SysTick wrap interrupts land inside them; with
+*              interrupts masked across a wrap; and across Sleep and Deep
+*              Sleep. Every valid span must equal the simulated time exactly.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "sim.h"
+#include "cybsp.h"
+#include "cyccnt.h"
+#include "pm_module.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+#define SIM_CYCCNT_SPANS        (20000UL)
+
+/* Longest span: 2^31 cycles, 44.7 s at 48 MHz */
+#define SIM_CYCCNT_MAX_LOG2     (31U)
+
+/* Sleep of a span across a transition: up to 2 s, several SysTick periods */
+#define SIM_CYCCNT_SLEEP_MAX_MS (2000U)
+
+/* Span kinds */
+#define SIM_CYCCNT_OPEN         (0U)    /* Interrupts enabled */
+#define SIM_CYCCNT_MASKED       (1U)    /* Interrupts masked */
+#define SIM_CYCCNT_SLEEP        (2U)    /* Across Sleep or Deep Sleep */
+#define SIM_CYCCNT_KINDS        (3U)
+
+/*******************************************************************************
+ * Global variables
+ ******************************************************************************/
+static uint64_t rngState;
+
+static const cy_stc_sysint_t wakeIntr = { CYBSP_USER_BTN_IRQ, 3U };
+
+static double sim_cyccnt_uniform(void)
+{
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 7;
+    rngState ^= rngState << 17;
+    return ((double)(rngState >> 11) + 0.5) / 9007199254740992.0;
+}
+
+/* Log-uniform span length from 1 to 2^bits cycles */
+static uint64_t sim_cyccnt_length(uint32_t bits)
+{
+    return (uint64_t)exp2(sim_cyccnt_uniform() * bits);
+}
+
+/* Wake source of the spans across a transition */
+static void sim_cyccnt_wake(void)
+{
+    sim_raise_irq(CYBSP_USER_BTN_IRQ);
+}
+
+static void sim_cyccnt_wake_isr(void)
+{
+}
+
+/*******************************************************************************
+ * Function Name: sim_cyccnt
+ *******************************************************************************
+ *
+ * Summary:
+ *  Scenario entry: sim cyccnt [spans] [seed]
+ *
+ ******************************************************************************/
+int sim_cyccnt(int argc, char **argv)
+{
+    static const char *kindNames[SIM_CYCCNT_KINDS] = { "interrupts on", "masked", "across sleep" };
+    uint32_t spans = (argc > 0) ? (uint32_t)strtoul(argv[0], NULL, 0) : SIM_CYCCNT_SPANS;
+    cyccnt_probe_t probe[SIM_CYCCNT_KINDS] = { CYCCNT_PROBE_INIT, CYCCNT_PROBE_INIT, CYCCNT_PROBE_INIT };
+    uint32_t exact[SIM_CYCCNT_KINDS] = { 0U };
+    uint32_t spansOf[SIM_CYCCNT_KINDS] = { 0U };
+    uint32_t crossed[SIM_CYCCNT_KINDS] = { 0U };
+    uint32_t refused = 0U;
+    uint32_t early = 0U;
+    uint64_t wraps;
+    uint64_t sum;
+    uint64_t start;
+    uint64_t expected;
+    uint64_t length;
+    uint64_t wakeAt;
+    cy_en_syspm_status_t status;
+    uint32_t kind;
+    uint32_t invalid;
+    uint32_t i;
+    double r;
+    int result = 0;
+
+    /* splitmix64 of the seed, so small seeds give well mixed xorshift states */
+    rngState = (argc > 1) ? strtoull(argv[1], NULL, 0) : 1U;
+    rngState += 0x9E3779B97F4A7C15ULL;
+    rngState = (rngState ^ (rngState >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    rngState = (rngState ^ (rngState >> 27)) * 0x94D049BB133111EBULL;
+    rngState ^= rngState >> 31;
+    rngState = (rngState == 0U) ? 1U : rngState;
+    spans = (spans != 0U) ? spans : SIM_CYCCNT_SPANS;
+
+    sim_reset();
+    (void) pm_init();
+    (void) Cy_SysInt_Init(&wakeIntr, sim_cyccnt_wake_isr);
+    NVIC_EnableIRQ(wakeIntr.intrSrc);
+    __enable_irq();
+
+    /* The spans hold the main loop far longer than the watchdog allows */
+    Cy_WDT_Disable();
+
+    for (i = 0U; i < spans; i++)
+    {
+        r = sim_cyccnt_uniform();
+        kind = (r < 0.0625) ? SIM_CYCCNT_SLEEP : ((r < 0.25) ? SIM_CYCCNT_MASKED : SIM_CYCCNT_OPEN);
+        spansOf[kind]++;
+        sum = probe[kind].sum;
+        invalid = probe[kind].invalid;
+        wraps = sim.systickWraps;
+
+        if (kind == SIM_CYCCNT_OPEN)
+        {
+            length = sim_cyccnt_length(SIM_CYCCNT_MAX_LOG2);
+            CYCCNT_BEGIN(probe[kind]);
+            start = sim.systickRead;
+            sim_advance(length);
+        }
+        else if (kind == SIM_CYCCNT_MASKED)
+        {
+            /* At most one wrap can be pending: shorter than a SysTick period,
+             * with room for the probe */
+            length = sim_cyccnt_length(CYCCNT_SYSTICK_BITS) % (CYCCNT_SYSTICK_MASK - (4U * SIM_CYCLES_CYCCNT_NOW));
+            __disable_irq();
+            CYCCNT_BEGIN(probe[kind]);
+            start = sim.systickRead;
+            sim_advance(length);
+        }
+        else
+        {
+            wakeAt = sim.cycles + sim_cyccnt_length(SIM_CYCCNT_MAX_LOG2) % sim_ms_to_cycles(SIM_CYCCNT_SLEEP_MAX_MS);
+            sim_schedule(wakeAt, sim_cyccnt_wake);
+            CYCCNT_BEGIN(probe[kind]);
+            start = sim.systickRead;
+            status = pm_enter(((i & 1U) != 0U) ? CY_SYSPM_DEEPSLEEP : CY_SYSPM_SLEEP);
+            if (status != CY_SYSPM_SUCCESS)
+            {
+                /* Refused, no transition: the span stays valid. The wake
+                 * event still has to run. */
+                refused++;
+                sim_advance((wakeAt > sim.cycles) ? (wakeAt - sim.cycles) : 0U);
+                sim_busy_wait();
+            }
+            else if (sim.cycles < wakeAt)
+            {
+                /* Woken by something else than the wake event, SysTick */
+                early++;
+                sim_busy_wait();
+            }
+        }
+
+        /* The time between the last SysTick reads of the two probe calls:
+         * a wrap pending in cyccnt_now() makes it read SysTick again */
+        CYCCNT_END(probe[kind]);
+        expected = sim.systickRead - start - cyccnt_overhead();
+        if (kind == SIM_CYCCNT_MASKED)
+        {
+            __enable_irq();
+        }
+
+        crossed[kind] += (sim.systickWraps != wraps) ? 1U : 0U;
+        if ((probe[kind].invalid == invalid) && ((probe[kind].sum - sum) == expected))
+        {
+            exact[kind]++;
+        }
+    }
+
+    printf("cyccnt: SysTick %u bits + wrap count, probe overhead %lu cycles (model %u)\n",
+           CYCCNT_SYSTICK_BITS, (unsigned long)cyccnt_overhead(), SIM_CYCLES_CYCCNT_NOW);
+    printf("%-13s %7s %7s %9s %7s %11s %11s\n", "spans", "count", "exact", "invalid", "wraps",
+           "min", "max");
+    for (kind = 0U; kind < SIM_CYCCNT_KINDS; kind++)
+    {
+        printf("%-13s %7lu %7lu %9lu %7lu %11lu %11lu\n", kindNames[kind], (unsigned long)spansOf[kind],
+               (unsigned long)exact[kind], (unsigned long)probe[kind].invalid, (unsigned long)crossed[kind],
+               (unsigned long)((probe[kind].count != 0U) ? probe[kind].min : 0U),
+               (unsigned long)probe[kind].max);
+    }
+    printf("transitions refused: %lu (spans valid), woken early: %lu\n",
+           (unsigned long)refused, (unsigned long)early);
+    printf("SysTick wrap interrupts: %llu in %.1f s\n", (unsigned long long)sim.systickWraps,
+           (double)sim.cycles / sim.hfclkHz);
+
+    /* Spans across a transition are only counted as invalid */
+    if ((cyccnt_overhead() != SIM_CYCLES_CYCCNT_NOW) || (early != 0U) ||
+        (exact[SIM_CYCCNT_OPEN] != spansOf[SIM_CYCCNT_OPEN]) ||
+        (exact[SIM_CYCCNT_MASKED] != spansOf[SIM_CYCCNT_MASKED]) ||
+        (probe[SIM_CYCCNT_SLEEP].invalid != (spansOf[SIM_CYCCNT_SLEEP] - refused)) ||
+        (exact[SIM_CYCCNT_SLEEP] != refused))
+    {
+        result = 1;
+    }
+
+    return result;
+}
+
+/* [] END OF FILE */
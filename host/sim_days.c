@@ -0,0 +1,185 @@
+/******************************************************************************
+* File Name: sim_days.c
+*
+* Description: Scenario 'days': Monte Carlo estimate of the charge drawn per
+*              day. Simulated users, each with a press trace of its own from
+*              the daily use model of sim_app.c (sessions of bouncy presses
+*              during waking hours, nights, idle days), run the application
+*              core for days in parallel (sim_batch_run()). The daily charge
+*              is reported for each TARGET kit of README Table 3, with the
+*              daily press and wakeup counts, as distributions over all the
+*              simulated days.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "sim.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+#define SIM_DAYS_MAX_USERS      (256U)
+#define SIM_DAYS_MAX_SAMPLES    (SIM_DAYS_MAX_USERS * SIM_APP_MAX_DAYS)
+
+/* uA x s per mAh */
+#define SIM_DAYS_UAS_PER_MAH    (3600000.0)
+
+/*******************************************************************************
+ * Global variables
+ ******************************************************************************/
+static sim_app_params_t params[SIM_DAYS_MAX_USERS];
+static sim_app_result_t results[SIM_DAYS_MAX_USERS];
+static bool done[SIM_DAYS_MAX_USERS];
+static double samples[SIM_DAYS_MAX_SAMPLES];
+
+static int sim_days_compare(const void *a, const void *b)
+{
+    double da = *(const double *)a;
+    double db = *(const double *)b;
+
+    return (da < db) ? -1 : (da > db);
+}
+
+/* Prints mean, 5th, 50th and 95th percentile and maximum of the samples */
+static void sim_days_print(const char *name, uint32_t count)
+{
+    double sum = 0.0;
+    uint32_t i;
+
+    qsort(samples, count, sizeof(samples[0]), sim_days_compare);
+    for (i = 0U; i < count; i++)
+    {
+        sum += samples[i];
+    }
+
+    printf("%-20s %9.3f %9.3f %9.3f %9.3f %9.3f\n", name, sum / count, samples[(count * 5U) / 100U],
+           samples[count / 2U], samples[(count * 95U) / 100U], samples[count - 1U]);
+}
+
+/*******************************************************************************
+ * Function Name: sim_days
+ *******************************************************************************
+ *
+ * Summary:
+ *  Scenario entry: sim days [days] [users] [debounce_ms] [jobs]. User n runs
+ *  with seed n; jobs defaults to the number of online CPUs. The default
+ *  debounce window is 30 ms: without one, contact bounce overshoots the
+ *  press count and the device ends up staying in Active mode.
+ *
+ ******************************************************************************/
+int sim_days(int argc, char **argv)
+{
+    uint32_t days = (argc > 0) ? (uint32_t)strtoul(argv[0], NULL, 0) : 7U;
+    uint32_t users = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 32U;
+    uint32_t debounceMs = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 0) : 30U;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    uint32_t jobs = (argc > 3) ? (uint32_t)strtoul(argv[3], NULL, 0) : (uint32_t)((cpus > 0) ? cpus : 1);
+    sim_app_params_t p = { 0U, 0U, SIM_PRESS_USER, 48U, debounceMs, 1U, 3U, 200U, NULL };
+    sim_batch_stats_t stats;
+    uint32_t count = 0U;
+    uint32_t idle = 0U;
+    uint32_t off = 0U;
+    uint32_t i, d, k;
+    char name[32];
+
+    days = ((days != 0U) && (days <= SIM_APP_MAX_DAYS)) ? days : 7U;
+    users = ((users != 0U) && (users <= SIM_DAYS_MAX_USERS)) ? users : 32U;
+
+    for (i = 0U; i < users; i++)
+    {
+        p.hours = days * 24U;
+        p.seed = i + 1U;
+        params[i] = p;
+    }
+    if (!sim_batch_run(params, results, done, users, jobs, &stats))
+    {
+        return 2;
+    }
+
+    /* Days of the users whose run completed */
+    for (i = 0U; i < users; i++)
+    {
+        off += (done[i] && !sim_app_residency_ok(&results[i])) ? 1U : 0U;
+        for (d = 0U; done[i] && (d < results[i].days); d++)
+        {
+            idle += (results[i].day[d].presses == 0U) ? 1U : 0U;
+            count++;
+        }
+    }
+    if (count == 0U)
+    {
+        printf("no complete days\n");
+        return 1;
+    }
+
+    printf("%lu users x %lu days of daily use, debounce %lu ms: %lu days, %.1f %% without presses\n",
+           (unsigned long)users, (unsigned long)days, (unsigned long)debounceMs, (unsigned long)count,
+           (100.0 * idle) / count);
+    printf("%-20s %9s %9s %9s %9s %9s\n", "per day", "mean", "p5", "p50", "p95", "max");
+
+    for (k = 0U; k <= (SIM_KIT_COUNT + 1U); k++)
+    {
+        count = 0U;
+        for (i = 0U; i < users; i++)
+        {
+            for (d = 0U; done[i] && (d < results[i].days); d++)
+            {
+                const sim_app_day_t *day = &results[i].day[d];
+
+                samples[count++] = (k == 0U) ? (double)day->presses :
+                                   (k == 1U) ? (double)day->wakeups :
+                                   (sim_charge_uas(&day->energy, &sim_kits[k - 2U]) / SIM_DAYS_UAS_PER_MAH);
+            }
+        }
+        if (k >= 2U)
+        {
+            (void) snprintf(name, sizeof(name), "%s mAh", sim_kits[k - 2U].target);
+        }
+        sim_days_print((k == 0U) ? "presses" : ((k == 1U) ? "wakeups" : name), count);
+    }
+
+    printf("%lu failed, %lu with the residency in pm_stats off, wall %.2f s, simulation CPU %.2f s\n",
+           (unsigned long)stats.failed, (unsigned long)off, stats.wallS, stats.cpuS);
+
+    return ((stats.failed == 0U) && (off == 0U)) ? 0 : 1;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,310 @@
+/******************************************************************************
+* File Name: sim_defer.c
+*
+* Description: Deferred work scenario. Button edges land between any two
+*              steps of the main loop code and run app_switch_isr(), which
+*              queues the press for the main loop (defer.c). The same edges
+*              are replayed with the press counted in the handler, as before
+*              the queue, and the handler durations compared, with a bottom
+*              half grown by a statistics update or a log record.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include "sim.h"
+#include "cybsp.h"
+#include "app.h"
+#include "defer.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+#define SIM_DEFER_PRESSES       (20000UL)
+
+/* Edges per 2^16 steps of main loop code: one per 8192 cycles on average */
+#define SIM_DEFER_RATE          (64U)
+#define SIM_DEFER_STEP_CYCLES   (8U)    /* One step of main loop code */
+#define SIM_DEFER_LOOP_STEPS    (32U)   /* Main loop work between defer_run(), up to */
+
+/* Costs of the queue, Cortex-M0 instructions of defer.c */
+#define SIM_DEFER_CYCLES_POST   (34U)   /* defer_post(): call, PRIMASK, slot, counters */
+#define SIM_DEFER_CYCLES_ITEM   (22U)   /* defer_run(), per item: copy, free, call */
+#define SIM_DEFER_CYCLES_PRESS  (16U)   /* Counting the press: app_press_work() */
+
+/* Bottom halves grown by: nothing, a statistics update, a log record */
+#define SIM_DEFER_EXTRAS        (3U)
+
+/*******************************************************************************
+ * Global variables
+ ******************************************************************************/
+static uint64_t rngState;
+
+static const cy_stc_sysint_t switchIntr = { CYBSP_USER_BTN_IRQ, 3U };
+
+static app_ctx_t app;
+
+static bool deferred;
+static uint32_t extraCycles;
+static uint32_t edges;
+static uint32_t isrRuns;
+static uint64_t isrCycles;
+static uint64_t isrMax;
+static uint32_t queueMax;
+static uint32_t extraRuns;
+static uint64_t latencyCycles;
+static uint64_t latencyMax;
+
+static uint32_t sim_defer_rand(void)
+{
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 7;
+    rngState ^= rngState << 17;
+    return (uint32_t)(rngState >> 32);
+}
+
+/* Code running for the given cycles, a step at a time. Edges landing in a
+ * handler pend, and merge with the edges pending already. */
+static void sim_defer_work(uint32_t cycles)
+{
+    uint32_t step;
+
+    while (cycles > 0U)
+    {
+        step = (cycles < SIM_DEFER_STEP_CYCLES) ? cycles : SIM_DEFER_STEP_CYCLES;
+        if ((sim.isrActive != 0U) && ((sim_defer_rand() & 0xFFFFU) < SIM_DEFER_RATE))
+        {
+            edges++;
+            sim_raise_irq(switchIntr.intrSrc);
+        }
+        sim_advance(step);
+        cycles -= step;
+    }
+}
+
+/* The grown part of the bottom half; data is the cycle count at the edge */
+static void sim_defer_extra(void *arg, uint32_t data)
+{
+    uint64_t latency = (uint32_t)sim.cycles - data;
+
+    (void) arg;
+    extraRuns++;
+    latencyCycles += latency;
+    latencyMax = (latency > latencyMax) ? latency : latencyMax;
+    sim_defer_work(extraCycles);
+}
+
+/*******************************************************************************
+ * Function Name: sim_defer_isr
+ *******************************************************************************
+ *
+ * Summary:
+ *  switch_isr() of main.c. Deferred: app_switch_isr() queues the press, and
+ *  the grown part of the bottom half is queued after it. Inline: the queue
+ *  is run in the handler and charged as the handler that counted the press
+ *  itself, then the grown part runs in the handler too.
+ *
+ ******************************************************************************/
+static void sim_defer_isr(void)
+{
+    uint64_t start = sim.cycles;
+    uint64_t cycles;
+    uint32_t queued;
+
+    isrRuns++;
+    app_switch_isr(&app);
+    if (deferred)
+    {
+        sim_defer_work(SIM_DEFER_CYCLES_POST);
+        if (extraCycles != 0U)
+        {
+            (void) defer_post(sim_defer_extra, NULL, (uint32_t)sim.cycles);
+            sim_defer_work(SIM_DEFER_CYCLES_POST);
+        }
+        queued = defer_stats()->posted - defer_stats()->run;
+        queueMax = (queued > queueMax) ? queued : queueMax;
+    }
+    else
+    {
+        defer_run();
+        sim_defer_work(SIM_DEFER_CYCLES_PRESS + extraCycles);
+    }
+
+    cycles = (sim.cycles - start) + SIM_CYCLES_ISR_ENTRY + SIM_CYCLES_ISR_EXIT;
+    isrCycles += cycles;
+    isrMax = (cycles > isrMax) ? cycles : isrMax;
+}
+
+/* Button edges landing in the main loop code */
+static void sim_defer_preempt(void)
+{
+    if ((sim_defer_rand() & 0xFFFFU) < SIM_DEFER_RATE)
+    {
+        edges++;
+        sim_raise_irq(switchIntr.intrSrc);
+        sim_dispatch_irqs();
+    }
+}
+
+/* defer_run() of the main loop, charged per item run */
+static void sim_defer_run(void)
+{
+    uint32_t run = defer_stats()->run;
+    uint32_t presses = app.presses;
+
+    defer_run();
+    sim_defer_work(((defer_stats()->run - run) * SIM_DEFER_CYCLES_ITEM) +
+                   ((app.presses - presses) * SIM_DEFER_CYCLES_PRESS));
+}
+
+/*******************************************************************************
+ * Function Name: sim_defer
+ *******************************************************************************
+ *
+ * Summary:
+ *  Scenario entry: sim defer [presses] [seed]
+ *
+ ******************************************************************************/
+int sim_defer(int argc, char **argv)
+{
+    /* A statistics update under the sequence lock, a formatted log record */
+    static const uint32_t extras[SIM_DEFER_EXTRAS] = { 0U, 150U, 1500U };
+    app_config_t config = APP_CONFIG_DEFAULT;
+    uint32_t presses = (argc > 0) ? (uint32_t)strtoul(argv[0], NULL, 0) : SIM_DEFER_PRESSES;
+    uint64_t seed = (argc > 1) ? strtoull(argv[1], NULL, 0) : 1U;
+    uint32_t full = defer_stats()->full;
+    uint64_t inlineMax = 0U;
+    uint32_t extra;
+    uint32_t variant;
+    uint32_t steps;
+    int result = 0;
+
+    presses = (presses != 0U) ? presses : SIM_DEFER_PRESSES;
+    config.debounceMs = 0U;
+
+    printf("defer: %lu presses, queue of %u, per edge %u/65536 steps of %u cycles\n",
+           (unsigned long)presses, DEFER_QUEUE_LEN, SIM_DEFER_RATE, SIM_DEFER_STEP_CYCLES);
+    printf("%-7s %-8s %8s %8s %7s %8s %6s %10s %10s\n", "extra", "handler", "edges", "counted",
+           "merged", "ISR mean", "max", "queue max", "latency");
+
+    for (extra = 0U; extra < SIM_DEFER_EXTRAS; extra++)
+    {
+        for (variant = 0U; variant < 2U; variant++)
+        {
+            /* splitmix64 of the seed: both variants draw the edges alike */
+            rngState = seed + 0x9E3779B97F4A7C15ULL;
+            rngState = (rngState ^ (rngState >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            rngState = (rngState ^ (rngState >> 27)) * 0x94D049BB133111EBULL;
+            rngState ^= rngState >> 31;
+            rngState = (rngState == 0U) ? 1U : rngState;
+
+            sim_reset();
+            (void) cybsp_init();
+            app_init(&app, &config, NULL);
+            (void) Cy_SysInt_Init(&switchIntr, sim_defer_isr);
+            NVIC_EnableIRQ(switchIntr.intrSrc);
+            __enable_irq();
+
+            deferred = (variant != 0U);
+            extraCycles = extras[extra];
+            edges = 0U;
+            isrRuns = 0U;
+            isrCycles = 0U;
+            isrMax = 0U;
+            queueMax = 0U;
+            extraRuns = 0U;
+            latencyCycles = 0U;
+            latencyMax = 0U;
+            sim.preempt = sim_defer_preempt;
+
+            /* The main loop: the deferred work, then other work */
+            while (isrRuns < presses)
+            {
+                sim_defer_run();
+                for (steps = 1U + (sim_defer_rand() % SIM_DEFER_LOOP_STEPS); steps > 0U; steps--)
+                {
+                    sim_advance(SIM_DEFER_STEP_CYCLES);
+                }
+            }
+            sim.preempt = NULL;
+            sim_defer_run();
+
+            printf("%-7lu %-8s %8lu %8lu %7lu %8.1f %6lu ", (unsigned long)extraCycles,
+                   deferred ? "deferred" : "inline", (unsigned long)edges, (unsigned long)app.presses,
+                   (unsigned long)(edges - isrRuns), (double)isrCycles / isrRuns, (unsigned long)isrMax);
+            if (deferred && (extraRuns != 0U))
+            {
+                printf("%10lu %10.1f\n", (unsigned long)queueMax, (double)latencyCycles / extraRuns);
+            }
+            else if (deferred)
+            {
+                printf("%10lu %10s\n", (unsigned long)queueMax, "-");
+            }
+            else
+            {
+                printf("%10s %10s\n", "-", "-");
+            }
+
+            /* Every handler run counts its press, nothing is left queued */
+            if ((app.presses != isrRuns) || defer_pending() ||
+                (deferred && (extraCycles != 0U) && (extraRuns != isrRuns)))
+            {
+                result = 1;
+            }
+            if (!deferred)
+            {
+                inlineMax = isrMax;
+            }
+            else if ((extraCycles != 0U) && (isrMax >= inlineMax))
+            {
+                result = 1;
+            }
+        }
+    }
+
+    printf("queue high water %lu, full %lu\n", (unsigned long)defer_stats()->highWater,
+           (unsigned long)(defer_stats()->full - full));
+    if (defer_stats()->full != full)
+    {
+        result = 1;
+    }
+
+    return result;
+}
+
+/* [] END OF FILE */
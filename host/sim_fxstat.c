@@ -0,0 +1,408 @@
+/******************************************************************************
+* File Name: sim_fxstat.c
+*
+* Description: Scenario 'fxstat': the fixed-point statistics of fxstat.c
+*              compared with the same statistics in soft-float. The charge
+*              accumulation, the weighted latency mean and variance, and the
+*              histogram percentiles run over one stream of samples, in
+*              fixed point, in float and in double. Reports the Cortex-M0
+*              cycles per update and the error of each against an exact
+*              reference.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+#include "fxstat.h"
+#include "pm_stats.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+#define SIM_FXSTAT_SAMPLES      (1000000UL)
+
+/* Histograms for the percentile comparison */
+#define SIM_FXSTAT_HISTS        (10000U)
+
+/* Cortex-M0 cost of the fxstat.c functions, with the call, counted from the
+ * instruction sequences: the 64-bit product is four MULS (single cycle
+ * multiplier) and the carry handling; the percentile walks the bins and
+ * makes one library 32-bit division (about 90 cycles). */
+#define SIM_CYCLES_FX_CHARGE    (48U)
+#define SIM_CYCLES_FX_EWMA      (38U)
+#define SIM_CYCLES_FX_QUANTILE  (260U)
+
+/* Cortex-M0 cost of the libgcc soft-float routines, with the call, typical
+ * for normal operands: single precision, then double precision */
+#define SIM_CYCLES_SF_ADD       (110U)
+#define SIM_CYCLES_SF_MUL       (100U)
+#define SIM_CYCLES_SF_DIV       (280U)
+#define SIM_CYCLES_SF_FROM_INT  (55U)
+#define SIM_CYCLES_SF_TO_INT    (45U)
+#define SIM_CYCLES_DF_ADD       (170U)
+#define SIM_CYCLES_DF_MUL       (210U)
+#define SIM_CYCLES_DF_DIV       (650U)
+#define SIM_CYCLES_DF_FROM_INT  (70U)
+#define SIM_CYCLES_DF_TO_INT    (60U)
+
+/* EWMA weight of fxstat_ewma_add() */
+#define SIM_FXSTAT_W            (1.0 / (1U << FXSTAT_EWMA_SHIFT))
+
+/*******************************************************************************
+ * Data types
+ ******************************************************************************/
+/* Soft-float calls made, per kind */
+typedef struct
+{
+    uint64_t add;
+    uint64_t mul;
+    uint64_t div;
+    uint64_t fromInt;
+    uint64_t toInt;
+} sim_fxstat_calls_t;
+
+/*******************************************************************************
+ * Global variables
+ ******************************************************************************/
+static sim_fxstat_calls_t sfCalls;
+static sim_fxstat_calls_t dfCalls;
+static uint64_t rngState;
+
+static double sim_fxstat_rand(void)
+{
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 7;
+    rngState ^= rngState << 17;
+    return ((double)(rngState >> 11) + 0.5) / 9007199254740992.0;
+}
+
+/* Soft-float operations, counted as the calls the Cortex-M0 would make */
+static float sf_add(float a, float b) { sfCalls.add++; return a + b; }
+static float sf_sub(float a, float b) { sfCalls.add++; return a - b; }
+static float sf_mul(float a, float b) { sfCalls.mul++; return a * b; }
+static float sf_div(float a, float b) { sfCalls.div++; return a / b; }
+static float sf_from(int32_t a) { sfCalls.fromInt++; return (float)a; }
+static uint32_t sf_to(float a) { sfCalls.toInt++; return (uint32_t)a; }
+static double df_add(double a, double b) { dfCalls.add++; return a + b; }
+static double df_sub(double a, double b) { dfCalls.add++; return a - b; }
+static double df_mul(double a, double b) { dfCalls.mul++; return a * b; }
+static double df_div(double a, double b) { dfCalls.div++; return a / b; }
+static double df_from(int32_t a) { dfCalls.fromInt++; return (double)a; }
+static uint32_t df_to(double a) { dfCalls.toInt++; return (uint32_t)a; }
+
+static double sim_fxstat_sf_cycles(const sim_fxstat_calls_t *calls)
+{
+    return (double)((calls->add * SIM_CYCLES_SF_ADD) + (calls->mul * SIM_CYCLES_SF_MUL) +
+                    (calls->div * SIM_CYCLES_SF_DIV) + (calls->fromInt * SIM_CYCLES_SF_FROM_INT) +
+                    (calls->toInt * SIM_CYCLES_SF_TO_INT));
+}
+
+static double sim_fxstat_df_cycles(const sim_fxstat_calls_t *calls)
+{
+    return (double)((calls->add * SIM_CYCLES_DF_ADD) + (calls->mul * SIM_CYCLES_DF_MUL) +
+                    (calls->div * SIM_CYCLES_DF_DIV) + (calls->fromInt * SIM_CYCLES_DF_FROM_INT) +
+                    (calls->toInt * SIM_CYCLES_DF_TO_INT));
+}
+
+/*******************************************************************************
+ * Function Name: sim_fxstat_print
+ *******************************************************************************
+ *
+ * Summary:
+ *  Prints one result line: cycles per update and error of each variant.
+ *
+ ******************************************************************************/
+static void sim_fxstat_print(const char *name, double fxCycles, double sfCycles, double dfCycles,
+                             double fxErr, double sfErr, double dfErr, const char *unit)
+{
+    printf("%-22s %6.0f %6.0f %6.0f   %10.3g %10.3g %10.3g %s\n", name, fxCycles, sfCycles, dfCycles,
+           fxErr, sfErr, dfErr, unit);
+}
+
+/*******************************************************************************
+ * Function Name: sim_fxstat_charge
+ *******************************************************************************
+ *
+ * Summary:
+ *  Integrates the charge of alternating Active and Deep Sleep intervals, as
+ *  pm_stats does at every transition. The reference is exact: the ticks of
+ *  each mode are summed in integers and multiplied once at the end.
+ *
+ ******************************************************************************/
+static void sim_fxstat_charge(uint32_t count)
+{
+    static const uint32_t currentNa[2] = { PM_STATS_ACTIVE_NA, PM_STATS_DEEPSLEEP_NA };
+    uint32_t perTick[2];
+    float sfPerTick[2];
+    double dfPerTick[2];
+    uint32_t fxCharge[2] = { 0U, 0U };
+    uint32_t fxFrac[2] = { 0U, 0U };
+    float sfCharge[2] = { 0.0f, 0.0f };
+    double dfCharge[2] = { 0.0, 0.0 };
+    uint64_t ticksSum[2] = { 0U, 0U };
+    double exact = 0.0;
+    double fx = 0.0;
+    double sf = 0.0;
+    double df = 0.0;
+    uint32_t ticks;
+    uint32_t mode;
+    uint32_t i;
+
+    for (mode = 0U; mode < 2U; mode++)
+    {
+        perTick[mode] = FXSTAT_CHARGE_PER_TICK(currentNa[mode], SIM_ILO_HZ);
+        sfPerTick[mode] = (float)currentNa[mode] / (1e3f * SIM_ILO_HZ);
+        dfPerTick[mode] = (double)currentNa[mode] / (1e3 * SIM_ILO_HZ);
+    }
+
+    memset(&sfCalls, 0, sizeof(sfCalls));
+    memset(&dfCalls, 0, sizeof(dfCalls));
+    for (i = 0U; i < count; i++)
+    {
+        /* Active for 0.1 to 2 ms, then Deep Sleep for up to 1.5 s */
+        mode = i & 1U;
+        ticks = (mode == 0U) ? (4U + (uint32_t)(76.0 * sim_fxstat_rand()))
+                             : (1U + (uint32_t)(59999.0 * sim_fxstat_rand()));
+        ticksSum[mode] += ticks;
+        fxCharge[mode] += fxstat_charge_add(&fxFrac[mode], ticks, perTick[mode]);
+        sfCharge[mode] = sf_add(sfCharge[mode], sf_mul(sf_from(ticks), sfPerTick[mode]));
+        dfCharge[mode] = df_add(dfCharge[mode], df_mul(df_from(ticks), dfPerTick[mode]));
+    }
+
+    for (mode = 0U; mode < 2U; mode++)
+    {
+        exact += ((double)ticksSum[mode] * currentNa[mode]) / (1e3 * SIM_ILO_HZ);
+        fx += fxCharge[mode] + (fxFrac[mode] / 4294967296.0);
+        sf += sfCharge[mode];
+        df += dfCharge[mode];
+    }
+
+    printf("%lu intervals, %.1f days, %.0f uA s\n", (unsigned long)count,
+           (double)(ticksSum[0] + ticksSum[1]) / SIM_ILO_HZ / 86400.0, exact);
+    sim_fxstat_print("charge add", SIM_CYCLES_FX_CHARGE, sim_fxstat_sf_cycles(&sfCalls) / count,
+                     sim_fxstat_df_cycles(&dfCalls) / count,
+                     fabs(fx - exact) / exact, fabs(sf - exact) / exact, fabs(df - exact) / exact, "relative");
+}
+
+/*******************************************************************************
+ * Function Name: sim_fxstat_ewma
+ *******************************************************************************
+ *
+ * Summary:
+ *  Runs the weighted mean and variance of fxstat_ewma_add() over log-normal
+ *  latency samples. The reference is the same recurrence in long double.
+ *
+ ******************************************************************************/
+static void sim_fxstat_ewma(uint32_t count)
+{
+    uint32_t fxMean = 0U;
+    uint32_t fxVar = 0U;
+    float sfMean = 0.0f;
+    float sfVar = 0.0f;
+    double dfMean = 0.0;
+    double dfVar = 0.0;
+    long double refMean = 0.0L;
+    long double refVar = 0.0L;
+    long double diff;
+    double refStd;
+    double fxErr = 0.0;
+    double sfErr = 0.0;
+    double dfErr = 0.0;
+    float sfDiff;
+    double dfDiff;
+    uint32_t sample;
+    uint32_t i;
+
+    memset(&sfCalls, 0, sizeof(sfCalls));
+    memset(&dfCalls, 0, sizeof(dfCalls));
+    for (i = 0U; i < count; i++)
+    {
+        /* Median 1000 cycles, a few exits above 10000 */
+        sample = (uint32_t)(1000.0 * exp(0.6 * sqrt(-2.0 * log(sim_fxstat_rand())) *
+                                         cos(6.283185307179586 * sim_fxstat_rand())));
+        sample = (sample != 0U) ? sample : 1U;
+        fxstat_ewma_add(&fxMean, &fxVar, sample);
+
+        if (i == 0U)
+        {
+            sfMean = sf_from(sample);
+            dfMean = df_from(sample);
+            refMean = sample;
+            continue;
+        }
+
+        sfDiff = sf_sub(sf_from(sample), sfMean);
+        sfMean = sf_add(sfMean, sf_mul(sfDiff, (float)SIM_FXSTAT_W));
+        sfVar = sf_mul((float)(1.0 - SIM_FXSTAT_W), sf_add(sfVar, sf_mul((float)SIM_FXSTAT_W, sf_mul(sfDiff, sfDiff))));
+        dfDiff = df_sub(df_from(sample), dfMean);
+        dfMean = df_add(dfMean, df_mul(dfDiff, SIM_FXSTAT_W));
+        dfVar = df_mul(1.0 - SIM_FXSTAT_W, df_add(dfVar, df_mul(SIM_FXSTAT_W, df_mul(dfDiff, dfDiff))));
+        diff = (long double)sample - refMean;
+        refMean += diff * SIM_FXSTAT_W;
+        refVar = (1.0L - SIM_FXSTAT_W) * (refVar + (SIM_FXSTAT_W * diff * diff));
+
+        /* Worst relative error of the mean and of the standard deviation */
+        fxErr = fmax(fxErr, fabs(((double)fxMean / (1U << FXSTAT_EWMA_FRAC)) - (double)refMean) / (double)refMean);
+        sfErr = fmax(sfErr, fabs(sfMean - (double)refMean) / (double)refMean);
+        dfErr = fmax(dfErr, fabs(dfMean - (double)refMean) / (double)refMean);
+        refStd = sqrt((double)refVar);
+        if (refStd > 100.0)
+        {
+            fxErr = fmax(fxErr, fabs(sqrt((double)fxVar) - refStd) / refStd);
+            sfErr = fmax(sfErr, fabs(sqrt(sfVar) - refStd) / refStd);
+            dfErr = fmax(dfErr, fabs(sqrt(dfVar) - refStd) / refStd);
+        }
+    }
+
+    sim_fxstat_print("mean / variance add", SIM_CYCLES_FX_EWMA, sim_fxstat_sf_cycles(&sfCalls) / count,
+                     sim_fxstat_df_cycles(&dfCalls) / count, fxErr, sfErr, dfErr, "relative, worst");
+}
+
+/*******************************************************************************
+ * Function Name: sim_fxstat_quantile
+ *******************************************************************************
+ *
+ * Summary:
+ *  Reads p50 and p99 from random latency histograms with
+ *  fxstat_hist_quantile() and with the same interpolation in floating
+ *  point. The reference is the interpolation in long double.
+ *
+ ******************************************************************************/
+static void sim_fxstat_quantile(uint32_t count)
+{
+    static const uint32_t q[2] = { 500U, 990U };
+    uint16_t hist[PM_STATS_HIST_BINS];
+    uint32_t total;
+    uint32_t below;
+    uint32_t bin;
+    uint32_t h;
+    uint32_t k;
+    double lo;
+    double hi;
+    long double ref;
+    double fxErr = 0.0;
+    double sfErr = 0.0;
+    double dfErr = 0.0;
+    uint32_t sfResult;
+    uint32_t dfResult;
+    uint32_t sfRank;
+    uint32_t dfRank;
+
+    memset(&sfCalls, 0, sizeof(sfCalls));
+    memset(&dfCalls, 0, sizeof(dfCalls));
+    for (h = 0U; h < count; h++)
+    {
+        total = 0U;
+        for (bin = 0U; bin < PM_STATS_HIST_BINS; bin++)
+        {
+            hist[bin] = (uint16_t)(sim_fxstat_rand() * ((sim_fxstat_rand() < 0.5) ? 100.0 : 60000.0));
+            total += hist[bin];
+        }
+
+        for (k = 0U; k < 2U; k++)
+        {
+            /* Rank at the middle of its share, as fxstat_hist_quantile() */
+            sfRank = sf_to(sf_mul(sf_from((int32_t)total), (float)FXSTAT_Q16(q[k]) / 65536.0f));
+            dfRank = df_to(df_mul(df_from((int32_t)total), (double)FXSTAT_Q16(q[k]) / 65536.0));
+            ref = floorl((long double)total * FXSTAT_Q16(q[k]) / 65536.0L);
+            ref = (ref < total) ? ref : (total - 1U);
+            below = 0U;
+            for (bin = 0U; (below + hist[bin]) <= (uint32_t)ref; bin++)
+            {
+                below += hist[bin];
+            }
+            if (bin == (PM_STATS_HIST_BINS - 1U))
+            {
+                continue;
+            }
+
+            lo = (bin == 0U) ? 0.0 : (double)(1UL << (PM_STATS_HIST_SHIFT + bin - 1U));
+            hi = (double)(1UL << (PM_STATS_HIST_SHIFT + bin));
+            sfResult = sf_to(sf_add((float)lo, sf_mul((float)(hi - lo),
+                             sf_div(sf_add(sf_from((int32_t)sfRank - (int32_t)below), 0.5f), sf_from(hist[bin])))));
+            dfResult = df_to(df_add(lo, df_mul(hi - lo,
+                             df_div(df_add(df_from((int32_t)dfRank - (int32_t)below), 0.5), df_from(hist[bin])))));
+            ref = lo + ((hi - lo) * ((ref - below) + 0.5L) / hist[bin]);
+
+            fxErr = fmax(fxErr, fabs((double)fxstat_hist_quantile(hist, PM_STATS_HIST_BINS, PM_STATS_HIST_SHIFT,
+                                                                  FXSTAT_Q16(q[k])) - (double)ref));
+            sfErr = fmax(sfErr, fabs((double)sfResult - (double)ref));
+            dfErr = fmax(dfErr, fabs((double)dfResult - (double)ref));
+        }
+    }
+
+    sim_fxstat_print("p50 + p99 readout", 2.0 * SIM_CYCLES_FX_QUANTILE, sim_fxstat_sf_cycles(&sfCalls) / count,
+                     sim_fxstat_df_cycles(&dfCalls) / count, fxErr, sfErr, dfErr, "cycles, worst");
+}
+
+/*******************************************************************************
+ * Function Name: sim_fxstat
+ *******************************************************************************
+ *
+ * Summary:
+ *  Scenario entry: sim fxstat [samples] [seed]
+ *
+ ******************************************************************************/
+int sim_fxstat(int argc, char **argv)
+{
+    uint32_t count = (argc > 0) ? (uint32_t)strtoul(argv[0], NULL, 0) : SIM_FXSTAT_SAMPLES;
+
+    /* splitmix64 of the seed, so small seeds give well mixed xorshift states */
+    rngState = (argc > 1) ? strtoull(argv[1], NULL, 0) : 1U;
+    rngState += 0x9E3779B97F4A7C15ULL;
+    rngState = (rngState ^ (rngState >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    rngState = (rngState ^ (rngState >> 27)) * 0x94D049BB133111EBULL;
+    rngState ^= rngState >> 31;
+    rngState = (rngState == 0U) ? 1U : rngState;
+    count = (count != 0U) ? count : SIM_FXSTAT_SAMPLES;
+
+    printf("%-22s %20s   %32s\n", "", "Cortex-M0 cycles", "error");
+    printf("%-22s %6s %6s %6s   %10s %10s %10s\n", "update", "fixed", "float", "double", "fixed", "float",
+           "double");
+    sim_fxstat_charge(count);
+    sim_fxstat_ewma(count);
+    sim_fxstat_quantile(SIM_FXSTAT_HISTS);
+
+    return 0;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,161 @@
+/******************************************************************************
+* File Name: sim_gpio.c
+*
+* Description: Scenario 'gpio': bus accesses of the Active mode main loop
+*              driving the User LED through Cy_GPIO_Write and through the
+*              shadowed gpio_out layer.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include "sim.h"
+#include "cybsp.h"
+#include "gpio_out.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+#define LED_ON                  (0U)
+
+/* Rest of the main loop body: SwitchPressCount loads, compares, branch */
+#define SIM_CYCLES_LOOP_BODY    (10U)
+
+/* Shadow compare when the LED state does not change */
+#define SIM_CYCLES_SHADOW_CHECK (6U)
+
+/* Shadow compare plus the DR store when it does */
+#define SIM_CYCLES_SHADOW_WRITE (9U)
+
+/*******************************************************************************
+ * Function Name: sim_gpio_run
+ *******************************************************************************
+ *
+ * Summary:
+ *  Runs the Active mode main loop for the given time.
+ *
+ * Parameters:
+ *  shadowed: Use gpio_out instead of Cy_GPIO_Write.
+ *  seconds: Simulated time.
+ *  accesses: Returns the number of port register accesses.
+ *  iterations: Returns the number of loop iterations.
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void sim_gpio_run(bool shadowed, uint32_t seconds, uint64_t *accesses, uint64_t *iterations)
+{
+    gpio_out_port_t led_port;
+    uint64_t end;
+    uint32_t lastWrites = 0U;
+
+    sim_reset();
+    (void) cybsp_init();
+    gpio_out_init(&led_port, CYBSP_USER_LED_PORT);
+    /* One register read to load the shadow */
+    sim.busReads++;
+
+    *iterations = 0U;
+    end = (uint64_t)seconds * sim.hfclkHz;
+    while (sim.cycles < end)
+    {
+        if (shadowed)
+        {
+            gpio_out_write(&led_port, CYBSP_USER_LED_NUM, LED_ON);
+            if (led_port.writes != lastWrites)
+            {
+                lastWrites = led_port.writes;
+                sim.busWrites++;
+                sim_advance(SIM_CYCLES_SHADOW_WRITE);
+            }
+            else
+            {
+                sim_advance(SIM_CYCLES_SHADOW_CHECK);
+            }
+        }
+        else
+        {
+            Cy_GPIO_Write(CYBSP_USER_LED_PORT, CYBSP_USER_LED_NUM, LED_ON);
+        }
+        sim_advance(SIM_CYCLES_LOOP_BODY);
+        (*iterations)++;
+    }
+
+    *accesses = (uint64_t)sim.busReads + sim.busWrites;
+}
+
+/*******************************************************************************
+ * Function Name: sim_gpio
+ *******************************************************************************
+ *
+ * Summary:
+ *  Scenario entry: sim gpio [seconds]
+ *
+ ******************************************************************************/
+int sim_gpio(int argc, char **argv)
+{
+    uint32_t seconds = (argc > 0) ? (uint32_t)strtoul(argv[0], NULL, 0) : 1U;
+    uint64_t pdlAccesses, pdlIterations;
+    uint64_t shadowAccesses, shadowIterations;
+
+    if (seconds == 0U)
+    {
+        seconds = 1U;
+    }
+
+    sim_gpio_run(false, seconds, &pdlAccesses, &pdlIterations);
+    sim_gpio_run(true, seconds, &shadowAccesses, &shadowIterations);
+
+    printf("Active main loop at %lu Hz, %lu s simulated\n",
+           (unsigned long)SIM_HFCLK_HZ, (unsigned long)seconds);
+    printf("%-14s %14s %18s\n", "variant", "iterations/s", "port accesses/s");
+    printf("%-14s %14llu %18llu\n", "Cy_GPIO_Write",
+           (unsigned long long)(pdlIterations / seconds),
+           (unsigned long long)(pdlAccesses / seconds));
+    printf("%-14s %14llu %18llu\n", "gpio_out",
+           (unsigned long long)(shadowIterations / seconds),
+           (unsigned long long)(shadowAccesses / seconds));
+    printf("saved: %llu port accesses/s\n",
+           (unsigned long long)((pdlAccesses - shadowAccesses) / seconds));
+
+    return 0;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,259 @@
+/******************************************************************************
+* File Name: sim_i2c.c
+*
+* Description: Scenario 'i2c': an I2C master polls the telemetry register
+*              map while the device sleeps in Deep Sleep between watchdog
+*              timer wakeups. Every read wakes the device on address match.
+*              The decoded map is checked against the simulator's own counts.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+#include "fxstat.h"
+#include "pm_module.h"
+#include "pm_stats.h"
+#include "wdt_svc.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+#define SIM_I2C_APP_PERIOD_MS   (1000U)
+
+/* Charge in the map versus residency times the mode current, uA s: the map
+ * holds whole uA s, and the rounded per-tick constant adds a few thousandths */
+#define SIM_I2C_CHARGE_TOL      (1.01)
+
+/*******************************************************************************
+ * Global variables
+ ******************************************************************************/
+static uint64_t nextPollMs;
+static uint32_t pollMs;
+static uint32_t polls;
+static uint32_t errors;
+static uint64_t pollCycles;
+static uint64_t lastSum;
+static uint32_t lastSeq;
+
+static const double modeNa[PM_STATS_MODES] = { PM_STATS_ACTIVE_NA, PM_STATS_SLEEP_NA, PM_STATS_DEEPSLEEP_NA };
+
+static void sim_i2c_app_tick(void)
+{
+}
+
+static uint32_t sim_i2c_get32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t sim_i2c_get16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+/*******************************************************************************
+ * Function Name: sim_i2c_decode
+ *******************************************************************************
+ *
+ * Summary:
+ *  Decodes the register map from the bytes the master received, at the
+ *  offsets documented in README.md, and checks it.
+ *
+ ******************************************************************************/
+static void sim_i2c_decode(const uint8_t *rx, uint32_t length)
+{
+    pm_stats_t map;
+    uint32_t i;
+    uint64_t sum = 0U;
+    double expected;
+    uint64_t iloTicks = (sim.cycles * SIM_ILO_HZ) / sim.hfclkHz;
+
+    memset(&map, 0, sizeof(map));
+    map.version = rx[0x00];
+    map.size = rx[0x01];
+    map.histBins = rx[0x02];
+    map.histShift = rx[0x03];
+    for (i = 0U; i < PM_STATS_MODES; i++)
+    {
+        map.residency[i] = sim_i2c_get32(&rx[0x04 + (4U * i)]);
+        map.residencyHi[i] = sim_i2c_get32(&rx[0x58 + (4U * i)]);
+        sum += pm_stats_residency_ticks(&map, i);
+    }
+    map.wakeups[0] = sim_i2c_get32(&rx[0x10]);
+    map.wakeups[1] = sim_i2c_get32(&rx[0x14]);
+    map.refused = sim_i2c_get32(&rx[0x18]);
+    for (i = 0U; i < PM_STATS_HIST_BINS; i++)
+    {
+        map.entryHist[i] = sim_i2c_get16(&rx[0x1C + (2U * i)]);
+        map.exitHist[i] = sim_i2c_get16(&rx[0x2C + (2U * i)]);
+    }
+    for (i = 0U; i < PM_STATS_MODES; i++)
+    {
+        map.charge[i] = sim_i2c_get32(&rx[0x3C + (4U * i)]);
+
+        /* Fixed-point charge against the residency, within rounding */
+        expected = ((double)pm_stats_residency_ticks(&map, i) * modeNa[i]) / (1e3 * SIM_ILO_HZ);
+        if (fabs(map.charge[i] - expected) > SIM_I2C_CHARGE_TOL)
+        {
+            errors++;
+        }
+    }
+    map.exitMean = sim_i2c_get32(&rx[0x48]);
+    map.exitVar = sim_i2c_get32(&rx[0x4C]);
+    map.lock.seq = sim_i2c_get32(&rx[0x50]);
+    map.canceled = sim_i2c_get32(&rx[0x54]);
+
+    /* The wake interrupt is served once pm_enter() has counted the wakeup and
+     * the time slept; residency only grows and never runs ahead of the clock.
+     * Updates mask the interrupt, so it never finds one in progress. */
+    if ((length != sizeof(pm_stats_t)) || (map.version != PM_STATS_VERSION) ||
+        (map.size != sizeof(pm_stats_t)) || (map.histBins != PM_STATS_HIST_BINS) ||
+        ((map.wakeups[0] + map.wakeups[1]) != sim.wakeups) ||
+        (sum > iloTicks) || (sum < lastSum) ||
+        ((map.lock.seq & 1U) != 0U) || (map.lock.seq < lastSeq))
+    {
+        errors++;
+    }
+
+    lastSum = sum;
+    lastSeq = map.lock.seq;
+}
+
+/*******************************************************************************
+ * Function Name: sim_i2c_poll
+ *******************************************************************************
+ *
+ * Summary:
+ *  I2C master: reads the whole register map every pollMs.
+ *
+ ******************************************************************************/
+static void sim_i2c_poll(void)
+{
+    sim_i2c_read(0U, sizeof(pm_stats_t));
+    nextPollMs += pollMs;
+    sim_schedule(sim_ms_to_cycles(nextPollMs), sim_i2c_poll);
+}
+
+/*******************************************************************************
+ * Function Name: sim_i2c
+ *******************************************************************************
+ *
+ * Summary:
+ *  Scenario entry: sim i2c [minutes] [poll_ms]
+ *
+ ******************************************************************************/
+int sim_i2c(int argc, char **argv)
+{
+    uint32_t minutes = (argc > 0) ? (uint32_t)strtoul(argv[0], NULL, 0) : 10U;
+    uint64_t endMs;
+    uint64_t cycles;
+    uint32_t bytes;
+    uint32_t i;
+
+    pollMs = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 1300U;
+    pollMs = (pollMs != 0U) ? pollMs : 1300U;
+    endMs = (uint64_t)((minutes != 0U) ? minutes : 1U) * 60000U;
+    nextPollMs = pollMs;
+
+    sim_reset();
+    sim_schedule(sim_ms_to_cycles(nextPollMs), sim_i2c_poll);
+    (void) pm_init();
+    __enable_irq();
+    wdt_svc_timer_start(0U, WDT_SVC_MS_TO_TICKS(SIM_I2C_APP_PERIOD_MS), true, sim_i2c_app_tick);
+
+    while (sim_now_ms() < endMs)
+    {
+        wdt_svc_kick();
+        bytes = sim.i2cBytes;
+        cycles = sim.modeCycles[SIM_MODE_ACTIVE];
+        (void) pm_enter(CY_SYSPM_DEEPSLEEP);
+        if (sim.i2cBytes != bytes)
+        {
+            pollCycles += sim.modeCycles[SIM_MODE_ACTIVE] - cycles;
+            polls++;
+            sim_i2c_decode(sim.i2cRx, sim.i2cBytes - bytes);
+        }
+    }
+    wdt_svc_timer_stop(0U);
+
+    printf("%lu min, map of %lu bytes read every %lu ms: %lu reads, %lu bytes\n",
+           (unsigned long)minutes, (unsigned long)sizeof(pm_stats_t), (unsigned long)pollMs,
+           (unsigned long)polls, (unsigned long)sim.i2cBytes);
+    printf("served in place from pm_stats: %s\n", (sim.i2cBuffer == (const uint8_t *)&pm_stats) ? "yes" : "no");
+    printf("Active time per read wakeup: %.1f us\n",
+           (polls != 0U) ? (1e6 * (double)pollCycles / polls / sim.hfclkHz) : 0.0);
+    printf("wakeups: %lu total, %lu Deep Sleep in the map, %lu from the WDT\n",
+           (unsigned long)sim.wakeups, (unsigned long)pm_stats.wakeups[1],
+           (unsigned long)wdt_svc_stats()->interrupts);
+    printf("residency (ILO ticks): Active %llu, Sleep %llu, Deep Sleep %llu\n",
+           (unsigned long long)pm_stats_residency_ticks(&pm_stats, PM_STATS_ACTIVE),
+           (unsigned long long)pm_stats_residency_ticks(&pm_stats, PM_STATS_SLEEP),
+           (unsigned long long)pm_stats_residency_ticks(&pm_stats, PM_STATS_DEEPSLEEP));
+    printf("charge estimate (uA s): Active %lu, Sleep %lu, Deep Sleep %lu; simulator %.0f\n",
+           (unsigned long)pm_stats.charge[PM_STATS_ACTIVE], (unsigned long)pm_stats.charge[PM_STATS_SLEEP],
+           (unsigned long)pm_stats.charge[PM_STATS_DEEPSLEEP], sim_charge_uas(&sim.energy, &sim_kits[0]));
+    printf("exit latency (cycles): weighted mean %.1f, std %.1f; p50 %lu, p99 %lu\n",
+           (double)pm_stats.exitMean / (1U << FXSTAT_EWMA_FRAC), sqrt((double)pm_stats.exitVar),
+           (unsigned long)fxstat_hist_quantile(pm_stats.exitHist, PM_STATS_HIST_BINS, PM_STATS_HIST_SHIFT,
+                                               FXSTAT_Q16(500U)),
+           (unsigned long)fxstat_hist_quantile(pm_stats.exitHist, PM_STATS_HIST_BINS, PM_STATS_HIST_SHIFT,
+                                               FXSTAT_Q16(990U)));
+    printf("latency (cycles)   entry    exit\n");
+    for (i = 0U; i < PM_STATS_HIST_BINS; i++)
+    {
+        if (i < (PM_STATS_HIST_BINS - 1U))
+        {
+            printf("  < %-14lu %7u %7u\n", 1UL << (PM_STATS_HIST_SHIFT + i),
+                   pm_stats.entryHist[i], pm_stats.exitHist[i]);
+        }
+        else
+        {
+            printf("  >= %-13lu %7u %7u\n", 1UL << (PM_STATS_HIST_SHIFT + i - 1U),
+                   pm_stats.entryHist[i], pm_stats.exitHist[i]);
+        }
+    }
+    printf("map check errors: %lu\n", (unsigned long)errors);
+
+    return ((errors == 0U) && (polls != 0U)) ? 0 : 1;
+}
+
+/* [] END OF FILE */
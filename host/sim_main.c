@@ -0,0 +1,106 @@
+/******************************************************************************
+* File Name: sim_main.c
+*
+* Description: Host simulator entry point. Runs the scenario named on the
+*              command line.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "sim.h"
+
+/*******************************************************************************
+ * Global variables
+ ******************************************************************************/
+static const struct
+{
+    const char *name;
+    int (*run)(int argc, char **argv);
+    const char *help;
+} scenarios[] =
+{
+    { "gpio", sim_gpio, "[seconds]  LED port accesses, Cy_GPIO_Write vs gpio_out" },
+    { "clock", sim_clock, "           flash wait states and CPI per HFCLK frequency" },
+    { "supply", sim_supply, "[minutes]  supply policy over a sagging VDDD trace" },
+    { "pd", sim_pd, "[hours] [seed]  Deep Sleep residency under USB-PD attach / detach traffic" },
+    { "wdt", sim_wdt, "[minutes] [period_ms]  wakeups of the watchdog service, merged vs separate feeding" },
+    { "i2c", sim_i2c, "[minutes] [poll_ms]  I2C master polling the telemetry register map" },
+    { "uart", sim_uart, "[capture]  binary vs text UART telemetry, bytes and Active time per report" },
+    { "fxstat", sim_fxstat, "[samples] [seed]  fixed-point statistics vs soft-float, cycles and error" },
+    { "qhist", sim_qhist, "[samples] [seed]  Deep Sleep exit latency p50/p99 estimator vs exact" },
+    { "seqlock", sim_seqlock, "[reads] [seed]  statistics snapshots under interleaved interrupt writers" },
+    { "prof", sim_prof, "[hours] [capture]  PC sampling profiler vs exact Active cycles per function" },
+    { "cyccnt", sim_cyccnt, "[spans] [seed]  SysTick cycle counter probes vs exact span cycles" },
+    { "bench", sim_bench, "[runs]  Microbenchmark firmware harness, report vs the PDL cost model" },
+    { "defer", sim_defer, "[presses] [seed]  deferred vs inline switch handler, ISR cycles and queue depth" },
+    { "pool", sim_pool, "[events] [seed]  fixed-block pools vs newlib nano malloc, cycles and failures" },
+    { "wake", sim_wake, "[hours] [hfclk_mhz]  wake path from flash vs SRAM, cycles per wakeup and charge" },
+    { "trace", sim_trace, "[events] [seed]  packed trace records, events per KB and cycles per event" },
+    { "button", sim_button, "[days] [seed]  a month of button presses, discrete-event speed" },
+    { "app", sim_app, "[hours] [blink_ms] [debounce_ms] [hfclk_mhz]  application core under bouncy presses" },
+    { "sweep", sim_sweep, "[hours] [jobs]  parallel sweep of the application core parameters" },
+    { "days", sim_days, "[days] [users] [debounce_ms] [jobs]  Monte Carlo daily charge and wakeups per TARGET" },
+};
+
+int main(int argc, char **argv)
+{
+    size_t i;
+
+    if (argc >= 2)
+    {
+        for (i = 0U; i < (sizeof(scenarios) / sizeof(scenarios[0])); i++)
+        {
+            if (strcmp(argv[1], scenarios[i].name) == 0)
+            {
+                return scenarios[i].run(argc - 2, &argv[2]);
+            }
+        }
+    }
+
+    fprintf(stderr, "usage: %s <scenario> [args]\n", argv[0]);
+    for (i = 0U; i < (sizeof(scenarios) / sizeof(scenarios[0])); i++)
+    {
+        fprintf(stderr, "  %-10s %s\n", scenarios[i].name, scenarios[i].help);
+    }
+
+    return 1;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,273 @@
+/******************************************************************************
+* File Name: sim_pd.c
+*
+* Description: Scenario 'pd': Deep Sleep residency with the USB-PD activity
+*              gate under a simulated CC event source. Attach sequences (CC
+*              debounce, VBUS ramp, contract negotiation), periodic PD
+*              messages while attached, and detaches are generated with
+*              random timing and reported to the gate as the USB-PD
+*              interrupt handlers would.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "sim.h"
+#include "pm_module.h"
+#include "pd_gate.h"
+#include "wdt_svc.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+#define SIM_PD_DEBOUNCE_MS      (150U)
+#define SIM_PD_VBUS_RAMP_MS     (100U)
+#define SIM_PD_NEGOTIATE_MIN_MS (200U)
+#define SIM_PD_NEGOTIATE_MAX_MS (600U)
+#define SIM_PD_MSG_PERIOD_MS    (60000U)
+#define SIM_PD_MSG_MS           (20U)
+#define SIM_PD_DETACH_MS        (50U)
+#define SIM_PD_DETACHED_MEAN_MS (20.0 * 60000.0)
+#define SIM_PD_ATTACHED_MEAN_MS (15.0 * 60000.0)
+
+/*******************************************************************************
+ * Data types
+ ******************************************************************************/
+typedef enum
+{
+    PD_PHASE_DETACHED,
+    PD_PHASE_DEBOUNCE,
+    PD_PHASE_VBUS_RAMP,
+    PD_PHASE_NEGOTIATE,
+    PD_PHASE_ATTACHED,
+    PD_PHASE_MSG,
+    PD_PHASE_DETACHING
+} sim_pd_phase_t;
+
+/*******************************************************************************
+ * Global variables
+ ******************************************************************************/
+static sim_pd_phase_t phase;
+static uint64_t nextMs;
+static uint64_t detachMs;
+static uint64_t endMs;
+static uint64_t rngState;
+static uint32_t attaches;
+static uint32_t violations;
+
+static double sim_pd_uniform(void)
+{
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 7;
+    rngState ^= rngState << 17;
+    return ((double)(rngState >> 11) + 0.5) / 9007199254740992.0;
+}
+
+static uint64_t sim_pd_exp_ms(double meanMs)
+{
+    return (uint64_t)(-meanMs * log(sim_pd_uniform()));
+}
+
+static uint64_t sim_pd_min(uint64_t a, uint64_t b)
+{
+    return (a < b) ? a : b;
+}
+
+/*******************************************************************************
+ * Function Name: sim_pd_event
+ *******************************************************************************
+ *
+ * Summary:
+ *  CC event source. Steps the attach / detach state machine, raises the
+ *  USB-PD interrupt on every activity change and schedules the next step.
+ *
+ ******************************************************************************/
+static void sim_pd_event(void)
+{
+    uint64_t now = sim_now_ms();
+
+    if (now >= endMs)
+    {
+        /* Wake up to end the run */
+        sim_raise_irq(usbpd_0_interrupt_IRQn);
+        return;
+    }
+
+    switch (phase)
+    {
+        case PD_PHASE_DETACHED:
+            attaches++;
+            pd_gate_set(PD_GATE_CC);
+            phase = PD_PHASE_DEBOUNCE;
+            nextMs = now + SIM_PD_DEBOUNCE_MS;
+            break;
+
+        case PD_PHASE_DEBOUNCE:
+            pd_gate_clear(PD_GATE_CC);
+            pd_gate_set(PD_GATE_VBUS);
+            phase = PD_PHASE_VBUS_RAMP;
+            nextMs = now + SIM_PD_VBUS_RAMP_MS;
+            break;
+
+        case PD_PHASE_VBUS_RAMP:
+            pd_gate_clear(PD_GATE_VBUS);
+            pd_gate_set(PD_GATE_PD_MSG);
+            phase = PD_PHASE_NEGOTIATE;
+            nextMs = now + SIM_PD_NEGOTIATE_MIN_MS +
+                     (uint64_t)(sim_pd_uniform() * (SIM_PD_NEGOTIATE_MAX_MS - SIM_PD_NEGOTIATE_MIN_MS));
+            break;
+
+        case PD_PHASE_NEGOTIATE:
+        case PD_PHASE_MSG:
+            pd_gate_clear(PD_GATE_PD_MSG);
+            if (phase == PD_PHASE_NEGOTIATE)
+            {
+                detachMs = now + sim_pd_exp_ms(SIM_PD_ATTACHED_MEAN_MS);
+            }
+            phase = PD_PHASE_ATTACHED;
+            nextMs = sim_pd_min(now + SIM_PD_MSG_PERIOD_MS, detachMs);
+            break;
+
+        case PD_PHASE_ATTACHED:
+            if (now >= detachMs)
+            {
+                pd_gate_set(PD_GATE_CC);
+                pd_gate_set(PD_GATE_VBUS);
+                phase = PD_PHASE_DETACHING;
+                nextMs = now + SIM_PD_DETACH_MS;
+            }
+            else
+            {
+                pd_gate_set(PD_GATE_PD_MSG);
+                phase = PD_PHASE_MSG;
+                nextMs = now + SIM_PD_MSG_MS;
+            }
+            break;
+
+        default:
+            pd_gate_clear(PD_GATE_CC);
+            pd_gate_clear(PD_GATE_VBUS);
+            phase = PD_PHASE_DETACHED;
+            nextMs = now + sim_pd_exp_ms(SIM_PD_DETACHED_MEAN_MS);
+            break;
+    }
+
+    sim_raise_irq(usbpd_0_interrupt_IRQn);
+    sim_schedule(sim_ms_to_cycles(sim_pd_min(nextMs, endMs)), sim_pd_event);
+}
+
+static void sim_pd_isr(void)
+{
+}
+
+/* Checks that Deep Sleep is never entered with PD activity pending */
+static cy_en_syspm_status_t sim_pd_check(cy_en_syspm_callback_type_t type,
+                                         cy_en_syspm_callback_mode_t mode)
+{
+    (void) type;
+
+    if ((mode == CY_SYSPM_BEFORE_TRANSITION) && pd_gate_busy())
+    {
+        violations++;
+    }
+
+    return CY_SYSPM_SUCCESS;
+}
+
+static const cy_stc_sysint_t sim_pd_intr = { usbpd_0_interrupt_IRQn, 1U };
+
+PM_MODULE_DEFINE(sim_pd_module, PM_PRIORITY_LOW,
+    .callback = sim_pd_check,
+    .types    = PM_TYPE_DEEPSLEEP,
+    .wakeIntr = &sim_pd_intr,
+    .wakeIsr  = sim_pd_isr);
+
+/*******************************************************************************
+ * Function Name: sim_pd
+ *******************************************************************************
+ *
+ * Summary:
+ *  Scenario entry: sim pd [hours] [seed]
+ *
+ ******************************************************************************/
+int sim_pd(int argc, char **argv)
+{
+    uint32_t hours = (argc > 0) ? (uint32_t)strtoul(argv[0], NULL, 0) : 1U;
+    double total;
+
+    /* splitmix64 of the seed, so small seeds give well mixed xorshift states */
+    rngState = (argc > 1) ? strtoull(argv[1], NULL, 0) : 1U;
+    rngState += 0x9E3779B97F4A7C15ULL;
+    rngState = (rngState ^ (rngState >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    rngState = (rngState ^ (rngState >> 27)) * 0x94D049BB133111EBULL;
+    rngState ^= rngState >> 31;
+    rngState = (rngState == 0U) ? 1U : rngState;
+    endMs = (uint64_t)((hours != 0U) ? hours : 1U) * 3600000U;
+    phase = PD_PHASE_DETACHED;
+    nextMs = sim_pd_exp_ms(SIM_PD_DETACHED_MEAN_MS);
+
+    sim_reset();
+    sim_schedule(sim_ms_to_cycles(sim_pd_min(nextMs, endMs)), sim_pd_event);
+    (void) pm_init();
+    __enable_irq();
+
+    while (sim_now_ms() < endMs)
+    {
+        wdt_svc_kick();
+        if (pm_enter(CY_SYSPM_DEEPSLEEP) == CY_SYSPM_FAIL)
+        {
+            (void) pm_enter(CY_SYSPM_SLEEP);
+        }
+    }
+
+    total = (double)sim.cycles;
+    printf("simulated %.1f h, %lu attaches, %lu wakeups\n", sim.cycles / (double)sim.hfclkHz / 3600.0,
+           (unsigned long)attaches, (unsigned long)sim.wakeups);
+    printf("residency: Deep Sleep %.3f %%, Sleep %.3f %%, Active %.3f %%\n",
+           100.0 * sim.modeCycles[SIM_MODE_DEEPSLEEP] / total,
+           100.0 * sim.modeCycles[SIM_MODE_SLEEP] / total,
+           100.0 * sim.modeCycles[SIM_MODE_ACTIVE] / total);
+    printf("Deep Sleep blocked %lu times, entered with PD activity %lu times\n",
+           (unsigned long)pd_gate_blocked_count(), (unsigned long)violations);
+
+    return (violations == 0U) ? 0 : 1;
+}
+
+/* [] END OF FILE */
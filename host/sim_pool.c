@@ -0,0 +1,558 @@
+/******************************************************************************
+* File Name: sim_pool.c
+*
+* Description: Event payload allocation benchmark. The same stream of event
+*              payloads, of mixed sizes and lifetimes, is allocated from the
+*              fixed-block pools of pool.c and from a model of the newlib
+*              nano malloc() on a heap of the same size: cycles per call,
+*              failed allocations, and the payloads checked intact.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+#include "pool.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+#define SIM_POOL_EVENTS         (200000UL)
+#define SIM_POOL_LIVE_MAX       (512U)      /* Live events at most */
+
+/* RAM for the payloads: the heap, or the storage of the pools */
+#define SIM_POOL_BUDGET         (2048U)
+
+/* Payloads: a button event, a statistics record, a log record. Sizes in
+ * bytes, multiples of 8 so the blocks of the 64-bit host are those of the
+ * Cortex-M0; shares per 2^16. */
+#define SIM_POOL_KINDS          (3U)
+
+/* Lifetimes in events: most payloads are consumed by the next main loop
+ * iterations, a few are held, for example until the UART is free */
+#define SIM_POOL_LIFE_MEAN      (8U)
+#define SIM_POOL_HELD_SHARE     (3277U)     /* Per 2^16: 5 % */
+#define SIM_POOL_HELD_MEAN      (1000U)
+
+/* Cortex-M0 cost of pool.c, with the call, counted from the instruction
+ * sequences: PRIMASK save and restore, list or storage update, counters.
+ * Interrupts are masked for the list update only. */
+#define SIM_CYCLES_POOL_ALLOC   (38U)
+#define SIM_CYCLES_POOL_FRESH   (44U)       /* From the storage never taken */
+#define SIM_CYCLES_POOL_FREE    (30U)
+#define SIM_CYCLES_POOL_MASKED  (24U)
+
+/* Cortex-M0 cost of the newlib nano malloc() and free(), with the call and
+ * the empty __malloc_lock() and __malloc_unlock() calls: fixed part, per
+ * free list chunk visited, then the split, the _sbrk() call, the merge
+ * with a neighbouring free chunk */
+#define SIM_CYCLES_MALLOC       (56U)
+#define SIM_CYCLES_MALLOC_CHUNK (9U)
+#define SIM_CYCLES_MALLOC_SPLIT (12U)
+#define SIM_CYCLES_MALLOC_SBRK  (40U)
+#define SIM_CYCLES_FREE         (44U)
+#define SIM_CYCLES_FREE_CHUNK   (8U)
+#define SIM_CYCLES_FREE_MERGE   (10U)
+
+/* Heap model: a size word before each payload, chunks aligned to 8 bytes,
+ * and a free chunk is at least the size word and the list link */
+#define SIM_HEAP_HEADER         (4U)
+#define SIM_HEAP_ALIGN          (8U)
+#define SIM_HEAP_MIN_CHUNK      (16U)
+#define SIM_HEAP_NONE           (0xFFFFFFFFUL)
+
+/*******************************************************************************
+ * Data types
+ ******************************************************************************/
+/* Live event */
+typedef struct
+{
+    uint8_t *payload;
+    uint32_t kind;
+    uint32_t tag;                       /* Written over the payload */
+    uint32_t expires;                   /* Event number freeing it */
+} sim_pool_event_t;
+
+/* Cycles of one allocator */
+typedef struct
+{
+    uint64_t allocs;
+    uint64_t allocCycles;
+    uint32_t allocMax;
+    uint64_t frees;
+    uint64_t freeCycles;
+    uint32_t freeMax;
+    uint32_t failed;
+    uint32_t corrupted;
+} sim_pool_cost_t;
+
+/*******************************************************************************
+ * Global variables
+ ******************************************************************************/
+static const uint32_t kindSize[SIM_POOL_KINDS] = { 8U, 24U, 64U };
+static const uint32_t kindShare[SIM_POOL_KINDS] = { 45875U, 16384U, 3277U };
+
+/* One pool per payload kind, SIM_POOL_BUDGET bytes in all */
+static POOL_DEFINE(buttonPool, 8U, 64U);
+static POOL_DEFINE(statsPool, 24U, 32U);
+static POOL_DEFINE(logPool, 64U, 12U);
+static pool_t *const pools[SIM_POOL_KINDS] = { &buttonPool, &statsPool, &logPool };
+
+/* Heap: free chunks in address order, each starting with its size and the
+ * offset of the next; the break past the chunks ever taken */
+static uint32_t heap[SIM_POOL_BUDGET / 4U];
+static uint32_t heapFree;
+static uint32_t heapBrk;
+static uint32_t heapUsed;
+static uint32_t heapPeak;
+static uint32_t heapFragFailed;         /* Failed with enough free bytes */
+
+static sim_pool_event_t live[SIM_POOL_LIVE_MAX];
+static uint32_t liveCount;
+static uint32_t liveKind[SIM_POOL_KINDS];
+static uint32_t liveKindMax[SIM_POOL_KINDS];
+static uint64_t rngState;
+
+static uint32_t sim_pool_rand(void)
+{
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 7;
+    rngState ^= rngState << 17;
+    return (uint32_t)(rngState >> 32);
+}
+
+/* Geometric, with the given mean */
+static uint32_t sim_pool_life(uint32_t mean)
+{
+    uint32_t life = 1U;
+
+    while ((sim_pool_rand() % mean) != 0U)
+    {
+        life++;
+    }
+
+    return life;
+}
+
+static uint32_t *sim_heap_word(uint32_t offset)
+{
+    return &heap[offset / 4U];
+}
+
+static void sim_pool_charge(sim_pool_cost_t *cost, bool alloc, uint32_t cycles)
+{
+    if (alloc)
+    {
+        cost->allocs++;
+        cost->allocCycles += cycles;
+        cost->allocMax = (cycles > cost->allocMax) ? cycles : cost->allocMax;
+    }
+    else
+    {
+        cost->frees++;
+        cost->freeCycles += cycles;
+        cost->freeMax = (cycles > cost->freeMax) ? cycles : cost->freeMax;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: sim_heap_malloc
+ *******************************************************************************
+ *
+ * Summary:
+ *  The newlib nano malloc(): first fit over the address ordered free list,
+ *  taking the tail of a larger chunk, else extending the break.
+ *
+ * Parameters:
+ *  size: Payload bytes.
+ *  cycles: Returns the cycles of the call.
+ *
+ * Return:
+ *  Payload, or NULL.
+ *
+ ******************************************************************************/
+static uint8_t *sim_heap_malloc(uint32_t size, uint32_t *cycles)
+{
+    uint32_t need = (size + SIM_HEAP_HEADER + SIM_HEAP_ALIGN - 1U) & ~(SIM_HEAP_ALIGN - 1U);
+    uint32_t prev = SIM_HEAP_NONE;
+    uint32_t chunk = heapFree;
+    uint32_t rest;
+
+    need = (need < SIM_HEAP_MIN_CHUNK) ? SIM_HEAP_MIN_CHUNK : need;
+    *cycles = SIM_CYCLES_MALLOC;
+    while (chunk != SIM_HEAP_NONE)
+    {
+        *cycles += SIM_CYCLES_MALLOC_CHUNK;
+        if (*sim_heap_word(chunk) >= need)
+        {
+            break;
+        }
+        prev = chunk;
+        chunk = *sim_heap_word(chunk + 4U);
+    }
+
+    if (chunk != SIM_HEAP_NONE)
+    {
+        rest = *sim_heap_word(chunk) - need;
+        if (rest >= SIM_HEAP_MIN_CHUNK)
+        {
+            *cycles += SIM_CYCLES_MALLOC_SPLIT;
+            *sim_heap_word(chunk) = rest;
+            chunk += rest;
+        }
+        else
+        {
+            need += rest;
+            if (prev == SIM_HEAP_NONE)
+            {
+                heapFree = *sim_heap_word(chunk + 4U);
+            }
+            else
+            {
+                *sim_heap_word(prev + 4U) = *sim_heap_word(chunk + 4U);
+            }
+        }
+    }
+    else
+    {
+        *cycles += SIM_CYCLES_MALLOC_SBRK;
+        if ((heapBrk + need) > SIM_POOL_BUDGET)
+        {
+            if ((SIM_POOL_BUDGET - heapUsed) >= need)
+            {
+                heapFragFailed++;
+            }
+            return NULL;
+        }
+        chunk = heapBrk;
+        heapBrk += need;
+    }
+
+    *sim_heap_word(chunk) = need;
+    heapUsed += need;
+    heapPeak = (heapUsed > heapPeak) ? heapUsed : heapPeak;
+
+    return (uint8_t *)sim_heap_word(chunk + SIM_HEAP_HEADER);
+}
+
+/*******************************************************************************
+ * Function Name: sim_heap_free
+ *******************************************************************************
+ *
+ * Summary:
+ *  The newlib nano free(): inserts the chunk into the address ordered free
+ *  list, merging it with the chunks before and after it.
+ *
+ * Parameters:
+ *  payload: Payload from sim_heap_malloc().
+ *
+ * Return:
+ *  Cycles of the call.
+ *
+ ******************************************************************************/
+static uint32_t sim_heap_free(uint8_t *payload)
+{
+    uint32_t chunk = (uint32_t)((payload - (uint8_t *)heap) - SIM_HEAP_HEADER);
+    uint32_t size = *sim_heap_word(chunk);
+    uint32_t cycles = SIM_CYCLES_FREE;
+    uint32_t prev;
+    uint32_t next;
+
+    heapUsed -= size;
+    if ((heapFree == SIM_HEAP_NONE) || (chunk < heapFree))
+    {
+        next = heapFree;
+        if ((next != SIM_HEAP_NONE) && ((chunk + size) == next))
+        {
+            cycles += SIM_CYCLES_FREE_MERGE;
+            size += *sim_heap_word(next);
+            next = *sim_heap_word(next + 4U);
+        }
+        *sim_heap_word(chunk) = size;
+        *sim_heap_word(chunk + 4U) = next;
+        heapFree = chunk;
+        return cycles;
+    }
+
+    /* The free chunk before it */
+    prev = heapFree;
+    next = *sim_heap_word(prev + 4U);
+    while ((next != SIM_HEAP_NONE) && (next < chunk))
+    {
+        cycles += SIM_CYCLES_FREE_CHUNK;
+        prev = next;
+        next = *sim_heap_word(prev + 4U);
+    }
+
+    if ((prev + *sim_heap_word(prev)) == chunk)
+    {
+        cycles += SIM_CYCLES_FREE_MERGE;
+        *sim_heap_word(prev) += size;
+        chunk = prev;
+    }
+    else
+    {
+        *sim_heap_word(chunk) = size;
+        *sim_heap_word(prev + 4U) = chunk;
+    }
+    if ((next != SIM_HEAP_NONE) && ((chunk + *sim_heap_word(chunk)) == next))
+    {
+        cycles += SIM_CYCLES_FREE_MERGE;
+        *sim_heap_word(chunk) += *sim_heap_word(next);
+        next = *sim_heap_word(next + 4U);
+    }
+    *sim_heap_word(chunk + 4U) = next;
+
+    return cycles;
+}
+
+/* Allocates a payload of the given kind */
+static uint8_t *sim_pool_alloc(bool heapAlloc, uint32_t kind, sim_pool_cost_t *cost)
+{
+    uint16_t fresh = pools[kind]->fresh;
+    uint32_t cycles;
+    uint8_t *payload;
+
+    if (heapAlloc)
+    {
+        payload = sim_heap_malloc(kindSize[kind], &cycles);
+    }
+    else
+    {
+        payload = pool_alloc(pools[kind]);
+        cycles = (pools[kind]->fresh != fresh) ? SIM_CYCLES_POOL_FRESH : SIM_CYCLES_POOL_ALLOC;
+    }
+    sim_pool_charge(cost, true, cycles);
+
+    return payload;
+}
+
+/* Frees the live event at index i, checking its payload */
+static void sim_pool_release(bool heapAlloc, uint32_t i, sim_pool_cost_t *cost)
+{
+    sim_pool_event_t *event = &live[i];
+    uint32_t j;
+
+    for (j = 0U; j < kindSize[event->kind]; j += 4U)
+    {
+        if (memcmp(&event->payload[j], &event->tag, 4U) != 0)
+        {
+            cost->corrupted++;
+            break;
+        }
+    }
+
+    if (heapAlloc)
+    {
+        sim_pool_charge(cost, false, sim_heap_free(event->payload));
+    }
+    else
+    {
+        pool_free(pools[event->kind], event->payload);
+        sim_pool_charge(cost, false, SIM_CYCLES_POOL_FREE);
+    }
+    liveKind[event->kind]--;
+    *event = live[--liveCount];
+}
+
+/*******************************************************************************
+ * Function Name: sim_pool_run
+ *******************************************************************************
+ *
+ * Summary:
+ *  Allocates the event stream of the seed, frees every payload when it
+ *  expires and the rest at the end.
+ *
+ * Parameters:
+ *  heapAlloc: Use the heap model instead of the pools.
+ *  events: Events of the stream.
+ *  seed: Stream seed.
+ *  cost: Returns the cycles and failures.
+ *
+ ******************************************************************************/
+static void sim_pool_run(bool heapAlloc, uint32_t events, uint64_t seed, sim_pool_cost_t *cost)
+{
+    sim_pool_event_t *event;
+    uint32_t n;
+    uint32_t i;
+    uint32_t kind;
+    uint32_t r;
+
+    /* splitmix64 of the seed: both allocators see the same stream */
+    rngState = seed + 0x9E3779B97F4A7C15ULL;
+    rngState = (rngState ^ (rngState >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    rngState = (rngState ^ (rngState >> 27)) * 0x94D049BB133111EBULL;
+    rngState ^= rngState >> 31;
+    rngState = (rngState == 0U) ? 1U : rngState;
+
+    memset(cost, 0, sizeof(*cost));
+    memset(liveKind, 0, sizeof(liveKind));
+    memset(liveKindMax, 0, sizeof(liveKindMax));
+    liveCount = 0U;
+    heapFree = SIM_HEAP_NONE;
+    heapBrk = 0U;
+    heapUsed = 0U;
+    heapPeak = 0U;
+    heapFragFailed = 0U;
+
+    for (n = 1U; n <= events; n++)
+    {
+        /* The payloads consumed by now */
+        for (i = 0U; i < liveCount; )
+        {
+            if (live[i].expires <= n)
+            {
+                sim_pool_release(heapAlloc, i, cost);
+            }
+            else
+            {
+                i++;
+            }
+        }
+
+        r = sim_pool_rand() & 0xFFFFU;
+        for (kind = 0U; (kind < (SIM_POOL_KINDS - 1U)) && (r >= kindShare[kind]); kind++)
+        {
+            r -= kindShare[kind];
+        }
+        r = sim_pool_rand();
+        i = ((sim_pool_rand() & 0xFFFFU) < SIM_POOL_HELD_SHARE) ? sim_pool_life(SIM_POOL_HELD_MEAN) :
+                                                                  sim_pool_life(SIM_POOL_LIFE_MEAN);
+        if (liveCount == SIM_POOL_LIVE_MAX)
+        {
+            continue;
+        }
+
+        event = &live[liveCount];
+        event->payload = sim_pool_alloc(heapAlloc, kind, cost);
+        if (event->payload == NULL)
+        {
+            cost->failed++;
+            continue;
+        }
+        event->kind = kind;
+        event->tag = r;
+        event->expires = n + i;
+        for (i = 0U; i < kindSize[kind]; i += 4U)
+        {
+            memcpy(&event->payload[i], &r, 4U);
+        }
+        liveCount++;
+        liveKind[kind]++;
+        liveKindMax[kind] = (liveKind[kind] > liveKindMax[kind]) ? liveKind[kind] : liveKindMax[kind];
+    }
+
+    while (liveCount > 0U)
+    {
+        sim_pool_release(heapAlloc, liveCount - 1U, cost);
+    }
+}
+
+static void sim_pool_print(const char *name, const sim_pool_cost_t *cost, uint32_t failed)
+{
+    printf("%-8s %10.1f %6lu %10.1f %6lu %8lu %8lu %9lu\n", name,
+           (double)cost->allocCycles / ((cost->allocs != 0U) ? cost->allocs : 1U), (unsigned long)cost->allocMax,
+           (double)cost->freeCycles / ((cost->frees != 0U) ? cost->frees : 1U), (unsigned long)cost->freeMax,
+           (unsigned long)cost->failed, (unsigned long)failed, (unsigned long)cost->corrupted);
+}
+
+/*******************************************************************************
+ * Function Name: sim_pool
+ *******************************************************************************
+ *
+ * Summary:
+ *  Scenario entry: sim pool [events] [seed]
+ *
+ ******************************************************************************/
+int sim_pool(int argc, char **argv)
+{
+    uint32_t events = (argc > 0) ? (uint32_t)strtoul(argv[0], NULL, 0) : SIM_POOL_EVENTS;
+    uint64_t seed = (argc > 1) ? strtoull(argv[1], NULL, 0) : 1U;
+    sim_pool_cost_t heapCost;
+    sim_pool_cost_t poolCost;
+    uint32_t poolFailed[SIM_POOL_KINDS];
+    uint32_t storage = 0U;
+    uint32_t kind;
+    int result = 0;
+
+    events = (events != 0U) ? events : SIM_POOL_EVENTS;
+
+    sim_pool_run(true, events, seed, &heapCost);
+    printf("pool: %lu events of %lu/%lu/%lu bytes, %lu byte heap, peak %lu bytes in use\n",
+           (unsigned long)events, (unsigned long)kindSize[0], (unsigned long)kindSize[1],
+           (unsigned long)kindSize[2], (unsigned long)SIM_POOL_BUDGET, (unsigned long)heapPeak);
+    printf("%-8s %10s %6s %10s %6s %8s %8s %9s\n", "", "alloc mean", "max", "free mean", "max",
+           "failed", "frag", "corrupted");
+    sim_pool_print("malloc", &heapCost, heapFragFailed);
+
+    for (kind = 0U; kind < SIM_POOL_KINDS; kind++)
+    {
+        poolFailed[kind] = pools[kind]->failed;
+    }
+    sim_pool_run(false, events, seed, &poolCost);
+    sim_pool_print("pool", &poolCost, 0U);
+
+    for (kind = 0U; kind < SIM_POOL_KINDS; kind++)
+    {
+        storage += (uint32_t)(pools[kind]->units * pools[kind]->count * sizeof(pool_block_t));
+        poolFailed[kind] = pools[kind]->failed - poolFailed[kind];
+        printf("  %2lu byte payloads: %2u blocks of %2u bytes, high water %2u, failed %lu\n",
+               (unsigned long)kindSize[kind], pools[kind]->count, (unsigned)(pools[kind]->units * sizeof(pool_block_t)),
+               pools[kind]->highWater, (unsigned long)poolFailed[kind]);
+
+        /* The pool counts what the stream did */
+        if ((pools[kind]->used != 0U) || (pools[kind]->highWater != liveKindMax[kind]))
+        {
+            result = 1;
+        }
+    }
+    printf("interrupts masked per pool call: %u cycles; malloc() and free() are not reentrant\n",
+           SIM_CYCLES_POOL_MASKED);
+
+    if ((heapCost.corrupted != 0U) || (poolCost.corrupted != 0U) || (storage != SIM_POOL_BUDGET) ||
+        (poolCost.failed != (poolFailed[0] + poolFailed[1] + poolFailed[2])) ||
+        (poolCost.allocMax > SIM_CYCLES_POOL_FRESH) || (poolCost.freeMax != SIM_CYCLES_POOL_FREE))
+    {
+        result = 1;
+    }
+
+    return result;
+}
+
+/* [] END OF FILE */
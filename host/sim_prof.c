@@ -0,0 +1,316 @@
+/******************************************************************************
+* File Name: sim_prof.c
+*
+* Description: PC sampling profiler scenario. Runs the application core with
+*              the profiler counter clocked, decodes the profiler frames from
+*              the UART output and compares the sampled flat profile with the
+*              exact Active cycles of each function.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+#include "elfsym.h"
+#include "telemetry_frame.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Profiler counter clock: CYBSP_PROF_TIMER_config counts 1000 clocks */
+#define SIM_PROF_CLOCK_HZ       (1000000UL)
+
+/* Code sites of the exact profile, and PCs of the sampled one */
+#define SIM_PROF_SITES          (8192U)
+
+#define SIM_PROF_TOP            (12U)
+
+/* Largest difference of a sampled share from the exact one, percentage
+ * points of Active time. The counts are decimated in long Active stretches,
+ * so the samples are too few and too regular for a binomial bound. */
+#define SIM_PROF_TOL_PCT        (0.5)
+
+/*******************************************************************************
+ * Global variables
+ ******************************************************************************/
+static uint64_t sitePc[SIM_PROF_SITES];
+static double siteCycles[SIM_PROF_SITES];
+static size_t sites;
+static uint64_t stoppedCycles;
+static uint64_t sampledPc[SIM_PROF_SITES];
+static double sampledCount[SIM_PROF_SITES];
+static size_t sampledPcs;
+static FILE *capture;
+
+/*******************************************************************************
+ * Function Name: sim_prof_count
+ *******************************************************************************
+ *
+ * Summary:
+ *  Adds to the count of a PC in a table, linear probing from its hash.
+ *
+ ******************************************************************************/
+static void sim_prof_count(uint64_t *pcs, double *counts, size_t *used, uint64_t pc, double count)
+{
+    size_t slot = (size_t)((pc * 0x9E3779B97F4A7C15ULL) >> 51) & (SIM_PROF_SITES - 1U);
+
+    while ((counts[slot] != 0.0) && (pcs[slot] != pc))
+    {
+        slot = (slot + 1U) & (SIM_PROF_SITES - 1U);
+    }
+    if (counts[slot] == 0.0)
+    {
+        if (*used == (SIM_PROF_SITES - 1U))
+        {
+            return;
+        }
+        pcs[slot] = pc;
+        (*used)++;
+    }
+    counts[slot] += count;
+}
+
+/* Active cycles outside the profiler interrupt. The counter is stopped
+ * around the sleep transitions, dumps included: that time is not sampled. */
+static void sim_prof_active(uintptr_t pc, uint64_t cycles)
+{
+    if (sim.tcpwmRunning)
+    {
+        sim_prof_count(sitePc, siteCycles, &sites, pc, (double)cycles);
+    }
+    else
+    {
+        stoppedCycles += cycles;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: sim_prof_setup
+ *******************************************************************************
+ *
+ * Summary:
+ *  Clocks the profiler counter and taps the Active cycles, before pm_init()
+ *  starts the counter.
+ *
+ ******************************************************************************/
+static void sim_prof_setup(void)
+{
+    sim.tcpwmClockHz = SIM_PROF_CLOCK_HZ;
+    sim.uartCapture = capture;
+    sim.activeCycles = sim_prof_active;
+}
+
+/*******************************************************************************
+ * Function Name: sim_prof_decode
+ *******************************************************************************
+ *
+ * Summary:
+ *  Decodes the profiler frames of the UART output.
+ *
+ * Parameters:
+ *  samples: Returns the samples taken.
+ *  dropped: Returns the samples dropped.
+ *
+ * Return:
+ *  Frames with a bad CRC or payload.
+ *
+ ******************************************************************************/
+static uint32_t sim_prof_decode(uint32_t *samples, uint32_t *dropped)
+{
+    uint8_t wire[TELEMETRY_FRAME_MAX_WIRE];
+    uint8_t raw[TELEMETRY_FRAME_MAX_RAW];
+    size_t wireLen = 0U;
+    size_t length;
+    size_t pos;
+    size_t used;
+    uint32_t value[2];
+    uint32_t errors = 0U;
+    uint32_t field;
+    int c;
+
+    rewind(capture);
+    while ((c = fgetc(capture)) != EOF)
+    {
+        if (c != TELEMETRY_FRAME_DELIMITER)
+        {
+            wire[wireLen] = (uint8_t)c;
+            wireLen = (wireLen < (sizeof(wire) - 1U)) ? (wireLen + 1U) : wireLen;
+            continue;
+        }
+
+        length = telemetry_cobs_decode(raw, sizeof(raw), wire, wireLen);
+        wireLen = 0U;
+        if ((length < (TELEMETRY_FRAME_HEADER + TELEMETRY_FRAME_CRC)) ||
+            (telemetry_crc16(TELEMETRY_FRAME_CRC_INIT, raw, length - TELEMETRY_FRAME_CRC) !=
+             (uint16_t)(raw[length - 2U] | (raw[length - 1U] << 8))))
+        {
+            errors++;
+            continue;
+        }
+        if (raw[0] != TELEMETRY_FRAME_PROF)
+        {
+            continue;
+        }
+
+        /* samples, dropped, then pc/count pairs */
+        length -= TELEMETRY_FRAME_CRC;
+        pos = TELEMETRY_FRAME_HEADER;
+        for (field = 0U; pos < length; field++)
+        {
+            used = telemetry_varint_decode(&raw[pos], length - pos, &value[field & 1U]);
+            if (used == 0U)
+            {
+                errors++;
+                break;
+            }
+            pos += used;
+            if (field == 0U)
+            {
+                *samples += value[0];
+            }
+            else if (field == 1U)
+            {
+                *dropped += value[1];
+            }
+            else if ((field & 1U) != 0U)
+            {
+                sim_prof_count(sampledPc, sampledCount, &sampledPcs, value[0], value[1]);
+            }
+            else
+            {
+                /* PC of the next pair */
+            }
+        }
+    }
+
+    return errors;
+}
+
+/*******************************************************************************
+ * Function Name: sim_prof
+ *******************************************************************************
+ *
+ * Summary:
+ *  Scenario entry: sim prof [hours] [capture]. Prints the functions with the
+ *  most Active cycles, their exact and sampled shares, and the cost of the
+ *  profiler; the capture holds the UART output for tdecode -e host/sim.
+ *
+ ******************************************************************************/
+int sim_prof(int argc, char **argv)
+{
+    sim_app_params_t p = { 6U, 1U, SIM_PRESS_STEADY, 48U, 30U, 1U, 3U, 200U, sim_prof_setup };
+    sim_app_result_t r;
+    elfsym_table_t table;
+    static elfsym_flat_t exact[SIM_PROF_SITES];
+    static elfsym_flat_t sampled[SIM_PROF_SITES];
+    size_t exactFuncs;
+    size_t sampledFuncs;
+    double profiled = 0.0;
+    double total = 0.0;
+    double active;
+    double share;
+    double err;
+    uint32_t samples = 0U;
+    uint32_t dropped = 0U;
+    uint32_t errors;
+    uint32_t failed = 0U;
+    size_t i;
+    size_t j;
+
+    p.hours = (argc > 0) ? (uint32_t)strtoul(argv[0], NULL, 0) : p.hours;
+    p.hours = (p.hours != 0U) ? p.hours : 6U;
+    capture = (argc > 1) ? fopen(argv[1], "w+b") : tmpfile();
+    if (capture == NULL)
+    {
+        perror((argc > 1) ? argv[1] : "tmpfile");
+        return 1;
+    }
+    if (!elfsym_load(&table, "/proc/self/exe"))
+    {
+        fprintf(stderr, "no symbols in /proc/self/exe\n");
+        return 1;
+    }
+
+    sim_app_run(&p, &r);
+    sim.activeCycles = NULL;
+    sim.uartCapture = NULL;
+    (void) fflush(capture);
+    errors = sim_prof_decode(&samples, &dropped);
+
+    exactFuncs = elfsym_flat(&table, sitePc, siteCycles, SIM_PROF_SITES, exact);
+    sampledFuncs = elfsym_flat(&table, sampledPc, sampledCount, SIM_PROF_SITES, sampled);
+    for (i = 0U; i < exactFuncs; i++)
+    {
+        profiled += exact[i].count;
+    }
+    for (i = 0U; i < sampledFuncs; i++)
+    {
+        total += sampled[i].count;
+    }
+    active = (double)sim.modeCycles[SIM_MODE_ACTIVE];
+
+    printf("%lu h, %lu wakeups: Active %.3f s, %lu samples (%lu dropped), %lu UART bytes\n",
+           (unsigned long)p.hours, (unsigned long)r.wakeups, active / sim.hfclkHz, (unsigned long)samples,
+           (unsigned long)dropped, (unsigned long)sim.uartBytes);
+    printf("profiler interrupt %.3f %% of Active cycles, counter stopped %.3f %% (sleep transitions)\n",
+           (100.0 * (active - profiled - (double)stoppedCycles)) / active, (100.0 * (double)stoppedCycles) / active);
+    printf("%-32s %8s %8s\n", "function", "exact %", "sampled");
+    for (i = 0U; (i < exactFuncs) && (i < SIM_PROF_TOP); i++)
+    {
+        share = exact[i].count / profiled;
+        for (j = 0U; (j < sampledFuncs) && (strcmp(sampled[j].name, exact[i].name) != 0); j++)
+        {
+        }
+        err = ((j < sampledFuncs) ? (sampled[j].count / total) : 0.0) - share;
+        failed += ((100.0 * fabs(err)) > SIM_PROF_TOL_PCT) ? 1U : 0U;
+        printf("%-32.32s %8.2f %8.2f\n", exact[i].name, 100.0 * share, 100.0 * (share + err));
+    }
+    printf("%lu frame errors, %lu functions off by more than %.1f %%\n", (unsigned long)errors,
+           (unsigned long)failed, SIM_PROF_TOL_PCT);
+
+    elfsym_free(&table);
+    (void) fclose(capture);
+    capture = NULL;
+
+    return ((errors == 0U) && (failed == 0U) && (samples != 0U)) ? 0 : 1;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,267 @@
+/******************************************************************************
+* File Name: sim_qhist.c
+*
+* Description: Streaming quantile estimator scenario. Feeds latency sample
+*              streams of several shapes to qhist_add() and compares p50 and
+*              p99 with the exact quantiles of the stored samples, and with
+*              the 8-bin exit latency histogram of the register map.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+#include "fxstat.h"
+#include "pm_stats.h"
+#include "qhist.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+#define SIM_QHIST_SAMPLES       (200000UL)
+
+/* Cortex-M0 cost of qhist_add(), with the call, counted from the instruction
+ * sequence: the four-step search for the leading one, the bin index and the
+ * 16-bit counter update; then one pass over the bins when a counter
+ * saturates (LDRH, ADDS, LSRS, STRH and the loop per bin). */
+#define SIM_CYCLES_QHIST_ADD    (60U)
+#define SIM_CYCLES_QHIST_HALVE  ((uint32_t)QHIST_BINS * 10U)
+
+#define SIM_QHIST_SHAPES        (4U)
+
+/*******************************************************************************
+ * Global variables
+ ******************************************************************************/
+static uint64_t rngState;
+
+static double sim_qhist_rand(void)
+{
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 7;
+    rngState ^= rngState << 17;
+    return ((double)(rngState >> 11) + 0.5) / 9007199254740992.0;
+}
+
+static double sim_qhist_normal(void)
+{
+    return sqrt(-2.0 * log(sim_qhist_rand())) * cos(6.283185307179586 * sim_qhist_rand());
+}
+
+/*******************************************************************************
+ * Function Name: sim_qhist_sample
+ *******************************************************************************
+ *
+ * Summary:
+ *  Returns an exit latency in cycles, of one of the stream shapes.
+ *
+ ******************************************************************************/
+static uint32_t sim_qhist_sample(uint32_t shape)
+{
+    double cycles;
+
+    switch (shape)
+    {
+        case 0U:
+            /* Log-normal around 1500 cycles */
+            cycles = 1500.0 * exp(0.3 * sim_qhist_normal());
+            break;
+
+        case 1U:
+            /* Mostly GPIO wakeups, 10 % with the HFCLK restore */
+            cycles = (sim_qhist_rand() < 0.9) ? (1200.0 + (50.0 * sim_qhist_normal()))
+                                              : (9000.0 + (400.0 * sim_qhist_normal()));
+            break;
+
+        case 2U:
+            /* Pareto tail, alpha 2.5, from 900 cycles */
+            cycles = 900.0 / pow(sim_qhist_rand(), 1.0 / 2.5);
+            break;
+
+        default:
+            /* Narrow: the same path every time, a few cycles of jitter */
+            cycles = 850.0 + (40.0 * sim_qhist_rand());
+            break;
+    }
+
+    return (cycles < 1.0) ? 1U : ((cycles > 1e9) ? 1000000000U : (uint32_t)cycles);
+}
+
+static int sim_qhist_compare(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+/*******************************************************************************
+ * Function Name: sim_qhist_exact
+ *******************************************************************************
+ *
+ * Summary:
+ *  Returns the exact quantile of sorted samples, with the rank of
+ *  qhist_quantile().
+ *
+ ******************************************************************************/
+static uint32_t sim_qhist_exact(const uint32_t *sorted, uint32_t count, uint32_t q16)
+{
+    uint32_t rank = (uint32_t)(((uint64_t)count * q16) >> 16);
+
+    return sorted[(rank < count) ? rank : (count - 1U)];
+}
+
+/*******************************************************************************
+ * Function Name: sim_qhist_map_add
+ *******************************************************************************
+ *
+ * Summary:
+ *  Counts a sample in a histogram laid out as the exit latency histogram of
+ *  the register map (pm_stats_t.exitHist).
+ *
+ ******************************************************************************/
+static void sim_qhist_map_add(uint16_t *hist, uint32_t cycles)
+{
+    uint32_t scaled = cycles >> PM_STATS_HIST_SHIFT;
+    uint32_t bin = 0U;
+
+    while ((scaled != 0U) && (bin < (PM_STATS_HIST_BINS - 1U)))
+    {
+        scaled >>= 1U;
+        bin++;
+    }
+    if (hist[bin] != UINT16_MAX)
+    {
+        hist[bin]++;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: sim_qhist
+ *******************************************************************************
+ *
+ * Summary:
+ *  Scenario entry: sim qhist [samples] [seed]
+ *
+ ******************************************************************************/
+int sim_qhist(int argc, char **argv)
+{
+    static const char *shapeNames[SIM_QHIST_SHAPES] = { "log-normal", "bimodal", "Pareto tail", "narrow" };
+    static const uint32_t q[2] = { 500U, 990U };
+    uint32_t count = (argc > 0) ? (uint32_t)strtoul(argv[0], NULL, 0) : SIM_QHIST_SAMPLES;
+    uint32_t *samples;
+    uint16_t mapHist[PM_STATS_HIST_BINS];
+    qhist_t hist = QHIST_INIT;
+    uint64_t halvings;
+    uint32_t exact;
+    uint32_t est;
+    uint32_t map;
+    uint32_t shape;
+    uint32_t bin;
+    uint32_t i;
+    uint32_t k;
+    double err;
+    double worst = 0.0;
+
+    /* splitmix64 of the seed, so small seeds give well mixed xorshift states */
+    rngState = (argc > 1) ? strtoull(argv[1], NULL, 0) : 1U;
+    rngState += 0x9E3779B97F4A7C15ULL;
+    rngState = (rngState ^ (rngState >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    rngState = (rngState ^ (rngState >> 27)) * 0x94D049BB133111EBULL;
+    rngState ^= rngState >> 31;
+    rngState = (rngState == 0U) ? 1U : rngState;
+    count = (count != 0U) ? count : SIM_QHIST_SAMPLES;
+
+    samples = malloc(count * sizeof(*samples));
+    if (samples == NULL)
+    {
+        return 2;
+    }
+
+    printf("qhist: %u bins, %u per octave, from %u cycles, %u bytes; %lu samples per shape\n",
+           (unsigned)QHIST_BINS, (unsigned)QHIST_SUB, 1U << QHIST_MIN_SHIFT, (unsigned)sizeof(qhist_t),
+           (unsigned long)count);
+    printf("%-12s %9s %9s %7s %9s   %9s %9s %7s %9s\n", "shape", "p50", "qhist", "error", "map",
+           "p99", "qhist", "error", "map");
+
+    halvings = 0U;
+    for (shape = 0U; shape < SIM_QHIST_SHAPES; shape++)
+    {
+        memset(&hist.bins, 0, sizeof(hist.bins));
+        hist.samples = 0U;
+        memset(mapHist, 0, sizeof(mapHist));
+        for (i = 0U; i < count; i++)
+        {
+            samples[i] = sim_qhist_sample(shape);
+            for (bin = 0U; (bin < QHIST_BINS) && (hist.bins[bin] != UINT16_MAX); bin++)
+            {
+            }
+            halvings += (bin < QHIST_BINS) ? 1U : 0U;
+            qhist_add(&hist, samples[i]);
+            sim_qhist_map_add(mapHist, samples[i]);
+        }
+        qsort(samples, count, sizeof(*samples), sim_qhist_compare);
+
+        printf("%-12s", shapeNames[shape]);
+        for (k = 0U; k < 2U; k++)
+        {
+            exact = sim_qhist_exact(samples, count, FXSTAT_Q16(q[k]));
+            est = qhist_quantile(&hist, FXSTAT_Q16(q[k]));
+            map = fxstat_hist_quantile(mapHist, PM_STATS_HIST_BINS, PM_STATS_HIST_SHIFT, FXSTAT_Q16(q[k]));
+            err = ((double)est - exact) / exact;
+            worst = fmax(worst, fabs(err));
+            printf(" %9lu %9lu %+6.1f%% %9lu  ", (unsigned long)exact, (unsigned long)est, 100.0 * err,
+                   (unsigned long)map);
+        }
+        printf("\n");
+    }
+
+    printf("update: %u cycles, %u more when a counter saturates (%llu times, %.2f cycles per sample)\n",
+           SIM_CYCLES_QHIST_ADD, SIM_CYCLES_QHIST_HALVE, (unsigned long long)halvings,
+           SIM_CYCLES_QHIST_ADD + ((double)halvings * SIM_CYCLES_QHIST_HALVE / (SIM_QHIST_SHAPES * (double)count)));
+    /* The estimate and the exact value share a bin, at most 1 / QHIST_SUB of
+     * its lower bound wide */
+    printf("worst quantile error %.1f%% (bound %.1f%%)\n", 100.0 * worst, 100.0 / QHIST_SUB);
+    free(samples);
+
+    return (worst <= (1.0 / QHIST_SUB)) ? 0 : 1;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,339 @@
+/******************************************************************************
+* File Name: sim_seqlock.c
+*
+* Description: Sequence lock stress scenario. The main loop takes snapshots
+*              of a block the size of the register map with seqlock_read(),
+*              while simulated interrupts land between any two words of the
+*              copy: a button handler that rewrites the block, and an EZI2C
+*              handler that reads it. Every snapshot reported consistent
+*              must be; plain copies of the block show the tearing the lock
+*              prevents.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+#include "cybsp.h"
+#include "pm_stats.h"
+#include "seqlock.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+#define SIM_SEQLOCK_READS       (100000UL)
+
+/* Guarded block: as many words as the register map */
+#define SIM_SEQLOCK_WORDS       (sizeof(pm_stats_t) / 4U)
+
+/* Interrupt rates, per 2^16 steps of main loop code */
+#define SIM_SEQLOCK_RATES       (3U)
+
+/* Main loop operations */
+#define SIM_SEQLOCK_OP_READ     (0U)    /* seqlock_read() */
+#define SIM_SEQLOCK_OP_PLAIN    (1U)    /* Copy without the lock */
+#define SIM_SEQLOCK_OP_WRITE    (2U)    /* Update, like pm_enter() */
+
+/*******************************************************************************
+ * Global variables
+ ******************************************************************************/
+static uint64_t rngState;
+
+static const cy_stc_sysint_t writerIntr = { CYBSP_USER_BTN_IRQ, 3U };
+static const cy_stc_sysint_t readerIntr = { CYBSP_I2C_IRQ, 3U };
+
+/* Every word of the block holds the number of the update that wrote it */
+static struct
+{
+    uint32_t words[SIM_SEQLOCK_WORDS];
+    seqlock_t lock;
+} shared = { .lock = SEQLOCK_INIT };
+
+static uint32_t updates;
+static uint32_t writeRate;
+static uint32_t readRate;
+static uint32_t isrWrites;
+static uint32_t isrReads;
+static uint32_t isrFailed;
+static uint32_t isrRetried;
+static uint64_t isrWords;           /* Words the handlers copied */
+
+static uint32_t sim_seqlock_rand(void)
+{
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 7;
+    rngState ^= rngState << 17;
+    return (uint32_t)(rngState >> 32);
+}
+
+/* Snapshot of one update throughout, no older than seen */
+static bool sim_seqlock_consistent(const uint32_t *words, uint32_t seen)
+{
+    uint32_t i;
+
+    for (i = 1U; i < SIM_SEQLOCK_WORDS; i++)
+    {
+        if (words[i] != words[0])
+        {
+            return false;
+        }
+    }
+
+    return words[0] >= seen;
+}
+
+/* Update of the whole block, one charged word at a time */
+static void sim_seqlock_write(void)
+{
+    uint32_t savedIntr = seqlock_write_begin(&shared.lock);
+    uint32_t i;
+
+    updates++;
+    for (i = 0U; i < SIM_SEQLOCK_WORDS; i++)
+    {
+        shared.words[i] = updates;
+        sim_copy_word();
+    }
+    seqlock_write_end(&shared.lock, savedIntr);
+}
+
+/* Button handler: updates the block, as a statistics writer in an
+ * interrupt would */
+static void sim_seqlock_writer_isr(void)
+{
+    isrWrites++;
+    sim_seqlock_write();
+    isrWords += SIM_SEQLOCK_WORDS;
+}
+
+/* EZI2C handler: reads the block; never preempts an update */
+static void sim_seqlock_reader_isr(void)
+{
+    uint32_t copy[SIM_SEQLOCK_WORDS];
+    uint64_t words = sim.copyWords;
+
+    isrReads++;
+    if (!seqlock_read(&shared.lock, copy, shared.words, sizeof(copy)) || !sim_seqlock_consistent(copy, 0U))
+    {
+        isrFailed++;
+    }
+    if ((sim.copyWords - words) != SIM_SEQLOCK_WORDS)
+    {
+        isrRetried++;
+    }
+    isrWords += sim.copyWords - words;
+}
+
+/* Interrupts landing in the main loop code */
+static void sim_seqlock_preempt(void)
+{
+    uint32_t r = sim_seqlock_rand() & 0xFFFFU;
+
+    if (r < writeRate)
+    {
+        sim_raise_irq(writerIntr.intrSrc);
+    }
+    else if (r < (writeRate + readRate))
+    {
+        sim_raise_irq(readerIntr.intrSrc);
+    }
+    else
+    {
+        return;
+    }
+    sim_dispatch_irqs();
+}
+
+/*******************************************************************************
+ * Function Name: sim_seqlock
+ *******************************************************************************
+ *
+ * Summary:
+ *  Scenario entry: sim seqlock [reads] [seed]
+ *
+ ******************************************************************************/
+int sim_seqlock(int argc, char **argv)
+{
+    /* Button writes and EZI2C reads per 2^16 steps: rare, one update per few
+     * snapshots, and more updates than snapshots */
+    static const uint32_t rates[SIM_SEQLOCK_RATES][2] = { { 16U, 64U }, { 1024U, 1024U }, { 8192U, 2048U } };
+    uint32_t reads = (argc > 0) ? (uint32_t)strtoul(argv[0], NULL, 0) : SIM_SEQLOCK_READS;
+    uint32_t copy[SIM_SEQLOCK_WORDS];
+    uint32_t attempts[SEQLOCK_READ_RETRIES + 1U];
+    uint32_t seen;
+    uint32_t snapshots;
+    uint32_t failed;
+    uint32_t wrong;
+    uint32_t unbounded;
+    uint32_t plain;
+    uint32_t torn;
+    uint32_t op;
+    uint32_t rate;
+    uint32_t i;
+    uint64_t words;
+    uint64_t cycles;
+    bool ok;
+    int result = 0;
+
+    /* splitmix64 of the seed, so small seeds give well mixed xorshift states */
+    rngState = (argc > 1) ? strtoull(argv[1], NULL, 0) : 1U;
+    rngState += 0x9E3779B97F4A7C15ULL;
+    rngState = (rngState ^ (rngState >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    rngState = (rngState ^ (rngState >> 27)) * 0x94D049BB133111EBULL;
+    rngState ^= rngState >> 31;
+    rngState = (rngState == 0U) ? 1U : rngState;
+    reads = (reads != 0U) ? reads : SIM_SEQLOCK_READS;
+
+    printf("seqlock: %lu word block, up to %u retries, %u cycles per word copied\n",
+           (unsigned long)SIM_SEQLOCK_WORDS, SEQLOCK_READ_RETRIES, SIM_CYCLES_COPY_WORD);
+    printf("%-13s %8s", "per 64K steps", "reads");
+    for (i = 0U; i <= SEQLOCK_READ_RETRIES; i++)
+    {
+        printf(" %7s%lu", "try ", (unsigned long)(i + 1U));
+    }
+    printf(" %7s %7s %7s %9s\n", "failed", "torn", "ISR rd", "cyc/read");
+
+    for (rate = 0U; rate < SIM_SEQLOCK_RATES; rate++)
+    {
+        sim_reset();
+        memset(&shared, 0, sizeof(shared));
+        (void) Cy_SysInt_Init(&writerIntr, sim_seqlock_writer_isr);
+        (void) Cy_SysInt_Init(&readerIntr, sim_seqlock_reader_isr);
+        NVIC_EnableIRQ(writerIntr.intrSrc);
+        NVIC_EnableIRQ(readerIntr.intrSrc);
+        __enable_irq();
+
+        writeRate = rates[rate][0];
+        readRate = rates[rate][1];
+        updates = 0U;
+        isrWrites = 0U;
+        isrReads = 0U;
+        isrFailed = 0U;
+        isrRetried = 0U;
+        isrWords = 0U;
+        seen = 0U;
+        snapshots = 0U;
+        failed = 0U;
+        wrong = 0U;
+        unbounded = 0U;
+        plain = 0U;
+        torn = 0U;
+        cycles = 0U;
+        for (i = 0U; i <= SEQLOCK_READ_RETRIES; i++)
+        {
+            attempts[i] = 0U;
+        }
+        sim.preempt = sim_seqlock_preempt;
+
+        while (snapshots < reads)
+        {
+            op = sim_seqlock_rand() % 4U;
+            op = (op < 2U) ? SIM_SEQLOCK_OP_READ : ((op == 2U) ? SIM_SEQLOCK_OP_PLAIN : SIM_SEQLOCK_OP_WRITE);
+
+            if (op == SIM_SEQLOCK_OP_READ)
+            {
+                words = sim.copyWords - isrWords;
+                cycles -= sim.cycles;
+                ok = seqlock_read(&shared.lock, copy, shared.words, sizeof(copy));
+                cycles += sim.cycles;
+
+                /* Attempts made: blocks copied, less those of the handlers.
+                 * A failed read has made them all. */
+                snapshots++;
+                i = (uint32_t)((sim.copyWords - isrWords - words) / SIM_SEQLOCK_WORDS);
+                if ((i == 0U) || (i > (SEQLOCK_READ_RETRIES + 1U)) ||
+                    (!ok && (i != (SEQLOCK_READ_RETRIES + 1U))))
+                {
+                    unbounded++;
+                }
+                else if (!ok)
+                {
+                    failed++;
+                }
+                else if (!sim_seqlock_consistent(copy, seen))
+                {
+                    wrong++;
+                }
+                else
+                {
+                    attempts[i - 1U]++;
+                    seen = copy[0];
+                }
+            }
+            else if (op == SIM_SEQLOCK_OP_PLAIN)
+            {
+                for (i = 0U; i < SIM_SEQLOCK_WORDS; i++)
+                {
+                    copy[i] = shared.words[i];
+                    sim_copy_word();
+                }
+                plain++;
+                torn += sim_seqlock_consistent(copy, 0U) ? 0U : 1U;
+            }
+            else
+            {
+                sim_seqlock_write();
+            }
+        }
+        sim.preempt = NULL;
+
+        printf("%5lu w %5lu r %8lu", (unsigned long)writeRate, (unsigned long)readRate, (unsigned long)reads);
+        for (i = 0U; i <= SEQLOCK_READ_RETRIES; i++)
+        {
+            printf(" %8lu", (unsigned long)attempts[i]);
+        }
+        printf(" %7lu %7lu %7lu %9.1f\n", (unsigned long)failed, (unsigned long)torn, (unsigned long)isrReads,
+               (double)cycles / reads);
+        printf("  %lu button updates, %lu main loop; %lu of %lu plain copies torn; inconsistent snapshots %lu, "
+               "over the bound %lu, ISR reads failed %lu, retried %lu\n",
+               (unsigned long)isrWrites, (unsigned long)(updates - isrWrites), (unsigned long)torn,
+               (unsigned long)plain, (unsigned long)wrong, (unsigned long)unbounded, (unsigned long)isrFailed, (unsigned long)isrRetried);
+
+        if ((wrong != 0U) || (unbounded != 0U) || (isrFailed != 0U) || (isrRetried != 0U) ||
+            ((shared.lock.seq & 1U) != 0U) || (shared.lock.seq != (2U * updates)))
+        {
+            result = 1;
+        }
+    }
+
+    return result;
+}
+
+/* [] END OF FILE */
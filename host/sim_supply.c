@@ -0,0 +1,258 @@
+/******************************************************************************
+* File Name: sim_supply.c
+*
+* Description: Scenario 'supply': validates the supply policy over a VDDD
+*              trace of a discharging battery with noise, load dips and a
+*              charger reconnect. The device wakes on a periodic event and
+*              enters the low power mode the policy selects.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include "sim.h"
+#include "pm_module.h"
+#include "supply_mon.h"
+#include "wdt_svc.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+#define SIM_SUPPLY_EVENT_MS     (100U)          /* Periodic wake event */
+#define SIM_SUPPLY_EVENT_IRQ    ioss_interrupts_gpio_3_IRQn
+#define SIM_SUPPLY_FLAP_MS      (10000U)        /* Level reverted this fast */
+
+/*******************************************************************************
+ * Global variables
+ ******************************************************************************/
+static uint64_t durationMs;
+static uint64_t nextEventMs;
+static uint32_t noiseState = 1U;
+static const uint16_t *scriptMv;        /* Scripted samples instead of the trace */
+
+/* Samples alternating between two new levels: none of them may be confirmed
+ * until the last SUPPLY_MON_CONFIRM samples agree */
+static const uint16_t confirmScript[] =
+{
+    3300U, 3300U, 3300U, 2900U, 2700U, 2900U, 2900U, 2900U, 0U
+};
+
+/*******************************************************************************
+ * Function Name: sim_supply_trace
+ *******************************************************************************
+ *
+ * Summary:
+ *  VDDD trace: linear sag from 3.3 V to 2.6 V, +/-40 mV noise, 150 mV dips
+ *  for 2 s every 5 minutes, and a charger reconnect (3.25 V) for the last
+ *  fifth of the run.
+ *
+ ******************************************************************************/
+static uint16_t sim_supply_trace(uint64_t ms)
+{
+    int32_t mv;
+
+    if ((ms * 5U) >= (durationMs * 4U))
+    {
+        mv = 3250;
+    }
+    else
+    {
+        mv = 3300 - (int32_t)((700U * ms) / durationMs);
+    }
+
+    if ((ms % 300000U) < 2000U)
+    {
+        mv -= 150;
+    }
+
+    noiseState = (noiseState * 1103515245U) + 12345U;
+    mv += (int32_t)((noiseState >> 16) % 81U) - 40;
+
+    return (uint16_t)mv;
+}
+
+/* Application event source, every SIM_SUPPLY_EVENT_MS */
+static void sim_supply_event(void)
+{
+    sim_raise_irq(SIM_SUPPLY_EVENT_IRQ);
+    nextEventMs += SIM_SUPPLY_EVENT_MS;
+    sim_schedule(sim_ms_to_cycles(nextEventMs), sim_supply_event);
+}
+
+static void sim_supply_isr(void)
+{
+}
+
+/* VDDD measured by the USB-PD block ADC: the trace, or the scripted samples */
+static uint16_t sim_supply_vddd(uint64_t ms)
+{
+    return (scriptMv != NULL) ? *scriptMv++ : sim_supply_trace(ms);
+}
+
+/*******************************************************************************
+ * Function Name: sim_supply_confirm
+ *******************************************************************************
+ *
+ * Summary:
+ *  Feeds confirmScript to supply_mon_sample() and returns the number of
+ *  samples after which the level is wrong.
+ *
+ ******************************************************************************/
+static uint32_t sim_supply_confirm(void)
+{
+    uint32_t errors = 0U;
+    uint32_t i;
+
+    scriptMv = confirmScript;
+    for (i = 0U; confirmScript[i] != 0U; i++)
+    {
+        supply_mon_sample();
+        if (supply_mon_level() != ((i < 7U) ? SUPPLY_LEVEL_NOMINAL : SUPPLY_LEVEL_LOW))
+        {
+            errors++;
+        }
+    }
+    scriptMv = NULL;
+
+    printf("confirm: LOW, CRITICAL, LOW %s, LOW x%u %s\n",
+           (errors == 0U) ? "ignored" : "confirmed", (unsigned)SUPPLY_MON_CONFIRM,
+           (supply_mon_level() == SUPPLY_LEVEL_LOW) ? "confirmed" : "ignored");
+
+    return errors;
+}
+
+/*******************************************************************************
+ * Function Name: sim_supply
+ *******************************************************************************
+ *
+ * Summary:
+ *  Scenario entry: sim supply [minutes]
+ *
+ ******************************************************************************/
+int sim_supply(int argc, char **argv)
+{
+    static const cy_stc_sysint_t eventIntr = { SIM_SUPPLY_EVENT_IRQ, 3U };
+    static const char *names[] = { "NOMINAL", "LOW", "CRITICAL" };
+    uint64_t levelMs[3] = { 0U };
+    uint32_t deepSleeps[3] = { 0U };
+    uint32_t sleeps[3] = { 0U };
+    uint32_t changes = 0U;
+    uint32_t flaps = 0U;
+    uint32_t errors = 0U;
+    uint64_t lastChangeMs = 0U;
+    uint64_t startMs;
+    supply_level_t level;
+    supply_level_t prev;
+    supply_level_t prevPrev = SUPPLY_LEVEL_NOMINAL;
+    cy_en_syspm_callback_type_t type;
+    uint32_t minutes = (argc > 0) ? (uint32_t)strtoul(argv[0], NULL, 0) : 60U;
+    uint32_t i;
+
+    durationMs = (uint64_t)((minutes != 0U) ? minutes : 60U) * 60000U;
+    nextEventMs = SIM_SUPPLY_EVENT_MS;
+
+    sim_reset();
+    sim.vdddTrace = sim_supply_vddd;
+    sim_schedule(sim_ms_to_cycles(nextEventMs), sim_supply_event);
+    (void) Cy_SysInt_Init(&eventIntr, sim_supply_isr);
+    NVIC_EnableIRQ(eventIntr.intrSrc);
+    (void) pm_init();
+    __enable_irq();
+
+    prev = supply_mon_level();
+    while (sim_now_ms() < durationMs)
+    {
+        startMs = sim_now_ms();
+        level = supply_mon_level();
+        type = supply_policy_sleep_type(CY_SYSPM_SLEEP);
+
+        /* Policy: Deep Sleep only on nominal supply if asked for, throttled
+         * features below nominal */
+        if (((level == SUPPLY_LEVEL_NOMINAL) && (type != CY_SYSPM_SLEEP)) ||
+            ((level != SUPPLY_LEVEL_NOMINAL) && (type != CY_SYSPM_DEEPSLEEP)) ||
+            (supply_policy_throttle(3U) != ((level == SUPPLY_LEVEL_NOMINAL) ? 3U :
+                                            ((level == SUPPLY_LEVEL_LOW) ? 1U : 0U))))
+        {
+            errors++;
+        }
+
+        if (type == CY_SYSPM_DEEPSLEEP)
+        {
+            deepSleeps[level]++;
+        }
+        else
+        {
+            sleeps[level]++;
+        }
+        wdt_svc_kick();
+        (void) pm_enter(type);
+        levelMs[level] += sim_now_ms() - startMs;
+
+        level = supply_mon_level();
+        if (level != prev)
+        {
+            changes++;
+            if ((level == prevPrev) && ((startMs - lastChangeMs) < SIM_SUPPLY_FLAP_MS))
+            {
+                flaps++;
+            }
+            printf("%8.1f s  %4u mV  %s -> %s\n", startMs / 1000.0,
+                   (unsigned)supply_mon_last_mv(), names[prev], names[level]);
+            lastChangeMs = startMs;
+            prevPrev = prev;
+            prev = level;
+        }
+    }
+
+    printf("\n%-9s %10s %10s %12s %10s\n", "level", "time (s)", "Sleep", "Deep Sleep", "blinks");
+    for (i = 0U; i < 3U; i++)
+    {
+        printf("%-9s %10.1f %10lu %12lu %10s\n", names[i], levelMs[i] / 1000.0,
+               (unsigned long)sleeps[i], (unsigned long)deepSleeps[i],
+               (i == 0U) ? "3" : ((i == 1U) ? "1" : "0"));
+    }
+    printf("\nwakeups %lu, VDDD samples %lu, level changes %lu, flaps %lu, policy errors %lu\n",
+           (unsigned long)sim.wakeups, (unsigned long)(sim.wakeups / SUPPLY_MON_INTERVAL),
+           (unsigned long)changes, (unsigned long)flaps, (unsigned long)errors);
+    errors += sim_supply_confirm();
+
+    return ((errors == 0U) && (flaps == 0U)) ? 0 : 1;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,391 @@
+/******************************************************************************
+* File Name: sim_sweep.c
+*
+* Description: Scenario 'sweep': parallel parameter sweep of the application
+*              core (sim_app.c) over HFCLK, debounce window, Sleep / Deep
+*              Sleep press counts and LED blink time, and the batch runner
+*              behind it. Worker processes take the simulations from
+*              work-stealing deques in shared memory; each simulation runs in
+*              a process of its own, forked from its worker, so no firmware
+*              or simulator state is shared between runs. The results are
+*              collected into one table.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* fork(), mmap() and sysconf() with -std=c99 */
+#define _DEFAULT_SOURCE
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include "sim.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+#define SIM_SWEEP_MAX_JOBS      (64U)
+#define SIM_SWEEP_MAX_TASKS     (1024U)
+
+/*******************************************************************************
+ * Data types
+ ******************************************************************************/
+/* Deque of task indexes. The owner takes from the bottom, thieves from the
+ * top. Operations are short, so a spinlock per deque is enough. */
+typedef struct
+{
+    volatile bool lock;
+    uint32_t top;
+    uint32_t bottom;
+    uint16_t tasks[SIM_SWEEP_MAX_TASKS];
+} sim_sweep_deque_t;
+
+/* Shared between the runner, the workers and the simulation processes */
+typedef struct
+{
+    sim_sweep_deque_t deques[SIM_SWEEP_MAX_JOBS];
+    sim_app_params_t params[SIM_SWEEP_MAX_TASKS];
+    sim_app_result_t results[SIM_SWEEP_MAX_TASKS];
+    double cpuS[SIM_SWEEP_MAX_TASKS];
+    bool done[SIM_SWEEP_MAX_TASKS];
+    uint32_t steals[SIM_SWEEP_MAX_JOBS];
+} sim_sweep_shared_t;
+
+/* The sweep: parameters and results of every combination */
+typedef struct
+{
+    sim_app_params_t params[SIM_SWEEP_MAX_TASKS];
+    sim_app_result_t results[SIM_SWEEP_MAX_TASKS];
+    bool done[SIM_SWEEP_MAX_TASKS];
+} sim_sweep_grid_t;
+
+/*******************************************************************************
+ * Global variables
+ ******************************************************************************/
+static const uint32_t hfclkMhz[] = { 48U, 24U, 12U, 6U };
+static const uint32_t debounceMs[] = { 0U, 10U, 30U, 60U };
+static const uint32_t pressCounts[][2] = { { 1U, 3U }, { 1U, 2U }, { 2U, 3U } };
+static const uint32_t blinkMs[] = { 50U, 100U, 200U, 400U };
+
+#define SIM_SWEEP_COUNT(a)      (sizeof(a) / sizeof((a)[0]))
+
+static sim_sweep_shared_t *shared;
+static sim_sweep_grid_t grid;
+static uint32_t taskCount;
+
+static void sim_sweep_lock(sim_sweep_deque_t *deque)
+{
+    while (__atomic_test_and_set(&deque->lock, __ATOMIC_ACQUIRE))
+    {
+    }
+}
+
+static void sim_sweep_unlock(sim_sweep_deque_t *deque)
+{
+    __atomic_clear(&deque->lock, __ATOMIC_RELEASE);
+}
+
+/*******************************************************************************
+ * Function Name: sim_sweep_take
+ *******************************************************************************
+ *
+ * Summary:
+ *  Takes the next task of a worker: the newest of its own deque, or else the
+ *  oldest of another worker's deque. No tasks are added once the workers run,
+ *  so finding all deques empty means the sweep is done.
+ *
+ * Parameters:
+ *  self: Worker index.
+ *  jobs: Number of workers.
+ *  task: Returns the task index.
+ *
+ * Return:
+ *  false when there is no task left.
+ *
+ ******************************************************************************/
+static bool sim_sweep_take(uint32_t self, uint32_t jobs, uint32_t *task)
+{
+    sim_sweep_deque_t *deque = &shared->deques[self];
+    bool found = false;
+    uint32_t i;
+
+    sim_sweep_lock(deque);
+    if (deque->bottom > deque->top)
+    {
+        *task = deque->tasks[--deque->bottom];
+        found = true;
+    }
+    sim_sweep_unlock(deque);
+
+    for (i = 1U; (i < jobs) && !found; i++)
+    {
+        deque = &shared->deques[(self + i) % jobs];
+        sim_sweep_lock(deque);
+        if (deque->bottom > deque->top)
+        {
+            *task = deque->tasks[deque->top++];
+            found = true;
+            shared->steals[self]++;
+        }
+        sim_sweep_unlock(deque);
+    }
+
+    return found;
+}
+
+/* Runs one simulation in a fresh process */
+static void sim_sweep_run_task(uint32_t task)
+{
+    clock_t start;
+    pid_t pid;
+    int status;
+
+    pid = fork();
+    if (pid == 0)
+    {
+        start = clock();
+        sim_app_run(&shared->params[task], &shared->results[task]);
+        shared->cpuS[task] = (double)(clock() - start) / CLOCKS_PER_SEC;
+        shared->done[task] = true;
+        _exit(0);
+    }
+
+    if ((pid < 0) || (waitpid(pid, &status, 0) != pid))
+    {
+        perror("sweep task");
+    }
+}
+
+static void sim_sweep_worker(uint32_t self, uint32_t jobs)
+{
+    uint32_t task;
+
+    while (sim_sweep_take(self, jobs, &task))
+    {
+        sim_sweep_run_task(task);
+    }
+}
+
+/* Table order: average current, then worst latency */
+static int sim_sweep_compare(const void *a, const void *b)
+{
+    const sim_app_result_t *ra = &grid.results[*(const uint16_t *)a];
+    const sim_app_result_t *rb = &grid.results[*(const uint16_t *)b];
+
+    if (ra->avgUa != rb->avgUa)
+    {
+        return (ra->avgUa < rb->avgUa) ? -1 : 1;
+    }
+    return (ra->latencyMaxMs < rb->latencyMaxMs) ? -1 : (ra->latencyMaxMs > rb->latencyMaxMs);
+}
+
+/* Builds the parameter grid */
+static void sim_sweep_grid(uint32_t hours)
+{
+    sim_app_params_t p = { hours, 1U, SIM_PRESS_STEADY, 0U, 0U, 0U, 0U, 0U, NULL };
+    uint32_t a, b, c, d;
+
+    taskCount = 0U;
+    for (a = 0U; a < SIM_SWEEP_COUNT(hfclkMhz); a++)
+    {
+        for (b = 0U; b < SIM_SWEEP_COUNT(debounceMs); b++)
+        {
+            for (c = 0U; c < SIM_SWEEP_COUNT(pressCounts); c++)
+            {
+                for (d = 0U; d < SIM_SWEEP_COUNT(blinkMs); d++)
+                {
+                    p.hfclkMhz = hfclkMhz[a];
+                    p.debounceMs = debounceMs[b];
+                    p.sleepPress = pressCounts[c][0];
+                    p.deepSleepPress = pressCounts[c][1];
+                    p.blinkMs = blinkMs[d];
+                    grid.params[taskCount++] = p;
+                }
+            }
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: sim_batch_run
+ *******************************************************************************
+ *
+ * Summary:
+ *  Runs sim_app_run() for each parameter set, every run in a process of its
+ *  own, on a pool of worker processes. The tasks are dealt to the worker
+ *  deques in contiguous blocks.
+ *
+ * Parameters:
+ *  params: Parameters of the runs.
+ *  results: Returns the result of each run.
+ *  done: Returns whether each run completed.
+ *  count: Number of runs, up to SIM_SWEEP_MAX_TASKS.
+ *  jobs: Number of workers.
+ *  stats: Returns the totals of the batch.
+ *
+ * Return:
+ *  false if the batch could not be started.
+ *
+ ******************************************************************************/
+bool sim_batch_run(const sim_app_params_t *params, sim_app_result_t *results, bool *done,
+                   uint32_t count, uint32_t jobs, sim_batch_stats_t *stats)
+{
+    struct timespec start, end;
+    uint32_t worker;
+    uint32_t i;
+
+    jobs = (jobs == 0U) ? 1U : ((jobs > SIM_SWEEP_MAX_JOBS) ? SIM_SWEEP_MAX_JOBS : jobs);
+    if (count > SIM_SWEEP_MAX_TASKS)
+    {
+        fprintf(stderr, "batch of %lu runs, at most %u\n", (unsigned long)count, SIM_SWEEP_MAX_TASKS);
+        return false;
+    }
+
+    shared = mmap(NULL, sizeof(*shared), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (shared == MAP_FAILED)
+    {
+        perror("mmap");
+        return false;
+    }
+    memset(shared, 0, sizeof(*shared));
+    memcpy(shared->params, params, count * sizeof(params[0]));
+    for (i = 0U; i < count; i++)
+    {
+        worker = (i * jobs) / count;
+        shared->deques[worker].tasks[shared->deques[worker].bottom++] = (uint16_t)i;
+    }
+
+    (void) fflush(stdout);
+    (void) clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0U; i < jobs; i++)
+    {
+        if (fork() == 0)
+        {
+            sim_sweep_worker(i, jobs);
+            _exit(0);
+        }
+    }
+    while (wait(NULL) > 0)
+    {
+    }
+    (void) clock_gettime(CLOCK_MONOTONIC, &end);
+
+    memset(stats, 0, sizeof(*stats));
+    stats->wallS = (double)(end.tv_sec - start.tv_sec) + ((double)(end.tv_nsec - start.tv_nsec) / 1e9);
+    for (i = 0U; i < count; i++)
+    {
+        results[i] = shared->results[i];
+        done[i] = shared->done[i];
+        stats->cpuS += shared->cpuS[i];
+        stats->failed += shared->done[i] ? 0U : 1U;
+    }
+    for (i = 0U; i < jobs; i++)
+    {
+        stats->steals += shared->steals[i];
+    }
+
+    (void) munmap(shared, sizeof(*shared));
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: sim_sweep
+ *******************************************************************************
+ *
+ * Summary:
+ *  Scenario entry: sim sweep [hours] [jobs]. Every combination simulates the
+ *  same press trace; jobs defaults to the number of online CPUs.
+ *
+ ******************************************************************************/
+int sim_sweep(int argc, char **argv)
+{
+    uint32_t hours = (argc > 0) ? (uint32_t)strtoul(argv[0], NULL, 0) : 6U;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    uint32_t jobs = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : (uint32_t)((cpus > 0) ? cpus : 1);
+    uint16_t order[SIM_SWEEP_MAX_TASKS];
+    sim_batch_stats_t stats;
+    uint32_t i;
+    const sim_app_params_t *p;
+    const sim_app_result_t *r;
+
+    hours = (hours != 0U) ? hours : 6U;
+    jobs = (jobs == 0U) ? 1U : ((jobs > SIM_SWEEP_MAX_JOBS) ? SIM_SWEEP_MAX_JOBS : jobs);
+
+    sim_sweep_grid(hours);
+    if (!sim_batch_run(grid.params, grid.results, grid.done, taskCount, jobs, &stats))
+    {
+        return 2;
+    }
+
+    for (i = 0U; i < taskCount; i++)
+    {
+        order[i] = (uint16_t)i;
+    }
+    qsort(order, taskCount, sizeof(order[0]), sim_sweep_compare);
+
+    printf("%4s %8s %6s %6s %8s %9s %8s %9s %9s %8s\n", "MHz", "debounce", "sleep", "deep", "blink",
+           "avg uA", "DS %", "lat mean", "lat max", "counted");
+    for (i = 0U; i < taskCount; i++)
+    {
+        p = &grid.params[order[i]];
+        r = &grid.results[order[i]];
+        if (!grid.done[order[i]])
+        {
+            continue;
+        }
+        printf("%4lu %6lums %6lu %6lu %6lums %9.1f %8.3f %7.1fms %7.1fms %4lu/%-4lu\n",
+               (unsigned long)p->hfclkMhz, (unsigned long)p->debounceMs, (unsigned long)p->sleepPress,
+               (unsigned long)p->deepSleepPress, (unsigned long)p->blinkMs, r->avgUa, r->deepSleepPct,
+               r->latencyMeanMs, r->latencyMaxMs, (unsigned long)r->counted, (unsigned long)r->presses);
+    }
+
+    printf("%lu simulations of %lu h, %lu workers, %lu steals, %lu failed\n", (unsigned long)taskCount,
+           (unsigned long)hours, (unsigned long)jobs, (unsigned long)stats.steals,
+           (unsigned long)stats.failed);
+    printf("wall %.2f s, simulation CPU %.2f s (%.2fx parallel)\n", stats.wallS, stats.cpuS,
+           stats.cpuS / stats.wallS);
+
+    return (stats.failed == 0U) ? 0 : 1;
+}
+
+/* [] END OF FILE */
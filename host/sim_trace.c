@@ -0,0 +1,355 @@
+/******************************************************************************
+* File Name: sim_trace.c
+*
+* Description: Scenario 'trace': density and cost of the packed trace records
+*              (telemetry_frame.c) compared with the 8 byte records of older
+*              firmware. Event streams of several shapes are framed with the
+*              policy of telemetry_uart_trace(), decoded again with the
+*              streaming decoder and checked against the input. Reports events
+*              per KB of buffer, and the Cortex-M0 cycles per event to encode,
+*              frame and send the records.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* clock_gettime() with -std=c99 */
+#define _DEFAULT_SOURCE
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "sim.h"
+#include "telemetry_uart.h"
+#include "pm_stats.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+#define SIM_TRACE_EVENTS        (100000U)
+
+/* Frame bytes around the payload: type, seq, CRC, COBS code, delimiter */
+#define SIM_TRACE_FRAME_BYTES   (TELEMETRY_FRAME_HEADER + TELEMETRY_FRAME_CRC + 2U)
+
+/* Cortex-M0 cost of telemetry_uart_trace() without the time read, counted
+ * from the instruction sequences. The 8 byte record: index, four stores,
+ * count update and full check. The packed record: delta and fit checks, the
+ * tag, the calls, and one varint byte; each further byte is one pass of the
+ * varint loop (compare, or, store, shift, branch). */
+#define SIM_CYCLES_TRACE_RAW    (32U)
+#define SIM_CYCLES_TRACE_PACK   (84U)
+#define SIM_CYCLES_TRACE_BYTE   (11U)
+
+/* CRC-16 (two nibble table lookups), COBS and copy, per frame byte */
+#define SIM_CYCLES_FRAME_BYTE   (30U)
+
+/*******************************************************************************
+ * Data types
+ ******************************************************************************/
+typedef enum
+{
+    SIM_TRACE_TIMER,            /* Timer wakeups every 250 ms */
+    SIM_TRACE_FEED,             /* Watchdog feeding only, every 1.5 s */
+    SIM_TRACE_PRESSES,          /* Button presses, 20 ms to 2 s apart */
+    SIM_TRACE_MIXED,            /* Wakeups with clock and supply changes */
+    SIM_TRACE_SHAPES
+} sim_trace_shape_t;
+
+/*******************************************************************************
+ * Global variables
+ ******************************************************************************/
+static const char *shapeNames[SIM_TRACE_SHAPES] = { "timer 250 ms", "feed 1.5 s", "presses", "mixed" };
+
+static uint64_t rngState;
+
+static double sim_trace_rand(void)
+{
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 7;
+    rngState ^= rngState << 17;
+    return ((double)(rngState >> 11) + 0.5) / 9007199254740992.0;
+}
+
+/*******************************************************************************
+ * Function Name: sim_trace_generate
+ *******************************************************************************
+ *
+ * Summary:
+ *  Fills an event stream of the given shape. Times are ILO ticks.
+ *
+ ******************************************************************************/
+static void sim_trace_generate(sim_trace_shape_t shape, telemetry_trace_t *events, uint32_t count)
+{
+    uint32_t ticks = 0x00012345U;
+    uint32_t i;
+    double r;
+
+    for (i = 0U; i < count; i++)
+    {
+        events[i].event = TELEMETRY_TRACE_WAKE;
+        events[i].arg = PM_STATS_DEEPSLEEP;
+        events[i].value = 0U;
+        r = sim_trace_rand();
+        switch (shape)
+        {
+            case SIM_TRACE_TIMER:
+                ticks += SIM_ILO_HZ / 4U;
+                break;
+
+            case SIM_TRACE_FEED:
+                ticks += (SIM_ILO_HZ * 3U) / 2U;
+                break;
+
+            case SIM_TRACE_PRESSES:
+                /* Log-uniform between 20 ms and 2 s */
+                ticks += (uint32_t)(0.02 * SIM_ILO_HZ * exp(r * log(100.0)));
+                break;
+
+            default:
+                if (r < 0.1)
+                {
+                    events[i].event = TELEMETRY_TRACE_CLOCK;
+                    events[i].arg = 0U;
+                    events[i].value = (sim_trace_rand() < 0.5) ? 24U : 48U;
+                    ticks += 2U;
+                }
+                else if (r < 0.2)
+                {
+                    events[i].event = TELEMETRY_TRACE_SUPPLY;
+                    events[i].arg = (uint8_t)(sim_trace_rand() * 4.0);
+                    events[i].value = (uint16_t)(2700.0 + (700.0 * sim_trace_rand()));
+                    ticks += (uint32_t)(sim_trace_rand() * SIM_ILO_HZ);
+                }
+                else
+                {
+                    events[i].arg = (sim_trace_rand() < 0.8) ? PM_STATS_DEEPSLEEP : PM_STATS_SLEEP;
+                    ticks += (uint32_t)(-0.5 * SIM_ILO_HZ * log(sim_trace_rand()));
+                }
+                break;
+        }
+        events[i].ticks = ticks;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: sim_trace_decode
+ *******************************************************************************
+ *
+ * Summary:
+ *  Decodes the packed frame payloads, stored back to back, and checks the
+ *  records against the events they were made from.
+ *
+ * Return:
+ *  Number of records decoded until the first malformed frame or wrong
+ *  record.
+ *
+ ******************************************************************************/
+static uint32_t sim_trace_decode(const uint8_t *stream, const uint8_t *frameLen, uint32_t frames,
+                                 const telemetry_trace_t *expected)
+{
+    telemetry_trace_decoder_t dec;
+    telemetry_trace_t rec;
+    uint32_t n = 0U;
+    uint32_t frame;
+    uint32_t end;
+
+    for (frame = 0U; frame < frames; frame++)
+    {
+        telemetry_trace_decode_start(&dec);
+        for (end = (uint32_t)frameLen[frame]; end != 0U; end--)
+        {
+            if (telemetry_trace_decode_byte(&dec, *stream++, &rec))
+            {
+                if ((rec.ticks != expected[n].ticks) || (rec.event != expected[n].event) ||
+                    (rec.arg != expected[n].arg) || (rec.value != expected[n].value))
+                {
+                    return n;
+                }
+                n++;
+            }
+        }
+        if (!telemetry_trace_decode_end(&dec))
+        {
+            break;
+        }
+    }
+
+    return n;
+}
+
+/*******************************************************************************
+ * Function Name: sim_trace_run
+ *******************************************************************************
+ *
+ * Summary:
+ *  Packs an event stream into frames the way telemetry_uart_trace() does,
+ *  decodes the frames and prints one line of results.
+ *
+ * Return:
+ *  true if every record decoded to its event.
+ *
+ ******************************************************************************/
+static bool sim_trace_run(sim_trace_shape_t shape, const telemetry_trace_t *events, uint32_t count)
+{
+    uint8_t *stream = malloc((size_t)count * (TELEMETRY_TRACE_MAX_BASE + TELEMETRY_TRACE_MAX_PACKED));
+    uint8_t *frameLen = malloc(count);
+    uint32_t bytes = 0U;
+    uint32_t len = 0U;
+    uint32_t frames = 0U;
+    uint32_t prev = 0U;
+    uint64_t encodeCycles = 0U;
+    uint32_t rawFrames = (count + 7U) / 8U;
+    uint32_t decoded;
+    double decodeNs;
+    double rawWire;
+    double packedWire;
+    double rawCycles;
+    double packedCycles;
+    struct timespec start;
+    struct timespec end;
+    size_t recLen;
+    uint32_t i;
+
+    if ((stream == NULL) || (frameLen == NULL))
+    {
+        perror("malloc");
+        exit(2);
+    }
+
+    for (i = 0U; i < count; i++)
+    {
+        if (((len + TELEMETRY_TRACE_MAX_PACKED) > TELEMETRY_UART_TRACE_BYTES) ||
+            ((events[i].ticks - prev) > TELEMETRY_TRACE_MAX_DELTA))
+        {
+            frameLen[frames++] = (uint8_t)len;
+            bytes += len;
+            len = 0U;
+        }
+
+        if (len == 0U)
+        {
+            len = (uint32_t)telemetry_varint_encode(&stream[bytes], events[i].ticks);
+            prev = events[i].ticks;
+        }
+        recLen = telemetry_trace_pack(&stream[bytes + len], events[i].ticks - prev, events[i].event,
+                                      events[i].arg, events[i].value);
+        encodeCycles += SIM_CYCLES_TRACE_PACK + (SIM_CYCLES_TRACE_BYTE * (recLen - 1U));
+        len += (uint32_t)recLen;
+        prev = events[i].ticks;
+    }
+    frameLen[frames++] = (uint8_t)len;
+    bytes += len;
+
+    (void) clock_gettime(CLOCK_MONOTONIC, &start);
+    decoded = sim_trace_decode(stream, frameLen, frames, events);
+    (void) clock_gettime(CLOCK_MONOTONIC, &end);
+    decodeNs = ((double)(end.tv_sec - start.tv_sec) * 1e9) + (double)(end.tv_nsec - start.tv_nsec);
+    free(stream);
+    free(frameLen);
+    if (decoded != count)
+    {
+        printf("%-14s record %lu does not decode\n", shapeNames[shape], (unsigned long)decoded);
+        return false;
+    }
+
+    rawWire = ((8.0 * count) + ((double)SIM_TRACE_FRAME_BYTES * rawFrames)) / count;
+    packedWire = ((double)bytes + ((double)SIM_TRACE_FRAME_BYTES * frames)) / count;
+    rawCycles = SIM_CYCLES_TRACE_RAW + ((SIM_CYCLES_FRAME_BYTE + SIM_CYCLES_UART_BYTE) * rawWire);
+    packedCycles = ((double)encodeCycles / count) + ((SIM_CYCLES_FRAME_BYTE + SIM_CYCLES_UART_BYTE) * packedWire);
+
+    printf("%-14s %6.2f %6.0f %6.0f %6.2f %6.2f %6u %6.1f %6.0f %6.0f %6.1f\n", shapeNames[shape],
+           (double)bytes / count, 1024.0 / 8.0, 1024.0 * count / (double)bytes,
+           rawWire, packedWire, SIM_CYCLES_TRACE_RAW, (double)encodeCycles / count,
+           rawCycles, packedCycles, decodeNs / count);
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: sim_trace
+ *******************************************************************************
+ *
+ * Summary:
+ *  Scenario entry: sim trace [events] [seed]
+ *
+ ******************************************************************************/
+int sim_trace(int argc, char **argv)
+{
+    uint32_t count = (argc > 0) ? (uint32_t)strtoul(argv[0], NULL, 0) : SIM_TRACE_EVENTS;
+    telemetry_trace_t *events;
+    uint32_t shape;
+    int result = 0;
+
+    /* splitmix64 of the seed, so small seeds give well mixed xorshift states */
+    rngState = (argc > 1) ? strtoull(argv[1], NULL, 0) : 1U;
+    rngState += 0x9E3779B97F4A7C15ULL;
+    rngState = (rngState ^ (rngState >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    rngState = (rngState ^ (rngState >> 27)) * 0x94D049BB133111EBULL;
+    rngState ^= rngState >> 31;
+    rngState = (rngState == 0U) ? 1U : rngState;
+
+    count = (count != 0U) ? count : SIM_TRACE_EVENTS;
+    events = malloc(count * sizeof(events[0]));
+    if (events == NULL)
+    {
+        perror("malloc");
+        return 2;
+    }
+
+    printf("%lu events per shape, %u byte trace buffer\n", (unsigned long)count, TELEMETRY_UART_TRACE_BYTES);
+    printf("%-14s %6s %13s %13s %13s %13s %6s\n", "", "packed", "events/KB", "wire B/ev",
+           "encode cyc/ev", "total cyc/ev", "decode");
+    printf("%-14s %6s %6s %6s %6s %6s %6s %6s %6s %6s %6s\n", "shape", "B/ev", "raw", "packed",
+           "raw", "packed", "raw", "packed", "raw", "packed", "ns/ev");
+    for (shape = 0U; shape < SIM_TRACE_SHAPES; shape++)
+    {
+        sim_trace_generate((sim_trace_shape_t)shape, events, count);
+        if (!sim_trace_run((sim_trace_shape_t)shape, events, count))
+        {
+            result = 1;
+        }
+    }
+    printf("total: encode, CRC / COBS framing (%u cycles/B) and UART FIFO writes (%u cycles/B)\n",
+           SIM_CYCLES_FRAME_BYTE, SIM_CYCLES_UART_BYTE);
+
+    free(events);
+
+    return result;
+}
+
+/* [] END OF FILE */
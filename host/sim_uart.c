@@ -0,0 +1,242 @@
+/******************************************************************************
+* File Name: sim_uart.c
+*
+* Description: Scenario 'uart': cost of a telemetry report on CYBSP_UART.
+*              One report is a statistics snapshot plus one trace record per
+*              wakeup in between. It is sent as binary frames
+*              (telemetry_uart.c) and as equivalent text through
+*              Cy_SCB_UART_PutString(), and the bytes and Active time are
+*              compared. A Deep Sleep run then streams binary telemetry,
+*              optionally to a capture file for host/tdecode.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include "sim.h"
+#include "cybsp.h"
+#include "pm_module.h"
+#include "clock_ctrl.h"
+#include "pm_stats.h"
+#include "telemetry_uart.h"
+#include "wdt_svc.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+#define SIM_UART_REPORTS        (100U)
+#define SIM_UART_RUN_MINUTES    (10U)
+#define SIM_UART_APP_PERIOD_MS  (250U)
+
+/*******************************************************************************
+ * Global variables
+ ******************************************************************************/
+static const char *modeNames[PM_STATS_MODES] = { "Active", "Sleep", "Deep Sleep" };
+
+static void sim_uart_app_tick(void)
+{
+}
+
+static void sim_uart_drain(void)
+{
+    while (!Cy_SCB_UART_IsTxComplete(CYBSP_UART_HW))
+    {
+    }
+}
+
+/*******************************************************************************
+ * Function Name: sim_uart_text_report
+ *******************************************************************************
+ *
+ * Summary:
+ *  Sends a report as text, with the same content as the binary frames.
+ *
+ ******************************************************************************/
+static void sim_uart_text_report(void)
+{
+    char line[96];
+    uint32_t i;
+
+    for (i = 0U; i < TELEMETRY_UART_STATS_INTERVAL; i++)
+    {
+        (void) snprintf(line, sizeof(line), "%lu: wake from %s\r\n",
+                        (unsigned long)wdt_svc_now(), modeNames[PM_STATS_DEEPSLEEP]);
+        Cy_SCB_UART_PutString(CYBSP_UART_HW, line);
+    }
+
+    (void) snprintf(line, sizeof(line), "Residency: Active %llu, Sleep %llu, Deep Sleep %llu\r\n",
+                    (unsigned long long)pm_stats_residency_ticks(&pm_stats, PM_STATS_ACTIVE),
+                    (unsigned long long)pm_stats_residency_ticks(&pm_stats, PM_STATS_SLEEP),
+                    (unsigned long long)pm_stats_residency_ticks(&pm_stats, PM_STATS_DEEPSLEEP));
+    Cy_SCB_UART_PutString(CYBSP_UART_HW, line);
+    (void) snprintf(line, sizeof(line), "Wakeups: Sleep %lu, Deep Sleep %lu, refused %lu\r\n",
+                    (unsigned long)pm_stats.wakeups[0], (unsigned long)pm_stats.wakeups[1],
+                    (unsigned long)pm_stats.refused);
+    Cy_SCB_UART_PutString(CYBSP_UART_HW, line);
+    Cy_SCB_UART_PutString(CYBSP_UART_HW, "Entry latency:");
+    for (i = 0U; i < PM_STATS_HIST_BINS; i++)
+    {
+        (void) snprintf(line, sizeof(line), " %u", pm_stats.entryHist[i]);
+        Cy_SCB_UART_PutString(CYBSP_UART_HW, line);
+    }
+    Cy_SCB_UART_PutString(CYBSP_UART_HW, "\r\nExit latency:");
+    for (i = 0U; i < PM_STATS_HIST_BINS; i++)
+    {
+        (void) snprintf(line, sizeof(line), " %u", pm_stats.exitHist[i]);
+        Cy_SCB_UART_PutString(CYBSP_UART_HW, line);
+    }
+    Cy_SCB_UART_PutString(CYBSP_UART_HW, "\r\n");
+}
+
+/*******************************************************************************
+ * Function Name: sim_uart_binary_report
+ *******************************************************************************
+ *
+ * Summary:
+ *  Sends a report as binary frames, as the telemetry module does.
+ *
+ ******************************************************************************/
+static void sim_uart_binary_report(void)
+{
+    uint32_t i;
+
+    for (i = 0U; i < TELEMETRY_UART_STATS_INTERVAL; i++)
+    {
+        telemetry_uart_trace(TELEMETRY_TRACE_WAKE, PM_STATS_DEEPSLEEP, 0U);
+    }
+    telemetry_uart_flush();
+    telemetry_uart_send(TELEMETRY_FRAME_STATS, &pm_stats, sizeof(pm_stats));
+}
+
+/*******************************************************************************
+ * Function Name: sim_uart_measure
+ *******************************************************************************
+ *
+ * Summary:
+ *  Sends SIM_UART_REPORTS reports, each followed by the wait for the UART to
+ *  drain that precedes Deep Sleep, and returns the Active cycles per report.
+ *
+ ******************************************************************************/
+static double sim_uart_measure(void (*report)(void), double *bytes)
+{
+    uint32_t i;
+    uint64_t start;
+
+    sim_reset();
+    (void) pm_init();
+    start = sim.cycles;
+    for (i = 0U; i < SIM_UART_REPORTS; i++)
+    {
+        report();
+        sim_uart_drain();
+    }
+
+    *bytes = (double)sim.uartBytes / SIM_UART_REPORTS;
+    return (double)(sim.cycles - start) / SIM_UART_REPORTS;
+}
+
+/*******************************************************************************
+ * Function Name: sim_uart
+ *******************************************************************************
+ *
+ * Summary:
+ *  Scenario entry: sim uart [capture_file]
+ *
+ ******************************************************************************/
+int sim_uart(int argc, char **argv)
+{
+    double textBytes;
+    double binBytes;
+    double textCycles;
+    double binCycles;
+    uint64_t endMs = (uint64_t)SIM_UART_RUN_MINUTES * 60000U;
+    FILE *capture = NULL;
+
+    textCycles = sim_uart_measure(sim_uart_text_report, &textBytes);
+    binCycles = sim_uart_measure(sim_uart_binary_report, &binBytes);
+
+    printf("report: stats snapshot + %u wake records, %u baud\n",
+           TELEMETRY_UART_STATS_INTERVAL, (unsigned)SIM_UART_BAUD);
+    printf("  text:   %6.1f bytes, %7.2f ms Active\n", textBytes, 1e3 * textCycles / sim.hfclkHz);
+    printf("  binary: %6.1f bytes, %7.2f ms Active (%.1fx fewer bytes)\n", binBytes,
+           1e3 * binCycles / sim.hfclkHz, textBytes / binBytes);
+
+    /* Streaming run: a wakeup every SIM_UART_APP_PERIOD_MS, Deep Sleep in between */
+    if (argc > 0)
+    {
+        capture = fopen(argv[0], "wb");
+        if (capture == NULL)
+        {
+            perror(argv[0]);
+            return 2;
+        }
+    }
+
+    sim_reset();
+    sim.uartCapture = capture;
+    (void) pm_init();
+    __enable_irq();
+    /* Clock switches, so the capture also holds log records (LOG_LEVEL_CLOCK) */
+    (void) clock_ctrl_set_hfclk(24U);
+    (void) clock_ctrl_set_hfclk(SIM_HFCLK_HZ / 1000000UL);
+    wdt_svc_timer_start(0U, WDT_SVC_MS_TO_TICKS(SIM_UART_APP_PERIOD_MS), true, sim_uart_app_tick);
+    while ((sim.cycles * 1000U / sim.hfclkHz) < endMs)
+    {
+        wdt_svc_kick();
+        (void) pm_enter(CY_SYSPM_DEEPSLEEP);
+    }
+    wdt_svc_timer_stop(0U);
+    telemetry_uart_flush();
+    sim_uart_drain();
+    sim.uartCapture = NULL;
+
+    printf("%u min streaming: %lu wakeups, %lu bytes, Deep Sleep %.3f %%\n", SIM_UART_RUN_MINUTES,
+           (unsigned long)sim.wakeups, (unsigned long)sim.uartBytes,
+           100.0 * sim.modeCycles[SIM_MODE_DEEPSLEEP] / sim.cycles);
+
+    if (capture != NULL)
+    {
+        (void) fclose(capture);
+        printf("capture written to %s, decode with host/tdecode\n", argv[0]);
+    }
+
+    return 0;
+}
+
+/* [] END OF FILE */
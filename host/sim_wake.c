@@ -0,0 +1,197 @@
+/******************************************************************************
+* File Name: sim_wake.c
+*
+* Description: Wake path placement scenario. Runs the application core and
+*              splits the Active cycles by the placement of the code that
+*              runs them: the functions marked PM_WAKE_FUNC, which the sim
+*              build links into .cy_ramfunc.pm_wake, and the rest. The CPI
+*              model of sim_clock then gives the wake path cycles from flash
+*              and from SRAM, and the charge the difference costs.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include "sim.h"
+#include "elfsym.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+#define SIM_WAKE_SECTION        ".cy_ramfunc.pm_wake"
+
+/* Functions of the wake path listed */
+#define SIM_WAKE_TOP            (12U)
+
+/*******************************************************************************
+ * Global variables
+ ******************************************************************************/
+static elfsym_table_t table;
+static uint64_t wakeStart;
+static uint64_t wakeEnd;
+static double *funcCycles;              /* Per symbol of table */
+static double wakeCycles;
+static double otherCycles;
+
+/* Active cycles of each code site, split by its placement */
+static void sim_wake_active(uintptr_t pc, uint64_t cycles)
+{
+    const elfsym_t *sym;
+
+    if ((pc >= wakeStart) && (pc < wakeEnd))
+    {
+        wakeCycles += (double)cycles;
+        sym = elfsym_lookup(&table, pc);
+        if (sym != NULL)
+        {
+            funcCycles[sym - table.syms] += (double)cycles;
+        }
+    }
+    else
+    {
+        otherCycles += (double)cycles;
+    }
+}
+
+static void sim_wake_setup(void)
+{
+    sim.activeCycles = sim_wake_active;
+}
+
+/*******************************************************************************
+ * Function Name: sim_wake
+ *******************************************************************************
+ *
+ * Summary:
+ *  Scenario entry: sim wake [hours] [hfclk_mhz]. Prints the Active cycles
+ *  per wakeup of the wake path functions, the wake path time per wakeup
+ *  from flash and from SRAM, and the charge per day of the difference.
+ *
+ ******************************************************************************/
+int sim_wake(int argc, char **argv)
+{
+    sim_app_params_t p = { 6U, 1U, SIM_PRESS_STEADY, 48U, 30U, 1U, 3U, 200U, sim_wake_setup };
+    sim_app_result_t r;
+    static elfsym_flat_t flat[SIM_WAKE_TOP * 8U];
+    static uint64_t pcs[SIM_WAKE_TOP * 8U];
+    static double counts[SIM_WAKE_TOP * 8U];
+    const sim_kit_t *kit = &sim_kits[0];
+    uint64_t addr;
+    uint64_t size;
+    size_t funcs = 0U;
+    size_t entries;
+    size_t i;
+    double cpiFlash;
+    double flashCycles;
+    double activeUa;
+    double savedS;
+    double savedUas;
+    double totalUas;
+    double days;
+
+    p.hours = (argc > 0) ? (uint32_t)strtoul(argv[0], NULL, 0) : p.hours;
+    p.hfclkMhz = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : p.hfclkMhz;
+    p.hours = (p.hours != 0U) ? p.hours : 6U;
+
+    if (!elfsym_load(&table, "/proc/self/exe") || !elfsym_section(&table, SIM_WAKE_SECTION, &addr, &size))
+    {
+        fprintf(stderr, "no %s section in /proc/self/exe\n", SIM_WAKE_SECTION);
+        elfsym_free(&table);
+        return 1;
+    }
+    wakeStart = addr;
+    wakeEnd = addr + size;
+    funcCycles = calloc(table.count, sizeof(double));
+    if (funcCycles == NULL)
+    {
+        elfsym_free(&table);
+        return 1;
+    }
+    wakeCycles = 0.0;
+    otherCycles = 0.0;
+
+    sim_app_run(&p, &r);
+    sim.activeCycles = NULL;
+
+    /* The cost model counts zero wait state cycles. From flash, each
+     * instruction adds the fetch stalls of the wait states; from SRAM it
+     * does not. The rest of the Active cycles run from flash either way. */
+    cpiFlash = SIM_CPI_BASE + (SIM_FETCH_PER_INSN * sim.waitStates);
+    flashCycles = (wakeCycles * cpiFlash) / SIM_CPI_BASE;
+    activeUa = kit->sleepUa + (((kit->activeUa - kit->sleepUa) * sim.hfclkHz) / SIM_HFCLK_HZ);
+    savedS = (flashCycles - wakeCycles) / sim.hfclkHz;
+    /* The time saved is spent in Deep Sleep */
+    savedUas = savedS * (activeUa - kit->deepSleepUa);
+    totalUas = r.avgUa * ((double)sim.cycles / sim.hfclkHz);
+    days = p.hours / 24.0;
+
+    for (i = 0U; (i < table.count) && (funcs < (sizeof(pcs) / sizeof(pcs[0]))); i++)
+    {
+        if (funcCycles[i] != 0.0)
+        {
+            pcs[funcs] = table.syms[i].addr;
+            counts[funcs] = funcCycles[i];
+            funcs++;
+        }
+    }
+    entries = elfsym_flat(&table, pcs, counts, funcs, flat);
+
+    printf("%lu h at %lu MHz, %lu wait states: %lu wakeups\n", (unsigned long)p.hours,
+           (unsigned long)(sim.hfclkHz / 1000000UL), (unsigned long)sim.waitStates, (unsigned long)r.wakeups);
+    printf("%-32s %12s\n", "function", "per wakeup");
+    for (i = 0U; (i < entries) && (i < SIM_WAKE_TOP); i++)
+    {
+        printf("%-32.32s %12.1f\n", flat[i].name, flat[i].count / r.wakeups);
+    }
+    printf("wake path %.3f %% of Active cycles: %.1f cycles (%.2f us) per wakeup from flash, "
+           "%.1f (%.2f us) from SRAM\n",
+           (100.0 * wakeCycles) / (wakeCycles + otherCycles), flashCycles / r.wakeups,
+           (1e6 * flashCycles) / r.wakeups / sim.hfclkHz, wakeCycles / r.wakeups,
+           (1e6 * wakeCycles) / r.wakeups / sim.hfclkHz);
+    printf("%s: SRAM saves %.2f uAs per day, %.4f %% of the charge\n", kit->target, savedUas / days,
+           (100.0 * savedUas) / totalUas);
+
+    free(funcCycles);
+    funcCycles = NULL;
+    elfsym_free(&table);
+
+    return (wakeCycles != 0.0) ? 0 : 1;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,181 @@
+/******************************************************************************
+* File Name: sim_wdt.c
+*
+* Description: Scenario 'wdt': wakeups of the watchdog service. An
+*              application timer runs on the WDT with the device in Deep
+*              Sleep between expirations; the run is repeated with the
+*              watchdog fed from a timer of its own, for comparison. A last
+*              run stops the main loop and measures the time to the watchdog
+*              reset.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include "sim.h"
+#include "pm_module.h"
+#include "wdt_svc.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+#define SIM_WDT_APP_TIMER       (0U)
+#define SIM_WDT_FEED_TIMER      (1U)
+
+/* Longest the main loop is left hanging */
+#define SIM_WDT_HANG_MAX_MS     (20000U)
+
+/*******************************************************************************
+ * Global variables
+ ******************************************************************************/
+static uint32_t appTicks;
+
+static void sim_wdt_app_tick(void)
+{
+    appTicks++;
+}
+
+static void sim_wdt_feed_tick(void)
+{
+}
+
+/*******************************************************************************
+ * Function Name: sim_wdt_run
+ *******************************************************************************
+ *
+ * Summary:
+ *  Runs the application timer for the given time, sleeping in Deep Sleep
+ *  between wakeups. Returns the number of wakeups.
+ *
+ ******************************************************************************/
+static uint32_t sim_wdt_run(uint32_t minutes, uint32_t periodMs, bool separateFeed)
+{
+    uint64_t endMs = (uint64_t)minutes * 60000U;
+
+    sim_reset();
+    appTicks = 0U;
+    (void) pm_init();
+    __enable_irq();
+
+    wdt_svc_timer_start(SIM_WDT_APP_TIMER, WDT_SVC_MS_TO_TICKS(periodMs), true, sim_wdt_app_tick);
+    if (separateFeed)
+    {
+        wdt_svc_timer_start(SIM_WDT_FEED_TIMER, WDT_SVC_FEED_TICKS, true, sim_wdt_feed_tick);
+    }
+
+    while (sim_now_ms() < endMs)
+    {
+        wdt_svc_kick();
+        (void) pm_enter(CY_SYSPM_DEEPSLEEP);
+    }
+
+    wdt_svc_timer_stop(SIM_WDT_APP_TIMER);
+    wdt_svc_timer_stop(SIM_WDT_FEED_TIMER);
+
+    return sim.wakeups;
+}
+
+/*******************************************************************************
+ * Function Name: sim_wdt
+ *******************************************************************************
+ *
+ * Summary:
+ *  Scenario entry: sim wdt [minutes] [period_ms]
+ *
+ ******************************************************************************/
+int sim_wdt(int argc, char **argv)
+{
+    uint32_t minutes = (argc > 0) ? (uint32_t)strtoul(argv[0], NULL, 0) : 10U;
+    uint32_t periodMs = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 1000U;
+    uint32_t periodTicks;
+    uint32_t mergedWakeups;
+    uint32_t mergedTicks;
+    uint32_t feedOnly;
+    uint32_t separateWakeups;
+    uint32_t expectedFeedOnly;
+    uint32_t resets;
+    uint64_t hangMs;
+    int result = 0;
+
+    minutes = (minutes != 0U) ? minutes : 1U;
+    periodMs = (periodMs != 0U) ? periodMs : 1000U;
+    periodTicks = WDT_SVC_MS_TO_TICKS(periodMs);
+
+    /* Feeding merged into the application wakeups */
+    feedOnly = wdt_svc_stats()->feedOnly;
+    mergedWakeups = sim_wdt_run(minutes, periodMs, false);
+    mergedTicks = appTicks;
+    feedOnly = wdt_svc_stats()->feedOnly - feedOnly;
+    resets = sim.wdtResets;
+
+    /* Feed-only wakeups needed to keep WDT interrupts WDT_SVC_FEED_TICKS apart */
+    expectedFeedOnly = mergedTicks * ((periodTicks - 1U) / WDT_SVC_FEED_TICKS);
+
+    /* Feeding on a timer of its own */
+    separateWakeups = sim_wdt_run(minutes, periodMs, true);
+    resets += sim.wdtResets;
+
+    /* Main loop hangs: the WDT interrupt is no longer cleared */
+    (void) sim_wdt_run(1U, periodMs, false);
+    hangMs = sim_now_ms();
+    while ((sim.wdtResets == 0U) && ((sim_now_ms() - hangMs) < SIM_WDT_HANG_MAX_MS))
+    {
+        Cy_SysLib_Delay(1U);
+    }
+    hangMs = sim_now_ms() - hangMs;
+
+    printf("%lu min, application timer every %lu ms, %lu expirations\n",
+           (unsigned long)minutes, (unsigned long)periodMs, (unsigned long)mergedTicks);
+    printf("wakeups: %lu with feeding merged (%lu feed-only, %lu expected), "
+           "%lu with a separate feed timer\n",
+           (unsigned long)mergedWakeups, (unsigned long)feedOnly, (unsigned long)expectedFeedOnly,
+           (unsigned long)separateWakeups);
+    printf("watchdog resets while running: %lu\n", (unsigned long)resets);
+    printf("main loop hang: reset after %llu ms\n", (unsigned long long)hangMs);
+
+    if ((resets != 0U) || (mergedWakeups != (mergedTicks + feedOnly)) ||
+        (feedOnly > (expectedFeedOnly + 1U)) || (sim.wdtResets == 0U))
+    {
+        result = 1;
+    }
+
+    return result;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,810 @@
+/******************************************************************************
+* File Name: tdecode.c
+*
+* Description: Host decoder of the binary UART telemetry (telemetry_uart.c).
+*              Reads a capture of the UART output from a file or stdin.
+*              Splits it into COBS frames at the 0x00 delimiters, checks CRC
+*              and sequence numbers, and prints statistics snapshots, trace
+*              records (packed or not) and log records. Log format strings
+*              are looked up in a dump of the .log_str section of the
+*              firmware ELF file.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "telemetry_frame.h"
+#include "pm_stats.h"
+#include "fxstat.h"
+#include "qhist.h"
+#include "elfsym.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Distinct PCs of the profile */
+#define TDECODE_PROF_PCS        (4096U)
+
+/* Lines of the profile */
+#define TDECODE_PROF_TOP        (20U)
+
+/* SRAM region of the Cortex-M memory map, where the BSP linker script runs
+ * the .cy_ramfunc code */
+#define TDECODE_SRAM_START      (0x20000000UL)
+#define TDECODE_SRAM_END        (0x40000000UL)
+
+/*******************************************************************************
+ * Global variables
+ ******************************************************************************/
+static uint32_t frames;
+static uint32_t statsFrames;
+static uint32_t traceRecords;
+static uint32_t crcErrors;
+static uint32_t framingErrors;
+static uint32_t seqGaps;
+static uint32_t logRecords;
+static bool quiet;
+
+/* PC samples of the profiler frames, summed over the capture */
+static uint64_t profPc[TDECODE_PROF_PCS];
+static double profCount[TDECODE_PROF_PCS];
+static size_t profPcs;
+static uint32_t profSamples;
+static uint32_t profDropped;
+
+/* Dump of the .log_str section */
+static char *logStrings;
+static size_t logStringsSize;
+
+static const char *levelNames[] = { "NONE", "ERROR", "WARN", "INFO", "DEBUG" };
+
+static const char *modeNames[PM_STATS_MODES] = { "Active", "Sleep", "Deep Sleep" };
+
+static uint32_t get32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t get16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+/*******************************************************************************
+ * Function Name: print_stats
+ *******************************************************************************
+ *
+ * Summary:
+ *  Prints a statistics snapshot, decoded at the offsets of the register map
+ *  (Table 4 in README.md).
+ *
+ ******************************************************************************/
+static void print_stats(const uint8_t *p, size_t length)
+{
+    uint16_t hist[PM_STATS_HIST_BINS];
+    uint64_t residency;
+    uint32_t mean;
+    uint32_t i;
+
+    /* Version 2 appended the charge estimate and the exit latency mean,
+     * version 3 the update sequence count, version 4 the canceled entries,
+     * version 5 the high words of the residency */
+    if ((length < 0x3CU) || (p[0] < 1U) || (p[0] > PM_STATS_VERSION) || (p[2] > PM_STATS_HIST_BINS) ||
+        ((p[0] >= 2U) && (length < 0x50U)) || ((p[0] >= 3U) && (length < 0x54U)) ||
+        ((p[0] >= 4U) && (length < 0x58U)) || ((p[0] >= 5U) && (length < 0x64U)))
+    {
+        printf("  stats: unknown layout (version %u, %u bytes)\n", p[0], (unsigned)length);
+        return;
+    }
+
+    /* Before version 5 the residency is modulo 2^32 */
+    printf("  residency (ILO ticks):");
+    for (i = 0U; i < PM_STATS_MODES; i++)
+    {
+        residency = get32(&p[0x04 + (4U * i)]);
+        if (p[0] >= 5U)
+        {
+            residency |= (uint64_t)get32(&p[0x58 + (4U * i)]) << 32;
+        }
+        printf(" %s %llu", modeNames[i], (unsigned long long)residency);
+    }
+    printf("\n  wakeups: Sleep %lu, Deep Sleep %lu, refused %lu\n",
+           (unsigned long)get32(&p[0x10]), (unsigned long)get32(&p[0x14]), (unsigned long)get32(&p[0x18]));
+    printf("  entry latency:");
+    for (i = 0U; i < p[2]; i++)
+    {
+        printf(" %u", get16(&p[0x1C + (2U * i)]));
+    }
+    printf("\n  exit latency: ");
+    for (i = 0U; i < p[2]; i++)
+    {
+        printf(" %u", get16(&p[0x2C + (2U * i)]));
+    }
+    printf("  (bins from 2^%u cycles)\n", p[3]);
+
+    for (i = 0U; i < p[2]; i++)
+    {
+        hist[i] = get16(&p[0x2C + (2U * i)]);
+    }
+    printf("  exit latency p50 %lu, p90 %lu, p99 %lu cycles\n",
+           (unsigned long)fxstat_hist_quantile(hist, p[2], p[3], FXSTAT_Q16(500U)),
+           (unsigned long)fxstat_hist_quantile(hist, p[2], p[3], FXSTAT_Q16(900U)),
+           (unsigned long)fxstat_hist_quantile(hist, p[2], p[3], FXSTAT_Q16(990U)));
+
+    if (p[0] >= 2U)
+    {
+        printf("  charge (uA s):");
+        for (i = 0U; i < PM_STATS_MODES; i++)
+        {
+            printf(" %s %lu", modeNames[i], (unsigned long)get32(&p[0x3C + (4U * i)]));
+        }
+        mean = get32(&p[0x48]);
+        printf("\n  exit latency weighted mean %lu.%02lu, variance %lu cycles^2\n",
+               (unsigned long)(mean >> FXSTAT_EWMA_FRAC),
+               (unsigned long)(((mean & ((1UL << FXSTAT_EWMA_FRAC) - 1U)) * 100U) >> FXSTAT_EWMA_FRAC),
+               (unsigned long)get32(&p[0x4C]));
+    }
+    if (p[0] >= 3U)
+    {
+        printf("  updates %lu\n", (unsigned long)(get32(&p[0x50]) >> 1));
+    }
+    if (p[0] >= 4U)
+    {
+        printf("  canceled for pending work %lu\n", (unsigned long)get32(&p[0x54]));
+    }
+}
+
+/*******************************************************************************
+ * Function Name: print_qhist
+ *******************************************************************************
+ *
+ * Summary:
+ *  Prints the Deep Sleep exit latency quantiles of a histogram frame
+ *  (qhist_t).
+ *
+ ******************************************************************************/
+static void print_qhist(const uint8_t *p, size_t length)
+{
+    qhist_t hist;
+    uint32_t i;
+
+    if ((length != sizeof(qhist_t)) || (p[0] != QHIST_BINS) || (p[1] != QHIST_SUB_BITS) ||
+        (p[2] != QHIST_MIN_SHIFT))
+    {
+        printf("  qhist: unknown layout (%u bins, %u bytes)\n", p[0], (unsigned)length);
+        return;
+    }
+
+    hist.samples = get32(&p[4]);
+    for (i = 0U; i < QHIST_BINS; i++)
+    {
+        hist.bins[i] = get16(&p[8U + (2U * i)]);
+    }
+    printf("  Deep Sleep exit latency, %lu samples: p50 %lu, p90 %lu, p99 %lu cycles\n",
+           (unsigned long)hist.samples,
+           (unsigned long)qhist_quantile(&hist, FXSTAT_Q16(500U)),
+           (unsigned long)qhist_quantile(&hist, FXSTAT_Q16(900U)),
+           (unsigned long)qhist_quantile(&hist, FXSTAT_Q16(990U)));
+}
+
+/*******************************************************************************
+ * Function Name: print_record
+ *******************************************************************************
+ *
+ * Summary:
+ *  Prints a trace record.
+ *
+ ******************************************************************************/
+static void print_record(const telemetry_trace_t *rec)
+{
+    traceRecords++;
+    if (quiet)
+    {
+        return;
+    }
+
+    printf("  %10lu ", (unsigned long)rec->ticks);
+    switch (rec->event)
+    {
+        case TELEMETRY_TRACE_WAKE:
+            printf("wake from %s\n", (rec->arg < PM_STATS_MODES) ? modeNames[rec->arg] : "?");
+            break;
+
+        case TELEMETRY_TRACE_CLOCK:
+            printf("HFCLK %u MHz\n", rec->value);
+            break;
+
+        case TELEMETRY_TRACE_SUPPLY:
+            printf("supply level %u at %u mV\n", rec->arg, rec->value);
+            break;
+
+        default:
+            printf("event 0x%02x arg %u value %u\n", rec->event, rec->arg, rec->value);
+            break;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: print_trace
+ *******************************************************************************
+ *
+ * Summary:
+ *  Prints the records of a trace frame of older firmware, 8 bytes each.
+ *
+ ******************************************************************************/
+static void print_trace(const uint8_t *p, size_t length)
+{
+    telemetry_trace_t rec;
+    size_t off;
+
+    for (off = 0U; (off + sizeof(telemetry_trace_t)) <= length; off += sizeof(telemetry_trace_t))
+    {
+        rec.ticks = get32(&p[off]);
+        rec.event = p[off + 4U];
+        rec.arg = p[off + 5U];
+        rec.value = get16(&p[off + 6U]);
+        print_record(&rec);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: print_trace_packed
+ *******************************************************************************
+ *
+ * Summary:
+ *  Prints the records of a packed trace frame, decoding the payload one byte
+ *  at a time.
+ *
+ * Return:
+ *  false if the payload is malformed.
+ *
+ ******************************************************************************/
+static bool print_trace_packed(const uint8_t *p, size_t length)
+{
+    telemetry_trace_decoder_t dec;
+    telemetry_trace_t rec;
+    size_t off;
+
+    telemetry_trace_decode_start(&dec);
+    for (off = 0U; off < length; off++)
+    {
+        if (telemetry_trace_decode_byte(&dec, p[off], &rec))
+        {
+            print_record(&rec);
+        }
+    }
+
+    return telemetry_trace_decode_end(&dec);
+}
+
+/*******************************************************************************
+ * Function Name: print_log
+ *******************************************************************************
+ *
+ * Summary:
+ *  Prints a log record, formatting the arguments with the format string at
+ *  its ID in the .log_str dump. Only integer conversions are supported.
+ *
+ ******************************************************************************/
+static void print_log(const uint8_t *p, size_t length)
+{
+    uint32_t count = p[1];
+    uint32_t id = get16(&p[2]);
+    uint32_t argIdx = 0U;
+    uint32_t arg;
+    const char *fmt;
+    char spec[16];
+    size_t specLen;
+
+    logRecords++;
+    if (quiet)
+    {
+        return;
+    }
+
+    printf("  %-5s ", (p[0] < (sizeof(levelNames) / sizeof(levelNames[0]))) ? levelNames[p[0]] : "?");
+    if ((length < (4U + (4U * count))) || (logStrings == NULL) || (id >= logStringsSize))
+    {
+        /* No string table: the raw record */
+        printf("string %lu args", (unsigned long)id);
+        for (argIdx = 0U; (argIdx < count) && ((4U + (4U * argIdx) + 4U) <= length); argIdx++)
+        {
+            printf(" 0x%08lx", (unsigned long)get32(&p[4U + (4U * argIdx)]));
+        }
+        printf("\n");
+        return;
+    }
+
+    for (fmt = &logStrings[id]; *fmt != '\0'; fmt++)
+    {
+        if (*fmt != '%')
+        {
+            putchar(*fmt);
+            continue;
+        }
+
+        /* Copy the conversion spec without length modifiers */
+        specLen = 0U;
+        spec[specLen++] = *fmt++;
+        while ((*fmt != '\0') && (strchr("-+ #0123456789.hl", *fmt) != NULL) && (specLen < (sizeof(spec) - 3U)))
+        {
+            if ((*fmt != 'l') && (*fmt != 'h'))
+            {
+                spec[specLen++] = *fmt;
+            }
+            fmt++;
+        }
+        if (*fmt == '\0')
+        {
+            break;
+        }
+        if (*fmt == '%')
+        {
+            putchar('%');
+            continue;
+        }
+
+        arg = (argIdx < count) ? get32(&p[4U + (4U * argIdx)]) : 0U;
+        argIdx++;
+        spec[specLen++] = 'l';
+        spec[specLen++] = *fmt;
+        spec[specLen] = '\0';
+        if ((*fmt == 'd') || (*fmt == 'i'))
+        {
+            printf(spec, (long)(int32_t)arg);
+        }
+        else if (strchr("uxXo", *fmt) != NULL)
+        {
+            printf(spec, (unsigned long)arg);
+        }
+        else
+        {
+            printf("<%%%c?>", *fmt);
+        }
+    }
+    printf("\n");
+}
+
+/*******************************************************************************
+ * Function Name: add_prof
+ *******************************************************************************
+ *
+ * Summary:
+ *  Adds the PC samples of a profiler frame to the profile.
+ *
+ * Return:
+ *  false if the payload is malformed.
+ *
+ ******************************************************************************/
+static bool add_prof(const uint8_t *p, size_t length)
+{
+    uint32_t value[2];
+    size_t used;
+    size_t pos = 0U;
+    size_t i;
+
+    for (i = 0U; i < 2U; i++)
+    {
+        used = telemetry_varint_decode(&p[pos], length - pos, &value[i]);
+        if (used == 0U)
+        {
+            return false;
+        }
+        pos += used;
+    }
+    profSamples += value[0];
+    profDropped += value[1];
+
+    while (pos < length)
+    {
+        for (i = 0U; i < 2U; i++)
+        {
+            used = telemetry_varint_decode(&p[pos], length - pos, &value[i]);
+            if (used == 0U)
+            {
+                return false;
+            }
+            pos += used;
+        }
+        for (i = 0U; (i < profPcs) && (profPc[i] != value[0]); i++)
+        {
+        }
+        if (i == profPcs)
+        {
+            if (profPcs == TDECODE_PROF_PCS)
+            {
+                profDropped += value[1];
+                continue;
+            }
+            profPc[profPcs] = value[0];
+            profCount[profPcs] = 0.0;
+            profPcs++;
+        }
+        profCount[i] += value[1];
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: print_prof
+ *******************************************************************************
+ *
+ * Summary:
+ *  Prints the flat profile: the sampled share of Active time per function,
+ *  or per PC without symbols.
+ *
+ * Parameters:
+ *  elf: Firmware ELF file, or NULL.
+ *
+ ******************************************************************************/
+static void print_prof(const char *elf)
+{
+    elfsym_table_t table;
+    elfsym_flat_t flat[TDECODE_PROF_PCS];
+    double total = 0.0;
+    size_t entries;
+    size_t i;
+
+    for (i = 0U; i < profPcs; i++)
+    {
+        total += profCount[i];
+    }
+    printf("profile: %lu samples, %lu dropped, %lu PCs\n", (unsigned long)profSamples,
+           (unsigned long)profDropped, (unsigned long)profPcs);
+    if (total == 0.0)
+    {
+        return;
+    }
+
+    if ((elf != NULL) && elfsym_load(&table, elf))
+    {
+        entries = elfsym_flat(&table, profPc, profCount, profPcs, flat);
+        for (i = 0U; (i < entries) && (i < TDECODE_PROF_TOP); i++)
+        {
+            printf("%8.0f %6.2f %%  %s\n", flat[i].count, (100.0 * flat[i].count) / total, flat[i].name);
+        }
+        elfsym_free(&table);
+        return;
+    }
+    if (elf != NULL)
+    {
+        fprintf(stderr, "%s: no ELF symbols, printing PCs\n", elf);
+    }
+
+    /* Largest counts first, by selection: the table is small */
+    for (entries = 0U; (entries < profPcs) && (entries < TDECODE_PROF_TOP); entries++)
+    {
+        size_t top = entries;
+        uint64_t pc;
+        double count;
+
+        for (i = entries + 1U; i < profPcs; i++)
+        {
+            top = (profCount[i] > profCount[top]) ? i : top;
+        }
+        pc = profPc[top];
+        count = profCount[top];
+        profPc[top] = profPc[entries];
+        profCount[top] = profCount[entries];
+        profPc[entries] = pc;
+        profCount[entries] = count;
+        printf("%8.0f %6.2f %%  0x%08lx\n", count, (100.0 * count) / total, (unsigned long)pc);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: decode_frame
+ *******************************************************************************
+ *
+ * Summary:
+ *  Decodes one COBS frame (without the delimiter).
+ *
+ ******************************************************************************/
+static void decode_frame(const uint8_t *wire, size_t wireLen)
+{
+    static bool haveSeq;
+    static uint8_t nextSeq;
+    uint8_t raw[TELEMETRY_FRAME_MAX_RAW];
+    size_t length;
+    uint16_t crc;
+    const uint8_t *payload;
+
+    length = telemetry_cobs_decode(raw, sizeof(raw), wire, wireLen);
+    if (length < (TELEMETRY_FRAME_HEADER + TELEMETRY_FRAME_CRC))
+    {
+        framingErrors++;
+        return;
+    }
+
+    length -= TELEMETRY_FRAME_CRC;
+    crc = telemetry_crc16(TELEMETRY_FRAME_CRC_INIT, raw, length);
+    if (crc != get16(&raw[length]))
+    {
+        crcErrors++;
+        return;
+    }
+
+    frames++;
+    if (haveSeq && (raw[1] != nextSeq))
+    {
+        seqGaps++;
+    }
+    haveSeq = true;
+    nextSeq = (uint8_t)(raw[1] + 1U);
+
+    payload = &raw[TELEMETRY_FRAME_HEADER];
+    length -= TELEMETRY_FRAME_HEADER;
+    switch (raw[0])
+    {
+        case TELEMETRY_FRAME_STATS:
+            statsFrames++;
+            if (!quiet)
+            {
+                printf("seq %3u stats\n", raw[1]);
+                print_stats(payload, length);
+            }
+            break;
+
+        case TELEMETRY_FRAME_QHIST:
+            if (!quiet)
+            {
+                printf("seq %3u exit latency histogram\n", raw[1]);
+                print_qhist(payload, length);
+            }
+            break;
+
+        case TELEMETRY_FRAME_TRACE:
+            if (!quiet)
+            {
+                printf("seq %3u trace, %u records\n", raw[1], (unsigned)(length / sizeof(telemetry_trace_t)));
+            }
+            print_trace(payload, length);
+            break;
+
+        case TELEMETRY_FRAME_TRACE_PACKED:
+            if (!quiet)
+            {
+                printf("seq %3u trace, %u bytes packed\n", raw[1], (unsigned)length);
+            }
+            if (!print_trace_packed(payload, length))
+            {
+                framingErrors++;
+            }
+            break;
+
+        case TELEMETRY_FRAME_PROF:
+            if (!quiet)
+            {
+                printf("seq %3u profile, %u bytes\n", raw[1], (unsigned)length);
+            }
+            if (!add_prof(payload, length))
+            {
+                framingErrors++;
+            }
+            break;
+
+        case TELEMETRY_FRAME_LOG:
+            if (length >= 4U)
+            {
+                if (!quiet)
+                {
+                    printf("seq %3u log\n", raw[1]);
+                }
+                print_log(payload, length);
+            }
+            break;
+
+        default:
+            if (!quiet)
+            {
+                printf("seq %3u unknown type 0x%02x, %u bytes\n", raw[1], raw[0], (unsigned)length);
+            }
+            break;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: print_ram
+ *******************************************************************************
+ *
+ * Summary:
+ *  Lists the functions the firmware runs from SRAM, such as the wake path of
+ *  a WAKE_PATH_IN_RAM=1 build, with the bytes of SRAM each takes.
+ *
+ * Parameters:
+ *  elf: Firmware ELF file.
+ *
+ * Return:
+ *  false if the file has no symbols.
+ *
+ ******************************************************************************/
+static bool print_ram(const char *elf)
+{
+    elfsym_table_t table;
+    uint64_t total = 0U;
+    uint32_t funcs = 0U;
+    size_t i;
+
+    if (!elfsym_load(&table, elf))
+    {
+        fprintf(stderr, "%s: no symbols\n", elf);
+        return false;
+    }
+
+    printf("%-10s %6s  %s\n", "address", "bytes", "function");
+    for (i = 0U; i < table.count; i++)
+    {
+        if ((table.syms[i].addr >= TDECODE_SRAM_START) && (table.syms[i].addr < TDECODE_SRAM_END))
+        {
+            printf("0x%08lx %6lu  %s\n", (unsigned long)table.syms[i].addr, (unsigned long)table.syms[i].size,
+                   table.syms[i].name);
+            total += table.syms[i].size;
+            funcs++;
+        }
+    }
+    printf("%lu functions in SRAM, %lu bytes\n", (unsigned long)funcs, (unsigned long)total);
+
+    elfsym_free(&table);
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: main
+ *******************************************************************************
+ *
+ * Summary:
+ *  tdecode [-q] [-s log_str.bin] [-e firmware.elf] [capture]: decodes a
+ *  capture file, or stdin. -q prints the summary only; -s loads the log
+ *  strings, dumped from the ELF file with objcopy
+ *  --dump-section .log_str=log_str.bin; -e symbolizes the profile of the
+ *  PC samples (prof.c) with the function symbols of the ELF file.
+ *  Returns non-zero if a frame was corrupted.
+ *  tdecode -r firmware.elf: lists the functions in SRAM and their sizes.
+ *
+ ******************************************************************************/
+int main(int argc, char **argv)
+{
+    FILE *in = stdin;
+    uint8_t wire[TELEMETRY_FRAME_MAX_WIRE];
+    size_t wireLen = 0U;
+    bool overflow = false;
+    int c;
+    int arg = 1;
+
+    FILE *strFile;
+    long strSize;
+    const char *elf = NULL;
+
+    for (; (argc > arg) && (argv[arg][0] == '-'); arg++)
+    {
+        if (strcmp(argv[arg], "-q") == 0)
+        {
+            quiet = true;
+        }
+        else if ((strcmp(argv[arg], "-s") == 0) && (argc > (arg + 1)))
+        {
+            arg++;
+            strFile = fopen(argv[arg], "rb");
+            if ((strFile == NULL) || (fseek(strFile, 0, SEEK_END) != 0) || ((strSize = ftell(strFile)) < 0))
+            {
+                perror(argv[arg]);
+                return 2;
+            }
+            rewind(strFile);
+            logStringsSize = (size_t)strSize;
+            logStrings = calloc(logStringsSize + 1U, 1U);
+            if ((logStrings == NULL) || (fread(logStrings, 1U, logStringsSize, strFile) != logStringsSize))
+            {
+                perror(argv[arg]);
+                return 2;
+            }
+            (void) fclose(strFile);
+        }
+        else if ((strcmp(argv[arg], "-e") == 0) && (argc > (arg + 1)))
+        {
+            arg++;
+            elf = argv[arg];
+        }
+        else if ((strcmp(argv[arg], "-r") == 0) && (argc > (arg + 1)))
+        {
+            return print_ram(argv[arg + 1]) ? 0 : 2;
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [-q] [-s log_str.bin] [-e firmware.elf] [capture]\n"
+                    "       %s -r firmware.elf\n", argv[0], argv[0]);
+            return 2;
+        }
+    }
+    if (argc > arg)
+    {
+        in = fopen(argv[arg], "rb");
+        if (in == NULL)
+        {
+            perror(argv[arg]);
+            return 2;
+        }
+    }
+
+    while ((c = fgetc(in)) != EOF)
+    {
+        if (c == TELEMETRY_FRAME_DELIMITER)
+        {
+            if (overflow)
+            {
+                framingErrors++;
+            }
+            else if (wireLen != 0U)
+            {
+                decode_frame(wire, wireLen);
+            }
+            wireLen = 0U;
+            overflow = false;
+        }
+        else if (wireLen < sizeof(wire))
+        {
+            wire[wireLen++] = (uint8_t)c;
+        }
+        else
+        {
+            /* Not a frame, for example text output: resync on the next delimiter */
+            overflow = true;
+        }
+    }
+
+    if (in != stdin)
+    {
+        (void) fclose(in);
+    }
+
+    printf("%lu frames (%lu stats, %lu trace records, %lu log records), %lu CRC errors, %lu framing errors, "
+           "%lu sequence gaps\n", (unsigned long)frames, (unsigned long)statsFrames,
+           (unsigned long)traceRecords, (unsigned long)logRecords, (unsigned long)crcErrors, (unsigned long)framingErrors,
+           (unsigned long)seqGaps);
+    if ((profSamples != 0U) || (profPcs != 0U))
+    {
+        print_prof(elf);
+    }
+
+    return ((crcErrors == 0U) && (framingErrors == 0U)) ? 0 : 1;
+}
+
+/* [] END OF FILE */
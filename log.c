@@ -0,0 +1,110 @@
+/******************************************************************************
+* File Name: log.c
+*
+* Description: Log record output. A record is sent as a TELEMETRY_FRAME_LOG
+*              frame on the telemetry UART: level, argument count, string ID
+*              (offset of the format string in .log_str) and the arguments.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "telemetry_uart.h"
+#include "pm_module.h"
+
+#if TELEMETRY_UART && PM_SECTIONS
+
+#define LOG_MODULE_LEVEL        LOG_LEVEL_NONE
+#include "log.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Payload: level, count, 16-bit string ID, then the arguments */
+#define LOG_RECORD_HEADER       (4U)
+
+/*******************************************************************************
+ * Global variables
+ ******************************************************************************/
+/* Start of .log_str, defined by pm_sections.ld */
+extern const char __log_str_start[];
+
+/*******************************************************************************
+ * Function Name: log_write
+ *******************************************************************************
+ *
+ * Summary:
+ *  Sends a log record. Called through the LOG_xxx macros, from the main loop
+ *  context only: it blocks until the frame is in the UART FIFO.
+ *
+ * Parameters:
+ *  level: LOG_LEVEL_xxx.
+ *  fmt: Format string in .log_str.
+ *  args: Arguments.
+ *  count: Number of arguments, at most LOG_MAX_ARGS.
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void log_write(uint32_t level, const char *fmt, const uint32_t *args, uint32_t count)
+{
+    uint8_t rec[LOG_RECORD_HEADER + (4U * LOG_MAX_ARGS)];
+    uint32_t id = (uint32_t)(fmt - __log_str_start);
+    uint32_t len = LOG_RECORD_HEADER;
+    uint32_t i;
+
+    CY_ASSERT(count <= LOG_MAX_ARGS);
+
+    rec[0] = (uint8_t)level;
+    rec[1] = (uint8_t)count;
+    rec[2] = (uint8_t)id;
+    rec[3] = (uint8_t)(id >> 8);
+    for (i = 0U; i < count; i++)
+    {
+        rec[len++] = (uint8_t)args[i];
+        rec[len++] = (uint8_t)(args[i] >> 8);
+        rec[len++] = (uint8_t)(args[i] >> 16);
+        rec[len++] = (uint8_t)(args[i] >> 24);
+    }
+
+    telemetry_uart_send(TELEMETRY_FRAME_LOG, rec, len);
+}
+
+#endif /* TELEMETRY_UART && PM_SECTIONS */
+
+/* [] END OF FILE */
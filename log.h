@@ -0,0 +1,156 @@
+/******************************************************************************
+* File Name: log.h
+*
+* Description: Logging with per-module compile-time levels. Statements above
+*              the level of their module compile to nothing. The format
+*              strings of the enabled ones go to the .log_str section, which
+*              is not loaded into the device (see pm_sections.ld). The
+*              device sends only the string offset and the arguments, and
+*              host/tdecode formats them from a dump of the section.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef LOG_H
+#define LOG_H
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cy_pdl.h"
+#include "pm_module.h"
+#include "telemetry_uart.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Log levels */
+#define LOG_LEVEL_NONE          0
+#define LOG_LEVEL_ERROR         1
+#define LOG_LEVEL_WARN          2
+#define LOG_LEVEL_INFO          3
+#define LOG_LEVEL_DEBUG         4
+
+/* Level of each module. Set from the Makefile with the numeric value, for
+ * example DEFINES+=LOG_LEVEL_SUPPLY=3 to log supply changes at INFO. */
+#ifndef LOG_LEVEL_APP
+#define LOG_LEVEL_APP           LOG_LEVEL_NONE
+#endif
+#ifndef LOG_LEVEL_CLOCK
+#define LOG_LEVEL_CLOCK         LOG_LEVEL_NONE
+#endif
+#ifndef LOG_LEVEL_SUPPLY
+#define LOG_LEVEL_SUPPLY        LOG_LEVEL_NONE
+#endif
+#ifndef LOG_LEVEL_PD
+#define LOG_LEVEL_PD            LOG_LEVEL_NONE
+#endif
+
+/* Integer arguments per statement */
+#define LOG_MAX_ARGS            (3U)
+
+/*******************************************************************************
+ * Macro Name: LOG_EMIT_
+ *******************************************************************************
+ *
+ * Summary:
+ *  Emits a log record. The format string is placed in .log_str and only its
+ *  address is used, so it takes no flash. Arguments are converted to
+ *  uint32_t; use integer conversions (%lu, %ld, %lx) in the format.
+ *
+ ******************************************************************************/
+#define LOG_EMIT_(level, fmt, ...)                                             \
+    do                                                                         \
+    {                                                                          \
+        static const char logFmt[] __attribute__((used, section(".log_str"))) = fmt; \
+        const uint32_t logArgs[] = { 0U, ##__VA_ARGS__ };                      \
+        log_write((level), logFmt, &logArgs[1],                                \
+                  (uint32_t)(sizeof(logArgs) / sizeof(logArgs[0])) - 1U);      \
+    } while (0)
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+void log_write(uint32_t level, const char *fmt, const uint32_t *args, uint32_t count);
+
+#endif /* LOG_H */
+
+/*******************************************************************************
+ * Per module part. Each source file defines LOG_MODULE_LEVEL before including
+ * this header, for example:
+ *
+ *  #define LOG_MODULE_LEVEL        LOG_LEVEL_SUPPLY
+ *  #include "log.h"
+ ******************************************************************************/
+#ifndef LOG_MODULE_LEVEL
+#error "Define LOG_MODULE_LEVEL before including log.h"
+#endif
+
+#if (LOG_MODULE_LEVEL > LOG_LEVEL_NONE) && !TELEMETRY_UART
+#error "Logging sends its records as telemetry frames, build with TELEMETRY_UART=1"
+#endif
+
+#if (LOG_MODULE_LEVEL > LOG_LEVEL_NONE) && !PM_SECTIONS
+#error "Log strings live in the .log_str section of pm_sections.ld, build with GCC_ARM"
+#endif
+
+/* For #if blocks around code that only exists to be logged */
+#define LOG_ENABLED(level)      (LOG_MODULE_LEVEL >= (level))
+
+#if LOG_MODULE_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(...)          LOG_EMIT_(LOG_LEVEL_ERROR, __VA_ARGS__)
+#else
+#define LOG_ERROR(...)          do { } while (0)
+#endif
+
+#if LOG_MODULE_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(...)           LOG_EMIT_(LOG_LEVEL_WARN, __VA_ARGS__)
+#else
+#define LOG_WARN(...)           do { } while (0)
+#endif
+
+#if LOG_MODULE_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(...)           LOG_EMIT_(LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define LOG_INFO(...)           do { } while (0)
+#endif
+
+#if LOG_MODULE_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...)          LOG_EMIT_(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...)          do { } while (0)
+#endif
+
+/* [] END OF FILE */
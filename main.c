@@ -45,22 +45,25 @@
 #include "cy_pdl.h"
 #include "cybsp.h"
 #include "cycfg_pins.h"
-#include "stdio.h"
-#include <inttypes.h>
+#include "pm_module.h"
+#include "app.h"
+#include "clock_ctrl.h"
+#include "telemetry_uart.h"
+#include "microbench.h"
+#include "wdt_svc.h"
+
+#define LOG_MODULE_LEVEL        LOG_LEVEL_APP
+#include "log.h"
 
 /******************************************************************************
  * Macros
  *****************************************************************************/
-#define LED_ON                  (0U)
-#define LED_OFF                 (1U)
 #define SWITCH_INTR_PRIORITY    (3U)
 
-#define SLEEP_SWITCH_PRESS      (1U)
-#define DEEP_SLEEP_SWITCH_PRESS (3U)
-#define BLINK_TIME_MS           (200U)
-
-/* Debug print macro to enable UART print */
-#define DEBUG_PRINT             (0U)
+/* UART clock: peri[0].div_16[0] in design.modus; the baud rate is
+ * CLOCK_CTRL_UART_BAUD */
+#define UART_CLK_DIV_TYPE       (CY_SYSCLK_DIV_16_BIT)
+#define UART_CLK_DIV_NUM        (0U)
 
 /* CY ASSERT failure */
 #define CY_ASSERT_FAILED        (0U)
@@ -68,90 +71,50 @@
 /*******************************************************************************
  * Global variables
  ******************************************************************************/
-volatile int16_t SwitchPressCount = 0;
+/* The application instance of the firmware */
+static app_ctx_t app;
+
+static const app_config_t app_config = APP_CONFIG_DEFAULT;
 
 /*******************************************************************************
  * Function Prototypes
  ******************************************************************************/
-void switch_isr();
-void led_blink(uint32_t blink_time, uint32_t num_toggles);
-
-/* Sleep Callback function */
-cy_en_syspm_status_t sleep_callback(cy_stc_syspm_callback_params_t  *callbackParams,
-                                    cy_en_syspm_callback_mode_t mode);
-/* Deep Sleep Callback function */
-cy_en_syspm_status_t deep_sleep_callback(cy_stc_syspm_callback_params_t *callbackParams,
-                                         cy_en_syspm_callback_mode_t mode);
-
-/* SysPm callback params */
-cy_stc_syspm_callback_params_t callbackParams = {
-        /*.base       =*/ NULL,
-        /*.context    =*/ NULL
-};
+PM_WAKE_FUNC void switch_isr(void);
 
-/* Callback declaration for Sleep mode */
-cy_stc_syspm_callback_t sleep_cb    =  {sleep_callback,              /* Callback function */
-                                       CY_SYSPM_SLEEP,               /* Callback type */
-                                       0,                            /* Skip mode */
-                                       &callbackParams,              /* Callback params */
-                                       NULL, NULL};                  /* For internal usage */
+/* HFCLK change hook */
+void app_clock_changed(uint32_t hfclkHz);
 
-/* Callback declaration for Deep Sleep mode */
-cy_stc_syspm_callback_t deep_sleep_cb = {deep_sleep_callback,        /* Callback function */
-                                       CY_SYSPM_DEEPSLEEP,           /* Callback type */
-                                       0,                            /* Skip mode */
-                                       &callbackParams,              /* Callback params */
-                                       NULL, NULL};                  /* For internal usage */
+/* Sleep and Deep Sleep callback function */
+PM_WAKE_FUNC cy_en_syspm_status_t app_pm_callback(cy_en_syspm_callback_type_t type,
+                                     cy_en_syspm_callback_mode_t mode);
+PM_WAKE_FUNC bool app_pm_work_pending(void);
 
 /* Initialize the switch interrupt */
-cy_stc_sysint_t switch_intr_config =
+const cy_stc_sysint_t switch_intr_config =
 {
     CYBSP_USER_BTN_IRQ,     /* Source of interrupt signal */
     SWITCH_INTR_PRIORITY    /* Interrupt priority */
 };
 
-#if DEBUG_PRINT
-cy_stc_scb_uart_context_t CYBSP_UART_context;
-
-/* Variable used for tracking the print status */
-volatile bool ENTER_LOOP = true;
-
-/*******************************************************************************
-* Function Name: check_status
-********************************************************************************
-* Summary:
-*  Prints the error message.
-*
-* Parameters:
-*  error_msg - message to print if any error encountered.
-*  status - status obtained after evaluation.
-*
-* Return:
-*  void
-*
-*******************************************************************************/
-void check_status(char *message, cy_rslt_t status)
-{
-    char error_msg[50];
-
-    sprintf(error_msg, "Error Code: 0x%08" PRIX32 "\n", status);
-
-    Cy_SCB_UART_PutString(CYBSP_UART_HW, "\r\n=====================================================\r\n");
-    Cy_SCB_UART_PutString(CYBSP_UART_HW, "\nFAIL: ");
-    Cy_SCB_UART_PutString(CYBSP_UART_HW, message);
-    Cy_SCB_UART_PutString(CYBSP_UART_HW, "\r\n");
-    Cy_SCB_UART_PutString(CYBSP_UART_HW, error_msg);
-    Cy_SCB_UART_PutString(CYBSP_UART_HW, "\r\n=====================================================\r\n");
-}
-#endif
+/* Application power module: the user button is the wake source and the
+ * callback indicates Sleep / Deep Sleep entry on the User LED */
+PM_MODULE_DEFINE(app_pm_module, PM_PRIORITY_DEFAULT,
+    .callback = app_pm_callback,
+    .types    = PM_TYPE_ALL,
+    .skipMode = &app.pmSkip,
+    .wakeIntr = &switch_intr_config,
+    .wakeIsr  = switch_isr,
+    .clockChanged = app_clock_changed,
+    .workPending = app_pm_work_pending);
 
 /*******************************************************************************
  * Function Name: main
  *******************************************************************************
  *
  * Summary:
- *  System entrance point. This function configures and initializes the GPIO
- *  interrupt, UART Component and Register callback functions.
+ *  System entrance point. This function initializes the application instance
+ *  and the power management modules (GPIO wake interrupt, power callbacks and
+ *  telemetry UART), then runs the application main loop.
  *
  * Parameters:
  *  void
@@ -163,8 +126,7 @@ void check_status(char *message, cy_rslt_t status)
 int main(void)
 {
     cy_rslt_t result;
-    cy_en_sysint_status_t intr_result;
-    bool cb_result = true;
+    cy_en_syspm_status_t pm_result;
 
     /* Initialize the device and board peripherals */
     result = cybsp_init();
@@ -173,93 +135,42 @@ int main(void)
         CY_ASSERT(CY_ASSERT_FAILED);
     }
 
+    /* Initialize the application instance bound to app_pm_module */
+    app_init(&app, &app_config, &app_pm_module);
+
     /* Enable global interrupts */
     __enable_irq();
 
-#if DEBUG_PRINT
-    /* Configure and enable the UART peripheral */
-    Cy_SCB_UART_Init(CYBSP_UART_HW, &CYBSP_UART_config, &CYBSP_UART_context);
-    Cy_SCB_UART_Enable(CYBSP_UART_HW);
-
-    /* Sequence to clear screen */
-    Cy_SCB_UART_PutString(CYBSP_UART_HW, "\x1b[2J\x1b[;H");
-
-    /* Print "Power modes" */
-    Cy_SCB_UART_PutString(CYBSP_UART_HW, "****************** ");
-    Cy_SCB_UART_PutString(CYBSP_UART_HW, "PMG1 MCU: Power modes");
-    Cy_SCB_UART_PutString(CYBSP_UART_HW, "****************** \r\n\n");
-#endif
-
-    /* Initialize and enable GPIO interrupt */
-    intr_result = Cy_SysInt_Init(&switch_intr_config, switch_isr);
-    if(intr_result != CY_SYSINT_SUCCESS)
+    /* Run the module init hooks and enable the wake interrupts. The power
+     * callbacks are collected in flash at link time, nothing to register. */
+    pm_result = pm_init();
+    if (pm_result != CY_SYSPM_SUCCESS)
     {
-#if DEBUG_PRINT
-        check_status("API Cy_SysInt_Init failed with error code", intr_result);
-#endif
+        LOG_ERROR("pm_init failed with error code 0x%08lx", pm_result);
         CY_ASSERT(CY_ASSERT_FAILED);
     }
 
-    /* Enables interrupt in the NVIC interrupt controller */
-    NVIC_EnableIRQ(switch_intr_config.intrSrc);
-
-    /* Register Sleep callback */
-    cb_result = Cy_SysPm_RegisterCallback(&sleep_cb);
-    if (cb_result != true)
-    {
-#if DEBUG_PRINT
-        check_status("API Cy_SysPm_RegisterCallback failed with error code", CY_RSLT_TYPE_ERROR);
-#endif
-        CY_ASSERT(CY_ASSERT_FAILED);
-    }
+    /* The telemetry UART, if enabled, is started by pm_init() */
+    LOG_INFO("PMG1 MCU: Power modes");
+    LOG_DEBUG("Entered for loop");
 
-    /* Register Deep Sleep callback */
-    cb_result = Cy_SysPm_RegisterCallback(&deep_sleep_cb);
-    if (cb_result != true)
+#if MICROBENCH
+    /* Benchmark firmware: reports the PDL primitives instead of running the
+     * application loop */
+    for (;;)
     {
-#if DEBUG_PRINT
-        check_status("API Cy_SysPm_RegisterCallback failed with error code", CY_RSLT_TYPE_ERROR);
-#endif
-        CY_ASSERT(CY_ASSERT_FAILED);
+        wdt_svc_kick();
+        microbench_run(MICROBENCH_RUNS);
+        microbench_report();
+        wdt_svc_kick();
+        Cy_SysLib_Delay(MICROBENCH_PERIOD_MS);
     }
-
+#else
     for (;;)
     {
-        /* Turn on User LED */
-        Cy_GPIO_Write(CYBSP_USER_LED_PORT, CYBSP_USER_LED_NUM, LED_ON);
-
-        /* Sleep mode */
-        if(SwitchPressCount == SLEEP_SWITCH_PRESS)
-        {
-#if DEBUG_PRINT
-            /* Send a string over serial terminal */
-            Cy_SCB_UART_PutString(CYBSP_UART_HW, "Enter Sleep mode\r\n");
-#endif
-            /* Go to Sleep */
-            Cy_SysPm_CpuEnterSleep();
-       }
-       /* Deep sleep mode */
-       else if (SwitchPressCount == DEEP_SLEEP_SWITCH_PRESS)
-       {
-#if DEBUG_PRINT
-           /* Send a string over serial terminal */
-           Cy_SCB_UART_PutString(CYBSP_UART_HW, "Enter Deep Sleep mode\r\n");
-#endif
-           /* Go to Deep Sleep */
-           Cy_SysPm_CpuEnterDeepSleep();
-
-           /* Making switch press count to 0U */
-           SwitchPressCount = 0;
-        }
-
-#if DEBUG_PRINT
-        if (ENTER_LOOP)
-        {
-            Cy_SCB_UART_PutString(CYBSP_UART_HW, "Entered for loop\r\n");
-            ENTER_LOOP = false;
-        }
-#endif
+        app_step(&app);
     }
+#endif
 }
 
 /*******************************************************************************
@@ -267,8 +178,8 @@ int main(void)
  *******************************************************************************
  *
  * Summary:
- *  This function is executed when GPIO interrupt is triggered.
- *  It Clears the triggered pin interrupt
+ *  This function is executed when GPIO interrupt is triggered. It forwards
+ *  to the application instance.
  *
  * Parameters:
  *  None
@@ -277,156 +188,87 @@ int main(void)
  *  void
  *
  ******************************************************************************/
-void switch_isr(void)
+PM_WAKE_FUNC void switch_isr(void)
 {
-    /* Counts the switch press */
-    SwitchPressCount++;
-
-    /* Clears the triggered pin interrupt */
-    Cy_GPIO_ClearInterrupt(CYBSP_USER_BTN_PORT, CYBSP_USER_BTN_NUM);
-}
-
-/*******************************************************************************
- * Function Name: callback_function
- *******************************************************************************
- *
- * Callback function implementation. It turns the LED off before going to
- * sleep power mode / deep sleep power mode.
- * After waking up, it sets the LED to blink for two times for sleep mode and
- * it sets the LED to blink for three times for deep sleep mode.
- *
- * Parameters:
- *  mode: Sleep mode (1) / Deep sleep mode (2)
- *  led_blink_count: Number of times User LED blinks
- *
- * Return:
- *  void
- *
- ******************************************************************************/
-cy_en_syspm_status_t callback_function(uint8_t mode, uint8_t led_blink_count)
-{
-    cy_en_syspm_status_t ret_val = CY_SYSPM_FAIL;
-
-    switch (mode)
-    {
-        case CY_SYSPM_CHECK_READY:
-            ret_val = CY_SYSPM_SUCCESS;
-            break;
-
-        case CY_SYSPM_CHECK_FAIL:
-#if DEBUG_PRINT
-            /* Send a string over serial terminal */
-            Cy_SCB_UART_PutString(CYBSP_UART_HW, "Device failed to enter Deep Sleep mode\r\n");
-#endif
-            ret_val = CY_SYSPM_FAIL;
-            break;
-
-        case CY_SYSPM_BEFORE_TRANSITION:
-            /* Blink the LED for two times before entering into Sleep mode */
-            led_blink(BLINK_TIME_MS, led_blink_count);
-
-            ret_val = CY_SYSPM_SUCCESS;
-            break;
-
-        case CY_SYSPM_AFTER_TRANSITION:
-#if DEBUG_PRINT
-            /* Send a string over serial terminal */
-            Cy_SCB_UART_PutString(CYBSP_UART_HW, "Enters Active mode\r\n");
-#endif
-            ret_val = CY_SYSPM_SUCCESS;
-            break;
-
-        default:
-            /* Don't do anything in the other modes */
-            ret_val = CY_SYSPM_SUCCESS;
-            break;
-    }
-    return ret_val;
+    app_switch_isr(&app);
 }
 
 /*******************************************************************************
- * Function Name: sleep_callback
+ * Function Name: app_pm_callback
  *******************************************************************************
  *
- * Sleep callback implementation. It turns the LED off before going to
- * sleep power mode. After waking up, it sets the LED to blink for two times.
+ * Summary:
+ *  Sleep and Deep Sleep callback of app_pm_module, forwarded to the
+ *  application instance.
  *
  * Parameters:
- *  callbackParams: The pointer to the callback parameters structure
- *  cy_stc_syspm_callback_params_t.
+ *  type: Power mode being entered, see cy_en_syspm_callback_type_t
  *  mode: Callback mode, see cy_en_syspm_callback_mode_t
  *
  * Return:
  *  Entered status, see cy_en_syspm_status_t.
  *
  ******************************************************************************/
-cy_en_syspm_status_t sleep_callback(
-        cy_stc_syspm_callback_params_t *callbackParams, cy_en_syspm_callback_mode_t mode)
+PM_WAKE_FUNC cy_en_syspm_status_t app_pm_callback(cy_en_syspm_callback_type_t type,
+                                                  cy_en_syspm_callback_mode_t mode)
 {
-    cy_en_syspm_status_t retVal;
-
-    retVal = callback_function(mode, 2);
-
-    return retVal;
+    return app_pm_event(&app, type, mode);
 }
 
 /*******************************************************************************
- * Function Name: deep_sleep_callback
+ * Function Name: app_pm_work_pending
  *******************************************************************************
  *
  * Summary:
- *  Deep Sleep callback implementation. It turns the LED off before going to deep
- *  sleep power mode. After waking up, it sets the LED to blink for three times.
+ *  Pending work check of app_pm_module, forwarded to the application
+ *  instance.
  *
  * Parameters:
- *  callbackParams: The pointer to the callback parameters structure cy_stc_syspm_callback_params_t.
- *  mode: Callback mode, see cy_en_syspm_callback_mode_t
+ *  None
  *
  * Return:
- *  Entered status, see cy_en_syspm_status_t.
+ *  true if a switch press is waiting for the main loop.
  *
  ******************************************************************************/
-cy_en_syspm_status_t deep_sleep_callback(
-        cy_stc_syspm_callback_params_t *callbackParams, cy_en_syspm_callback_mode_t mode)
+PM_WAKE_FUNC bool app_pm_work_pending(void)
 {
-    cy_en_syspm_status_t retVal;
-
-    retVal = callback_function(mode, 3);
-
-    return retVal;
+    return app_work_pending(&app);
 }
 
 /*******************************************************************************
- * Function Name: led_blink
+ * Function Name: app_clock_changed
  *******************************************************************************
+ *
  * Summary:
- * Blinks the LED for num_toggles times, with a period of blink_time.
+ *  Called by clock_ctrl_set_hfclk() after an HFCLK change. Reprograms the UART
+ *  clock divider and oversampling for CLOCK_CTRL_UART_BAUD from the new
+ *  peripheral clock; clock_ctrl_set_hfclk() has refused the frequencies that
+ *  cannot hold it.
  *
  * Parameters:
- * blink_time:  Time in ms for on and off times.
- * num_toggles: Describes how many times to toggle the LED on and off.
+ *  hfclkHz: New HFCLK frequency in Hz.
  *
  * Return:
  *  void
  *
  ******************************************************************************/
-void led_blink(uint32_t blink_time, uint32_t num_toggles)
+void app_clock_changed(uint32_t hfclkHz)
 {
-    /* Variable used to set LED blink time */
-    uint8_t count = 0U;
+#if TELEMETRY_UART
+    clock_ctrl_uart_t uart;
 
-    /* Toggle the LED the desired number of times in this loop */
-    for (count = 0; count < num_toggles; count++)
+    (void) hfclkHz;
+    if (clock_ctrl_uart_clock(Cy_SysClk_ClkPeriGetFrequency(), CLOCK_CTRL_UART_BAUD, &uart))
     {
-        Cy_GPIO_Write(CYBSP_USER_LED_PORT, CYBSP_USER_LED_NUM, LED_OFF);
-        Cy_SysLib_Delay(blink_time);
-        Cy_GPIO_Write(CYBSP_USER_LED_PORT, CYBSP_USER_LED_NUM, LED_ON);
-        Cy_SysLib_Delay(blink_time);
+        /* The oversampling can only change with the SCB disabled */
+        Cy_SCB_UART_Disable(CYBSP_UART_HW, NULL);
+        CY_REG32_CLR_SET(CYBSP_UART_HW->CTRL, SCB_CTRL_OVS, uart.ovs - 1U);
+        (void) Cy_SysClk_PeriphSetDivider(UART_CLK_DIV_TYPE, UART_CLK_DIV_NUM, uart.div - 1U);
+        Cy_SCB_UART_Enable(CYBSP_UART_HW);
     }
-
-    /* Turn off the User LED */
-    Cy_GPIO_Write(CYBSP_USER_LED_PORT, CYBSP_USER_LED_NUM, LED_OFF);
+#else
+    (void) hfclkHz;
+#endif
 }
 
 /* [] END OF FILE */
-
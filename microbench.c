@@ -0,0 +1,372 @@
+/******************************************************************************
+* File Name: microbench.c
+*
+* Description: Microbenchmarks of the PDL primitives, timed with the cycle
+*              counter probes and reported as text on CYBSP_UART.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "microbench.h"
+
+#if MICROBENCH
+
+#include "cybsp.h"
+#include "pm_module.h"
+
+#if !CYCCNT_ENABLE
+#error "MICROBENCH needs CYCCNT_ENABLE=1 to time the primitives"
+#endif
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Interrupt pended, with interrupts masked, to end the Sleep round trip at
+ * once; cleared again before its handler could run */
+#define MICROBENCH_WAKE_IRQ     CYBSP_USER_BTN_IRQ
+
+/* Width of the name column and length of a report line */
+#define MICROBENCH_NAME_WIDTH   (28U)
+#define MICROBENCH_LINE         (96U)
+
+/*******************************************************************************
+ * Global variables
+ ******************************************************************************/
+static microbench_result_t benchResults[MICROBENCH_COUNT] =
+{
+    [MICROBENCH_GPIO_WRITE]  = { "Cy_GPIO_Write",              1U, CYCCNT_PROBE_INIT },
+    [MICROBENCH_GPIO_CLEAR]  = { "Cy_GPIO_ClearInterrupt",     1U, CYCCNT_PROBE_INIT },
+    [MICROBENCH_SLEEP]       = { "Cy_SysPm_CpuEnterSleep",     1U, CYCCNT_PROBE_INIT },
+    [MICROBENCH_PM_WALK]     = { "pm_check",                   1U, CYCCNT_PROBE_INIT },
+    [MICROBENCH_PM_WALK_ALL] = { "pm_check, no skips",         1U, CYCCNT_PROBE_INIT },
+    [MICROBENCH_UART_BYTE]   = { "Cy_SCB_UART_PutString/byte", MICROBENCH_UART_BYTES, CYCCNT_PROBE_INIT },
+};
+
+static uint32_t benchRuns;
+
+/* Skip masks of the modules, saved while MICROBENCH_PM_WALK_ALL runs */
+static uint8_t benchSkip[MICROBENCH_MODULES];
+
+/* Carriage returns: the benchmark output does not show on a terminal */
+static const char benchUartString[MICROBENCH_UART_BYTES + 1U] = "\r\r\r\r\r\r\r\r";
+
+#if !TELEMETRY_UART
+static cy_stc_scb_uart_context_t benchUartContext;
+static bool benchUartReady;
+#endif
+
+/*******************************************************************************
+ * Function Name: microbench_skips
+ *******************************************************************************
+ *
+ * Summary:
+ *  Clears the skip masks of all modules, saving them, or restores them. With
+ *  the masks clear, pm_check() calls every module taking part in the power
+ *  mode, as it did before the masks existed.
+ *
+ * Parameters:
+ *  clear: true to clear the masks, false to restore them.
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void microbench_skips(bool clear)
+{
+    const pm_module_t *module;
+    uint32_t i;
+
+    CY_ASSERT(PM_TABLE_COUNT <= MICROBENCH_MODULES);
+
+    for (i = 0U; i < PM_TABLE_COUNT; i++)
+    {
+        module = PM_TABLE_MODULE(i);
+        if (module->skipMode != NULL)
+        {
+            if (clear)
+            {
+                benchSkip[i] = *module->skipMode;
+                *module->skipMode = 0U;
+            }
+            else
+            {
+                *module->skipMode = benchSkip[i];
+            }
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: microbench_time
+ *******************************************************************************
+ *
+ * Summary:
+ *  Times one call of a primitive, with interrupts masked so the span holds
+ *  the primitive alone.
+ *
+ * Parameters:
+ *  id: Primitive.
+ *  run: Run number.
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void microbench_time(microbench_id_t id, uint32_t run)
+{
+    cyccnt_probe_t *probe = &benchResults[id].probe;
+    uint32_t savedIntr;
+
+    /* Start with the UART TX FIFO empty */
+    if (id == MICROBENCH_UART_BYTE)
+    {
+        while (!Cy_SCB_UART_IsTxComplete(CYBSP_UART_HW))
+        {
+        }
+    }
+
+    savedIntr = Cy_SysLib_EnterCriticalSection();
+    switch (id)
+    {
+        case MICROBENCH_GPIO_WRITE:
+            CYCCNT_BEGIN(*probe);
+            Cy_GPIO_Write(CYBSP_USER_LED_PORT, CYBSP_USER_LED_NUM, run & 1U);
+            CYCCNT_END(*probe);
+            break;
+
+        case MICROBENCH_GPIO_CLEAR:
+            CYCCNT_BEGIN(*probe);
+            Cy_GPIO_ClearInterrupt(CYBSP_USER_BTN_PORT, CYBSP_USER_BTN_NUM);
+            CYCCNT_END(*probe);
+            break;
+
+        case MICROBENCH_SLEEP:
+            /* With the wake interrupt pending, WFI returns at once: this is
+             * the software path, not the wakeup latency (see pm_stats.h) */
+            NVIC_SetPendingIRQ(MICROBENCH_WAKE_IRQ);
+            CYCCNT_BEGIN(*probe);
+            (void) Cy_SysPm_CpuEnterSleep();
+            CYCCNT_END(*probe);
+            NVIC_ClearPendingIRQ(MICROBENCH_WAKE_IRQ);
+            break;
+
+        case MICROBENCH_PM_WALK:
+            CYCCNT_BEGIN(*probe);
+            (void) pm_check(CY_SYSPM_DEEPSLEEP);
+            CYCCNT_END(*probe);
+            break;
+
+        case MICROBENCH_PM_WALK_ALL:
+            microbench_skips(true);
+            CYCCNT_BEGIN(*probe);
+            (void) pm_check(CY_SYSPM_DEEPSLEEP);
+            CYCCNT_END(*probe);
+            microbench_skips(false);
+            break;
+
+        default:
+            CYCCNT_BEGIN(*probe);
+            Cy_SCB_UART_PutString(CYBSP_UART_HW, benchUartString);
+            CYCCNT_END(*probe);
+            break;
+    }
+    Cy_SysLib_ExitCriticalSection(savedIntr);
+}
+
+/*******************************************************************************
+ * Function Name: microbench_run
+ *******************************************************************************
+ *
+ * Summary:
+ *  Runs every primitive the given number of times, interleaved, and keeps
+ *  the results until the next run. Call it after pm_init(), which starts the
+ *  cycle counter.
+ *
+ * Parameters:
+ *  runs: Calls timed per primitive.
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void microbench_run(uint32_t runs)
+{
+    const cyccnt_probe_t probeInit = CYCCNT_PROBE_INIT;
+    uint32_t id;
+    uint32_t run;
+
+#if !TELEMETRY_UART
+    if (!benchUartReady)
+    {
+        Cy_SCB_UART_Init(CYBSP_UART_HW, &CYBSP_UART_config, &benchUartContext);
+        Cy_SCB_UART_Enable(CYBSP_UART_HW);
+        benchUartReady = true;
+    }
+#endif
+
+    for (id = 0U; id < (uint32_t)MICROBENCH_COUNT; id++)
+    {
+        benchResults[id].probe = probeInit;
+    }
+    benchRuns = runs;
+
+    NVIC_EnableIRQ(MICROBENCH_WAKE_IRQ);
+    for (run = 0U; run < runs; run++)
+    {
+        for (id = 0U; id < (uint32_t)MICROBENCH_COUNT; id++)
+        {
+            microbench_time((microbench_id_t)id, run);
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: microbench_put
+ *******************************************************************************
+ *
+ * Summary:
+ *  Appends a string to a report line.
+ *
+ ******************************************************************************/
+static char *microbench_put(char *p, const char *s)
+{
+    while (*s != '\0')
+    {
+        *p++ = *s++;
+    }
+
+    return p;
+}
+
+/*******************************************************************************
+ * Function Name: microbench_put_u32
+ *******************************************************************************
+ *
+ * Summary:
+ *  Appends a number in decimal to a report line.
+ *
+ ******************************************************************************/
+static char *microbench_put_u32(char *p, uint32_t value)
+{
+    char digits[10];
+    uint32_t count = 0U;
+
+    do
+    {
+        digits[count++] = (char)('0' + (value % 10U));
+        value /= 10U;
+    } while (value != 0U);
+
+    while (count != 0U)
+    {
+        *p++ = digits[--count];
+    }
+
+    return p;
+}
+
+/*******************************************************************************
+ * Function Name: microbench_report
+ *******************************************************************************
+ *
+ * Summary:
+ *  Sends the results of the last run on CYBSP_UART, one line per primitive:
+ *  the mean, minimum and maximum cycles per operation, less the probe
+ *  overhead.
+ *
+ ******************************************************************************/
+void microbench_report(void)
+{
+    char line[MICROBENCH_LINE];
+    const microbench_result_t *result;
+    uint64_t ops;
+    uint32_t mean10;
+    uint32_t id;
+    char *p;
+
+    p = microbench_put(line, "microbench: ");
+    p = microbench_put_u32(p, benchRuns);
+    p = microbench_put(p, " runs, HFCLK ");
+    p = microbench_put_u32(p, Cy_SysClk_ClkHfGetFrequency() / 1000000UL);
+    p = microbench_put(p, " MHz, probe overhead ");
+    p = microbench_put_u32(p, cyccnt_overhead());
+    p = microbench_put(p, " cycles\r\n");
+    *p = '\0';
+    Cy_SCB_UART_PutString(CYBSP_UART_HW, line);
+
+    for (id = 0U; id < (uint32_t)MICROBENCH_COUNT; id++)
+    {
+        result = &benchResults[id];
+        ops = (uint64_t)result->probe.count * result->ops;
+        mean10 = (ops != 0U) ? (uint32_t)((result->probe.sum * 10U) / ops) : 0U;
+
+        p = microbench_put(line, result->name);
+        while (p < &line[MICROBENCH_NAME_WIDTH])
+        {
+            *p++ = ' ';
+        }
+        p = microbench_put(p, " mean ");
+        p = microbench_put_u32(p, mean10 / 10U);
+        *p++ = '.';
+        p = microbench_put_u32(p, mean10 % 10U);
+        p = microbench_put(p, " min ");
+        p = microbench_put_u32(p, (result->probe.count != 0U) ? (result->probe.min / result->ops) : 0U);
+        p = microbench_put(p, " max ");
+        p = microbench_put_u32(p, result->probe.max / result->ops);
+        p = microbench_put(p, " cycles\r\n");
+        *p = '\0';
+        Cy_SCB_UART_PutString(CYBSP_UART_HW, line);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: microbench_result
+ *******************************************************************************
+ *
+ * Summary:
+ *  Returns the result of a primitive from the last run.
+ *
+ ******************************************************************************/
+const microbench_result_t *microbench_result(microbench_id_t id)
+{
+    return &benchResults[id];
+}
+
+#endif /* MICROBENCH */
+
+/* [] END OF FILE */
@@ -0,0 +1,112 @@
+/******************************************************************************
+* File Name: microbench.h
+*
+* Description: Microbenchmarks of the PDL primitives the power modes
+*              firmware is built on. Each primitive is timed a number of
+*              times with the cycle counter probes of cyccnt.h, and the mean,
+*              minimum and maximum cycles are reported as text on CYBSP_UART.
+*              Built as its own firmware with MICROBENCH=1 in the Makefile.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef MICROBENCH_H
+#define MICROBENCH_H
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cy_pdl.h"
+#include "cyccnt.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Builds the benchmark firmware instead of the application. Set from the
+ * Makefile: MICROBENCH=1. Needs CYCCNT_ENABLE=1. */
+#ifndef MICROBENCH
+#define MICROBENCH              (0U)
+#endif
+
+/* Times each primitive is run per report */
+#ifndef MICROBENCH_RUNS
+#define MICROBENCH_RUNS         (1000U)
+#endif
+
+/* Bytes per Cy_SCB_UART_PutString() call: the TX FIFO depth, so the CPU
+ * cost per byte is timed and not the line rate */
+#define MICROBENCH_UART_BYTES   (8U)
+
+/* Modules whose skip masks MICROBENCH_PM_WALK_ALL can clear */
+#define MICROBENCH_MODULES      (16U)
+
+/* Pause between two reports of the benchmark firmware */
+#define MICROBENCH_PERIOD_MS    (500U)
+
+/*******************************************************************************
+ * Data types
+ ******************************************************************************/
+typedef enum
+{
+    MICROBENCH_GPIO_WRITE = 0U,         /* Cy_GPIO_Write() of the User LED */
+    MICROBENCH_GPIO_CLEAR,              /* Cy_GPIO_ClearInterrupt() of the button */
+    MICROBENCH_SLEEP,                   /* Cy_SysPm_CpuEnterSleep() round trip */
+    MICROBENCH_PM_WALK,                 /* pm_check(): the module callback walk */
+    MICROBENCH_PM_WALK_ALL,             /* pm_check() with no phase skipped */
+    MICROBENCH_UART_BYTE,               /* Cy_SCB_UART_PutString(), per byte */
+    MICROBENCH_COUNT
+} microbench_id_t;
+
+/* Result of one primitive. The probe times one call, which does ops
+ * operations (bytes for the UART). */
+typedef struct
+{
+    const char *name;
+    uint32_t ops;
+    cyccnt_probe_t probe;
+} microbench_result_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+#if MICROBENCH
+void microbench_run(uint32_t runs);
+void microbench_report(void);
+const microbench_result_t *microbench_result(microbench_id_t id);
+#endif
+
+#endif /* MICROBENCH_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,217 @@
+/******************************************************************************
+* File Name: pd_gate.c
+*
+* Description: USB-PD activity gate for Deep Sleep. Each activity source has
+*              its own flag byte, so the interrupt handlers set and clear
+*              them with single stores and no critical section. The gate is
+*              a power management module taking part in Deep Sleep only: its
+*              CHECK_READY callback refuses the transition while a source is
+*              active or the PD stack is not idle; Sleep is not gated.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "pd_gate.h"
+#include "pm_module.h"
+
+#define LOG_MODULE_LEVEL        LOG_LEVEL_PD
+#include "log.h"
+
+/*******************************************************************************
+ * Global variables
+ ******************************************************************************/
+static volatile uint8_t pdActivity[PD_GATE_SOURCE_COUNT];
+static volatile uint32_t pdBlocked;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+static cy_en_syspm_status_t pd_gate_callback(cy_en_syspm_callback_type_t type,
+                                             cy_en_syspm_callback_mode_t mode);
+
+/* Only CHECK_READY is used */
+static volatile uint8_t pdGateSkip = CY_SYSPM_SKIP_CHECK_FAIL |
+                                     CY_SYSPM_SKIP_BEFORE_TRANSITION |
+                                     CY_SYSPM_SKIP_AFTER_TRANSITION;
+
+/* High priority: refuse before other modules prepare for Deep Sleep */
+PM_MODULE_DEFINE(pd_gate_module, PM_PRIORITY_HIGH,
+    .callback = pd_gate_callback,
+    .types    = PM_TYPE_DEEPSLEEP,
+    .skipMode = &pdGateSkip);
+
+/*******************************************************************************
+ * Function Name: pd_gate_set
+ *******************************************************************************
+ *
+ * Summary:
+ *  Marks an activity source as active. Call it from the CC / VBUS interrupt
+ *  handlers or the PD stack event callback when activity starts; this
+ *  example has no USB-PD port to call it (see README.md).
+ *
+ * Parameters:
+ *  source: Activity source.
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void pd_gate_set(pd_gate_source_t source)
+{
+    pdActivity[source] = 1U;
+}
+
+/*******************************************************************************
+ * Function Name: pd_gate_clear
+ *******************************************************************************
+ *
+ * Summary:
+ *  Marks an activity source as idle again.
+ *
+ * Parameters:
+ *  source: Activity source.
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void pd_gate_clear(pd_gate_source_t source)
+{
+    pdActivity[source] = 0U;
+}
+
+/*******************************************************************************
+ * Function Name: pd_gate_busy
+ *******************************************************************************
+ *
+ * Summary:
+ *  Returns true while any activity source is active or the PD stack is busy.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  true if Deep Sleep must wait for PD activity.
+ *
+ ******************************************************************************/
+bool pd_gate_busy(void)
+{
+    uint32_t source;
+
+    for (source = 0U; source < (uint32_t)PD_GATE_SOURCE_COUNT; source++)
+    {
+        if (pdActivity[source] != 0U)
+        {
+            return true;
+        }
+    }
+
+    return !pd_gate_stack_idle();
+}
+
+/*******************************************************************************
+ * Function Name: pd_gate_stack_idle
+ *******************************************************************************
+ *
+ * Summary:
+ *  Asks the PD stack whether it can enter Deep Sleep. This default has no
+ *  stack to ask and returns true; applications running the PDStack
+ *  middleware override it with Cy_PdStack_Dpm_PrepareDeepSleep().
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  true if the PD stack allows Deep Sleep.
+ *
+ ******************************************************************************/
+__WEAK bool pd_gate_stack_idle(void)
+{
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: pd_gate_blocked_count
+ *******************************************************************************
+ *
+ * Summary:
+ *  Returns the number of Deep Sleep entries refused because of PD activity.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  The refusal count, modulo 2^32.
+ *
+ ******************************************************************************/
+uint32_t pd_gate_blocked_count(void)
+{
+    return pdBlocked;
+}
+
+/*******************************************************************************
+ * Function Name: pd_gate_callback
+ *******************************************************************************
+ *
+ * Summary:
+ *  Deep Sleep CHECK_READY: refuses the transition while PD is busy.
+ *
+ * Parameters:
+ *  type: Power mode being entered, always CY_SYSPM_DEEPSLEEP.
+ *  mode: Callback phase, only CY_SYSPM_CHECK_READY is not skipped.
+ *
+ * Return:
+ *  CY_SYSPM_FAIL while PD is busy, CY_SYSPM_SUCCESS otherwise.
+ *
+ ******************************************************************************/
+static cy_en_syspm_status_t pd_gate_callback(cy_en_syspm_callback_type_t type,
+                                             cy_en_syspm_callback_mode_t mode)
+{
+    (void) type;
+
+    if ((mode == CY_SYSPM_CHECK_READY) && pd_gate_busy())
+    {
+        pdBlocked++;
+        LOG_DEBUG("Deep Sleep refused, USB-PD busy");
+        return CY_SYSPM_FAIL;
+    }
+
+    return CY_SYSPM_SUCCESS;
+}
+
+/* [] END OF FILE */
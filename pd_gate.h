@@ -0,0 +1,75 @@
+/******************************************************************************
+* File Name: pd_gate.h
+*
+* Description: USB-PD activity gate for Deep Sleep. CC, VBUS and PD message
+*              activity reported by the USB-PD interrupt handlers blocks
+*              Deep Sleep through a CY_SYSPM_CHECK_READY refusal until the
+*              activity is over.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef PD_GATE_H
+#define PD_GATE_H
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cy_pdl.h"
+
+/*******************************************************************************
+ * Data types
+ ******************************************************************************/
+/* Activity sources tracked by the gate */
+typedef enum
+{
+    PD_GATE_CC = 0U,            /* CC line change: attach, detach, debounce */
+    PD_GATE_VBUS,               /* VBUS ramp or discharge in progress */
+    PD_GATE_PD_MSG,             /* PD message exchange / contract negotiation */
+    PD_GATE_SOURCE_COUNT
+} pd_gate_source_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+void pd_gate_set(pd_gate_source_t source);
+void pd_gate_clear(pd_gate_source_t source);
+bool pd_gate_busy(void);
+bool pd_gate_stack_idle(void);
+uint32_t pd_gate_blocked_count(void);
+
+#endif /* PD_GATE_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,366 @@
+/******************************************************************************
+* File Name: pm_module.c
+*
+* Description: Walks the static power management module table built by the
+*              linker: runs the init hooks, enables the wake sources and
+*              dispatches the SysPm callback phases around Sleep and Deep Sleep
+*              entry, in place of the PDL run-time callback list.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "pm_module.h"
+#include "pm_stats.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Runs for each module pm_call() visits; called is true if its callback ran.
+ * Empty unless the build defines it. */
+#ifndef PM_CALL_STEP
+#define PM_CALL_STEP(called)    do { } while (0)
+#endif
+
+/*******************************************************************************
+ * Function Name: pm_skip_flag
+ *******************************************************************************
+ *
+ * Summary:
+ *  Returns the CY_SYSPM_SKIP_xxx flag matching a callback phase.
+ *
+ * Parameters:
+ *  mode: Callback phase.
+ *
+ * Return:
+ *  Skip flag.
+ *
+ ******************************************************************************/
+PM_WAKE_FUNC static uint8_t pm_skip_flag(cy_en_syspm_callback_mode_t mode)
+{
+    uint8_t flag;
+
+    switch (mode)
+    {
+        case CY_SYSPM_CHECK_READY:
+            flag = CY_SYSPM_SKIP_CHECK_READY;
+            break;
+
+        case CY_SYSPM_CHECK_FAIL:
+            flag = CY_SYSPM_SKIP_CHECK_FAIL;
+            break;
+
+        case CY_SYSPM_BEFORE_TRANSITION:
+            flag = CY_SYSPM_SKIP_BEFORE_TRANSITION;
+            break;
+
+        default:
+            flag = CY_SYSPM_SKIP_AFTER_TRANSITION;
+            break;
+    }
+
+    return flag;
+}
+
+/*******************************************************************************
+ * Function Name: pm_call
+ *******************************************************************************
+ *
+ * Summary:
+ *  Invokes the callback of a module if it takes part in the given power mode
+ *  and does not currently skip the phase.
+ *
+ * Parameters:
+ *  module: Module descriptor.
+ *  type: Power mode being entered.
+ *  mode: Callback phase.
+ *
+ * Return:
+ *  Callback status, CY_SYSPM_SUCCESS if the module is not involved or skips
+ *  the phase.
+ *
+ ******************************************************************************/
+PM_WAKE_FUNC static cy_en_syspm_status_t pm_call(const pm_module_t *module,
+        cy_en_syspm_callback_type_t type, cy_en_syspm_callback_mode_t mode)
+{
+    cy_en_syspm_status_t retVal = CY_SYSPM_SUCCESS;
+    bool called = (module->callback != NULL) &&
+                  ((module->types & (1UL << (uint32_t)type)) != 0U) &&
+                  ((module->skipMode == NULL) || ((*module->skipMode & pm_skip_flag(mode)) == 0U));
+
+    if (called)
+    {
+        retVal = module->callback(type, mode);
+    }
+    PM_CALL_STEP(called);
+
+    return retVal;
+}
+
+/*******************************************************************************
+ * Function Name: pm_work_pending
+ *******************************************************************************
+ *
+ * Summary:
+ *  Asks the modules whether the main loop has work pending.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  true if a module has work pending.
+ *
+ ******************************************************************************/
+PM_WAKE_FUNC static bool pm_work_pending(void)
+{
+    const pm_module_t *module;
+    uint32_t i;
+
+    for (i = 0U; i < PM_TABLE_COUNT; i++)
+    {
+        module = PM_TABLE_MODULE(i);
+        if ((module->workPending != NULL) && module->workPending())
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*******************************************************************************
+ * Function Name: pm_init
+ *******************************************************************************
+ *
+ * Summary:
+ *  Starts the power statistics, then runs the init hook of every module and
+ *  enables its wake source interrupt, in priority order.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  CY_SYSPM_SUCCESS, or CY_SYSPM_FAIL if a wake source could not be set up.
+ *
+ ******************************************************************************/
+cy_en_syspm_status_t pm_init(void)
+{
+    const pm_module_t *module;
+    uint32_t i;
+
+    pm_stats_init();
+
+    for (i = 0U; i < PM_TABLE_COUNT; i++)
+    {
+        module = PM_TABLE_MODULE(i);
+        if (module->init != NULL)
+        {
+            module->init();
+        }
+
+        if (module->wakeIntr != NULL)
+        {
+            if (Cy_SysInt_Init(module->wakeIntr, module->wakeIsr) != CY_SYSINT_SUCCESS)
+            {
+                return CY_SYSPM_FAIL;
+            }
+
+            NVIC_EnableIRQ(module->wakeIntr->intrSrc);
+        }
+    }
+
+    return CY_SYSPM_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: pm_enter
+ *******************************************************************************
+ *
+ * Summary:
+ *  Puts the CPU into Sleep or Deep Sleep. Follows the PDL callback sequence:
+ *  CHECK_READY and BEFORE_TRANSITION in table order, CHECK_FAIL (for the
+ *  modules that were ready) and AFTER_TRANSITION in reverse order. Must be
+ *  called with interrupts enabled.
+ *
+ *  Interrupts taken while the callbacks run, for example during the LED
+ *  indication of the application, can leave work for the main loop. The
+ *  modules are asked for pending work with interrupts masked, and the CPU
+ *  does not sleep if there is any: a masked interrupt that arrives after the
+ *  check still ends the sleep, and is served once interrupts are enabled.
+ *  A canceled entry still runs the AFTER_TRANSITION callbacks, but counts no
+ *  wakeup and no exit latency.
+ *
+ * Parameters:
+ *  type: CY_SYSPM_SLEEP or CY_SYSPM_DEEPSLEEP.
+ *
+ * Return:
+ *  CY_SYSPM_SUCCESS if the CPU was put into the low power mode,
+ *  CY_SYSPM_FAIL if a module refused the transition,
+ *  CY_SYSPM_CANCELED if the CPU did not sleep because of pending work.
+ *
+ ******************************************************************************/
+PM_WAKE_FUNC cy_en_syspm_status_t pm_enter(cy_en_syspm_callback_type_t type)
+{
+    uint32_t i;
+    bool canceled;
+
+    for (i = 0U; i < PM_TABLE_COUNT; i++)
+    {
+        if (pm_call(PM_TABLE_MODULE(i), type, CY_SYSPM_CHECK_READY) != CY_SYSPM_SUCCESS)
+        {
+            /* Roll back the modules that already agreed */
+            while (i > 0U)
+            {
+                i--;
+                (void) pm_call(PM_TABLE_MODULE(i), type, CY_SYSPM_CHECK_FAIL);
+            }
+
+            pm_stats_refused();
+            return CY_SYSPM_FAIL;
+        }
+    }
+
+    pm_stats_before();
+    for (i = 0U; i < PM_TABLE_COUNT; i++)
+    {
+        (void) pm_call(PM_TABLE_MODULE(i), type, CY_SYSPM_BEFORE_TRANSITION);
+    }
+    pm_stats_sleep();
+
+    __disable_irq();
+    canceled = pm_work_pending();
+    if (!canceled)
+    {
+        if (type == CY_SYSPM_DEEPSLEEP)
+        {
+            (void) Cy_SysPm_CpuEnterDeepSleep();
+            pm_stats_wake(PM_STATS_DEEPSLEEP);
+        }
+        else
+        {
+            (void) Cy_SysPm_CpuEnterSleep();
+            pm_stats_wake(PM_STATS_SLEEP);
+        }
+    }
+    __enable_irq();
+
+    for (i = PM_TABLE_COUNT; i > 0U; )
+    {
+        i--;
+        (void) pm_call(PM_TABLE_MODULE(i), type, CY_SYSPM_AFTER_TRANSITION);
+    }
+
+    if (canceled)
+    {
+        pm_stats_canceled();
+        return CY_SYSPM_CANCELED;
+    }
+    pm_stats_after();
+
+    return CY_SYSPM_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: pm_check
+ *******************************************************************************
+ *
+ * Summary:
+ *  Walks the table as pm_enter() does when a module refuses: CHECK_READY in
+ *  table order, then CHECK_FAIL in reverse order for the modules that were
+ *  ready. Nothing is entered. Used to time the callback walk (microbench.c).
+ *
+ * Parameters:
+ *  type: CY_SYSPM_SLEEP or CY_SYSPM_DEEPSLEEP.
+ *
+ * Return:
+ *  CY_SYSPM_SUCCESS if every module was ready, else CY_SYSPM_FAIL.
+ *
+ ******************************************************************************/
+cy_en_syspm_status_t pm_check(cy_en_syspm_callback_type_t type)
+{
+    cy_en_syspm_status_t retVal = CY_SYSPM_SUCCESS;
+    uint32_t i;
+
+    for (i = 0U; i < PM_TABLE_COUNT; i++)
+    {
+        if (pm_call(PM_TABLE_MODULE(i), type, CY_SYSPM_CHECK_READY) != CY_SYSPM_SUCCESS)
+        {
+            retVal = CY_SYSPM_FAIL;
+            break;
+        }
+    }
+
+    while (i > 0U)
+    {
+        i--;
+        (void) pm_call(PM_TABLE_MODULE(i), type, CY_SYSPM_CHECK_FAIL);
+    }
+
+    return retVal;
+}
+
+/*******************************************************************************
+ * Function Name: pm_notify_clock
+ *******************************************************************************
+ *
+ * Summary:
+ *  Calls the clockChanged hook of every module, in priority order, after the
+ *  HFCLK frequency has changed (see clock_ctrl.c).
+ *
+ * Parameters:
+ *  hfclkHz: New HFCLK frequency in Hz.
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void pm_notify_clock(uint32_t hfclkHz)
+{
+    const pm_module_t *module;
+    uint32_t i;
+
+    for (i = 0U; i < PM_TABLE_COUNT; i++)
+    {
+        module = PM_TABLE_MODULE(i);
+        if (module->clockChanged != NULL)
+        {
+            module->clockChanged(hfclkHz);
+        }
+    }
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,210 @@
+/******************************************************************************
+* File Name: pm_module.h
+*
+* Description: Static power management module table. Each module declares its
+*              init hook, wake source and SysPm callback with PM_MODULE_DEFINE;
+*              the linker collects the declarations into a const, priority
+*              sorted table in flash (see pm_sections.ld), so nothing has to be
+*              registered at run time.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef PM_MODULE_H
+#define PM_MODULE_H
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cy_pdl.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Power modes a module takes part in (pm_module_t.types) */
+#define PM_TYPE_SLEEP           (0x01U)
+#define PM_TYPE_DEEPSLEEP       (0x02U)
+#define PM_TYPE_ALL             (PM_TYPE_SLEEP | PM_TYPE_DEEPSLEEP)
+
+/* Module priorities. Lower values are called first on the way down
+ * (CHECK_READY, BEFORE_TRANSITION) and last on the way up (CHECK_FAIL,
+ * AFTER_TRANSITION). Priorities are pasted into the section name and sorted
+ * by name, so they must be two-digit decimal literals (10 - 99). */
+#define PM_PRIORITY_HIGH        10
+#define PM_PRIORITY_DEFAULT     50
+#define PM_PRIORITY_LOW         90
+
+/* Place the wake-critical path (wake ISRs, pm_enter() and the functions
+ * marked PM_WAKE_FUNC) in SRAM, so the CPU does not fetch from flash right
+ * after Deep Sleep exit. Set from the Makefile: DEFINES+=PM_WAKE_PATH_IN_RAM=1 */
+#ifndef PM_WAKE_PATH_IN_RAM
+#define PM_WAKE_PATH_IN_RAM     (0U)
+#endif
+
+/* Marks a function of the wake path. With PM_WAKE_PATH_IN_RAM the function is
+ * placed in the .cy_ramfunc.pm_wake section, which the BSP linker script
+ * copies to SRAM with the other .cy_ramfunc code; long_call lets flash code
+ * reach it. */
+#if PM_WAKE_PATH_IN_RAM
+#define PM_WAKE_FUNC            __attribute__((section(".cy_ramfunc.pm_wake"), long_call))
+#else
+#define PM_WAKE_FUNC
+#endif
+
+/* The build links pm_sections.ld (GCC_ARM), which collects the module table
+ * and the log strings from their linker sections. The Makefile sets it to 0
+ * for the other toolchains: the table is then the list in pm_table.c, and
+ * logging is not available. */
+#ifndef PM_SECTIONS
+#define PM_SECTIONS             (1U)
+#endif
+
+#define PM_STRINGIFY_(x)        #x
+#define PM_STRINGIFY(x)         PM_STRINGIFY_(x)
+
+/*******************************************************************************
+ * Macro Name: PM_MODULE_DEFINE
+ *******************************************************************************
+ *
+ * Summary:
+ *  Declares a power management module. The descriptor is placed in the
+ *  ".pm_table.<priority>.<name>" input section; pm_sections.ld sorts these
+ *  sections by name and exposes the result as a single const array. Without
+ *  PM_SECTIONS, the descriptor is a plain constant listed in pm_table.c.
+ *
+ * Parameters:
+ *  name: Identifier of the descriptor.
+ *  priority: Two-digit priority, see PM_PRIORITY_DEFAULT.
+ *  ...: Designated initializers for the pm_module_t fields.
+ *
+ * Example:
+ *  PM_MODULE_DEFINE(led_module, PM_PRIORITY_DEFAULT,
+ *                   .callback = led_pm_callback,
+ *                   .types    = PM_TYPE_ALL);
+ *
+ ******************************************************************************/
+#if PM_SECTIONS
+#define PM_MODULE_DEFINE(name, priority, ...)                                  \
+    const pm_module_t name                                                     \
+    __attribute__((used, aligned(4),                                           \
+        section(".pm_table." PM_STRINGIFY(priority) "." #name))) =             \
+    { __VA_ARGS__ }
+#else
+#define PM_MODULE_DEFINE(name, priority, ...)                                  \
+    const pm_module_t name = { __VA_ARGS__ }
+#endif
+
+/* Module table in call order: PM_TABLE_MODULE(0) to
+ * PM_TABLE_MODULE(PM_TABLE_COUNT - 1) */
+#if PM_SECTIONS
+#define PM_TABLE_COUNT          ((uint32_t)(__pm_table_end - __pm_table_start))
+#define PM_TABLE_MODULE(i)      (&__pm_table_start[(i)])
+#else
+#define PM_TABLE_COUNT          (pm_table_count)
+#define PM_TABLE_MODULE(i)      (pm_table[(i)])
+#endif
+
+/*******************************************************************************
+ * Data types
+ ******************************************************************************/
+/* Module power callback. Same contract as the PDL SysPm callbacks, but the
+ * power mode being entered is passed instead of the callback parameters. */
+typedef cy_en_syspm_status_t (*pm_callback_t)(cy_en_syspm_callback_type_t type,
+                                              cy_en_syspm_callback_mode_t mode);
+
+/* Power management module descriptor. Lives in flash; all fields optional.
+ * skipMode points to a byte in RAM holding CY_SYSPM_SKIP_xxx flags, so the
+ * module can drop callback phases it has nothing to do in at run time. */
+typedef struct
+{
+    void (*init)(void);                 /* Called once from pm_init() */
+    pm_callback_t callback;             /* Power transition callback */
+    uint32_t types;                     /* PM_TYPE_xxx modes using callback */
+    volatile uint8_t *skipMode;         /* Phases to skip, or NULL */
+    const cy_stc_sysint_t *wakeIntr;    /* Wake source interrupt, or NULL */
+    cy_israddress wakeIsr;              /* Handler for wakeIntr */
+    void (*clockChanged)(uint32_t hfclkHz); /* Called after HFCLK changes */
+    bool (*workPending)(void);          /* Main loop work pending, checked by
+                                         * pm_enter() with interrupts masked */
+} pm_module_t;
+
+/*******************************************************************************
+ * Global variables
+ ******************************************************************************/
+#if PM_SECTIONS
+/* Table bounds, defined by pm_sections.ld */
+extern const pm_module_t __pm_table_start[];
+extern const pm_module_t __pm_table_end[];
+#else
+/* Module list of pm_table.c */
+extern const pm_module_t *const pm_table[];
+extern const uint32_t pm_table_count;
+#endif
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+cy_en_syspm_status_t pm_init(void);
+PM_WAKE_FUNC cy_en_syspm_status_t pm_enter(cy_en_syspm_callback_type_t type);
+cy_en_syspm_status_t pm_check(cy_en_syspm_callback_type_t type);
+void pm_notify_clock(uint32_t hfclkHz);
+
+/*******************************************************************************
+ * Function Name: pm_skip_update
+ *******************************************************************************
+ *
+ * Summary:
+ *  Changes the callback phases skipped for a module. Call it from the context
+ *  that calls pm_enter(), whenever the module state changes what its callback
+ *  has to do (for example skip CY_SYSPM_SKIP_AFTER_TRANSITION while there is
+ *  nothing to restore).
+ *
+ * Parameters:
+ *  module: Module descriptor, must have a skipMode byte.
+ *  set: CY_SYSPM_SKIP_xxx flags to add.
+ *  clear: CY_SYSPM_SKIP_xxx flags to remove.
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+__STATIC_INLINE void pm_skip_update(const pm_module_t *module, uint8_t set, uint8_t clear)
+{
+    *module->skipMode = (uint8_t)((*module->skipMode & (uint8_t)~clear) | set);
+}
+
+#endif /* PM_MODULE_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,380 @@
+/******************************************************************************
+* File Name: pm_stats.c
+*
+* Description: Power statistics. Residency is measured in ILO ticks of the
+*              watchdog service time base, which keeps counting in Deep
+*              Sleep; transition latencies are measured in CPU cycles with
+*              SysTick, which runs free; only cyccnt.c takes its interrupt.
+*              The charge estimate and the latency mean and variance use the
+*              integer arithmetic of fxstat.c. Every update is one write
+*              section of pm_stats.lock, so readers get consistent snapshots.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "pm_stats.h"
+#include "fxstat.h"
+#include "wdt_svc.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+#define PM_STATS_SYSTICK_MASK   (0x00FFFFFFUL)
+
+/* Longest time between two residency updates, 1 h. The ILO tick differences
+ * are 32 bits and wrap after 29.8 h, also when the device stays Active. */
+#define PM_STATS_REFRESH_TICKS  (3600UL * WDT_SVC_ILO_HZ)
+
+/* pm_stats_record() result of a transition too long to count in cycles */
+#define PM_STATS_LONG           (UINT32_MAX)
+
+/*******************************************************************************
+ * Global variables
+ ******************************************************************************/
+pm_stats_t pm_stats =
+{
+    .version   = PM_STATS_VERSION,
+    .size      = (uint8_t)sizeof(pm_stats_t),
+    .histBins  = PM_STATS_HIST_BINS,
+    .histShift = PM_STATS_HIST_SHIFT,
+    .lock      = SEQLOCK_INIT
+};
+qhist_t pm_stats_dsexit = QHIST_INIT;
+
+/* Time of the last residency update, ILO ticks */
+static uint32_t statsLastTicks;
+
+/* Start of the latency measurement in progress */
+static uint32_t statsStartTicks;
+static uint32_t statsStartCycles;
+
+/* Mode of the exit latency measurement in progress */
+static uint32_t statsWakeMode;
+
+/* Charge per ILO tick of each mode, and the fractions of pm_stats.charge */
+static const uint32_t statsChargePerTick[PM_STATS_MODES] =
+{
+    FXSTAT_CHARGE_PER_TICK(PM_STATS_ACTIVE_NA, WDT_SVC_ILO_HZ),
+    FXSTAT_CHARGE_PER_TICK(PM_STATS_SLEEP_NA, WDT_SVC_ILO_HZ),
+    FXSTAT_CHARGE_PER_TICK(PM_STATS_DEEPSLEEP_NA, WDT_SVC_ILO_HZ)
+};
+static uint32_t statsChargeFrac[PM_STATS_MODES];
+
+/*******************************************************************************
+ * Function Name: pm_stats_mark
+ *******************************************************************************
+ *
+ * Summary:
+ *  Starts a latency measurement.
+ *
+ ******************************************************************************/
+PM_WAKE_FUNC static void pm_stats_mark(void)
+{
+    statsStartCycles = SysTick->VAL;
+    statsStartTicks = wdt_svc_now();
+}
+
+/*******************************************************************************
+ * Function Name: pm_stats_record
+ *******************************************************************************
+ *
+ * Summary:
+ *  Ends a latency measurement and counts it in a histogram.
+ *
+ * Parameters:
+ *  hist: Histogram, PM_STATS_HIST_BINS saturating counters.
+ *  now: Current time in ILO ticks.
+ *
+ * Return:
+ *  The latency in cycles, PM_STATS_LONG for a long transition.
+ *
+ ******************************************************************************/
+PM_WAKE_FUNC static uint32_t pm_stats_record(uint16_t *hist, uint32_t now)
+{
+    /* SysTick counts down */
+    uint32_t cycles = (statsStartCycles - SysTick->VAL) & PM_STATS_SYSTICK_MASK;
+    uint32_t scaled = cycles >> PM_STATS_HIST_SHIFT;
+    uint32_t bin = 0U;
+
+    if ((now - statsStartTicks) >= PM_STATS_LONG_TICKS)
+    {
+        bin = PM_STATS_HIST_BINS - 1U;
+        cycles = PM_STATS_LONG;
+    }
+    else
+    {
+        while ((scaled != 0U) && (bin < (PM_STATS_HIST_BINS - 1U)))
+        {
+            scaled >>= 1U;
+            bin++;
+        }
+    }
+
+    if (hist[bin] != UINT16_MAX)
+    {
+        hist[bin]++;
+    }
+
+    return cycles;
+}
+
+/*******************************************************************************
+ * Function Name: pm_stats_residency
+ *******************************************************************************
+ *
+ * Summary:
+ *  Adds the time since the last update to a mode, with its charge. The
+ *  residency carries into its high word.
+ *
+ * Parameters:
+ *  mode: PM_STATS_xxx mode.
+ *  now: Current time in ILO ticks.
+ *
+ ******************************************************************************/
+PM_WAKE_FUNC static void pm_stats_residency(uint32_t mode, uint32_t now)
+{
+    uint32_t ticks = now - statsLastTicks;
+
+    pm_stats.residency[mode] += ticks;
+    if (pm_stats.residency[mode] < ticks)
+    {
+        pm_stats.residencyHi[mode]++;
+    }
+    pm_stats.charge[mode] += fxstat_charge_add(&statsChargeFrac[mode], ticks, statsChargePerTick[mode]);
+    statsLastTicks = now;
+}
+
+/*******************************************************************************
+ * Function Name: pm_stats_refresh
+ *******************************************************************************
+ *
+ * Summary:
+ *  Watchdog service timer, every PM_STATS_REFRESH_TICKS: adds the time since
+ *  the last update to Active mode. The WDT interrupt only runs while the CPU
+ *  is Active, and a wakeup has already counted the time slept.
+ *
+ ******************************************************************************/
+static void pm_stats_refresh(void)
+{
+    uint32_t now = wdt_svc_now();
+    uint32_t savedIntr = seqlock_write_begin(&pm_stats.lock);
+
+    pm_stats_residency(PM_STATS_ACTIVE, now);
+    seqlock_write_end(&pm_stats.lock, savedIntr);
+}
+
+/*******************************************************************************
+ * Function Name: pm_stats_init
+ *******************************************************************************
+ *
+ * Summary:
+ *  Starts SysTick as a free running 24-bit down counter of CPU cycles, unless
+ *  the application already runs it, and starts the residency clock and its
+ *  refresh timer.
+ *
+ ******************************************************************************/
+void pm_stats_init(void)
+{
+    if ((SysTick->CTRL & SysTick_CTRL_ENABLE_Msk) == 0U)
+    {
+        SysTick->LOAD = PM_STATS_SYSTICK_MASK;
+        SysTick->VAL = 0U;
+        SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+    }
+
+    statsLastTicks = wdt_svc_now();
+    wdt_svc_timer_start(WDT_SVC_TIMER_STATS, PM_STATS_REFRESH_TICKS, true, pm_stats_refresh);
+}
+
+/*******************************************************************************
+ * Function Name: pm_stats_refused
+ *******************************************************************************
+ *
+ * Summary:
+ *  Counts a transition refused in CHECK_READY.
+ *
+ ******************************************************************************/
+PM_WAKE_FUNC void pm_stats_refused(void)
+{
+    uint32_t savedIntr = seqlock_write_begin(&pm_stats.lock);
+
+    pm_stats.refused++;
+    seqlock_write_end(&pm_stats.lock, savedIntr);
+}
+
+/*******************************************************************************
+ * Function Name: pm_stats_canceled
+ *******************************************************************************
+ *
+ * Summary:
+ *  Counts an entry canceled after BEFORE_TRANSITION because the main loop had
+ *  work pending. The CPU stayed Active, so the residency clock keeps counting
+ *  Active time and no exit latency is recorded.
+ *
+ ******************************************************************************/
+PM_WAKE_FUNC void pm_stats_canceled(void)
+{
+    uint32_t savedIntr = seqlock_write_begin(&pm_stats.lock);
+
+    pm_stats.canceled++;
+    seqlock_write_end(&pm_stats.lock, savedIntr);
+}
+
+/*******************************************************************************
+ * Function Name: pm_stats_before
+ *******************************************************************************
+ *
+ * Summary:
+ *  Called before the BEFORE_TRANSITION callbacks: starts the entry latency.
+ *
+ ******************************************************************************/
+PM_WAKE_FUNC void pm_stats_before(void)
+{
+    pm_stats_mark();
+}
+
+/*******************************************************************************
+ * Function Name: pm_stats_sleep
+ *******************************************************************************
+ *
+ * Summary:
+ *  Called right before the CPU enters the low power mode: records the entry
+ *  latency and the Active time since the last wakeup.
+ *
+ ******************************************************************************/
+PM_WAKE_FUNC void pm_stats_sleep(void)
+{
+    uint32_t now = wdt_svc_now();
+    uint32_t savedIntr = seqlock_write_begin(&pm_stats.lock);
+
+    (void) pm_stats_record(pm_stats.entryHist, now);
+    pm_stats_residency(PM_STATS_ACTIVE, now);
+    seqlock_write_end(&pm_stats.lock, savedIntr);
+}
+
+/*******************************************************************************
+ * Function Name: pm_stats_wake
+ *******************************************************************************
+ *
+ * Summary:
+ *  Called right after the CPU left the low power mode: records the time spent
+ *  in it and starts the exit latency.
+ *
+ * Parameters:
+ *  mode: PM_STATS_SLEEP or PM_STATS_DEEPSLEEP.
+ *
+ ******************************************************************************/
+PM_WAKE_FUNC void pm_stats_wake(uint32_t mode)
+{
+    uint32_t savedIntr;
+
+    pm_stats_mark();
+    savedIntr = seqlock_write_begin(&pm_stats.lock);
+    pm_stats_residency(mode, statsStartTicks);
+    pm_stats.wakeups[mode - PM_STATS_SLEEP]++;
+    seqlock_write_end(&pm_stats.lock, savedIntr);
+    statsWakeMode = mode;
+}
+
+/*******************************************************************************
+ * Function Name: pm_stats_after
+ *******************************************************************************
+ *
+ * Summary:
+ *  Called after the AFTER_TRANSITION callbacks: records the exit latency,
+ *  and adds it to the weighted mean and variance unless it was too long to
+ *  count in cycles. A Deep Sleep exit also goes to the quantile estimator,
+ *  a long one in its last bin.
+ *
+ ******************************************************************************/
+PM_WAKE_FUNC void pm_stats_after(void)
+{
+    uint32_t now = wdt_svc_now();
+    uint32_t savedIntr = seqlock_write_begin(&pm_stats.lock);
+    uint32_t cycles = pm_stats_record(pm_stats.exitHist, now);
+
+    if (cycles != PM_STATS_LONG)
+    {
+        fxstat_ewma_add(&pm_stats.exitMean, &pm_stats.exitVar, cycles);
+    }
+    if (statsWakeMode == PM_STATS_DEEPSLEEP)
+    {
+        qhist_add(&pm_stats_dsexit, cycles);
+    }
+    seqlock_write_end(&pm_stats.lock, savedIntr);
+}
+
+/*******************************************************************************
+ * Function Name: pm_stats_snapshot
+ *******************************************************************************
+ *
+ * Summary:
+ *  Copies the register map without masking interrupts (seqlock_read).
+ *
+ * Parameters:
+ *  dst: Snapshot.
+ *
+ * Return:
+ *  true if dst is consistent, false if updates kept preempting the copy.
+ *
+ ******************************************************************************/
+bool pm_stats_snapshot(pm_stats_t *dst)
+{
+    return seqlock_read(&pm_stats.lock, dst, &pm_stats, sizeof(pm_stats));
+}
+
+/*******************************************************************************
+ * Function Name: pm_stats_dsexit_snapshot
+ *******************************************************************************
+ *
+ * Summary:
+ *  Copies the Deep Sleep exit latency estimator without masking interrupts.
+ *
+ * Parameters:
+ *  dst: Snapshot.
+ *
+ * Return:
+ *  true if dst is consistent, false if updates kept preempting the copy.
+ *
+ ******************************************************************************/
+bool pm_stats_dsexit_snapshot(qhist_t *dst)
+{
+    return seqlock_read(&pm_stats.lock, dst, &pm_stats_dsexit, sizeof(pm_stats_dsexit));
+}
+
+/* [] END OF FILE */
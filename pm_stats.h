@@ -0,0 +1,148 @@
+/******************************************************************************
+* File Name: pm_stats.h
+*
+* Description: Power statistics kept by pm_enter(): residency per power
+*              mode, wakeups, refused transitions and histograms of the
+*              transition latencies. The structure is the telemetry register
+*              map, so its layout is part of the interface.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef PM_STATS_H
+#define PM_STATS_H
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cy_pdl.h"
+#include "pm_module.h"
+#include "qhist.h"
+#include "seqlock.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Layout version, first byte of the register map */
+#define PM_STATS_VERSION        (5U)
+
+/* Latency histograms: bin 0 counts below 2^PM_STATS_HIST_SHIFT cycles, bin n
+ * counts [2^(PM_STATS_HIST_SHIFT + n - 1), 2^(PM_STATS_HIST_SHIFT + n)),
+ * the last bin everything above */
+#define PM_STATS_HIST_BINS      (8U)
+#define PM_STATS_HIST_SHIFT     (7U)
+
+/* Transitions longer than this many ILO ticks (100 ms) go to the last bin
+ * without looking at SysTick, which may have wrapped */
+#define PM_STATS_LONG_TICKS     (4000U)
+
+/* Power modes tracked for residency */
+#define PM_STATS_ACTIVE         (0U)
+#define PM_STATS_SLEEP          (1U)
+#define PM_STATS_DEEPSLEEP      (2U)
+#define PM_STATS_MODES          (3U)
+
+/* Current of each mode for the charge estimate, nA, with HFCLK at 48 MHz.
+ * The defaults are the PMG1-S0 kit (Table 3 in README.md); the Makefile
+ * sets the values of the kit selected with TARGET. */
+#ifndef PM_STATS_ACTIVE_NA
+#define PM_STATS_ACTIVE_NA      (5800000UL)
+#endif
+#ifndef PM_STATS_SLEEP_NA
+#define PM_STATS_SLEEP_NA       (2230000UL)
+#endif
+#ifndef PM_STATS_DEEPSLEEP_NA
+#define PM_STATS_DEEPSLEEP_NA   (178200UL)
+#endif
+
+/*******************************************************************************
+ * Data types
+ ******************************************************************************/
+/* Register map. Little endian, naturally aligned; offsets are listed in
+ * README.md. Append new fields at the end and bump PM_STATS_VERSION.
+ * Updates are guarded by lock, which the I2C master reads before and after
+ * the map to tell a consistent read (README.md). */
+typedef struct
+{
+    uint8_t version;                            /* 0x00 PM_STATS_VERSION */
+    uint8_t size;                               /* 0x01 sizeof(pm_stats_t) */
+    uint8_t histBins;                           /* 0x02 PM_STATS_HIST_BINS */
+    uint8_t histShift;                          /* 0x03 PM_STATS_HIST_SHIFT */
+    uint32_t residency[PM_STATS_MODES];         /* 0x04 ILO ticks per mode, low words */
+    uint32_t wakeups[2];                        /* 0x10 Sleep, Deep Sleep exits */
+    uint32_t refused;                           /* 0x18 CHECK_READY refusals */
+    uint16_t entryHist[PM_STATS_HIST_BINS];     /* 0x1C BEFORE_TRANSITION to WFI */
+    uint16_t exitHist[PM_STATS_HIST_BINS];      /* 0x2C Wakeup to AFTER_TRANSITION done */
+    uint32_t charge[PM_STATS_MODES];            /* 0x3C Estimated uA s per mode */
+    uint32_t exitMean;                          /* 0x48 Exit latency, weighted mean, cycles / 16 */
+    uint32_t exitVar;                           /* 0x4C Exit latency, weighted variance, cycles^2 */
+    seqlock_t lock;                             /* 0x50 Update sequence count */
+    uint32_t canceled;                          /* 0x54 Entries canceled for pending work */
+    uint32_t residencyHi[PM_STATS_MODES];       /* 0x58 ILO ticks per mode, high words */
+} pm_stats_t;
+
+/*******************************************************************************
+ * Global variables
+ ******************************************************************************/
+extern pm_stats_t pm_stats;
+
+/* Deep Sleep exit latency in cycles, for p50/p99 (qhist_quantile). Not part
+ * of the register map; telemetry_uart sends it as a frame of its own.
+ * Updated under pm_stats.lock. */
+extern qhist_t pm_stats_dsexit;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+/* Residency of a mode in ILO ticks. 32 bits wrap after 29.8 h at 40 kHz, so
+ * the map keeps the high words apart. */
+__STATIC_INLINE uint64_t pm_stats_residency_ticks(const pm_stats_t *stats, uint32_t mode)
+{
+    return ((uint64_t)stats->residencyHi[mode] << 32) | stats->residency[mode];
+}
+
+void pm_stats_init(void);
+bool pm_stats_snapshot(pm_stats_t *dst);
+bool pm_stats_dsexit_snapshot(qhist_t *dst);
+PM_WAKE_FUNC void pm_stats_refused(void);
+PM_WAKE_FUNC void pm_stats_canceled(void);
+PM_WAKE_FUNC void pm_stats_before(void);
+PM_WAKE_FUNC void pm_stats_sleep(void);
+PM_WAKE_FUNC void pm_stats_wake(uint32_t mode);
+PM_WAKE_FUNC void pm_stats_after(void);
+
+#endif /* PM_STATS_H */
+
+/* [] END OF FILE */
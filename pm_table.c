@@ -0,0 +1,101 @@
+/******************************************************************************
+* File Name: pm_table.c
+*
+* Description: Power management module table for toolchains without
+*              pm_sections.ld (PM_SECTIONS = 0). Lists the descriptors of the
+*              modules in the order the linker fragment sorts them: by
+*              priority, then by name. A new module must be added here too.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "pm_module.h"
+
+#if !PM_SECTIONS
+
+#include "cyccnt.h"
+#include "prof.h"
+#include "telemetry_i2c.h"
+#include "telemetry_uart.h"
+
+/*******************************************************************************
+ * Global variables
+ ******************************************************************************/
+extern const pm_module_t pd_gate_module;
+extern const pm_module_t telemetry_i2c_module;
+extern const pm_module_t app_pm_module;
+extern const pm_module_t cyccnt_module;
+extern const pm_module_t defer_module;
+extern const pm_module_t wdt_svc_module;
+extern const pm_module_t prof_module;
+extern const pm_module_t supply_mon_module;
+extern const pm_module_t telemetry_uart_module;
+extern const pm_module_t wdt_svc_pm_module;
+
+const pm_module_t *const pm_table[] =
+{
+    /* PM_PRIORITY_HIGH */
+    &pd_gate_module,
+#if TELEMETRY_I2C
+    &telemetry_i2c_module,
+#endif
+
+    /* PM_PRIORITY_DEFAULT */
+    &app_pm_module,
+#if CYCCNT_ENABLE
+    &cyccnt_module,
+#endif
+    &defer_module,
+    &wdt_svc_module,
+
+    /* PM_PRIORITY_LOW */
+#if PROF_SAMPLE
+    &prof_module,
+#endif
+    &supply_mon_module,
+#if TELEMETRY_UART
+    &telemetry_uart_module,
+#endif
+    &wdt_svc_pm_module,
+};
+
+const uint32_t pm_table_count = (uint32_t)(sizeof(pm_table) / sizeof(pm_table[0]));
+
+#endif /* !PM_SECTIONS */
+
+/* [] END OF FILE */
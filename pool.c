@@ -0,0 +1,130 @@
+/******************************************************************************
+* File Name: pool.c
+*
+* Description: Fixed-block memory pools. A pool hands out the blocks
+*              returned to it first, most recently returned first, then the
+*              blocks of its storage never taken. Both take constant time.
+*              The Cortex-M0 has no exclusive access instructions, so the
+*              list updates mask interrupts for a few instructions.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "pool.h"
+
+/*******************************************************************************
+ * Function Name: pool_alloc
+ *******************************************************************************
+ *
+ * Summary:
+ *  Takes a block from a pool. Callable from interrupt handlers and from
+ *  thread context.
+ *
+ * Parameters:
+ *  pool: Pool, see POOL_DEFINE().
+ *
+ * Return:
+ *  The block, pointer aligned, or NULL if the pool is empty: the failure is
+ *  counted.
+ *
+ ******************************************************************************/
+void *pool_alloc(pool_t *pool)
+{
+    uint32_t savedIntr = __get_PRIMASK();
+    pool_block_t *block;
+
+    __disable_irq();
+    block = pool->freeList;
+    if (block != NULL)
+    {
+        pool->freeList = block->next;
+    }
+    else if (pool->fresh < pool->count)
+    {
+        block = &pool->storage[(uint32_t)pool->fresh * pool->units];
+        pool->fresh++;
+    }
+    else
+    {
+        pool->failed++;
+    }
+
+    if (block != NULL)
+    {
+        pool->used++;
+        pool->highWater = (pool->used > pool->highWater) ? pool->used : pool->highWater;
+    }
+    __set_PRIMASK(savedIntr);
+
+    return block;
+}
+
+/*******************************************************************************
+ * Function Name: pool_free
+ *******************************************************************************
+ *
+ * Summary:
+ *  Returns a block to the pool it was taken from. Callable from interrupt
+ *  handlers and from thread context.
+ *
+ * Parameters:
+ *  pool: Pool the block was taken from.
+ *  block: Block returned by pool_alloc(), or NULL.
+ *
+ ******************************************************************************/
+void pool_free(pool_t *pool, void *block)
+{
+    uint32_t savedIntr;
+    pool_block_t *freed = (pool_block_t *)block;
+
+    if (freed == NULL)
+    {
+        return;
+    }
+    CY_ASSERT((freed >= pool->storage) && (freed < &pool->storage[(uint32_t)pool->fresh * pool->units]) &&
+              (((uint32_t)(freed - pool->storage) % pool->units) == 0U));
+
+    savedIntr = __get_PRIMASK();
+    __disable_irq();
+    CY_ASSERT(pool->used != 0U);
+    freed->next = pool->freeList;
+    pool->freeList = freed;
+    pool->used--;
+    __set_PRIMASK(savedIntr);
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,117 @@
+/******************************************************************************
+* File Name: pool.h
+*
+* Description: Fixed-block memory pools for event payloads, without a heap.
+*              A pool and its storage are sized at compile time with
+*              POOL_DEFINE(); blocks are taken and returned in constant
+*              time, from interrupt handlers as well as from the main loop.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef POOL_H
+#define POOL_H
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cy_pdl.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Storage units of a block of size bytes: a free block holds the link to
+ * the next one, so blocks are at least a pointer and pointer aligned */
+#define POOL_BLOCK_UNITS(size)  (((size) + sizeof(pool_block_t) - 1U) / sizeof(pool_block_t))
+
+/*******************************************************************************
+ * Macro Name: POOL_DEFINE
+ *******************************************************************************
+ *
+ * Summary:
+ *  Defines a pool of blocks of size bytes each. The storage is a file scope
+ *  compound literal, zero initialized in .bss. Blocks never taken are handed
+ *  out from the storage in order, so the pool needs no initialization at run
+ *  time. Put static before it for a pool private to a file.
+ *
+ * Parameters:
+ *  name: Identifier of the pool.
+ *  size: Payload bytes per block, rounded up to a pointer.
+ *  blocks: Blocks, 1 - 65535.
+ *
+ * Example:
+ *  static POOL_DEFINE(event_pool, sizeof(event_t), 8U);
+ *
+ ******************************************************************************/
+#define POOL_DEFINE(name, size, blocks)                                        \
+    pool_t name =                                                              \
+    {                                                                          \
+        .storage  = (pool_block_t[POOL_BLOCK_UNITS(size) * (blocks)])          \
+                    { { NULL } },                                              \
+        .units    = (uint16_t)POOL_BLOCK_UNITS(size),                          \
+        .count    = (uint16_t)(blocks)                                         \
+    }
+
+/*******************************************************************************
+ * Data types
+ ******************************************************************************/
+/* Free block, linked into the free list of its pool */
+typedef struct pool_block
+{
+    struct pool_block *next;
+} pool_block_t;
+
+/* Pool. The fields are set up by POOL_DEFINE(); the counters are read only
+ * for the application. */
+typedef struct
+{
+    pool_block_t *freeList;             /* Returned blocks, most recent first */
+    pool_block_t *storage;              /* Blocks */
+    uint16_t units;                     /* Block size, pool_block_t units */
+    uint16_t count;                     /* Blocks */
+    uint16_t fresh;                     /* Blocks of the storage ever taken */
+    uint16_t used;                      /* Blocks taken */
+    uint16_t highWater;                 /* Most blocks taken at once */
+    uint32_t failed;                    /* Allocations failed, pool empty */
+} pool_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+void *pool_alloc(pool_t *pool);
+void pool_free(pool_t *pool, void *block);
+
+#endif /* POOL_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,310 @@
+/******************************************************************************
+* File Name: prof.c
+*
+* Description: Statistical PC sampling profiler (prof.h). The counter runs in
+*              Active mode only: a power management module stops it before
+*              Sleep and Deep Sleep and starts it again on wakeup, and dumps
+*              the samples while it is stopped, so neither the idle time nor
+*              the dump shows in the profile.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "prof.h"
+
+#if PROF_SAMPLE
+
+#include "cybsp.h"
+#include "pm_module.h"
+#include "telemetry_uart.h"
+
+#if !TELEMETRY_UART
+#error "PROF_SAMPLE needs TELEMETRY_UART=1 to dump the samples"
+#endif
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Multiplicative hash (Knuth) of the PC to the first slot tried */
+#define PROF_HASH_MUL           (2654435761U)
+
+/*******************************************************************************
+ * Global variables
+ ******************************************************************************/
+/* Sampled PCs and their counts; PC 0 marks a free slot. A count stands for
+ * 2^profShift samples: when the counts would overflow, they are halved and
+ * only every other sample is counted from then on. */
+static uint32_t profPc[PROF_SLOTS];
+static uint16_t profCount[PROF_SLOTS];
+static uint32_t profCounted;        /* Sum of profCount */
+static uint8_t profShift;
+static uint32_t profSamples;        /* Samples since the last dump */
+static uint32_t profDropped;        /* Of which not counted in the table */
+
+/* Only BEFORE_TRANSITION and AFTER_TRANSITION have work to do */
+static volatile uint8_t profSkip = CY_SYSPM_SKIP_CHECK_READY | CY_SYSPM_SKIP_CHECK_FAIL;
+
+static const cy_stc_sysint_t profIntr =
+{
+    CYBSP_PROF_TIMER_IRQ,
+    PROF_INTR_PRIORITY
+};
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+static void prof_init(void);
+static cy_en_syspm_status_t prof_pm_callback(cy_en_syspm_callback_type_t type,
+                                             cy_en_syspm_callback_mode_t mode);
+
+/* Low priority, so the work of most modules around a transition is sampled.
+ * Sorted by name before telemetry_uart_module, which waits for the UART to
+ * drain after the dump; its AFTER_TRANSITION work runs before the counter
+ * restarts and is not sampled. */
+PM_MODULE_DEFINE(prof_module, PM_PRIORITY_LOW,
+    .init     = prof_init,
+    .callback = prof_pm_callback,
+    .types    = PM_TYPE_ALL,
+    .skipMode = &profSkip);
+
+/*******************************************************************************
+ * Function Name: prof_timer_isr
+ *******************************************************************************
+ *
+ * Summary:
+ *  Counter interrupt. Reads the PC from the exception frame of the
+ *  interrupted code, on the stack that EXC_RETURN in LR selects, and passes
+ *  it to prof_sample(). Returns through the EXC_RETURN pushed with LR.
+ *  Builds for other architectures provide their own handler.
+ *
+ ******************************************************************************/
+#if defined(__arm__)
+__attribute__((naked)) void prof_timer_isr(void)
+{
+    __asm volatile (
+        "    movs r0, #4          \n"
+        "    mov  r1, lr          \n"
+        "    tst  r0, r1          \n"
+        "    bne  1f              \n"
+        "    mrs  r0, msp         \n"
+        "    b    2f              \n"
+        "1:  mrs  r0, psp         \n"
+        "2:  ldr  r0, [r0, #24]   \n"
+        "    push {r4, lr}        \n"
+        "    bl   prof_sample     \n"
+        "    pop  {r4, pc}        \n");
+}
+#endif
+
+/*******************************************************************************
+ * Function Name: prof_decimate
+ *******************************************************************************
+ *
+ * Summary:
+ *  Halves the counts and the sampling rate, so no count can overflow however
+ *  long the CPU stays in Active mode. PCs whose count drops to 0 keep their
+ *  slot until the dump.
+ *
+ ******************************************************************************/
+static void prof_decimate(void)
+{
+    uint32_t slot;
+
+    profCounted = 0U;
+    for (slot = 0U; slot < PROF_SLOTS; slot++)
+    {
+        profCount[slot] >>= 1U;
+        profCounted += profCount[slot];
+    }
+    profShift++;
+}
+
+/*******************************************************************************
+ * Function Name: prof_sample
+ *******************************************************************************
+ *
+ * Summary:
+ *  Counts a sample of the PC. Tries at most PROF_PROBES slots from the hash
+ *  of the PC, and makes one pass over the table when the counts are halved,
+ *  so the handler takes a bounded time.
+ *
+ * Parameters:
+ *  pc: Interrupted PC.
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void prof_sample(uint32_t pc)
+{
+    uint32_t slot = (pc * PROF_HASH_MUL) >> (32U - PROF_SLOTS_LOG2);
+    uint32_t probe;
+
+    Cy_TCPWM_ClearInterrupt(CYBSP_PROF_TIMER_HW, CYBSP_PROF_TIMER_NUM, CY_TCPWM_INT_ON_TC);
+
+    /* Every 2^profShift-th sample is counted */
+    if ((++profSamples & ((1UL << profShift) - 1U)) != 0U)
+    {
+        return;
+    }
+
+    for (probe = 0U; probe < PROF_PROBES; probe++)
+    {
+        if (profPc[slot] == 0U)
+        {
+            profPc[slot] = pc;
+        }
+        if (profPc[slot] == pc)
+        {
+            profCount[slot]++;
+            if (++profCounted == UINT16_MAX)
+            {
+                prof_decimate();
+            }
+            return;
+        }
+        slot = (slot + 1U) & (PROF_SLOTS - 1U);
+    }
+
+    profDropped += 1UL << profShift;
+}
+
+/*******************************************************************************
+ * Function Name: prof_dump
+ *******************************************************************************
+ *
+ * Summary:
+ *  Sends the table as TELEMETRY_FRAME_PROF frames and clears it. Called with
+ *  the counter stopped.
+ *
+ ******************************************************************************/
+static void prof_dump(void)
+{
+    uint8_t payload[TELEMETRY_FRAME_MAX_PAYLOAD];
+    size_t length;
+    uint32_t slot;
+
+    length = telemetry_varint_encode(payload, profSamples);
+    length += telemetry_varint_encode(&payload[length], profDropped);
+    for (slot = 0U; slot < PROF_SLOTS; slot++)
+    {
+        if (profCount[slot] == 0U)
+        {
+            profPc[slot] = 0U;
+            continue;
+        }
+
+        if ((length + TELEMETRY_PROF_MAX_ENTRY) > TELEMETRY_FRAME_MAX_PAYLOAD)
+        {
+            telemetry_uart_send(TELEMETRY_FRAME_PROF, payload, (uint32_t)length);
+            payload[0] = 0U;
+            payload[1] = 0U;
+            length = 2U;
+        }
+        length += telemetry_varint_encode(&payload[length], profPc[slot]);
+        length += telemetry_varint_encode(&payload[length], (uint32_t)profCount[slot] << profShift);
+        profPc[slot] = 0U;
+        profCount[slot] = 0U;
+    }
+    telemetry_uart_send(TELEMETRY_FRAME_PROF, payload, (uint32_t)length);
+
+    profCounted = 0U;
+    profShift = 0U;
+    profSamples = 0U;
+    profDropped = 0U;
+}
+
+/*******************************************************************************
+ * Function Name: prof_init
+ *******************************************************************************
+ *
+ * Summary:
+ *  Power management module init hook: starts the counter with its period
+ *  interrupt, as configured for CYBSP_PROF_TIMER in the Device Configurator.
+ *
+ ******************************************************************************/
+static void prof_init(void)
+{
+    (void) Cy_TCPWM_Counter_Init(CYBSP_PROF_TIMER_HW, CYBSP_PROF_TIMER_NUM, &CYBSP_PROF_TIMER_config);
+    Cy_TCPWM_Counter_Enable(CYBSP_PROF_TIMER_HW, CYBSP_PROF_TIMER_NUM);
+    (void) Cy_SysInt_Init(&profIntr, prof_timer_isr);
+    NVIC_EnableIRQ(profIntr.intrSrc);
+    Cy_TCPWM_TriggerStart(CYBSP_PROF_TIMER_HW, 1UL << CYBSP_PROF_TIMER_NUM);
+}
+
+/*******************************************************************************
+ * Function Name: prof_pm_callback
+ *******************************************************************************
+ *
+ * Summary:
+ *  Stops the counter before Sleep and Deep Sleep, with its interrupt cleared
+ *  so it cannot wake the CPU, and dumps a full table; starts the counter
+ *  again on wakeup.
+ *
+ ******************************************************************************/
+static cy_en_syspm_status_t prof_pm_callback(cy_en_syspm_callback_type_t type,
+                                             cy_en_syspm_callback_mode_t mode)
+{
+    (void) type;
+
+    if (mode == CY_SYSPM_BEFORE_TRANSITION)
+    {
+        Cy_TCPWM_TriggerStopOrKill(CYBSP_PROF_TIMER_HW, 1UL << CYBSP_PROF_TIMER_NUM);
+        Cy_TCPWM_ClearInterrupt(CYBSP_PROF_TIMER_HW, CYBSP_PROF_TIMER_NUM, CY_TCPWM_INT_ON_TC);
+        NVIC_ClearPendingIRQ(profIntr.intrSrc);
+
+        if (profSamples >= PROF_DUMP_SAMPLES)
+        {
+            prof_dump();
+        }
+    }
+    else if (mode == CY_SYSPM_AFTER_TRANSITION)
+    {
+        Cy_TCPWM_TriggerStart(CYBSP_PROF_TIMER_HW, 1UL << CYBSP_PROF_TIMER_NUM);
+    }
+    else
+    {
+        /* Nothing to do in the other phases */
+    }
+
+    return CY_SYSPM_SUCCESS;
+}
+
+#endif /* PROF_SAMPLE */
+
+/* [] END OF FILE */
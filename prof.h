@@ -0,0 +1,88 @@
+/******************************************************************************
+* File Name: prof.h
+*
+* Description: Statistical PC sampling profiler of the Active mode time. A
+*              TCPWM counter interrupts periodically; the handler counts the
+*              interrupted PC in a small hash table, which is dumped as
+*              telemetry frames and turned into a flat profile on the host
+*              (host/tdecode -e firmware.elf).
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef PROF_H
+#define PROF_H
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cy_pdl.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Enables the profiler. Set from the Makefile: PROF_SAMPLE=1. Needs
+ * TELEMETRY_UART=1 and a TCPWM counter named CYBSP_PROF_TIMER. */
+#ifndef PROF_SAMPLE
+#define PROF_SAMPLE             (0U)
+#endif
+
+/* Distinct PCs kept between dumps, a power of two; 6 bytes each */
+#define PROF_SLOTS_LOG2         (7U)
+#define PROF_SLOTS              (1UL << PROF_SLOTS_LOG2)
+
+/* Slots tried per sample before it is dropped */
+#define PROF_PROBES             (8U)
+
+/* The table is dumped before the next Sleep or Deep Sleep entry once this
+ * many samples are taken. Until then the table halves its counts and its
+ * sampling rate whenever they would overflow, so a long stretch of Active
+ * mode is sampled evenly. */
+#define PROF_DUMP_SAMPLES       (1024U)
+
+/* Above the other interrupts, so their handlers are sampled too */
+#define PROF_INTR_PRIORITY      (0U)
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+#if PROF_SAMPLE
+void prof_timer_isr(void);
+void prof_sample(uint32_t pc);
+#endif
+
+#endif /* PROF_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,198 @@
+/******************************************************************************
+* File Name: qhist.c
+*
+* Description: Streaming quantile estimator (qhist.h). The bin of a value is
+*              its octave, found with a four-step binary search since the
+*              Cortex-M0 has no count leading zeros instruction, and the two
+*              bits below the leading one.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "qhist.h"
+#include "fxstat.h"
+
+/* The footprint limit of the estimator */
+typedef char qhist_size_check[(sizeof(qhist_t) <= 128U) ? 1 : -1];
+
+/*******************************************************************************
+ * Function Name: qhist_add
+ *******************************************************************************
+ *
+ * Summary:
+ *  Adds a sample. Takes a fixed path, plus one pass over the bins when a
+ *  counter saturates, at most once every 65535 samples.
+ *
+ * Parameters:
+ *  hist: Histogram.
+ *  value: Sample.
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+PM_WAKE_FUNC void qhist_add(qhist_t *hist, uint32_t value)
+{
+    uint32_t v = value >> QHIST_MIN_SHIFT;
+    uint32_t msb = 0U;
+    uint32_t bin;
+    uint32_t i;
+
+    if (v >= QHIST_TOP)
+    {
+        bin = QHIST_BINS - 1U;
+    }
+    else if (v < QHIST_SUB)
+    {
+        bin = v;
+    }
+    else
+    {
+        /* Position of the leading one, v below 2^16 */
+        if (v >= (1UL << 8))
+        {
+            msb += 8U;
+        }
+        if ((v >> msb) >= (1UL << 4))
+        {
+            msb += 4U;
+        }
+        if ((v >> msb) >= (1UL << 2))
+        {
+            msb += 2U;
+        }
+        if ((v >> msb) >= (1UL << 1))
+        {
+            msb += 1U;
+        }
+        bin = ((msb - QHIST_SUB_BITS + 1U) << QHIST_SUB_BITS) + ((v >> (msb - QHIST_SUB_BITS)) & (QHIST_SUB - 1U));
+    }
+
+    if (hist->bins[bin] == UINT16_MAX)
+    {
+        for (i = 0U; i < QHIST_BINS; i++)
+        {
+            hist->bins[i] = (uint16_t)((hist->bins[i] + 1U) >> 1);
+        }
+    }
+    hist->bins[bin]++;
+    hist->samples++;
+}
+
+/*******************************************************************************
+ * Function Name: qhist_bin_low
+ *******************************************************************************
+ *
+ * Summary:
+ *  Returns the lower bound of a bin; the upper bound is the lower bound of
+ *  the next bin.
+ *
+ * Parameters:
+ *  bin: Bin, up to QHIST_BINS.
+ *
+ * Return:
+ *  The smallest value counted in the bin.
+ *
+ ******************************************************************************/
+uint32_t qhist_bin_low(uint32_t bin)
+{
+    uint32_t msb = (bin >> QHIST_SUB_BITS) + QHIST_SUB_BITS - 1U;
+
+    if (bin < QHIST_SUB)
+    {
+        return bin << QHIST_MIN_SHIFT;
+    }
+
+    return (QHIST_SUB + (bin & (QHIST_SUB - 1U))) << (msb - QHIST_SUB_BITS + QHIST_MIN_SHIFT);
+}
+
+/*******************************************************************************
+ * Function Name: qhist_quantile
+ *******************************************************************************
+ *
+ * Summary:
+ *  Estimates a quantile, interpolating linearly inside the bin. For the last
+ *  bin, which counts the values beyond the range, the lower bound is
+ *  returned.
+ *
+ * Parameters:
+ *  hist: Histogram.
+ *  q16: Quantile, 16 fraction bits (FXSTAT_Q16).
+ *
+ * Return:
+ *  The quantile, 0 for an empty histogram.
+ *
+ ******************************************************************************/
+uint32_t qhist_quantile(const qhist_t *hist, uint32_t q16)
+{
+    uint32_t total = 0U;
+    uint32_t below = 0U;
+    uint32_t rank;
+    uint32_t lo;
+    uint32_t frac16;
+    uint32_t bin;
+
+    for (bin = 0U; bin < QHIST_BINS; bin++)
+    {
+        total += hist->bins[bin];
+    }
+    if (total == 0U)
+    {
+        return 0U;
+    }
+
+    rank = (uint32_t)(fxstat_umul64(total, q16) >> 16);
+    rank = (rank < total) ? rank : (total - 1U);
+    for (bin = 0U; (below + hist->bins[bin]) <= rank; bin++)
+    {
+        below += hist->bins[bin];
+    }
+
+    lo = qhist_bin_low(bin);
+    if (bin == (QHIST_BINS - 1U))
+    {
+        return lo;
+    }
+
+    /* Position inside the bin, at the middle of the rank's share */
+    frac16 = ((((rank - below) << 1) + 1U) << 15) / hist->bins[bin];
+
+    return lo + (uint32_t)(fxstat_umul64(qhist_bin_low(bin + 1U) - lo, frac16) >> 16);
+}
+
+/* [] END OF FILE */
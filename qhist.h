@@ -0,0 +1,102 @@
+/******************************************************************************
+* File Name: qhist.h
+*
+* Description: Streaming quantile estimator: a log-linear histogram with four
+*              bins per octave and 16-bit counters. It takes 104 bytes, does
+*              not store samples, and adds a sample in a bounded number of
+*              cycles, so it can run on the wake path.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef QHIST_H
+#define QHIST_H
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cy_pdl.h"
+#include "pm_module.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Bins per octave: 2^QHIST_SUB_BITS, so a bin spans at most 25 % of its
+ * lower bound */
+#define QHIST_SUB_BITS          (2U)
+#define QHIST_SUB               (1UL << QHIST_SUB_BITS)
+
+/* Resolution: values are counted in units of 2^QHIST_MIN_SHIFT */
+#define QHIST_MIN_SHIFT         (6U)
+
+/* The bins cover the octaves up to 2^(QHIST_MIN_SHIFT + QHIST_TOP_BITS) */
+#define QHIST_TOP_BITS          (13U)
+
+#define QHIST_BINS              ((QHIST_TOP_BITS - QHIST_SUB_BITS + 1U) * QHIST_SUB)
+
+/* The last bin counts only the values beyond the range: from the lower bound
+ * of that bin, QHIST_TOP << QHIST_MIN_SHIFT, 458752 cycles or 9.6 ms at
+ * 48 MHz. The range thus ends one bin below the top octave. */
+#define QHIST_TOP               ((2UL * QHIST_SUB - 1UL) << (QHIST_TOP_BITS - QHIST_SUB_BITS - 1U))
+
+/*******************************************************************************
+ * Data types
+ ******************************************************************************/
+/* Histogram, little endian, sent as is in TELEMETRY_FRAME_QHIST. When a
+ * counter would overflow, all counters are halved, so the estimate follows
+ * the recent samples. */
+typedef struct
+{
+    uint8_t binCount;                   /* QHIST_BINS */
+    uint8_t subBits;                    /* QHIST_SUB_BITS */
+    uint8_t minShift;                   /* QHIST_MIN_SHIFT */
+    uint8_t reserved;
+    uint32_t samples;                   /* Samples added, modulo 2^32 */
+    uint16_t bins[QHIST_BINS];
+} qhist_t;
+
+#define QHIST_INIT              { .binCount = QHIST_BINS, .subBits = QHIST_SUB_BITS, \
+                                  .minShift = QHIST_MIN_SHIFT }
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+PM_WAKE_FUNC void qhist_add(qhist_t *hist, uint32_t value);
+uint32_t qhist_bin_low(uint32_t bin);
+uint32_t qhist_quantile(const qhist_t *hist, uint32_t q16);
+
+#endif /* QHIST_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,109 @@
+/******************************************************************************
+* File Name: seqlock.c
+*
+* Description: Bounded snapshot copy of data guarded by a sequence lock
+*              (seqlock.h).
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "seqlock.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Runs after each word copied. Empty unless the build defines it. */
+#ifndef SEQLOCK_COPY_WORD
+#define SEQLOCK_COPY_WORD()     do { } while (0)
+#endif
+
+/*******************************************************************************
+ * Function Name: seqlock_read
+ *******************************************************************************
+ *
+ * Summary:
+ *  Copies data guarded by a sequence lock, retrying while writers preempt the
+ *  copy, at most SEQLOCK_READ_RETRIES times. Interrupts stay enabled. On a
+ *  single core a reader never sees an update in progress: an interrupt
+ *  handler writer runs to completion before the copy resumes, and a thread
+ *  writer masks the interrupts that could read. A reader in an interrupt
+ *  handler therefore always succeeds with its first copy.
+ *
+ * Parameters:
+ *  lock: Sequence lock of the data.
+ *  dst: Snapshot, word aligned.
+ *  src: Data, word aligned.
+ *  size: Bytes to copy, a multiple of 4.
+ *
+ * Return:
+ *  true if dst holds a consistent snapshot; false if writers kept preempting
+ *  the copy, and dst holds the last, torn copy.
+ *
+ ******************************************************************************/
+bool seqlock_read(const seqlock_t *lock, void *dst, const void *src, uint32_t size)
+{
+    uint32_t *to;
+    const uint32_t *from;
+    uint32_t seq;
+    uint32_t attempt;
+    uint32_t i;
+
+    CY_ASSERT(((((uintptr_t)dst | (uintptr_t)src | size) & 3U) == 0U));
+
+    for (attempt = 0U; attempt <= SEQLOCK_READ_RETRIES; attempt++)
+    {
+        seq = seqlock_read_begin(lock);
+
+        to = (uint32_t *)dst;
+        from = (const uint32_t *)src;
+        for (i = 0U; i < (size / 4U); i++)
+        {
+            to[i] = from[i];
+            SEQLOCK_COPY_WORD();
+        }
+
+        if (!seqlock_read_retry(lock, seq))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,182 @@
+/******************************************************************************
+* File Name: seqlock.h
+*
+* Description: Sequence lock for multi-word data written from one context and
+*              read from another. Readers take no lock and do not mask
+*              interrupts: they copy the data and retry if a writer ran
+*              meanwhile. Writers mask interrupts only while they update the
+*              data, which is all the Cortex-M0, without exclusive access
+*              instructions, needs to keep the sequence count consistent.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cy_pdl.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Copies seqlock_read() makes after the first before it gives up */
+#ifndef SEQLOCK_READ_RETRIES
+#define SEQLOCK_READ_RETRIES    (4U)
+#endif
+
+#define SEQLOCK_INIT            { .seq = 0U }
+
+/*******************************************************************************
+ * Data types
+ ******************************************************************************/
+/* Sequence count: odd while an update is in progress, incremented by two per
+ * update. Wraps after 2^31 updates, far more than a reader is ever preempted
+ * for. */
+typedef struct
+{
+    volatile uint32_t seq;
+} seqlock_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+bool seqlock_read(const seqlock_t *lock, void *dst, const void *src, uint32_t size);
+
+/*******************************************************************************
+ * Function Name: seqlock_write_begin
+ *******************************************************************************
+ *
+ * Summary:
+ *  Starts an update. Masks interrupts until seqlock_write_end(), so a reader
+ *  in an interrupt handler never waits on an update it preempted, and two
+ *  writers never interleave their sequence count updates. Keep the update
+ *  short: it delays every interrupt. Safe with interrupts already masked.
+ *
+ * Parameters:
+ *  lock: Sequence lock of the data.
+ *
+ * Return:
+ *  The interrupt state to pass to seqlock_write_end().
+ *
+ ******************************************************************************/
+__STATIC_INLINE uint32_t seqlock_write_begin(seqlock_t *lock)
+{
+    /* The CMSIS intrinsics rather than Cy_SysLib_EnterCriticalSection(): they
+     * are inline, so writers on the wake path stay in SRAM with
+     * PM_WAKE_PATH_IN_RAM */
+    uint32_t savedIntr = __get_PRIMASK();
+
+    __disable_irq();
+    lock->seq++;
+    __DMB();
+
+    return savedIntr;
+}
+
+/*******************************************************************************
+ * Function Name: seqlock_write_end
+ *******************************************************************************
+ *
+ * Summary:
+ *  Ends an update started with seqlock_write_begin().
+ *
+ * Parameters:
+ *  lock: Sequence lock of the data.
+ *  savedIntr: Value returned by seqlock_write_begin().
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+__STATIC_INLINE void seqlock_write_end(seqlock_t *lock, uint32_t savedIntr)
+{
+    __DMB();
+    lock->seq++;
+    __set_PRIMASK(savedIntr);
+}
+
+/*******************************************************************************
+ * Function Name: seqlock_read_begin
+ *******************************************************************************
+ *
+ * Summary:
+ *  Starts a read: returns the sequence count to check the data against with
+ *  seqlock_read_retry().
+ *
+ * Parameters:
+ *  lock: Sequence lock of the data.
+ *
+ * Return:
+ *  The sequence count.
+ *
+ ******************************************************************************/
+__STATIC_INLINE uint32_t seqlock_read_begin(const seqlock_t *lock)
+{
+    uint32_t seq = lock->seq;
+
+    __DMB();
+
+    return seq;
+}
+
+/*******************************************************************************
+ * Function Name: seqlock_read_retry
+ *******************************************************************************
+ *
+ * Summary:
+ *  Ends a read. The data read since seqlock_read_begin() is consistent unless
+ *  an update was in progress or has run meanwhile.
+ *
+ * Parameters:
+ *  lock: Sequence lock of the data.
+ *  seq: Value returned by seqlock_read_begin().
+ *
+ * Return:
+ *  true if the data read must be discarded.
+ *
+ ******************************************************************************/
+__STATIC_INLINE bool seqlock_read_retry(const seqlock_t *lock, uint32_t seq)
+{
+    __DMB();
+
+    return ((seq & 1U) != 0U) || (lock->seq != seq);
+}
+
+#endif /* SEQLOCK_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,370 @@
+/******************************************************************************
+* File Name: supply_mon.c
+*
+* Description: Supply voltage monitor and power policy. The monitor is a
+*              power management module: its AFTER_TRANSITION callback counts
+*              wakeups and samples VDDD every SUPPLY_MON_INTERVAL of them,
+*              so sampling never causes a wakeup of its own. The policy
+*              functions are pure and are exercised by the host simulator.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cybsp.h"
+#include "supply_mon.h"
+#include "pm_module.h"
+#include "telemetry_uart.h"
+
+#define LOG_MODULE_LEVEL        LOG_LEVEL_SUPPLY
+#include "log.h"
+
+/*******************************************************************************
+ * Global variables
+ ******************************************************************************/
+static volatile supply_level_t supplyLevel = SUPPLY_LEVEL_NOMINAL;
+static volatile uint16_t supplyMv = SUPPLY_MON_NOMINAL_MV;
+static uint8_t wakeCount;
+#if (SUPPLY_MON_USBPD != 0U)
+static cy_stc_usbpd_context_t supplyUsbpdContext;   /* Used without the PD stack */
+static cy_stc_usbpd_context_t *supplyUsbpd;         /* Block measuring VDDD */
+#endif
+static supply_level_t candidateLevel = SUPPLY_LEVEL_NOMINAL;   /* Level being confirmed */
+static uint8_t confirmCount;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+static void supply_mon_init(void);
+static cy_en_syspm_status_t supply_mon_callback(cy_en_syspm_callback_type_t type,
+                                                cy_en_syspm_callback_mode_t mode);
+
+/* Only AFTER_TRANSITION is used */
+static volatile uint8_t supplyMonSkip = CY_SYSPM_SKIP_CHECK_READY |
+                                        CY_SYSPM_SKIP_CHECK_FAIL |
+                                        CY_SYSPM_SKIP_BEFORE_TRANSITION;
+
+PM_MODULE_DEFINE(supply_mon_module, PM_PRIORITY_LOW,
+    .init     = supply_mon_init,
+    .callback = supply_mon_callback,
+    .types    = PM_TYPE_ALL,
+    .skipMode = &supplyMonSkip);
+
+/*******************************************************************************
+ * Function Name: supply_mon_set_usbpd
+ *******************************************************************************
+ *
+ * Summary:
+ *  Measures VDDD with the USB-PD block of the PD stack instead of initializing
+ *  the block itself. Call it before pm_init().
+ *
+ * Parameters:
+ *  context: USB-PD block context initialized by the PD stack
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+#if (SUPPLY_MON_USBPD != 0U)
+void supply_mon_set_usbpd(cy_stc_usbpd_context_t *context)
+{
+    supplyUsbpd = context;
+}
+#endif
+
+/*******************************************************************************
+ * Function Name: supply_mon_read_mv
+ *******************************************************************************
+ *
+ * Summary:
+ *  Measures VDDD with the USB-PD block ADC: Cy_USBPD_Adc_Calibrate() converts
+ *  the bandgap reference and returns VDDD in mV. Returns SUPPLY_MON_NOMINAL_MV
+ *  on devices without the block, or if it failed to initialize. Boards that
+ *  measure VDDD another way override this function.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  VDDD in mV.
+ *
+ ******************************************************************************/
+__WEAK uint16_t supply_mon_read_mv(void)
+{
+#if (SUPPLY_MON_USBPD != 0U)
+    if (supplyUsbpd != NULL)
+    {
+        return Cy_USBPD_Adc_Calibrate(supplyUsbpd, SUPPLY_MON_USBPD_ADC);
+    }
+#endif
+    return SUPPLY_MON_NOMINAL_MV;
+}
+
+/*******************************************************************************
+ * Function Name: supply_mon_init
+ *******************************************************************************
+ *
+ * Summary:
+ *  Initializes the USB-PD block ADC, unless the PD stack context was passed,
+ *  then takes the first VDDD sample and applies its level directly.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void supply_mon_init(void)
+{
+#if (SUPPLY_MON_USBPD != 0U)
+    if (supplyUsbpd == NULL)
+    {
+        if ((Cy_USBPD_Init(&supplyUsbpdContext, 0U, SUPPLY_MON_USBPD_HW, SUPPLY_MON_USBPD_TRIM,
+                           (cy_stc_usbpd_config_t *)&SUPPLY_MON_USBPD_CONFIG, NULL) == CY_USBPD_STAT_SUCCESS) &&
+            (Cy_USBPD_Adc_Init(&supplyUsbpdContext, SUPPLY_MON_USBPD_ADC) == CY_USBPD_STAT_SUCCESS))
+        {
+            supplyUsbpd = &supplyUsbpdContext;
+        }
+        else
+        {
+            LOG_ERROR("USB-PD ADC init failed, assuming %lu mV", SUPPLY_MON_NOMINAL_MV);
+        }
+    }
+#endif
+    supplyMv = supply_mon_read_mv();
+    supplyLevel = supply_policy_level(SUPPLY_LEVEL_NOMINAL, supplyMv);
+    candidateLevel = supplyLevel;
+    confirmCount = 0U;
+}
+
+/*******************************************************************************
+ * Function Name: supply_mon_sample
+ *******************************************************************************
+ *
+ * Summary:
+ *  Takes a VDDD sample. The supply level changes once SUPPLY_MON_CONFIRM
+ *  consecutive samples map to the same new level; a sample mapping to
+ *  another level restarts the count for that one.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void supply_mon_sample(void)
+{
+    uint16_t mv = supply_mon_read_mv();
+    supply_level_t level = supply_policy_level(supplyLevel, mv);
+
+    supplyMv = mv;
+    if (level == supplyLevel)
+    {
+        confirmCount = 0U;
+        return;
+    }
+
+    if (level != candidateLevel)
+    {
+        candidateLevel = level;
+        confirmCount = 0U;
+    }
+    if (++confirmCount >= SUPPLY_MON_CONFIRM)
+    {
+        confirmCount = 0U;
+        supplyLevel = level;
+        telemetry_uart_trace(TELEMETRY_TRACE_SUPPLY, (uint8_t)level, mv);
+        LOG_WARN("Supply level %lu at %lu mV", level, mv);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: supply_mon_level
+ *******************************************************************************
+ *
+ * Summary:
+ *  Returns the supply level from the last sample.
+ *
+ ******************************************************************************/
+supply_level_t supply_mon_level(void)
+{
+    return supplyLevel;
+}
+
+/*******************************************************************************
+ * Function Name: supply_mon_last_mv
+ *******************************************************************************
+ *
+ * Summary:
+ *  Returns the last VDDD sample in mV.
+ *
+ ******************************************************************************/
+uint16_t supply_mon_last_mv(void)
+{
+    return supplyMv;
+}
+
+/*******************************************************************************
+ * Function Name: supply_mon_callback
+ *******************************************************************************
+ *
+ * Summary:
+ *  Samples VDDD on every SUPPLY_MON_INTERVAL-th wakeup.
+ *
+ * Parameters:
+ *  type: Power mode left.
+ *  mode: Callback phase, only CY_SYSPM_AFTER_TRANSITION is not skipped.
+ *
+ * Return:
+ *  CY_SYSPM_SUCCESS
+ *
+ ******************************************************************************/
+static cy_en_syspm_status_t supply_mon_callback(cy_en_syspm_callback_type_t type,
+                                                cy_en_syspm_callback_mode_t mode)
+{
+    (void) type;
+
+    if (mode == CY_SYSPM_AFTER_TRANSITION)
+    {
+        wakeCount++;
+        if (wakeCount >= SUPPLY_MON_INTERVAL)
+        {
+            wakeCount = 0U;
+            supply_mon_sample();
+        }
+    }
+
+    return CY_SYSPM_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: supply_policy_level
+ *******************************************************************************
+ *
+ * Summary:
+ *  Computes the supply level from a VDDD sample. Thresholds apply directly
+ *  when the supply falls; it has to rise SUPPLY_MON_HYST_MV above a threshold
+ *  to get back to the better level, so noise does not make the level flap.
+ *
+ * Parameters:
+ *  level: Current level.
+ *  vdddMv: VDDD sample in mV.
+ *
+ * Return:
+ *  New level.
+ *
+ ******************************************************************************/
+supply_level_t supply_policy_level(supply_level_t level, uint16_t vdddMv)
+{
+    uint32_t lowMv = SUPPLY_MON_LOW_MV;
+    uint32_t criticalMv = SUPPLY_MON_CRITICAL_MV;
+
+    if (level >= SUPPLY_LEVEL_LOW)
+    {
+        lowMv += SUPPLY_MON_HYST_MV;
+    }
+    if (level >= SUPPLY_LEVEL_CRITICAL)
+    {
+        criticalMv += SUPPLY_MON_HYST_MV;
+    }
+
+    if (vdddMv < criticalMv)
+    {
+        return SUPPLY_LEVEL_CRITICAL;
+    }
+    if (vdddMv < lowMv)
+    {
+        return SUPPLY_LEVEL_LOW;
+    }
+    return SUPPLY_LEVEL_NOMINAL;
+}
+
+/*******************************************************************************
+ * Function Name: supply_policy_sleep_type
+ *******************************************************************************
+ *
+ * Summary:
+ *  Returns the low power mode to enter for a requested one: below the nominal
+ *  supply level, Sleep is promoted to Deep Sleep.
+ *
+ * Parameters:
+ *  requested: Power mode requested by the application.
+ *
+ * Return:
+ *  Power mode to enter.
+ *
+ ******************************************************************************/
+cy_en_syspm_callback_type_t supply_policy_sleep_type(cy_en_syspm_callback_type_t requested)
+{
+    return (supplyLevel != SUPPLY_LEVEL_NOMINAL) ? CY_SYSPM_DEEPSLEEP : requested;
+}
+
+/*******************************************************************************
+ * Function Name: supply_policy_throttle
+ *******************************************************************************
+ *
+ * Summary:
+ *  Scales the amount of a heavy feature (LED blinks, debug output, ...) to
+ *  the supply level: all of it at nominal level, one unit at low level and
+ *  none at critical level.
+ *
+ * Parameters:
+ *  amount: Amount used at the nominal level.
+ *
+ * Return:
+ *  Amount allowed at the current level.
+ *
+ ******************************************************************************/
+uint32_t supply_policy_throttle(uint32_t amount)
+{
+    uint32_t allowed = amount;
+
+    if (supplyLevel == SUPPLY_LEVEL_CRITICAL)
+    {
+        allowed = 0U;
+    }
+    else if ((supplyLevel == SUPPLY_LEVEL_LOW) && (amount > 1U))
+    {
+        allowed = 1U;
+    }
+
+    return allowed;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,117 @@
+/******************************************************************************
+* File Name: supply_mon.h
+*
+* Description: Supply voltage monitor and power policy. VDDD is sampled at a
+*              low duty cycle on the way out of the low power modes, and the
+*              supply level derived from it throttles heavy features and
+*              makes the application prefer Deep Sleep as the supply
+*              degrades.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef SUPPLY_MON_H
+#define SUPPLY_MON_H
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cy_pdl.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Supply assumed before the first sample, from vdddMv in design.modus */
+#ifndef SUPPLY_MON_NOMINAL_MV
+#define SUPPLY_MON_NOMINAL_MV   (3300U)
+#endif
+
+/* Level thresholds on VDDD, in mV, and hysteresis applied on the way up */
+#define SUPPLY_MON_LOW_MV       (3000U)
+#define SUPPLY_MON_CRITICAL_MV  (2800U)
+#define SUPPLY_MON_HYST_MV      (100U)
+
+/* VDDD is sampled once every SUPPLY_MON_INTERVAL wakeups */
+#define SUPPLY_MON_INTERVAL     (16U)
+
+/* Set to 1 to measure VDDD with the USB-PD block ADC (Cy_USBPD_Adc_Calibrate()
+ * against the bandgap). The block is taken from the generated USB-PD port 0
+ * configuration unless the PD stack context is passed to
+ * supply_mon_set_usbpd(), so design.modus must enable the USB-PD port 0
+ * personality, which the templates do not. Otherwise every sample is
+ * SUPPLY_MON_NOMINAL_MV. */
+#ifndef SUPPLY_MON_USBPD
+#define SUPPLY_MON_USBPD        (0U)
+#endif
+
+#ifndef SUPPLY_MON_USBPD_HW
+#define SUPPLY_MON_USBPD_HW     mtb_usbpd_port0_HW
+#define SUPPLY_MON_USBPD_TRIM   mtb_usbpd_port0_HW_TRIM
+#define SUPPLY_MON_USBPD_CONFIG mtb_usbpd_port0_config
+#endif
+
+#define SUPPLY_MON_USBPD_ADC    CY_USBPD_ADC_ID_0
+
+/* Consecutive samples that must agree before the level changes, so short
+ * load dips do not make it flap */
+#define SUPPLY_MON_CONFIRM      (3U)
+
+/*******************************************************************************
+ * Data types
+ ******************************************************************************/
+typedef enum
+{
+    SUPPLY_LEVEL_NOMINAL = 0U,  /* All features */
+    SUPPLY_LEVEL_LOW,           /* Heavy features throttled, Deep Sleep preferred */
+    SUPPLY_LEVEL_CRITICAL       /* Heavy features off, Deep Sleep only */
+} supply_level_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+uint16_t supply_mon_read_mv(void);
+#if (SUPPLY_MON_USBPD != 0U)
+void supply_mon_set_usbpd(cy_stc_usbpd_context_t *context);
+#endif
+void supply_mon_sample(void);
+supply_level_t supply_mon_level(void);
+uint16_t supply_mon_last_mv(void);
+supply_level_t supply_policy_level(supply_level_t level, uint16_t vdddMv);
+cy_en_syspm_callback_type_t supply_policy_sleep_type(cy_en_syspm_callback_type_t requested);
+uint32_t supply_policy_throttle(uint32_t amount);
+
+#endif /* SUPPLY_MON_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,463 @@
+/******************************************************************************
+* File Name: telemetry_frame.c
+*
+* Description: Telemetry frame codec. The CRC uses a 16 entry nibble table
+*              (32 bytes of flash).
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "telemetry_frame.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Packed trace decoder states (telemetry_trace_decoder_t.state) */
+#define TRACE_DEC_BASE          (0U)    /* Frame base time */
+#define TRACE_DEC_HEAD          (1U)    /* Delta and tag */
+#define TRACE_DEC_EVENT         (2U)
+#define TRACE_DEC_ARG           (3U)
+#define TRACE_DEC_VALUE         (4U)
+#define TRACE_DEC_ERROR         (5U)
+
+/*******************************************************************************
+ * Global variables
+ ******************************************************************************/
+/* CRC-16/CCITT (polynomial 0x1021) of each nibble value */
+static const uint16_t crcNibble[16] =
+{
+    0x0000U, 0x1021U, 0x2042U, 0x3063U, 0x4084U, 0x50A5U, 0x60C6U, 0x70E7U,
+    0x8108U, 0x9129U, 0xA14AU, 0xB16BU, 0xC18CU, 0xD1ADU, 0xE1CEU, 0xF1EFU
+};
+
+/*******************************************************************************
+ * Function Name: telemetry_crc16
+ *******************************************************************************
+ *
+ * Summary:
+ *  CRC-16/CCITT-FALSE. Pass TELEMETRY_FRAME_CRC_INIT as crc for the first
+ *  block, the previous result for the next ones.
+ *
+ * Parameters:
+ *  crc: Running CRC.
+ *  data: Bytes to add.
+ *  length: Number of bytes.
+ *
+ * Return:
+ *  Updated CRC.
+ *
+ ******************************************************************************/
+uint16_t telemetry_crc16(uint16_t crc, const uint8_t *data, size_t length)
+{
+    size_t i;
+
+    for (i = 0U; i < length; i++)
+    {
+        crc = (uint16_t)((crc << 4) ^ crcNibble[(crc >> 12) ^ (data[i] >> 4)]);
+        crc = (uint16_t)((crc << 4) ^ crcNibble[(crc >> 12) ^ (data[i] & 0x0FU)]);
+    }
+
+    return crc;
+}
+
+/*******************************************************************************
+ * Function Name: telemetry_cobs_encode
+ *******************************************************************************
+ *
+ * Summary:
+ *  COBS encodes a block. The output holds no zero byte and is at most
+ *  length + 1 + length / 254 bytes long; the delimiter is not appended.
+ *
+ * Parameters:
+ *  out: Output buffer.
+ *  in: Bytes to encode.
+ *  length: Number of bytes.
+ *
+ * Return:
+ *  Number of bytes written to out.
+ *
+ ******************************************************************************/
+size_t telemetry_cobs_encode(uint8_t *out, const uint8_t *in, size_t length)
+{
+    size_t codeIdx = 0U;
+    size_t outIdx = 1U;
+    uint8_t code = 1U;
+    size_t i;
+
+    for (i = 0U; i < length; i++)
+    {
+        if (in[i] == 0U)
+        {
+            out[codeIdx] = code;
+            codeIdx = outIdx++;
+            code = 1U;
+        }
+        else
+        {
+            out[outIdx++] = in[i];
+            if (++code == 0xFFU)
+            {
+                out[codeIdx] = code;
+                codeIdx = outIdx++;
+                code = 1U;
+            }
+        }
+    }
+    out[codeIdx] = code;
+
+    return outIdx;
+}
+
+/*******************************************************************************
+ * Function Name: telemetry_cobs_decode
+ *******************************************************************************
+ *
+ * Summary:
+ *  Decodes a COBS block, without its delimiter.
+ *
+ * Parameters:
+ *  out: Output buffer.
+ *  outSize: Size of the output buffer.
+ *  in: Encoded bytes.
+ *  length: Number of encoded bytes.
+ *
+ * Return:
+ *  Number of decoded bytes, 0 if the block is malformed or does not fit.
+ *
+ ******************************************************************************/
+size_t telemetry_cobs_decode(uint8_t *out, size_t outSize, const uint8_t *in, size_t length)
+{
+    size_t inIdx = 0U;
+    size_t outIdx = 0U;
+    uint8_t code;
+    uint8_t i;
+
+    while (inIdx < length)
+    {
+        code = in[inIdx++];
+        if ((code == 0U) || ((inIdx + code - 1U) > length))
+        {
+            return 0U;
+        }
+
+        for (i = 1U; i < code; i++)
+        {
+            if ((in[inIdx] == 0U) || (outIdx >= outSize))
+            {
+                return 0U;
+            }
+            out[outIdx++] = in[inIdx++];
+        }
+
+        /* A code below 0xFF stands for a zero, except at the end */
+        if ((code != 0xFFU) && (inIdx < length))
+        {
+            if (outIdx >= outSize)
+            {
+                return 0U;
+            }
+            out[outIdx++] = 0U;
+        }
+    }
+
+    return outIdx;
+}
+
+/*******************************************************************************
+ * Function Name: telemetry_varint_encode
+ *******************************************************************************
+ *
+ * Summary:
+ *  Writes a value as a varint (LEB128): 7 bits per byte, least significant
+ *  first, bit 7 set on all bytes but the last.
+ *
+ * Parameters:
+ *  out: Output buffer, 5 bytes at most are written.
+ *  value: Value to write.
+ *
+ * Return:
+ *  Number of bytes written to out.
+ *
+ ******************************************************************************/
+size_t telemetry_varint_encode(uint8_t *out, uint32_t value)
+{
+    size_t length = 0U;
+
+    while (value >= 0x80U)
+    {
+        out[length++] = (uint8_t)(value | 0x80U);
+        value >>= 7;
+    }
+    out[length++] = (uint8_t)value;
+
+    return length;
+}
+
+/*******************************************************************************
+ * Function Name: telemetry_varint_decode
+ *******************************************************************************
+ *
+ * Summary:
+ *  Reads a varint written by telemetry_varint_encode().
+ *
+ * Parameters:
+ *  in: Input bytes.
+ *  length: Number of input bytes.
+ *  value: Returns the value.
+ *
+ * Return:
+ *  Number of bytes read, 0 if the varint is truncated or longer than 32
+ *  bits.
+ *
+ ******************************************************************************/
+size_t telemetry_varint_decode(const uint8_t *in, size_t length, uint32_t *value)
+{
+    uint32_t acc = 0U;
+    size_t i;
+
+    for (i = 0U; (i < length) && (i < 5U); i++)
+    {
+        acc |= (uint32_t)(in[i] & 0x7FU) << (7U * i);
+        if ((in[i] & 0x80U) == 0U)
+        {
+            *value = acc;
+            return i + 1U;
+        }
+    }
+
+    return 0U;
+}
+
+/*******************************************************************************
+ * Function Name: telemetry_trace_pack
+ *******************************************************************************
+ *
+ * Summary:
+ *  Writes a packed trace record (see TELEMETRY_FRAME_TRACE_PACKED).
+ *
+ * Parameters:
+ *  out: Output buffer, TELEMETRY_TRACE_MAX_PACKED bytes at most are written.
+ *  delta: Ticks since the previous record, at most TELEMETRY_TRACE_MAX_DELTA.
+ *  event: TELEMETRY_TRACE_xxx.
+ *  arg: Event argument.
+ *  value: Event value.
+ *
+ * Return:
+ *  Number of bytes written to out.
+ *
+ ******************************************************************************/
+size_t telemetry_trace_pack(uint8_t *out, uint32_t delta, uint8_t event, uint8_t arg, uint16_t value)
+{
+    uint32_t code = (uint32_t)event - 1U;
+    uint32_t tag;
+    size_t length;
+
+    tag = (code < TELEMETRY_TRACE_TAG_EVENT) ? code : TELEMETRY_TRACE_TAG_EVENT;
+    tag |= (uint32_t)((arg < 3U) ? arg : 3U) << 2;
+    if (value != 0U)
+    {
+        tag |= TELEMETRY_TRACE_TAG_VALUE;
+    }
+
+    length = telemetry_varint_encode(out, (delta << TELEMETRY_TRACE_TAG_BITS) | tag);
+    if ((tag & TELEMETRY_TRACE_TAG_EVENT) == TELEMETRY_TRACE_TAG_EVENT)
+    {
+        out[length++] = event;
+    }
+    if ((tag & TELEMETRY_TRACE_TAG_ARG) == TELEMETRY_TRACE_TAG_ARG)
+    {
+        out[length++] = arg;
+    }
+    if (value != 0U)
+    {
+        length += telemetry_varint_encode(&out[length], value);
+    }
+
+    return length;
+}
+
+/*******************************************************************************
+ * Function Name: telemetry_trace_decode_start
+ *******************************************************************************
+ *
+ * Summary:
+ *  Prepares the decoder for the payload of a packed trace frame.
+ *
+ * Parameters:
+ *  dec: Decoder.
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void telemetry_trace_decode_start(telemetry_trace_decoder_t *dec)
+{
+    dec->rec.ticks = 0U;
+    dec->acc = 0U;
+    dec->shift = 0U;
+    dec->state = TRACE_DEC_BASE;
+}
+
+/*******************************************************************************
+ * Function Name: telemetry_trace_decode_byte
+ *******************************************************************************
+ *
+ * Summary:
+ *  Feeds the next payload byte of a packed trace frame to the decoder. On a
+ *  malformed payload the decoder ignores the rest of the frame.
+ *
+ * Parameters:
+ *  dec: Decoder, started with telemetry_trace_decode_start().
+ *  byte: Payload byte.
+ *  rec: Receives the record the byte completes.
+ *
+ * Return:
+ *  true if a record was written to rec.
+ *
+ ******************************************************************************/
+bool telemetry_trace_decode_byte(telemetry_trace_decoder_t *dec, uint8_t byte, telemetry_trace_t *rec)
+{
+    uint32_t value;
+
+    if (dec->state == TRACE_DEC_ERROR)
+    {
+        return false;
+    }
+
+    if ((dec->state == TRACE_DEC_EVENT) || (dec->state == TRACE_DEC_ARG))
+    {
+        value = byte;
+    }
+    else
+    {
+        /* Varint: 5 bytes at most, the last one with 4 bits */
+        if ((dec->shift > 28U) || ((dec->shift == 28U) && (byte > 0x0FU)))
+        {
+            dec->state = TRACE_DEC_ERROR;
+            return false;
+        }
+        dec->acc |= (uint32_t)(byte & 0x7FU) << dec->shift;
+        dec->shift += 7U;
+        if ((byte & 0x80U) != 0U)
+        {
+            return false;
+        }
+        value = dec->acc;
+        dec->acc = 0U;
+        dec->shift = 0U;
+    }
+
+    switch (dec->state)
+    {
+        case TRACE_DEC_BASE:
+            dec->rec.ticks = value;
+            dec->state = TRACE_DEC_HEAD;
+            return false;
+
+        case TRACE_DEC_HEAD:
+            dec->tag = (uint8_t)(value & ((1UL << TELEMETRY_TRACE_TAG_BITS) - 1U));
+            dec->rec.ticks += value >> TELEMETRY_TRACE_TAG_BITS;
+            dec->rec.event = (uint8_t)((dec->tag & TELEMETRY_TRACE_TAG_EVENT) + 1U);
+            dec->rec.arg = (uint8_t)((dec->tag & TELEMETRY_TRACE_TAG_ARG) >> 2);
+            dec->rec.value = 0U;
+            break;
+
+        case TRACE_DEC_EVENT:
+            dec->rec.event = (uint8_t)value;
+            dec->tag &= (uint8_t)~TELEMETRY_TRACE_TAG_EVENT;
+            break;
+
+        case TRACE_DEC_ARG:
+            dec->rec.arg = (uint8_t)value;
+            dec->tag &= (uint8_t)~TELEMETRY_TRACE_TAG_ARG;
+            break;
+
+        default:
+            if (value > 0xFFFFU)
+            {
+                dec->state = TRACE_DEC_ERROR;
+                return false;
+            }
+            dec->rec.value = (uint16_t)value;
+            dec->tag &= (uint8_t)~TELEMETRY_TRACE_TAG_VALUE;
+            break;
+    }
+
+    /* Next field of the record, if any */
+    if ((dec->tag & TELEMETRY_TRACE_TAG_EVENT) == TELEMETRY_TRACE_TAG_EVENT)
+    {
+        dec->state = TRACE_DEC_EVENT;
+    }
+    else if ((dec->tag & TELEMETRY_TRACE_TAG_ARG) == TELEMETRY_TRACE_TAG_ARG)
+    {
+        dec->state = TRACE_DEC_ARG;
+    }
+    else if ((dec->tag & TELEMETRY_TRACE_TAG_VALUE) != 0U)
+    {
+        dec->state = TRACE_DEC_VALUE;
+    }
+    else
+    {
+        dec->state = TRACE_DEC_HEAD;
+        *rec = dec->rec;
+        return true;
+    }
+
+    return false;
+}
+
+/*******************************************************************************
+ * Function Name: telemetry_trace_decode_end
+ *******************************************************************************
+ *
+ * Summary:
+ *  Checks the decoder at the end of a packed trace frame.
+ *
+ * Parameters:
+ *  dec: Decoder.
+ *
+ * Return:
+ *  true if the payload ended after a complete record.
+ *
+ ******************************************************************************/
+bool telemetry_trace_decode_end(const telemetry_trace_decoder_t *dec)
+{
+    return (dec->state == TRACE_DEC_HEAD) && (dec->shift == 0U);
+}
+
+/* [] END OF FILE */
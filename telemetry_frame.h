@@ -0,0 +1,153 @@
+/******************************************************************************
+* File Name: telemetry_frame.h
+*
+* Description: Telemetry frame codec: CRC-16 and COBS framing, and the packed
+*              trace record format. Shared by the firmware encoder
+*              (telemetry_uart.c) and the host decoder, so it depends on
+*              nothing but the C library.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef TELEMETRY_FRAME_H
+#define TELEMETRY_FRAME_H
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Frame on the wire: COBS([type][seq][payload][crc16 LE]) followed by 0x00.
+ * The CRC (CRC-16/CCITT-FALSE) covers type, seq and payload. */
+#define TELEMETRY_FRAME_HEADER      (2U)
+#define TELEMETRY_FRAME_CRC         (2U)
+#define TELEMETRY_FRAME_MAX_PAYLOAD (104U)
+#define TELEMETRY_FRAME_MAX_RAW     (TELEMETRY_FRAME_HEADER + TELEMETRY_FRAME_MAX_PAYLOAD + \
+                                     TELEMETRY_FRAME_CRC)
+
+/* COBS adds one byte per 254 bytes, at least one; plus the delimiter */
+#define TELEMETRY_FRAME_MAX_WIRE    (TELEMETRY_FRAME_MAX_RAW + 2U)
+#define TELEMETRY_FRAME_DELIMITER   (0x00U)
+#define TELEMETRY_FRAME_CRC_INIT    (0xFFFFU)
+
+/* Frame types */
+#define TELEMETRY_FRAME_STATS       (0x01U)     /* pm_stats_t, see pm_stats.h */
+#define TELEMETRY_FRAME_TRACE       (0x02U)     /* telemetry_trace_t records, older firmware */
+#define TELEMETRY_FRAME_LOG         (0x03U)     /* Log record, see log.c */
+#define TELEMETRY_FRAME_TRACE_PACKED (0x04U)    /* Packed trace records, see below */
+#define TELEMETRY_FRAME_QHIST       (0x05U)     /* Deep Sleep exit latency, qhist_t */
+#define TELEMETRY_FRAME_PROF        (0x06U)     /* PC samples, see below */
+
+/* Trace events */
+#define TELEMETRY_TRACE_WAKE        (0x01U)     /* arg: PM_STATS_SLEEP / DEEPSLEEP */
+#define TELEMETRY_TRACE_CLOCK       (0x02U)     /* value: HFCLK in MHz */
+#define TELEMETRY_TRACE_SUPPLY      (0x03U)     /* arg: supply level, value: mV */
+
+/* Packed trace frame payload: the time of the first record as a varint
+ * (LEB128, ILO ticks), then the records:
+ *
+ *  varint((delta << 5) | tag)  delta: ticks since the previous record
+ *  [event]                     if tag bits 1:0 are 3
+ *  [arg]                       if tag bits 3:2 are 3
+ *  [varint(value)]             if tag bit 4 is set
+ *
+ * Tag bits 1:0 hold event - 1 for TELEMETRY_TRACE_WAKE to _SUPPLY, bits 3:2
+ * an arg of 0 to 2, and bit 4 is set if value is not zero. A wakeup record
+ * takes 3 bytes for gaps up to 1.6 s, instead of 8. */
+#define TELEMETRY_TRACE_TAG_BITS    (5U)
+#define TELEMETRY_TRACE_TAG_EVENT   (0x03U)
+#define TELEMETRY_TRACE_TAG_ARG     (0x0CU)
+#define TELEMETRY_TRACE_TAG_VALUE   (0x10U)
+
+/* Longest delta of a record; a longer gap starts a new frame */
+#define TELEMETRY_TRACE_MAX_DELTA   (0xFFFFFFFFUL >> TELEMETRY_TRACE_TAG_BITS)
+
+/* Longest packed record and frame base */
+#define TELEMETRY_TRACE_MAX_PACKED  (5U + 1U + 1U + 3U)
+#define TELEMETRY_TRACE_MAX_BASE    (5U)
+
+/* PC sample frame payload (prof.c): the samples taken and dropped since the
+ * previous dump, both 0 except in the first frame of a dump, then pairs of
+ *
+ *  varint(pc) varint(count)
+ *
+ * one per sampled PC. Counts are in samples; the samples not counted for any
+ * PC are the dropped ones, and the rounding of the decimated counts. */
+#define TELEMETRY_PROF_MAX_ENTRY    (5U + 5U)
+
+/*******************************************************************************
+ * Data types
+ ******************************************************************************/
+/* Trace record. The TELEMETRY_FRAME_TRACE payload holds them as is, 8 bytes,
+ * little endian; the packed decoder returns them. */
+typedef struct
+{
+    uint32_t ticks;             /* Time, ILO ticks */
+    uint8_t event;              /* TELEMETRY_TRACE_xxx */
+    uint8_t arg;
+    uint16_t value;
+} telemetry_trace_t;
+
+/* Streaming decoder of packed trace frames, fed one byte at a time */
+typedef struct
+{
+    telemetry_trace_t rec;      /* Record being decoded */
+    uint32_t acc;               /* Varint being read */
+    uint8_t shift;              /* Bits of acc read */
+    uint8_t state;              /* Next field, or error */
+    uint8_t tag;
+} telemetry_trace_decoder_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+uint16_t telemetry_crc16(uint16_t crc, const uint8_t *data, size_t length);
+size_t telemetry_cobs_encode(uint8_t *out, const uint8_t *in, size_t length);
+size_t telemetry_cobs_decode(uint8_t *out, size_t outSize, const uint8_t *in, size_t length);
+size_t telemetry_varint_encode(uint8_t *out, uint32_t value);
+size_t telemetry_varint_decode(const uint8_t *in, size_t length, uint32_t *value);
+size_t telemetry_trace_pack(uint8_t *out, uint32_t delta, uint8_t event, uint8_t arg, uint16_t value);
+void telemetry_trace_decode_start(telemetry_trace_decoder_t *dec);
+bool telemetry_trace_decode_byte(telemetry_trace_decoder_t *dec, uint8_t byte, telemetry_trace_t *rec);
+bool telemetry_trace_decode_end(const telemetry_trace_decoder_t *dec);
+
+#endif /* TELEMETRY_FRAME_H */
+
+/* [] END OF FILE */
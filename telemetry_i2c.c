@@ -0,0 +1,151 @@
+/******************************************************************************
+* File Name: telemetry_i2c.c
+*
+* Description: I2C slave telemetry. The EZI2C buffer is the pm_stats
+*              structure itself, so reads are served from the statistics in
+*              place, with no copy and no work in the main loop. The
+*              register map is read-only. The module takes part in Deep
+*              Sleep through the EZI2C Deep Sleep callback: Deep Sleep is
+*              refused during a transfer, and the SCB is armed to wake the
+*              device on address match. A read spans many interrupts with
+*              updates in between, so the master checks the pm_stats.lock
+*              sequence count around it (see README.md).
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "telemetry_i2c.h"
+
+#if TELEMETRY_I2C
+
+#include "cybsp.h"
+#include "pm_module.h"
+#include "pm_stats.h"
+
+/*******************************************************************************
+ * Global variables
+ ******************************************************************************/
+static cy_stc_scb_ezi2c_context_t telemetryI2cContext;
+
+static cy_stc_syspm_callback_params_t telemetryI2cPmParams =
+{
+    .base    = TELEMETRY_I2C_HW,
+    .context = &telemetryI2cContext
+};
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+static void telemetry_i2c_init(void);
+PM_WAKE_FUNC static cy_en_syspm_status_t telemetry_i2c_pm_callback(cy_en_syspm_callback_type_t type,
+                                                                   cy_en_syspm_callback_mode_t mode);
+
+static const cy_stc_sysint_t telemetry_i2c_intr_config =
+{
+    TELEMETRY_I2C_IRQ,              /* Source of interrupt signal */
+    TELEMETRY_I2C_INTR_PRIORITY     /* Interrupt priority */
+};
+
+/* High priority: refuse Deep Sleep during a transfer before other modules
+ * prepare for it */
+PM_MODULE_DEFINE(telemetry_i2c_module, PM_PRIORITY_HIGH,
+    .init     = telemetry_i2c_init,
+    .callback = telemetry_i2c_pm_callback,
+    .types    = PM_TYPE_DEEPSLEEP,
+    .wakeIntr = &telemetry_i2c_intr_config,
+    .wakeIsr  = telemetry_i2c_isr);
+
+/*******************************************************************************
+ * Function Name: telemetry_i2c_init
+ *******************************************************************************
+ *
+ * Summary:
+ *  Power management module init hook: starts the EZI2C slave with the
+ *  statistics as its buffer. rwBoundary 0 makes the whole map read-only.
+ *
+ ******************************************************************************/
+static void telemetry_i2c_init(void)
+{
+    if (Cy_SCB_EZI2C_Init(TELEMETRY_I2C_HW, &TELEMETRY_I2C_CONFIG, &telemetryI2cContext) ==
+        CY_SCB_EZI2C_SUCCESS)
+    {
+        Cy_SCB_EZI2C_SetBuffer1(TELEMETRY_I2C_HW, (uint8_t *)&pm_stats, sizeof(pm_stats), 0U,
+                                &telemetryI2cContext);
+        Cy_SCB_EZI2C_Enable(TELEMETRY_I2C_HW);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: telemetry_i2c_pm_callback
+ *******************************************************************************
+ *
+ * Summary:
+ *  Deep Sleep callback: forwards to the EZI2C driver, which refuses Deep Sleep
+ *  while a transfer is in progress and enables the address match wakeup.
+ *
+ ******************************************************************************/
+PM_WAKE_FUNC static cy_en_syspm_status_t telemetry_i2c_pm_callback(cy_en_syspm_callback_type_t type,
+                                                                   cy_en_syspm_callback_mode_t mode)
+{
+    (void) type;
+
+    return Cy_SCB_EZI2C_DeepSleepCallback(&telemetryI2cPmParams, mode);
+}
+
+/*******************************************************************************
+ * Function Name: telemetry_i2c_isr
+ *******************************************************************************
+ *
+ * Summary:
+ *  SCB interrupt: address match wakeup and EZI2C transfer handling.
+ *
+ * Parameters:
+ *  None
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+PM_WAKE_FUNC void telemetry_i2c_isr(void)
+{
+    Cy_SCB_EZI2C_Interrupt(TELEMETRY_I2C_HW, &telemetryI2cContext);
+}
+
+#endif /* TELEMETRY_I2C */
+
+/* [] END OF FILE */
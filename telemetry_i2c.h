@@ -0,0 +1,83 @@
+/******************************************************************************
+* File Name: telemetry_i2c.h
+*
+* Description: I2C slave telemetry. An SCB configured as EZI2C slave exposes
+*              the power statistics (pm_stats_t) as a read-only register map
+*              to an I2C master, such as an embedded controller. The SCB
+*              wakes the device from Deep Sleep on address match.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef TELEMETRY_I2C_H
+#define TELEMETRY_I2C_H
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cy_pdl.h"
+#include "pm_module.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Enables the I2C telemetry slave. Set from the Makefile: TELEMETRY_I2C=1.
+ * Needs an SCB named CYBSP_I2C configured as EZI2C slave, with wake from
+ * Deep Sleep enabled, in design.modus. */
+#ifndef TELEMETRY_I2C
+#define TELEMETRY_I2C           (0U)
+#endif
+
+#if TELEMETRY_I2C
+
+/* SCB instance, as named in the Device Configurator */
+#ifndef TELEMETRY_I2C_HW
+#define TELEMETRY_I2C_HW        CYBSP_I2C_HW
+#define TELEMETRY_I2C_IRQ       CYBSP_I2C_IRQ
+#define TELEMETRY_I2C_CONFIG    CYBSP_I2C_config
+#endif
+
+#define TELEMETRY_I2C_INTR_PRIORITY (3U)
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+PM_WAKE_FUNC void telemetry_i2c_isr(void);
+
+#endif /* TELEMETRY_I2C */
+
+#endif /* TELEMETRY_I2C_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,267 @@
+/******************************************************************************
+* File Name: telemetry_uart.c
+*
+* Description: Binary telemetry on CYBSP_UART. A power management module
+*              records a trace record on every wakeup and sends a statistics
+*              snapshot every TELEMETRY_UART_STATS_INTERVAL wakeups. Before
+*              Deep Sleep, where the SCB UART stops, it waits for the
+*              transmitter to drain.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "telemetry_uart.h"
+
+#if TELEMETRY_UART
+
+#include <string.h>
+#include "cybsp.h"
+#include "pm_module.h"
+#include "pm_stats.h"
+#include "wdt_svc.h"
+
+/*******************************************************************************
+ * Global variables
+ ******************************************************************************/
+static cy_stc_scb_uart_context_t telemetryUartContext;
+static uint8_t traceBuf[TELEMETRY_UART_TRACE_BYTES];   /* Packed trace frame payload */
+static uint32_t traceLen;
+static uint32_t traceTicks;     /* Time of the last buffered record */
+static uint32_t statsWakeups;
+static uint32_t statsSnapshots;
+
+/* Statistics snapshot being sent, kept off the stack the frame buffers of
+ * telemetry_uart_send() already take */
+static union
+{
+    pm_stats_t map;
+    qhist_t dsexit;
+} statsCopy;
+static uint8_t frameSeq;
+
+/* Only BEFORE_TRANSITION and AFTER_TRANSITION have work to do */
+static volatile uint8_t telemetryUartSkip = CY_SYSPM_SKIP_CHECK_READY | CY_SYSPM_SKIP_CHECK_FAIL;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+static void telemetry_uart_init(void);
+static cy_en_syspm_status_t telemetry_uart_pm_callback(cy_en_syspm_callback_type_t type,
+                                                       cy_en_syspm_callback_mode_t mode);
+static void telemetry_uart_clock_changed(uint32_t hfclkHz);
+
+/* Low priority: AFTER_TRANSITION runs first on the way up, so the trace
+ * record is taken before the other modules' work */
+PM_MODULE_DEFINE(telemetry_uart_module, PM_PRIORITY_LOW,
+    .init     = telemetry_uart_init,
+    .callback = telemetry_uart_pm_callback,
+    .types    = PM_TYPE_ALL,
+    .skipMode = &telemetryUartSkip,
+    .clockChanged = telemetry_uart_clock_changed);
+
+/*******************************************************************************
+ * Function Name: telemetry_uart_init
+ *******************************************************************************
+ *
+ * Summary:
+ *  Power management module init hook: starts the UART.
+ *
+ ******************************************************************************/
+static void telemetry_uart_init(void)
+{
+    Cy_SCB_UART_Init(CYBSP_UART_HW, &CYBSP_UART_config, &telemetryUartContext);
+    Cy_SCB_UART_Enable(CYBSP_UART_HW);
+}
+
+/*******************************************************************************
+ * Function Name: telemetry_uart_send
+ *******************************************************************************
+ *
+ * Summary:
+ *  Sends one frame. Blocks until the frame is in the TX FIFO.
+ *
+ * Parameters:
+ *  type: TELEMETRY_FRAME_xxx.
+ *  payload: Frame payload.
+ *  length: Payload length, at most TELEMETRY_FRAME_MAX_PAYLOAD.
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void telemetry_uart_send(uint8_t type, const void *payload, uint32_t length)
+{
+    uint8_t raw[TELEMETRY_FRAME_MAX_RAW];
+    uint8_t wire[TELEMETRY_FRAME_MAX_WIRE];
+    uint16_t crc;
+    size_t wireLen;
+
+    CY_ASSERT(length <= TELEMETRY_FRAME_MAX_PAYLOAD);
+
+    raw[0] = type;
+    raw[1] = frameSeq++;
+    memcpy(&raw[TELEMETRY_FRAME_HEADER], payload, length);
+    length += TELEMETRY_FRAME_HEADER;
+    crc = telemetry_crc16(TELEMETRY_FRAME_CRC_INIT, raw, length);
+    raw[length++] = (uint8_t)crc;
+    raw[length++] = (uint8_t)(crc >> 8);
+
+    wireLen = telemetry_cobs_encode(wire, raw, length);
+    wire[wireLen++] = TELEMETRY_FRAME_DELIMITER;
+
+    Cy_SCB_UART_PutArrayBlocking(CYBSP_UART_HW, wire, (uint32_t)wireLen);
+}
+
+/*******************************************************************************
+ * Function Name: telemetry_uart_flush
+ *******************************************************************************
+ *
+ * Summary:
+ *  Sends the buffered trace records.
+ *
+ ******************************************************************************/
+void telemetry_uart_flush(void)
+{
+    if (traceLen != 0U)
+    {
+        telemetry_uart_send(TELEMETRY_FRAME_TRACE_PACKED, traceBuf, traceLen);
+        traceLen = 0U;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: telemetry_uart_trace
+ *******************************************************************************
+ *
+ * Summary:
+ *  Buffers a trace record, packed with the time since the previous record
+ *  (see TELEMETRY_FRAME_TRACE_PACKED). A trace frame is sent when the record
+ *  does not fit in the buffer. Call it from the main loop context.
+ *
+ * Parameters:
+ *  event: TELEMETRY_TRACE_xxx.
+ *  arg: Event argument.
+ *  value: Event value.
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void telemetry_uart_trace(uint8_t event, uint8_t arg, uint16_t value)
+{
+    uint32_t now = wdt_svc_now();
+
+    if (((traceLen + TELEMETRY_TRACE_MAX_PACKED) > sizeof(traceBuf)) ||
+        ((now - traceTicks) > TELEMETRY_TRACE_MAX_DELTA))
+    {
+        telemetry_uart_flush();
+    }
+
+    /* A frame starts with the full time, so it decodes on its own */
+    if (traceLen == 0U)
+    {
+        traceLen = (uint32_t)telemetry_varint_encode(traceBuf, now);
+        traceTicks = now;
+    }
+
+    traceLen += (uint32_t)telemetry_trace_pack(&traceBuf[traceLen], now - traceTicks, event, arg, value);
+    traceTicks = now;
+}
+
+/*******************************************************************************
+ * Function Name: telemetry_uart_pm_callback
+ *******************************************************************************
+ *
+ * Summary:
+ *  Waits for the UART to drain before Deep Sleep, traces every wakeup and
+ *  sends the statistics every TELEMETRY_UART_STATS_INTERVAL wakeups, with
+ *  the exit latency histogram every TELEMETRY_UART_QHIST_INTERVAL snapshots.
+ *
+ ******************************************************************************/
+static cy_en_syspm_status_t telemetry_uart_pm_callback(cy_en_syspm_callback_type_t type,
+                                                       cy_en_syspm_callback_mode_t mode)
+{
+    if ((mode == CY_SYSPM_BEFORE_TRANSITION) && (type == CY_SYSPM_DEEPSLEEP))
+    {
+        while (!Cy_SCB_UART_IsTxComplete(CYBSP_UART_HW))
+        {
+        }
+    }
+    else if (mode == CY_SYSPM_AFTER_TRANSITION)
+    {
+        telemetry_uart_trace(TELEMETRY_TRACE_WAKE,
+                             (type == CY_SYSPM_DEEPSLEEP) ? PM_STATS_DEEPSLEEP : PM_STATS_SLEEP, 0U);
+
+        /* A snapshot torn by updates is tried again at the next wakeup */
+        if ((++statsWakeups >= TELEMETRY_UART_STATS_INTERVAL) && pm_stats_snapshot(&statsCopy.map))
+        {
+            statsWakeups = 0U;
+            telemetry_uart_flush();
+            telemetry_uart_send(TELEMETRY_FRAME_STATS, &statsCopy.map, sizeof(statsCopy.map));
+            if ((++statsSnapshots >= TELEMETRY_UART_QHIST_INTERVAL) && pm_stats_dsexit_snapshot(&statsCopy.dsexit))
+            {
+                statsSnapshots = 0U;
+                telemetry_uart_send(TELEMETRY_FRAME_QHIST, &statsCopy.dsexit, sizeof(statsCopy.dsexit));
+            }
+        }
+    }
+    else
+    {
+        /* Nothing to do in the other phases */
+    }
+
+    return CY_SYSPM_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: telemetry_uart_clock_changed
+ *******************************************************************************
+ *
+ * Summary:
+ *  HFCLK change hook: traces the new frequency. The UART divider itself is
+ *  reprogrammed by app_clock_changed().
+ *
+ ******************************************************************************/
+static void telemetry_uart_clock_changed(uint32_t hfclkHz)
+{
+    telemetry_uart_trace(TELEMETRY_TRACE_CLOCK, 0U, (uint16_t)(hfclkHz / 1000000UL));
+}
+
+#endif /* TELEMETRY_UART */
+
+/* [] END OF FILE */
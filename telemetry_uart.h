@@ -0,0 +1,84 @@
+/******************************************************************************
+* File Name: telemetry_uart.h
+*
+* Description: Binary telemetry on CYBSP_UART. Statistics snapshots and
+*              trace records are sent as COBS framed, CRC protected frames
+*              (see telemetry_frame.h) instead of text. host/tdecode decodes
+*              a capture.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef TELEMETRY_UART_H
+#define TELEMETRY_UART_H
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cy_pdl.h"
+#include "telemetry_frame.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Enables the binary telemetry. Set from the Makefile: TELEMETRY_UART=1.
+ * Also carries the log records of log.h. */
+#ifndef TELEMETRY_UART
+#define TELEMETRY_UART          (0U)
+#endif
+
+/* Statistics snapshot every this many wakeups */
+#define TELEMETRY_UART_STATS_INTERVAL   (16U)
+
+/* Deep Sleep exit latency histogram every this many snapshots */
+#define TELEMETRY_UART_QHIST_INTERVAL   (4U)
+
+/* Buffer of packed trace records, sent as one frame when full */
+#define TELEMETRY_UART_TRACE_BYTES      (64U)
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+#if TELEMETRY_UART
+void telemetry_uart_send(uint8_t type, const void *payload, uint32_t length);
+void telemetry_uart_trace(uint8_t event, uint8_t arg, uint16_t value);
+void telemetry_uart_flush(void);
+#else
+#define telemetry_uart_trace(event, arg, value)     do { } while (0)
+#endif
+
+#endif /* TELEMETRY_UART_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,387 @@
+/******************************************************************************
+* File Name: wdt_svc.c
+*
+* Description: Watchdog service. The WDT counter runs from the ILO in
+*              Active, Sleep and Deep Sleep. Its match value is always
+*              programmed to the nearest of the next software timer deadline
+*              and WDT_SVC_FEED_TICKS from now, so timer wakeups also feed
+*              the watchdog and a feed-only wakeup happens only when no
+*              timer is due within that time. The interrupt is cleared (the
+*              watchdog fed) only if the main loop called wdt_svc_kick()
+*              since the previous check, made by the first WDT interrupt
+*              WDT_SVC_FEED_TICKS or more after the one before. Otherwise
+*              the interrupt is masked and left pending, and the hardware
+*              resets the device after three unserviced matches. Entering Sleep or Deep Sleep
+*              counts as a check-in too, see wdt_svc_pm_callback().
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "wdt_svc.h"
+#include "pm_module.h"
+
+/*******************************************************************************
+ * Data types
+ ******************************************************************************/
+typedef struct
+{
+    uint32_t deadline;          /* Absolute tick of the next expiration */
+    uint32_t period;            /* Reload for periodic timers, 0 for one-shot */
+    wdt_svc_callback_t callback;/* NULL when stopped */
+} wdt_svc_timer_t;
+
+/*******************************************************************************
+ * Global variables
+ ******************************************************************************/
+static wdt_svc_timer_t wdtTimers[WDT_SVC_TIMER_COUNT];
+static wdt_svc_stats_t wdtStats;
+
+/* Extended tick count at the last WDT counter read */
+static uint32_t wdtNow;
+static uint32_t wdtLastCount;
+
+/* Set by the main loop, checked and cleared by the WDT interrupt */
+static volatile uint8_t wdtAlive;
+
+/* Tick of the last main loop check. Timer interrupts closer together than
+ * WDT_SVC_FEED_TICKS, such as during the LED indication of the
+ * application, do not each require a check-in. */
+static uint32_t wdtCheckTicks;
+
+/* The check-in callback only runs in BEFORE_TRANSITION */
+static volatile uint8_t wdtPmSkip = CY_SYSPM_SKIP_CHECK_READY | CY_SYSPM_SKIP_CHECK_FAIL |
+                                    CY_SYSPM_SKIP_AFTER_TRANSITION;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+static void wdt_svc_init(void);
+PM_WAKE_FUNC static cy_en_syspm_status_t wdt_svc_pm_callback(cy_en_syspm_callback_type_t type,
+                                                             cy_en_syspm_callback_mode_t mode);
+
+static const cy_stc_sysint_t wdt_intr_config =
+{
+    WDT_SVC_IRQ,                /* Source of interrupt signal */
+    WDT_SVC_INTR_PRIORITY       /* Interrupt priority */
+};
+
+PM_MODULE_DEFINE(wdt_svc_module, PM_PRIORITY_DEFAULT,
+    .init     = wdt_svc_init,
+    .wakeIntr = &wdt_intr_config,
+    .wakeIsr  = wdt_svc_isr);
+
+/* Separate module, so the check-in is the last BEFORE_TRANSITION callback */
+PM_MODULE_DEFINE(wdt_svc_pm_module, PM_PRIORITY_LOW,
+    .callback = wdt_svc_pm_callback,
+    .types    = PM_TYPE_ALL,
+    .skipMode = &wdtPmSkip);
+
+/*******************************************************************************
+ * Function Name: wdt_svc_update_now
+ *******************************************************************************
+ *
+ * Summary:
+ *  Extends the 16-bit WDT counter to 32 bits. Called at least once per
+ *  counter wrap, since the WDT interrupt fires at least that often.
+ *
+ ******************************************************************************/
+PM_WAKE_FUNC static uint32_t wdt_svc_update_now(void)
+{
+    uint32_t count = Cy_WDT_GetCount();
+
+    wdtNow += (count - wdtLastCount) & WDT_SVC_COUNTER_MASK;
+    wdtLastCount = count;
+
+    return wdtNow;
+}
+
+/*******************************************************************************
+ * Function Name: wdt_svc_program
+ *******************************************************************************
+ *
+ * Summary:
+ *  Programs the WDT match for the nearest of the timer deadlines and the feed
+ *  deadline. Called with interrupts disabled or from the WDT interrupt.
+ *
+ ******************************************************************************/
+static void wdt_svc_program(void)
+{
+    uint32_t now = wdt_svc_update_now();
+    uint32_t delta = WDT_SVC_FEED_TICKS;
+    uint32_t left;
+    uint32_t id;
+
+    for (id = 0U; id < WDT_SVC_TIMER_COUNT; id++)
+    {
+        if (wdtTimers[id].callback != NULL)
+        {
+            left = wdtTimers[id].deadline - now;
+            /* Already due: match as soon as possible */
+            left = ((int32_t)left <= 0) ? 1U : left;
+            delta = (left < delta) ? left : delta;
+        }
+    }
+
+    Cy_WDT_SetMatch((wdtLastCount + delta) & WDT_SVC_COUNTER_MASK);
+}
+
+/*******************************************************************************
+ * Function Name: wdt_svc_init
+ *******************************************************************************
+ *
+ * Summary:
+ *  Power management module init hook: starts the WDT with its interrupt
+ *  unmasked. The wake interrupt itself is enabled by pm_init().
+ *
+ ******************************************************************************/
+static void wdt_svc_init(void)
+{
+    wdtLastCount = Cy_WDT_GetCount();
+    wdtCheckTicks = wdtNow;
+    wdtAlive = 1U;
+    wdt_svc_program();
+    Cy_WDT_ClearInterrupt();
+    Cy_WDT_UnmaskInterrupt();
+    Cy_WDT_Enable();
+}
+
+/*******************************************************************************
+ * Function Name: wdt_svc_pm_callback
+ *******************************************************************************
+ *
+ * Summary:
+ *  Checks in for the main loop right before the CPU sleeps. A WDT interrupt
+ *  taken while an earlier callback runs long, such as the LED indication of
+ *  the application, clears the check-in of the main loop; without this, the
+ *  interrupt that wakes the device would then find none and let the
+ *  watchdog reset it.
+ *
+ * Parameters:
+ *  type: Power mode being entered (unused).
+ *  mode: Callback mode, only CY_SYSPM_BEFORE_TRANSITION is not skipped.
+ *
+ * Return:
+ *  CY_SYSPM_SUCCESS
+ *
+ ******************************************************************************/
+PM_WAKE_FUNC static cy_en_syspm_status_t wdt_svc_pm_callback(cy_en_syspm_callback_type_t type,
+                                                             cy_en_syspm_callback_mode_t mode)
+{
+    (void) type;
+    (void) mode;
+
+    wdtAlive = 1U;
+
+    return CY_SYSPM_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: wdt_svc_kick
+ *******************************************************************************
+ *
+ * Summary:
+ *  Reports that the main loop is alive. Call it once per main loop iteration;
+ *  the main loop runs after every wakeup, including WDT wakeups.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void wdt_svc_kick(void)
+{
+    wdtAlive = 1U;
+}
+
+/*******************************************************************************
+ * Function Name: wdt_svc_now
+ *******************************************************************************
+ *
+ * Summary:
+ *  Returns the current time in ILO ticks since the WDT was started.
+ *
+ ******************************************************************************/
+PM_WAKE_FUNC uint32_t wdt_svc_now(void)
+{
+    uint32_t intrState = Cy_SysLib_EnterCriticalSection();
+    uint32_t now = wdt_svc_update_now();
+
+    Cy_SysLib_ExitCriticalSection(intrState);
+
+    return now;
+}
+
+/*******************************************************************************
+ * Function Name: wdt_svc_timer_start
+ *******************************************************************************
+ *
+ * Summary:
+ *  Starts a software timer on the WDT. The callback runs in the WDT interrupt
+ *  and the device wakes up from Deep Sleep for it.
+ *
+ * Parameters:
+ *  id: Timer slot, below WDT_SVC_TIMER_COUNT.
+ *  ticks: Time to expiration in ILO ticks, see WDT_SVC_MS_TO_TICKS.
+ *  periodic: Restart the timer with the same period on expiration.
+ *  callback: Function called on expiration.
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void wdt_svc_timer_start(uint32_t id, uint32_t ticks, bool periodic, wdt_svc_callback_t callback)
+{
+    uint32_t intrState;
+
+    CY_ASSERT(id < WDT_SVC_TIMER_COUNT);
+
+    intrState = Cy_SysLib_EnterCriticalSection();
+    wdtTimers[id].deadline = wdt_svc_update_now() + ticks;
+    wdtTimers[id].period = periodic ? ticks : 0U;
+    wdtTimers[id].callback = callback;
+    wdt_svc_program();
+    Cy_SysLib_ExitCriticalSection(intrState);
+}
+
+/*******************************************************************************
+ * Function Name: wdt_svc_timer_stop
+ *******************************************************************************
+ *
+ * Summary:
+ *  Stops a software timer.
+ *
+ * Parameters:
+ *  id: Timer slot.
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void wdt_svc_timer_stop(uint32_t id)
+{
+    uint32_t intrState;
+
+    CY_ASSERT(id < WDT_SVC_TIMER_COUNT);
+
+    intrState = Cy_SysLib_EnterCriticalSection();
+    wdtTimers[id].callback = NULL;
+    wdt_svc_program();
+    Cy_SysLib_ExitCriticalSection(intrState);
+}
+
+/*******************************************************************************
+ * Function Name: wdt_svc_stats
+ *******************************************************************************
+ *
+ * Summary:
+ *  Returns the WDT wakeup counters.
+ *
+ ******************************************************************************/
+const wdt_svc_stats_t *wdt_svc_stats(void)
+{
+    return &wdtStats;
+}
+
+/*******************************************************************************
+ * Function Name: wdt_svc_isr
+ *******************************************************************************
+ *
+ * Summary:
+ *  WDT interrupt: feeds the watchdog if the main loop is alive, runs the
+ *  expired timers and programs the next match.
+ *
+ * Parameters:
+ *  None
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+PM_WAKE_FUNC void wdt_svc_isr(void)
+{
+    uint32_t now;
+    uint32_t id;
+    bool expired = false;
+    wdt_svc_callback_t callback;
+
+    now = wdt_svc_update_now();
+    if ((now - wdtCheckTicks) >= WDT_SVC_FEED_TICKS)
+    {
+        if (wdtAlive == 0U)
+        {
+            /* The main loop did not run since the last check: keep the
+             * interrupt pending so the hardware resets the device */
+            Cy_WDT_MaskInterrupt();
+            return;
+        }
+        wdtAlive = 0U;
+        wdtCheckTicks = now;
+    }
+    Cy_WDT_ClearInterrupt();
+
+    wdtStats.interrupts++;
+    for (id = 0U; id < WDT_SVC_TIMER_COUNT; id++)
+    {
+        callback = wdtTimers[id].callback;
+        if ((callback != NULL) && ((int32_t)(wdtTimers[id].deadline - now) <= 0))
+        {
+            if (wdtTimers[id].period != 0U)
+            {
+                wdtTimers[id].deadline += wdtTimers[id].period;
+            }
+            else
+            {
+                wdtTimers[id].callback = NULL;
+            }
+            expired = true;
+            wdtStats.expired++;
+            callback();
+        }
+    }
+
+    if (!expired)
+    {
+        wdtStats.feedOnly++;
+    }
+
+    wdt_svc_program();
+}
+
+/* [] END OF FILE */
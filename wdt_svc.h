@@ -0,0 +1,112 @@
+/******************************************************************************
+* File Name: wdt_svc.h
+*
+* Description: Watchdog service. The WDT is used both as the wake timer of
+*              the application and as its supervisor: feeding happens in the
+*              WDT interrupt of the scheduled wakeups, so protection does
+*              not cost wakeups of its own.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2022-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef WDT_SVC_H
+#define WDT_SVC_H
+
+/*******************************************************************************
+ * Include header files
+ ******************************************************************************/
+#include "cy_pdl.h"
+#include "pm_module.h"
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* WDT clock: ILO, nominal frequency */
+#define WDT_SVC_ILO_HZ          (40000UL)
+
+/* The WDT counter is 16 bits wide; it matches once per wrap at the latest */
+#define WDT_SVC_COUNTER_MASK    (0xFFFFUL)
+
+/* Longest time between WDT interrupts, in ILO ticks. Must stay below one
+ * counter wrap. */
+#define WDT_SVC_FEED_TICKS      (60000UL)
+
+/* Number of software timers: the application's, below WDT_SVC_TIMER_STATS,
+ * and the residency refresh of the power statistics (pm_stats.c) */
+#define WDT_SVC_TIMER_COUNT     (3U)
+#define WDT_SVC_TIMER_STATS     (2U)
+
+/* WDT interrupt. The PMG1-S0 to S3 device headers route the WDT to the SRSS
+ * interrupt; other devices must name theirs. */
+#ifndef WDT_SVC_IRQ
+#if defined(CY_DEVICE_PMG1S0) || defined(CY_DEVICE_PMG1S1) || defined(CY_DEVICE_PMG1S2) || \
+    defined(CY_DEVICE_PMG1S3)
+#define WDT_SVC_IRQ             srss_interrupt_IRQn
+#else
+#error "WDT_SVC_IRQ: define the WDT interrupt of this device"
+#endif
+#endif
+#define WDT_SVC_INTR_PRIORITY   (3U)
+
+/* Converts milliseconds to ILO ticks */
+#define WDT_SVC_MS_TO_TICKS(ms) (((uint32_t)(ms) * WDT_SVC_ILO_HZ) / 1000UL)
+
+/*******************************************************************************
+ * Data types
+ ******************************************************************************/
+/* Software timer callback, called from the WDT interrupt */
+typedef void (*wdt_svc_callback_t)(void);
+
+/* Counters */
+typedef struct
+{
+    uint32_t interrupts;        /* WDT interrupts (wakeups from the WDT) */
+    uint32_t feedOnly;          /* Interrupts with no timer expiring */
+    uint32_t expired;           /* Timer expirations */
+} wdt_svc_stats_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+void wdt_svc_kick(void);
+PM_WAKE_FUNC uint32_t wdt_svc_now(void);
+void wdt_svc_timer_start(uint32_t id, uint32_t ticks, bool periodic, wdt_svc_callback_t callback);
+void wdt_svc_timer_stop(uint32_t id);
+const wdt_svc_stats_t *wdt_svc_stats(void);
+PM_WAKE_FUNC void wdt_svc_isr(void);
+
+#endif /* WDT_SVC_H */
+
+/* [] END OF FILE */